@@ -215,6 +215,20 @@ evt_parse_expiry_nsec(struct evt_options *opt, const char *arg)
 	return ret;
 }
 
+static int
+evt_parse_timer_cancel_pct(struct evt_options *opt, const char *arg)
+{
+	int ret;
+
+	ret = parser_read_uint8(&(opt->timer_cancel_pct), arg);
+	if (ret == 0 && opt->timer_cancel_pct > 100) {
+		evt_err("Timer cancel percentage cannot be > 100");
+		return -EINVAL;
+	}
+
+	return ret;
+}
+
 static int
 evt_parse_nb_timer_adptrs(struct evt_options *opt, const char *arg)
 {
@@ -366,6 +380,8 @@ usage(char *program)
 		"\t--timer_tick_nsec  : timer tick interval in ns.\n"
 		"\t--max_tmo_nsec     : max timeout interval in ns.\n"
 		"\t--expiry_nsec      : event timer expiry ns.\n"
+		"\t--timer_cancel_pct : percentage of armed timers to cancel\n"
+		"\t                     in the perf_timer test.\n"
 		"\t--crypto_adptr_mode : 0 for OP_NEW mode (default) and\n"
 		"\t                      1 for OP_FORWARD mode.\n"
 		"\t--mbuf_sz          : packet mbuf size.\n"
@@ -447,6 +463,7 @@ static struct option lgopts[] = {
 	{ EVT_TIMER_TICK_NSEC,     1, 0, 0 },
 	{ EVT_MAX_TMO_NSEC,        1, 0, 0 },
 	{ EVT_EXPIRY_NSEC,         1, 0, 0 },
+	{ EVT_TIMER_CANCEL_PCT,    1, 0, 0 },
 	{ EVT_MBUF_SZ,             1, 0, 0 },
 	{ EVT_MAX_PKT_SZ,          1, 0, 0 },
 	{ EVT_PROD_ENQ_BURST_SZ,   1, 0, 0 },
@@ -489,6 +506,7 @@ evt_opts_parse_long(int opt_idx, struct evt_options *opt)
 		{ EVT_TIMER_TICK_NSEC, evt_parse_timer_tick_nsec},
 		{ EVT_MAX_TMO_NSEC, evt_parse_max_tmo_nsec},
 		{ EVT_EXPIRY_NSEC, evt_parse_expiry_nsec},
+		{ EVT_TIMER_CANCEL_PCT, evt_parse_timer_cancel_pct},
 		{ EVT_MBUF_SZ, evt_parse_mbuf_sz},
 		{ EVT_MAX_PKT_SZ, evt_parse_max_pkt_sz},
 		{ EVT_PROD_ENQ_BURST_SZ, evt_parse_prod_enq_burst_sz},
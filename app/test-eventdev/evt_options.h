@@ -43,6 +43,7 @@
 #define EVT_TIMER_TICK_NSEC      ("timer_tick_nsec")
 #define EVT_MAX_TMO_NSEC         ("max_tmo_nsec")
 #define EVT_EXPIRY_NSEC          ("expiry_nsec")
+#define EVT_TIMER_CANCEL_PCT     ("timer_cancel_pct")
 #define EVT_MBUF_SZ              ("mbuf_sz")
 #define EVT_MAX_PKT_SZ           ("max_pkt_sz")
 #define EVT_PROD_ENQ_BURST_SZ    ("prod_enq_burst_sz")
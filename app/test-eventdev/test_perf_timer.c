@@ -0,0 +1,884 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <math.h>
+
+#include <rte_cycles.h>
+#include <rte_event_timer_adapter.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_mempool.h>
+
+#include "evt_common.h"
+#include "evt_options.h"
+#include "evt_test.h"
+
+/* See http://doc.dpdk.org/guides/tools/testeventdev.html for test details */
+
+#define PERF_TIMER_BURST_SIZE 16
+#define PERF_TIMER_QUEUE_ID 0
+
+/* Seconds without progress before the test is considered stalled */
+#define PERF_TIMER_STALL_SEC 5
+
+/* Lateness histogram: values below 16 cycles get a bucket each, larger values
+ * use 16 linear sub-buckets per power of two, bounding the percentile error
+ * to 1/16 of the reported value.
+ */
+#define PERF_TIMER_HIST_SUB_BITS 4
+#define PERF_TIMER_HIST_SUB (1 << PERF_TIMER_HIST_SUB_BITS)
+#define PERF_TIMER_HIST_NB ((64 - PERF_TIMER_HIST_SUB_BITS + 1) * \
+			    PERF_TIMER_HIST_SUB)
+
+struct test_perf_timer;
+
+struct perf_timer_elt {
+	union {
+		struct rte_event_timer tim;
+		struct {
+			char pad[offsetof(struct rte_event_timer, user_meta)];
+			uint64_t exp_cycles;
+		};
+	};
+} __rte_cache_aligned;
+
+struct perf_timer_prod {
+	struct test_perf_timer *t;
+	struct perf_timer_elt **elts;
+	uint64_t armed;
+	uint64_t arm_fail;
+	uint64_t arm_cycles;
+	uint64_t canceled;
+	uint64_t cancel_fail;
+	uint64_t cancel_cycles;
+	int done;
+} __rte_cache_aligned;
+
+struct perf_timer_worker {
+	struct test_perf_timer *t;
+	uint8_t dev_id;
+	uint8_t port_id;
+	uint64_t expired;
+	uint64_t lateness_sum;
+	uint64_t lateness_max;
+	uint64_t first_cycles;
+	uint64_t last_cycles;
+	uint64_t *lateness_hist;
+} __rte_cache_aligned;
+
+struct test_perf_timer {
+	/* Don't change the offset of "done". Signal handler use this memory
+	 * to terminate all lcores work.
+	 */
+	int done;
+	enum evt_test_result result;
+	uint8_t nb_workers;
+	uint8_t nb_producers;
+	uint8_t sched_type;
+	uint64_t timeout_ticks;
+	uint64_t timeout_cycles;
+	struct rte_mempool *pool;
+	struct evt_options *opt;
+	struct perf_timer_prod prod[EVT_MAX_PORTS];
+	struct perf_timer_worker worker[EVT_MAX_PORTS];
+	struct rte_event_timer_adapter *timer_adptr[
+		RTE_EVENT_TIMER_ADAPTER_NUM_MAX] __rte_cache_aligned;
+} __rte_cache_aligned;
+
+static inline unsigned int
+perf_timer_hist_bucket(uint64_t cycles)
+{
+	unsigned int msb;
+
+	if (cycles < PERF_TIMER_HIST_SUB)
+		return cycles;
+
+	msb = rte_fls_u64(cycles) - 1;
+	return (msb - PERF_TIMER_HIST_SUB_BITS + 1) * PERF_TIMER_HIST_SUB +
+		((cycles >> (msb - PERF_TIMER_HIST_SUB_BITS)) &
+		 (PERF_TIMER_HIST_SUB - 1));
+}
+
+/* Upper bound of the values accounted to a histogram bucket */
+static inline uint64_t
+perf_timer_hist_value(unsigned int bucket)
+{
+	unsigned int shift;
+
+	if (bucket < PERF_TIMER_HIST_SUB)
+		return bucket;
+
+	shift = bucket / PERF_TIMER_HIST_SUB - 1;
+	return (((uint64_t)PERF_TIMER_HIST_SUB +
+		 bucket % PERF_TIMER_HIST_SUB + 1) << shift) - 1;
+}
+
+static inline uint64_t
+perf_timer_nb_armed(struct test_perf_timer *t)
+{
+	uint64_t total = 0;
+	uint8_t i;
+
+	for (i = 0; i < t->nb_producers; i++)
+		total += __atomic_load_n(&t->prod[i].armed, __ATOMIC_RELAXED);
+
+	return total;
+}
+
+static inline uint64_t
+perf_timer_nb_expired(struct test_perf_timer *t)
+{
+	uint64_t total = 0;
+	uint8_t i;
+
+	for (i = 0; i < t->nb_workers; i++)
+		total += __atomic_load_n(&t->worker[i].expired,
+					 __ATOMIC_RELAXED);
+
+	return total;
+}
+
+static int
+perf_timer_worker(void *arg)
+{
+	struct perf_timer_worker *w = arg;
+	struct test_perf_timer *t = w->t;
+	const uint8_t dev = w->dev_id;
+	const uint8_t port = w->port_id;
+	struct rte_event ev[PERF_TIMER_BURST_SIZE];
+	struct perf_timer_elt *elt;
+	uint64_t now, lateness;
+	uint16_t i, nb_rx;
+
+	if (t->opt->verbose_level > 1)
+		printf("%s(): lcore %d dev_id %d port=%d\n", __func__,
+		       rte_lcore_id(), dev, port);
+
+	while (t->done == false) {
+		nb_rx = rte_event_dequeue_burst(dev, port, ev, RTE_DIM(ev), 0);
+		if (!nb_rx) {
+			rte_pause();
+			continue;
+		}
+
+		now = rte_get_timer_cycles();
+		if (unlikely(w->first_cycles == 0))
+			w->first_cycles = now;
+		w->last_cycles = now;
+
+		for (i = 0; i < nb_rx; i++) {
+			elt = ev[i].event_ptr;
+			lateness = now > elt->exp_cycles ?
+				now - elt->exp_cycles : 0;
+			w->lateness_hist[perf_timer_hist_bucket(lateness)]++;
+			w->lateness_sum += lateness;
+			if (lateness > w->lateness_max)
+				w->lateness_max = lateness;
+		}
+
+		__atomic_store_n(&w->expired, w->expired + nb_rx,
+				 __ATOMIC_RELAXED);
+	}
+
+	return 0;
+}
+
+static uint16_t
+perf_timer_arm(struct test_perf_timer *t,
+	       struct rte_event_timer_adapter *adptr,
+	       struct rte_event_timer **tims, uint16_t nb_tims)
+{
+	if (t->opt->timdev_use_burst)
+		return rte_event_timer_arm_tmo_tick_burst(adptr, tims,
+							  t->timeout_ticks,
+							  nb_tims);
+
+	return rte_event_timer_arm_burst(adptr, tims, nb_tims);
+}
+
+static int
+perf_timer_producer(void *arg)
+{
+	struct perf_timer_prod *p = arg;
+	struct test_perf_timer *t = p->t;
+	struct evt_options *opt = t->opt;
+	const uint64_t nb_timers = opt->nb_timers;
+	const uint8_t nb_timer_adptrs = opt->nb_timer_adptrs;
+	struct rte_event_timer *tims[PERF_TIMER_BURST_SIZE];
+	struct rte_event_timer_adapter *adptr;
+	struct perf_timer_elt **elts = p->elts;
+	struct rte_event_timer tim;
+	uint64_t i, start, now;
+	uint16_t j, n, nb, nb_tims, done;
+
+	if (opt->verbose_level > 1)
+		printf("%s(): lcore %d\n", __func__, rte_lcore_id());
+
+	memset(&tim, 0, sizeof(struct rte_event_timer));
+	tim.ev.op = RTE_EVENT_OP_NEW;
+	tim.ev.queue_id = PERF_TIMER_QUEUE_ID;
+	tim.ev.sched_type = t->sched_type;
+	tim.ev.priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+	tim.ev.event_type = RTE_EVENT_TYPE_TIMER;
+	tim.state = RTE_EVENT_TIMER_NOT_ARMED;
+	tim.timeout_ticks = t->timeout_ticks;
+
+	/* Take all timer objects upfront so that only the arm operations
+	 * are accounted to the arm rate.
+	 */
+	start = rte_get_timer_cycles();
+	for (i = 0; i < nb_timers; i += n) {
+		n = RTE_MIN(nb_timers - i, (uint64_t)PERF_TIMER_BURST_SIZE);
+		while (rte_mempool_get_bulk(t->pool, (void **)&elts[i], n)) {
+			if (t->done)
+				goto out;
+			if (rte_get_timer_cycles() - start >
+			    rte_get_timer_hz() * PERF_TIMER_STALL_SEC) {
+				evt_err("lcore %d: only %"PRIu64" of %"PRIu64
+					" timer objects available",
+					rte_lcore_id(), i, nb_timers);
+				t->done = true;
+				goto out;
+			}
+			rte_pause();
+		}
+		for (j = 0; j < n; j++) {
+			elts[i + j]->tim = tim;
+			elts[i + j]->tim.ev.flow_id = (i + j) % opt->nb_flows;
+			elts[i + j]->tim.ev.event_ptr = elts[i + j];
+		}
+	}
+
+	/* Arm the timers in bursts, spreading the bursts over the adapters */
+	start = rte_get_timer_cycles();
+	for (i = 0; i < nb_timers && t->done == false; i += n) {
+		n = RTE_MIN(nb_timers - i, (uint64_t)PERF_TIMER_BURST_SIZE);
+		adptr = t->timer_adptr[(i / PERF_TIMER_BURST_SIZE) %
+				       nb_timer_adptrs];
+
+		now = rte_get_timer_cycles();
+		for (j = 0; j < n; j++) {
+			elts[i + j]->exp_cycles = now + t->timeout_cycles;
+			tims[j] = &elts[i + j]->tim;
+		}
+
+		done = perf_timer_arm(t, adptr, tims, n);
+		while (done < n && t->done == false) {
+			if (rte_errno == EINVAL || rte_errno == EALREADY) {
+				/* Skip the timer that cannot be armed */
+				p->arm_fail++;
+				if (++done == n)
+					break;
+			} else {
+				rte_pause();
+			}
+			done += perf_timer_arm(t, adptr, &tims[done],
+					       n - done);
+		}
+		__atomic_store_n(&p->armed, p->armed + n,
+				 __ATOMIC_RELAXED);
+	}
+	p->armed -= p->arm_fail;
+	p->arm_cycles = rte_get_timer_cycles() - start;
+
+	if (opt->timer_cancel_pct == 0)
+		goto out;
+
+	/* Cancel the requested share of every armed burst */
+	start = rte_get_timer_cycles();
+	for (i = 0; i < nb_timers && t->done == false; i += n) {
+		n = RTE_MIN(nb_timers - i, (uint64_t)PERF_TIMER_BURST_SIZE);
+		adptr = t->timer_adptr[(i / PERF_TIMER_BURST_SIZE) %
+				       nb_timer_adptrs];
+
+		nb_tims = 0;
+		for (j = 0; j < n; j++)
+			if ((i + j) % 100 < opt->timer_cancel_pct)
+				tims[nb_tims++] = &elts[i + j]->tim;
+
+		done = rte_event_timer_cancel_burst(adptr, tims, nb_tims);
+		p->canceled += done;
+		while (done < nb_tims && t->done == false) {
+			if (rte_errno == EAGAIN) {
+				rte_pause();
+			} else {
+				/* Timer already expired or was never armed */
+				p->cancel_fail++;
+				done++;
+			}
+			nb = rte_event_timer_cancel_burst(adptr, &tims[done],
+							  nb_tims - done);
+			p->canceled += nb;
+			done += nb;
+		}
+	}
+	p->cancel_cycles = rte_get_timer_cycles() - start;
+
+out:
+	__atomic_store_n(&p->done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static int
+perf_timer_launch_lcores(struct evt_test *test, struct evt_options *opt)
+{
+	struct test_perf_timer *t = evt_test_priv(test);
+	const uint64_t hz = rte_get_timer_hz();
+	uint64_t expected, expired, last_expired;
+	uint64_t cycles, sample_cycles, progress_cycles, stall_cycles;
+	int ret, lcore_id, port_idx, prod_idx;
+	uint8_t i, nb_done;
+
+	port_idx = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (!(opt->wlcores[lcore_id]))
+			continue;
+
+		ret = rte_eal_remote_launch(perf_timer_worker,
+				&t->worker[port_idx], lcore_id);
+		if (ret) {
+			evt_err("failed to launch worker %d", lcore_id);
+			return ret;
+		}
+		port_idx++;
+	}
+
+	prod_idx = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (!(opt->plcores[lcore_id]))
+			continue;
+
+		ret = rte_eal_remote_launch(perf_timer_producer,
+				&t->prod[prod_idx], lcore_id);
+		if (ret) {
+			evt_err("failed to launch producer %d", lcore_id);
+			return ret;
+		}
+		prod_idx++;
+	}
+
+	/* Consider the test stalled if no timer fires for a while past
+	 * the timeout of the last armed timer.
+	 */
+	stall_cycles = hz * PERF_TIMER_STALL_SEC + t->timeout_cycles;
+	sample_cycles = progress_cycles = rte_get_timer_cycles();
+	last_expired = 0;
+
+	while (t->done == false) {
+		cycles = rte_get_timer_cycles();
+		expired = perf_timer_nb_expired(t);
+		if (expired != last_expired) {
+			last_expired = expired;
+			progress_cycles = cycles;
+		}
+
+		if (cycles - sample_cycles > hz) {
+			printf(CLGRN"\rarmed %"PRIu64" expired %"PRIu64 CLNRM,
+			       perf_timer_nb_armed(t), expired);
+			fflush(stdout);
+			sample_cycles = cycles;
+		}
+
+		nb_done = 0;
+		expected = 0;
+		for (i = 0; i < t->nb_producers; i++) {
+			if (!__atomic_load_n(&t->prod[i].done,
+					     __ATOMIC_ACQUIRE))
+				continue;
+			nb_done++;
+			expected += t->prod[i].armed - t->prod[i].canceled;
+		}
+		if (nb_done != t->nb_producers) {
+			progress_cycles = cycles;
+			rte_pause();
+			continue;
+		}
+
+		if (expired >= expected) {
+			t->result = EVT_TEST_SUCCESS;
+			t->done = true;
+		} else if (cycles - progress_cycles > stall_cycles) {
+			rte_event_dev_dump(opt->dev_id, stdout);
+			evt_err("%"PRIu64" of %"PRIu64" timers did not expire",
+				expected - expired, expected);
+			t->done = true;
+		}
+		rte_pause();
+	}
+	printf("\n");
+
+	return 0;
+}
+
+static double
+perf_timer_rate(uint64_t nb, uint64_t cycles)
+{
+	return cycles ? (double)nb * rte_get_timer_hz() / cycles / 1E6 : 0;
+}
+
+static double
+perf_timer_cycles_to_us(uint64_t cycles)
+{
+	return (double)cycles * 1E6 / rte_get_timer_hz();
+}
+
+static int
+perf_timer_result(struct evt_test *test, struct evt_options *opt)
+{
+	static const double pcts[] = { 50, 90, 99, 99.9, 99.99 };
+	struct test_perf_timer *t = evt_test_priv(test);
+	uint64_t armed = 0, arm_fail = 0, arm_cycles = 0;
+	uint64_t canceled = 0, cancel_fail = 0, cancel_cycles = 0;
+	uint64_t expired = 0, lateness_sum = 0, lateness_max = 0;
+	uint64_t first = UINT64_MAX, last = 0;
+	uint64_t *hist, target, count;
+	char name[EVT_STR_FMT + 1];
+	unsigned int b, p;
+	uint8_t i;
+
+	for (i = 0; i < t->nb_producers; i++) {
+		struct perf_timer_prod *prod = &t->prod[i];
+
+		armed += prod->armed;
+		arm_fail += prod->arm_fail;
+		arm_cycles = RTE_MAX(arm_cycles, prod->arm_cycles);
+		canceled += prod->canceled;
+		cancel_fail += prod->cancel_fail;
+		cancel_cycles = RTE_MAX(cancel_cycles, prod->cancel_cycles);
+	}
+
+	hist = rte_zmalloc(NULL, sizeof(uint64_t) * PERF_TIMER_HIST_NB, 0);
+	if (hist == NULL) {
+		evt_err("failed to allocate lateness histogram");
+		return EVT_TEST_FAILED;
+	}
+
+	for (i = 0; i < t->nb_workers; i++) {
+		struct perf_timer_worker *w = &t->worker[i];
+
+		expired += w->expired;
+		lateness_sum += w->lateness_sum;
+		lateness_max = RTE_MAX(lateness_max, w->lateness_max);
+		if (w->expired) {
+			first = RTE_MIN(first, w->first_cycles);
+			last = RTE_MAX(last, w->last_cycles);
+		}
+		for (b = 0; b < PERF_TIMER_HIST_NB; b++)
+			hist[b] += w->lateness_hist[b];
+	}
+
+	printf("Timer distribution across worker cores :\n");
+	for (i = 0; i < t->nb_workers; i++)
+		printf("Worker %d timers: "CLGRN"%"PRIu64" "CLNRM"percentage:"
+		       CLGRN" %3.2f"CLNRM"\n", i, t->worker[i].expired,
+		       expired ? (double)t->worker[i].expired / expired * 100 :
+		       0);
+
+	evt_dump("armed", "%"PRIu64" (%"PRIu64" failed)", armed, arm_fail);
+	evt_dump("arm rate", "%.3f M/s", perf_timer_rate(armed, arm_cycles));
+	if (opt->timer_cancel_pct) {
+		evt_dump("canceled", "%"PRIu64" (%"PRIu64" failed)", canceled,
+			 cancel_fail);
+		evt_dump("cancel rate", "%.3f M/s",
+			 perf_timer_rate(canceled, cancel_cycles));
+	}
+	evt_dump("expired", "%"PRIu64, expired);
+	evt_dump("expiry rate", "%.3f M/s",
+		 expired > 1 ? perf_timer_rate(expired - 1, last - first) : 0);
+
+	if (expired) {
+		evt_dump("lateness avg", "%.3f us",
+			 perf_timer_cycles_to_us(lateness_sum / expired));
+		for (p = 0; p < RTE_DIM(pcts); p++) {
+			target = ceil(expired * pcts[p] / 100);
+			count = 0;
+			for (b = 0; b < PERF_TIMER_HIST_NB - 1; b++) {
+				count += hist[b];
+				if (count >= target)
+					break;
+			}
+			snprintf(name, sizeof(name), "lateness p%g", pcts[p]);
+			evt_dump(name, "%.3f us",
+				 perf_timer_cycles_to_us(RTE_MIN(
+					perf_timer_hist_value(b),
+					lateness_max)));
+		}
+		evt_dump("lateness max", "%.3f us",
+			 perf_timer_cycles_to_us(lateness_max));
+	}
+
+	rte_free(hist);
+
+	return t->result;
+}
+
+static int
+perf_timer_adapter_setup(struct test_perf_timer *t, struct evt_options *opt)
+{
+	struct rte_event_timer_adapter_info adapter_info;
+	struct rte_event_timer_adapter *wl;
+	uint64_t nb_timers, tick_nsec;
+	uint8_t flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES;
+	uint32_t service_id;
+	int i, ret;
+
+	if (t->nb_producers == 1)
+		flags |= RTE_EVENT_TIMER_ADAPTER_F_SP_PUT;
+
+	/* Bursts are spread round robin, leave room for partial rounds */
+	nb_timers = opt->nb_timers * t->nb_producers / opt->nb_timer_adptrs +
+		t->nb_producers * PERF_TIMER_BURST_SIZE;
+
+	for (i = 0; i < opt->nb_timer_adptrs; i++) {
+		struct rte_event_timer_adapter_conf config = {
+			.event_dev_id = opt->dev_id,
+			.timer_adapter_id = i,
+			.timer_tick_ns = opt->timer_tick_nsec,
+			.max_tmo_ns = opt->max_tmo_nsec,
+			.nb_timers = nb_timers,
+			.flags = flags,
+		};
+
+		wl = rte_event_timer_adapter_create(&config);
+		if (wl == NULL) {
+			evt_err("failed to create event timer adapter %d", i);
+			return -rte_errno;
+		}
+		t->timer_adptr[i] = wl;
+
+		memset(&adapter_info, 0,
+		       sizeof(struct rte_event_timer_adapter_info));
+		rte_event_timer_adapter_get_info(wl, &adapter_info);
+		opt->optm_timer_tick_nsec = adapter_info.min_resolution_ns;
+
+		if (!(adapter_info.caps &
+		      RTE_EVENT_TIMER_ADAPTER_CAP_INTERNAL_PORT)) {
+			service_id = -1U;
+			rte_event_timer_adapter_service_id_get(wl, &service_id);
+			ret = evt_service_setup(service_id);
+			if (ret) {
+				evt_err("Failed to setup service core"
+					" for timer adapter\n");
+				return ret;
+			}
+			rte_service_runstate_set(service_id, 1);
+		}
+	}
+
+	tick_nsec = opt->optm_timer_tick_nsec ? opt->optm_timer_tick_nsec :
+		opt->timer_tick_nsec;
+	t->timeout_ticks = RTE_MAX(opt->expiry_nsec / tick_nsec, (uint64_t)1);
+	t->timeout_cycles = (double)t->timeout_ticks * tick_nsec *
+		rte_get_timer_hz() / 1E9;
+
+	return 0;
+}
+
+static int
+perf_timer_eventdev_setup(struct evt_test *test, struct evt_options *opt)
+{
+	struct test_perf_timer *t = evt_test_priv(test);
+	struct rte_event_dev_info dev_info;
+	uint32_t service_id;
+	uint8_t queue = PERF_TIMER_QUEUE_ID;
+	int ret, i;
+
+	memset(&dev_info, 0, sizeof(struct rte_event_dev_info));
+	ret = rte_event_dev_info_get(opt->dev_id, &dev_info);
+	if (ret) {
+		evt_err("failed to get eventdev info %d", opt->dev_id);
+		return ret;
+	}
+
+	ret = evt_configure_eventdev(opt, 1, t->nb_workers);
+	if (ret) {
+		evt_err("failed to configure eventdev %d", opt->dev_id);
+		return ret;
+	}
+
+	struct rte_event_queue_conf q_conf = {
+			.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+			.schedule_type = t->sched_type,
+			.nb_atomic_flows = opt->nb_flows,
+			.nb_atomic_order_sequences = opt->nb_flows,
+	};
+	ret = rte_event_queue_setup(opt->dev_id, queue, &q_conf);
+	if (ret) {
+		evt_err("failed to setup queue=%d", queue);
+		return ret;
+	}
+
+	if (opt->wkr_deq_dep > dev_info.max_event_port_dequeue_depth)
+		opt->wkr_deq_dep = dev_info.max_event_port_dequeue_depth;
+
+	const struct rte_event_port_conf p_conf = {
+			.dequeue_depth = opt->wkr_deq_dep,
+			.enqueue_depth = dev_info.max_event_port_dequeue_depth,
+			.new_event_threshold = dev_info.max_num_events,
+	};
+
+	for (i = 0; i < t->nb_workers; i++) {
+		struct perf_timer_worker *w = &t->worker[i];
+
+		w->dev_id = opt->dev_id;
+		w->port_id = i;
+		w->t = t;
+		w->lateness_hist = rte_zmalloc_socket(NULL,
+				sizeof(uint64_t) * PERF_TIMER_HIST_NB,
+				RTE_CACHE_LINE_SIZE, opt->socket_id);
+		if (w->lateness_hist == NULL) {
+			evt_err("failed to allocate lateness histogram");
+			return -ENOMEM;
+		}
+
+		ret = rte_event_port_setup(opt->dev_id, i, &p_conf);
+		if (ret) {
+			evt_err("failed to setup port %d", i);
+			return ret;
+		}
+
+		ret = rte_event_port_link(opt->dev_id, i, &queue, NULL, 1);
+		if (ret != 1) {
+			evt_err("failed to link queue to port %d", i);
+			return -EINVAL;
+		}
+	}
+
+	for (i = 0; i < t->nb_producers; i++) {
+		struct perf_timer_prod *p = &t->prod[i];
+
+		p->t = t;
+		p->elts = rte_zmalloc_socket(NULL,
+				sizeof(*p->elts) * opt->nb_timers,
+				RTE_CACHE_LINE_SIZE, opt->socket_id);
+		if (p->elts == NULL) {
+			evt_err("failed to allocate producer timer list");
+			return -ENOMEM;
+		}
+	}
+
+	ret = perf_timer_adapter_setup(t, opt);
+	if (ret)
+		return ret;
+
+	if (!evt_has_distributed_sched(opt->dev_id)) {
+		rte_event_dev_service_id_get(opt->dev_id, &service_id);
+		ret = evt_service_setup(service_id);
+		if (ret) {
+			evt_err("No service lcore found to run event dev.");
+			return ret;
+		}
+	}
+
+	ret = rte_event_dev_start(opt->dev_id);
+	if (ret) {
+		evt_err("failed to start eventdev %d", opt->dev_id);
+		return ret;
+	}
+
+	for (i = 0; i < opt->nb_timer_adptrs; i++) {
+		ret = rte_event_timer_adapter_start(t->timer_adptr[i]);
+		if (ret) {
+			evt_err("failed to Start event timer adapter %d", i);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static void
+perf_timer_eventdev_destroy(struct evt_test *test, struct evt_options *opt)
+{
+	struct test_perf_timer *t = evt_test_priv(test);
+	int i;
+
+	for (i = 0; i < opt->nb_timer_adptrs; i++) {
+		if (t->timer_adptr[i] == NULL)
+			continue;
+		rte_event_timer_adapter_stop(t->timer_adptr[i]);
+	}
+	rte_event_dev_stop(opt->dev_id);
+	for (i = 0; i < opt->nb_timer_adptrs; i++) {
+		if (t->timer_adptr[i] == NULL)
+			continue;
+		rte_event_timer_adapter_free(t->timer_adptr[i]);
+	}
+	rte_event_dev_close(opt->dev_id);
+}
+
+static int
+perf_timer_mempool_setup(struct evt_test *test, struct evt_options *opt)
+{
+	struct test_perf_timer *t = evt_test_priv(test);
+
+	t->pool = rte_mempool_create(test->name, /* mempool name */
+			opt->nb_timers * t->nb_producers, /* number of elements*/
+			sizeof(struct perf_timer_elt), /* element size*/
+			0, /* cache size, objects are taken once and kept */
+			0, NULL, NULL, NULL, NULL,
+			opt->socket_id, 0); /* flags */
+	if (t->pool == NULL) {
+		evt_err("failed to create mempool of %"PRIu64" timers",
+			opt->nb_timers * t->nb_producers);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void
+perf_timer_mempool_destroy(struct evt_test *test, struct evt_options *opt)
+{
+	struct test_perf_timer *t = evt_test_priv(test);
+	uint8_t i;
+
+	RTE_SET_USED(opt);
+
+	for (i = 0; i < t->nb_producers; i++)
+		rte_free(t->prod[i].elts);
+	for (i = 0; i < t->nb_workers; i++)
+		rte_free(t->worker[i].lateness_hist);
+	rte_mempool_free(t->pool);
+}
+
+static int
+perf_timer_test_setup(struct evt_test *test, struct evt_options *opt)
+{
+	struct test_perf_timer *t;
+
+	t = rte_zmalloc_socket(test->name, sizeof(struct test_perf_timer),
+			       RTE_CACHE_LINE_SIZE, opt->socket_id);
+	if (t == NULL) {
+		evt_err("failed to allocate test_perf_timer memory");
+		return -ENOMEM;
+	}
+	test->test_priv = t;
+
+	t->done = false;
+	t->result = EVT_TEST_FAILED;
+	t->opt = opt;
+	t->nb_workers = evt_nr_active_lcores(opt->wlcores);
+	t->nb_producers = evt_nr_active_lcores(opt->plcores);
+	t->sched_type = opt->nb_stages ? opt->sched_type_list[0] :
+		RTE_SCHED_TYPE_ATOMIC;
+
+	return 0;
+}
+
+static void
+perf_timer_test_destroy(struct evt_test *test, struct evt_options *opt)
+{
+	RTE_SET_USED(opt);
+
+	rte_free(test->test_priv);
+}
+
+static int
+perf_timer_opt_check(struct evt_options *opt)
+{
+	if (rte_lcore_count() < 3) {
+		evt_err("test need minimum 3 lcores");
+		return -1;
+	}
+
+	if (evt_lcores_has_overlap(opt->wlcores, rte_get_main_lcore())) {
+		evt_err("worker lcores overlaps with main lcore");
+		return -1;
+	}
+	if (evt_lcores_has_overlap(opt->plcores, rte_get_main_lcore())) {
+		evt_err("producer lcores overlaps with main lcore");
+		return -1;
+	}
+	if (evt_lcores_has_overlap_multi(opt->wlcores, opt->plcores)) {
+		evt_err("worker lcores overlaps producer lcores");
+		return -1;
+	}
+	if (evt_has_disabled_lcore(opt->wlcores) ||
+	    evt_has_disabled_lcore(opt->plcores)) {
+		evt_err("one or more worker or producer lcores are not enabled");
+		return -1;
+	}
+	if (!evt_has_active_lcore(opt->wlcores)) {
+		evt_err("minimum one worker is required");
+		return -1;
+	}
+	if (!evt_has_active_lcore(opt->plcores)) {
+		evt_err("minimum one producer is required");
+		return -1;
+	}
+	if (evt_nr_active_lcores(opt->wlcores) > EVT_MAX_PORTS ||
+	    evt_nr_active_lcores(opt->plcores) > EVT_MAX_PORTS) {
+		evt_err("number of workers or producers exceeds %d",
+			EVT_MAX_PORTS);
+		return -1;
+	}
+
+	if (opt->nb_stages && evt_has_invalid_sched_type(opt))
+		return -1;
+
+	if (opt->nb_timers == 0 || opt->nb_flows == 0) {
+		evt_err("nb_timers and nb_flows must be non-zero");
+		return -1;
+	}
+	if (opt->timer_tick_nsec == 0 || opt->expiry_nsec == 0) {
+		evt_err("timer_tick_nsec and expiry_nsec must be non-zero");
+		return -1;
+	}
+	if (opt->expiry_nsec > opt->max_tmo_nsec) {
+		evt_info("expiry_nsec exceeds max_tmo_nsec, using %"PRIu64,
+			 opt->expiry_nsec);
+		opt->max_tmo_nsec = opt->expiry_nsec;
+	}
+
+	return 0;
+}
+
+static void
+perf_timer_opt_dump(struct evt_options *opt)
+{
+	evt_dump("nb_prod_lcores", "%d", evt_nr_active_lcores(opt->plcores));
+	evt_dump_producer_lcores(opt);
+	evt_dump("nb_worker_lcores", "%d", evt_nr_active_lcores(opt->wlcores));
+	evt_dump_worker_lcores(opt);
+	evt_dump("nb_timer_adapters", "%d", opt->nb_timer_adptrs);
+	evt_dump("arm mode", "%s", opt->timdev_use_burst ?
+		 "arm_tmo_tick_burst" : "arm_burst");
+	evt_dump("timer_tick_nsec", "%"PRIu64, opt->timer_tick_nsec);
+	evt_dump("max_tmo_nsec", "%"PRIu64, opt->max_tmo_nsec);
+	evt_dump("expiry_nsec", "%"PRIu64, opt->expiry_nsec);
+	evt_dump("timer_cancel_pct", "%u", opt->timer_cancel_pct);
+}
+
+static bool
+perf_timer_capability_check(struct evt_options *opt)
+{
+	struct rte_event_dev_info dev_info;
+
+	rte_event_dev_info_get(opt->dev_id, &dev_info);
+	if (dev_info.max_event_ports < evt_nr_active_lcores(opt->wlcores)) {
+		evt_err("not enough eventdev ports=%d/%d",
+			evt_nr_active_lcores(opt->wlcores),
+			dev_info.max_event_ports);
+		return false;
+	}
+
+	return true;
+}
+
+static const struct evt_test_ops perf_timer =  {
+	.cap_check          = perf_timer_capability_check,
+	.opt_check          = perf_timer_opt_check,
+	.opt_dump           = perf_timer_opt_dump,
+	.test_setup         = perf_timer_test_setup,
+	.mempool_setup      = perf_timer_mempool_setup,
+	.eventdev_setup     = perf_timer_eventdev_setup,
+	.launch_lcores      = perf_timer_launch_lcores,
+	.eventdev_destroy   = perf_timer_eventdev_destroy,
+	.mempool_destroy    = perf_timer_mempool_destroy,
+	.test_result        = perf_timer_result,
+	.test_destroy       = perf_timer_test_destroy,
+};
+
+EVT_TEST_REGISTER(perf_timer);
@@ -6,6 +6,7 @@
 
 #include <string.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
 #include <rte_ethdev.h>
@@ -31,6 +32,10 @@ test_event_eth_rx_intr_adapter_common(void)
 #include <rte_bus_vdev.h>
 
 #include <rte_event_eth_rx_adapter.h>
+#include <rte_service.h>
+#ifdef RTE_NET_RING
+#include <rte_eth_ring.h>
+#endif
 
 #define MAX_NUM_RX_QUEUE	64
 #define NB_MBUFS		(8192 * num_ports * MAX_NUM_RX_QUEUE)
@@ -548,6 +553,349 @@ adapter_queue_stats_test(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_queue_vector_adapt_test(void)
+{
+	struct rte_event_eth_rx_adapter_queue_conf queue_config = {0};
+	struct rte_event_eth_rx_adapter_vector_adapt_conf adapt_conf = {0};
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter_queue_stats q_stats;
+	struct rte_mempool *vector_mp;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+					 &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) ||
+	    (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT))
+		return TEST_SKIPPED;
+
+	err = rte_event_eth_rx_adapter_vector_limits_get(TEST_DEV_ID,
+						TEST_ETHDEV_ID, &limits);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vector_mp = rte_event_vector_pool_create("rxa_vector_adapt_pool", 512,
+						 0, limits.max_sz,
+						 rte_socket_id());
+	TEST_ASSERT(vector_mp != NULL, "Failed to create vector pool");
+
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+	queue_config.ev.queue_id = 0;
+	queue_config.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.ev.priority = 0;
+	queue_config.servicing_weight = 1;
+	queue_config.event_buf_size = 1024;
+	queue_config.vector_sz = limits.min_sz;
+	queue_config.vector_timeout_ns = limits.max_timeout_ns;
+	queue_config.vector_mp = vector_mp;
+
+	adapt_conf.enable = 1;
+	adapt_conf.min_sz = limits.min_sz;
+	adapt_conf.max_sz = limits.max_sz;
+	adapt_conf.min_timeout_ns = limits.min_timeout_ns;
+	adapt_conf.max_timeout_ns = limits.max_timeout_ns;
+
+	/* Queue not added */
+	err = rte_event_eth_rx_adapter_queue_vector_adapt_set(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &adapt_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0,
+					&queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Inverted bounds */
+	adapt_conf.min_sz = limits.max_sz;
+	adapt_conf.max_sz = limits.min_sz;
+	err = rte_event_eth_rx_adapter_queue_vector_adapt_set(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &adapt_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	adapt_conf.min_sz = limits.min_sz;
+	adapt_conf.max_sz = limits.max_sz;
+	err = rte_event_eth_rx_adapter_queue_vector_adapt_set(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &adapt_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	memset(&adapt_conf, 0, sizeof(adapt_conf));
+	err = rte_event_eth_rx_adapter_queue_vector_adapt_get(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &adapt_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(adapt_conf.enable, "Adaptive sizing not enabled");
+	TEST_ASSERT_EQUAL(adapt_conf.max_sz, limits.max_sz,
+			"Expected max_sz %u got %u", limits.max_sz,
+			adapt_conf.max_sz);
+
+	err = rte_event_eth_rx_adapter_queue_stats_get(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0,
+						&q_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(q_stats.rx_vector_sz >= limits.min_sz &&
+		    q_stats.rx_vector_sz <= limits.max_sz,
+		    "Vector size %" PRIu64 " out of bounds",
+		    q_stats.rx_vector_sz);
+
+	/* Disabling restores the vector size configured at queue add */
+	adapt_conf.enable = 0;
+	err = rte_event_eth_rx_adapter_queue_vector_adapt_set(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &adapt_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_stats_get(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0,
+						&q_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(q_stats.rx_vector_sz, limits.min_sz,
+			"Expected vector size %u got %" PRIu64,
+			limits.min_sz, q_stats.rx_vector_sz);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID,
+						TEST_ETHDEV_ID,
+						0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_mempool_free(vector_mp);
+
+	return TEST_SUCCESS;
+}
+
+#ifdef RTE_NET_RING
+
+#define VECTOR_ADAPT_RING_SIZE		1024
+#define VECTOR_ADAPT_MAX_SZ		256
+#define VECTOR_ADAPT_WINDOW_NS		(10 * 1000 * 1000)
+
+/* Ring port, created before the adapter to be known by it */
+static struct rte_ring *vector_adapt_ring;
+static struct rte_mempool *vector_adapt_mbuf_mp;
+static int vector_adapt_port = -1;
+
+static int
+adapter_create_ring_port(void)
+{
+	struct rte_eth_conf port_conf = {0};
+	int err;
+
+	vector_adapt_ring = rte_ring_create("rxa_vector_adapt_ring",
+			VECTOR_ADAPT_RING_SIZE, rte_socket_id(),
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT(vector_adapt_ring != NULL, "Failed to create ring");
+
+	vector_adapt_mbuf_mp = rte_pktmbuf_pool_create("rxa_vector_adapt_mbuf",
+			2 * VECTOR_ADAPT_RING_SIZE, 0, 0,
+			RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+	TEST_ASSERT(vector_adapt_mbuf_mp != NULL,
+		    "Failed to create mbuf pool");
+
+	vector_adapt_port = rte_eth_from_ring(vector_adapt_ring);
+	TEST_ASSERT(vector_adapt_port >= 0, "Failed to create ring port");
+
+	err = rte_eth_dev_configure(vector_adapt_port, 1, 1, &port_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_eth_rx_queue_setup(vector_adapt_port, 0,
+			VECTOR_ADAPT_RING_SIZE, rte_socket_id(), NULL,
+			vector_adapt_mbuf_mp);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_eth_tx_queue_setup(vector_adapt_port, 0,
+			VECTOR_ADAPT_RING_SIZE, rte_socket_id(), NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_eth_dev_start(vector_adapt_port);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return adapter_create_with_params();
+}
+
+static void
+adapter_free_ring_port(void)
+{
+	rte_event_eth_rx_adapter_free(TEST_INST_ID);
+
+	if (vector_adapt_port >= 0) {
+		rte_eth_dev_stop(vector_adapt_port);
+		rte_eth_dev_close(vector_adapt_port);
+		vector_adapt_port = -1;
+	}
+	rte_ring_free(vector_adapt_ring);
+	vector_adapt_ring = NULL;
+	rte_mempool_free(vector_adapt_mbuf_mp);
+	vector_adapt_mbuf_mp = NULL;
+}
+
+/* Put packets on the ring port and run the adapter until it takes them. */
+static int
+vector_adapt_inject(uint32_t service_id, uint16_t nb_pkts)
+{
+	struct rte_mbuf *mbufs[64];
+	uint16_t nb;
+	int i;
+
+	while (nb_pkts != 0) {
+		nb = RTE_MIN(nb_pkts, RTE_DIM(mbufs));
+		TEST_ASSERT(rte_pktmbuf_alloc_bulk(vector_adapt_mbuf_mp,
+				mbufs, nb) == 0, "Failed to allocate mbufs");
+		TEST_ASSERT_EQUAL(rte_ring_enqueue_burst(vector_adapt_ring,
+				(void **)mbufs, nb, NULL), nb,
+				"Failed to enqueue mbufs");
+		nb_pkts -= nb;
+	}
+
+	for (i = 0; i < 1024 && rte_ring_count(vector_adapt_ring) != 0; i++)
+		rte_service_run_iter_on_app_lcore(service_id, 1);
+	TEST_ASSERT_EQUAL(rte_ring_count(vector_adapt_ring), 0,
+			"Adapter did not receive all packets");
+
+	return TEST_SUCCESS;
+}
+
+/* Run the adapter until the adaptation window started at ts is over. */
+static void
+vector_adapt_wait(uint32_t service_id, uint64_t ts, uint64_t window)
+{
+	while (rte_rdtsc() - ts <= window)
+		rte_service_run_iter_on_app_lcore(service_id, 1);
+}
+
+static int
+adapter_queue_vector_adapt_traffic_test(void)
+{
+	struct rte_event_eth_rx_adapter_queue_conf queue_config = {0};
+	struct rte_event_eth_rx_adapter_vector_adapt_conf adapt_conf = {0};
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter_queue_stats q_stats;
+	struct rte_mempool *vector_mp;
+	uint64_t window_ns, window, ts;
+	uint32_t service_id;
+	uint16_t max_sz;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, vector_adapt_port,
+						&cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) ||
+	    (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT))
+		return TEST_SKIPPED;
+
+	err = rte_event_eth_rx_adapter_vector_limits_get(TEST_DEV_ID,
+						vector_adapt_port, &limits);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	max_sz = RTE_MIN(limits.max_sz, VECTOR_ADAPT_MAX_SZ);
+	if (max_sz <= limits.min_sz)
+		return TEST_SKIPPED;
+	window_ns = RTE_MAX(RTE_MIN((uint64_t)VECTOR_ADAPT_WINDOW_NS,
+				    limits.max_timeout_ns),
+			    limits.min_timeout_ns);
+	window = window_ns * rte_get_timer_hz() / NS_PER_S;
+
+	vector_mp = rte_event_vector_pool_create("rxa_vector_traffic_pool",
+						 1024, 0, max_sz,
+						 rte_socket_id());
+	TEST_ASSERT(vector_mp != NULL, "Failed to create vector pool");
+
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+	queue_config.ev.queue_id = 0;
+	queue_config.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.ev.priority = 0;
+	queue_config.servicing_weight = 1;
+	queue_config.event_buf_size = 1024;
+	queue_config.vector_sz = limits.min_sz;
+	queue_config.vector_timeout_ns = window_ns;
+	queue_config.vector_mp = vector_mp;
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+					vector_adapt_port, 0, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_service_id_get(TEST_INST_ID,
+						      &service_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_service_set_runstate_mapped_check(service_id, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	adapt_conf.enable = 1;
+	adapt_conf.min_sz = limits.min_sz;
+	adapt_conf.max_sz = max_sz;
+	adapt_conf.min_timeout_ns = limits.min_timeout_ns;
+	adapt_conf.max_timeout_ns = window_ns;
+	err = rte_event_eth_rx_adapter_queue_vector_adapt_set(TEST_INST_ID,
+					vector_adapt_port, 0, &adapt_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	ts = rte_rdtsc();
+
+	/* High rate: twice the maximum size arrives within the window */
+	err = vector_adapt_inject(service_id, 2 * max_sz);
+	TEST_ASSERT(err == TEST_SUCCESS, "Failed to inject packets");
+	vector_adapt_wait(service_id, ts, window);
+	err = vector_adapt_inject(service_id, 1);
+	TEST_ASSERT(err == TEST_SUCCESS, "Failed to inject packets");
+	ts = rte_rdtsc();
+
+	err = rte_event_eth_rx_adapter_queue_stats_get(TEST_INST_ID,
+					vector_adapt_port, 0, &q_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(q_stats.rx_vector_sz, max_sz,
+			"Expected vector size %u at high rate got %" PRIu64,
+			max_sz, q_stats.rx_vector_sz);
+
+	/* Low rate: a single packet arrives within the next window */
+	vector_adapt_wait(service_id, ts, window);
+	err = vector_adapt_inject(service_id, 1);
+	TEST_ASSERT(err == TEST_SUCCESS, "Failed to inject packets");
+
+	err = rte_event_eth_rx_adapter_queue_stats_get(TEST_INST_ID,
+					vector_adapt_port, 0, &q_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(q_stats.rx_vector_sz, limits.min_sz,
+			"Expected vector size %u at low rate got %" PRIu64,
+			limits.min_sz, q_stats.rx_vector_sz);
+	TEST_ASSERT(q_stats.rx_vector_timeout_ns < window_ns,
+		    "Vector timeout %" PRIu64 " not reduced at low rate",
+		    q_stats.rx_vector_timeout_ns);
+
+	err = rte_event_eth_rx_adapter_stop(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID,
+					vector_adapt_port, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_mempool_free(vector_mp);
+
+	return TEST_SUCCESS;
+}
+
+#else
+
+static int
+adapter_create_ring_port(void)
+{
+	return TEST_SUCCESS;
+}
+
+static void
+adapter_free_ring_port(void)
+{
+}
+
+static int
+adapter_queue_vector_adapt_traffic_test(void)
+{
+	printf("net_ring is required to drive traffic, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#endif /* RTE_NET_RING */
+
 static void
 adapter_free(void)
 {
@@ -1019,6 +1367,10 @@ static struct unit_test_suite event_eth_rx_tests = {
 			     adapter_queue_event_buf_test),
 		TEST_CASE_ST(adapter_create_with_params, adapter_free,
 			     adapter_queue_stats_test),
+		TEST_CASE_ST(adapter_create_with_params, adapter_free,
+			     adapter_queue_vector_adapt_test),
+		TEST_CASE_ST(adapter_create_ring_port, adapter_free_ring_port,
+			     adapter_queue_vector_adapt_traffic_test),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -6,6 +6,7 @@
 
 #include <rte_bus_vdev.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_ethdev.h>
 #include <rte_eth_ring.h>
 #include <rte_eventdev.h>
@@ -464,32 +465,22 @@ tx_adapter_single(uint16_t port, uint16_t tx_queue_id,
 	return -1;
 }
 
+/*
+ * Add all the queues of the test port to the adapter and start
+ * the event device, with services run from the test lcore.
+ */
 static int
-tx_adapter_service(void)
+tx_adapter_service_setup(uint8_t *ev_qid)
 {
-	struct rte_event_eth_tx_adapter_stats stats;
-	uint32_t i;
 	int err;
-	uint8_t ev_port, ev_qid;
-	struct rte_mbuf  bufs[RING_SIZE];
-	struct rte_mbuf *pbufs[RING_SIZE];
+	uint32_t i;
+	uint8_t ev_port;
 	struct rte_event_dev_info dev_info;
 	struct rte_event_dev_config dev_conf;
 	struct rte_event_queue_conf qconf;
 	uint32_t qcnt, pcnt;
-	uint16_t q;
-	int internal_port;
-	uint32_t cap;
 
 	memset(&dev_conf, 0, sizeof(dev_conf));
-	err = rte_event_eth_tx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
-						&cap);
-	TEST_ASSERT(err == 0, "Failed to get adapter cap err %d\n", err);
-
-	internal_port = !!(cap & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT);
-	if (internal_port)
-		return TEST_SUCCESS;
-
 	err = rte_event_eth_tx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
 						-1);
 	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
@@ -522,14 +513,14 @@ tx_adapter_service(void)
 	TEST_ASSERT(err == 0, "Event device initialization failed err %d\n",
 			err);
 
-	ev_qid = qcnt;
+	*ev_qid = qcnt;
 	qconf.nb_atomic_flows = dev_info.max_event_queue_flows;
 	qconf.nb_atomic_order_sequences = 32;
 	qconf.schedule_type = RTE_SCHED_TYPE_ATOMIC;
 	qconf.priority = RTE_EVENT_DEV_PRIORITY_HIGHEST;
 	qconf.event_queue_cfg = RTE_EVENT_QUEUE_CFG_SINGLE_LINK;
-	err = rte_event_queue_setup(TEST_DEV_ID, ev_qid, &qconf);
-	TEST_ASSERT_SUCCESS(err, "Failed to setup queue %u", ev_qid);
+	err = rte_event_queue_setup(TEST_DEV_ID, *ev_qid, &qconf);
+	TEST_ASSERT_SUCCESS(err, "Failed to setup queue %u", *ev_qid);
 
 	/*
 	 * Setup ports again so that the newly added queue is visible
@@ -556,7 +547,7 @@ tx_adapter_service(void)
 			" err %s\n", rte_strerror(rte_errno));
 	}
 
-	err = rte_event_port_link(TEST_DEV_ID, ev_port, &ev_qid, NULL, 1);
+	err = rte_event_port_link(TEST_DEV_ID, ev_port, ev_qid, NULL, 1);
 	TEST_ASSERT(err == 1, "Failed to link queue port %u",
 		    ev_port);
 
@@ -586,6 +577,33 @@ tx_adapter_service(void)
 	err = rte_event_dev_start(TEST_DEV_ID);
 	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
 
+	return TEST_SUCCESS;
+}
+
+static int
+tx_adapter_service(void)
+{
+	struct rte_event_eth_tx_adapter_stats stats;
+	uint32_t i;
+	int err;
+	uint8_t ev_qid;
+	struct rte_mbuf  bufs[RING_SIZE];
+	struct rte_mbuf *pbufs[RING_SIZE];
+	uint16_t q;
+	int internal_port;
+	uint32_t cap;
+
+	err = rte_event_eth_tx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+						&cap);
+	TEST_ASSERT(err == 0, "Failed to get adapter cap err %d\n", err);
+
+	internal_port = !!(cap & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT);
+	if (internal_port)
+		return TEST_SUCCESS;
+
+	err = tx_adapter_service_setup(&ev_qid);
+	TEST_ASSERT_SUCCESS(err, "Failed to setup adapter service");
+
 	for (q = 0; q < MAX_NUM_QUEUE; q++) {
 		for (i = 0; i < RING_SIZE; i++)
 			pbufs[i] = &bufs[i];
@@ -638,6 +656,187 @@ tx_adapter_service(void)
 	return TEST_SUCCESS;
 }
 
+static int
+tx_adapter_coalesce(void)
+{
+	struct rte_event_eth_tx_adapter_queue_coalesce_conf conf;
+	struct rte_event_dev_xstats_name *names;
+	uint64_t *values;
+	uint32_t cap;
+	int err, i, n;
+
+	err = rte_event_eth_tx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+						&cap);
+	TEST_ASSERT(err == 0, "Failed to get adapter cap err %d\n", err);
+
+	if (cap & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT)
+		return TEST_SUCCESS;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.burst_size = 8;
+	conf.max_hold_cycles = rte_get_timer_hz() / 1000;
+
+	err = rte_event_eth_tx_adapter_queue_coalesce_set(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_tx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_tx_adapter_queue_coalesce_set(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0, NULL);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	conf.burst_size = RTE_EVENT_ETH_TX_ADAPTER_COALESCE_MAX_BURST + 1;
+	err = rte_event_eth_tx_adapter_queue_coalesce_set(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	conf.burst_size = 8;
+	err = rte_event_eth_tx_adapter_queue_coalesce_set(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	memset(&conf, 0, sizeof(conf));
+	err = rte_event_eth_tx_adapter_queue_coalesce_get(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(conf.burst_size, 8, "Expected burst size 8 got %u",
+			conf.burst_size);
+	TEST_ASSERT_EQUAL(conf.max_hold_cycles, rte_get_timer_hz() / 1000,
+			"Unexpected hold time %" PRIu64, conf.max_hold_cycles);
+
+	conf.burst_size = 0;
+	err = rte_event_eth_tx_adapter_queue_coalesce_set(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	n = rte_event_eth_tx_adapter_xstats_names_get(TEST_INST_ID, NULL, 0);
+	TEST_ASSERT(n > 0, "Expected xstats count > 0 got %d", n);
+
+	names = calloc(n, sizeof(*names));
+	values = calloc(n, sizeof(*values));
+	TEST_ASSERT(names != NULL && values != NULL, "Failed to alloc xstats");
+
+	err = rte_event_eth_tx_adapter_xstats_names_get(TEST_INST_ID, names, n);
+	TEST_ASSERT(err == n, "Expected %d got %d", n, err);
+	err = rte_event_eth_tx_adapter_xstats_get(TEST_INST_ID, values, n);
+	TEST_ASSERT(err == n, "Expected %d got %d", n, err);
+	for (i = 0; i < n; i++)
+		TEST_ASSERT(strlen(names[i].name) != 0, "Empty xstat name");
+
+	err = rte_event_eth_tx_adapter_xstats_reset(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	free(names);
+	free(values);
+
+	err = rte_event_eth_tx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
+#define COALESCE_BURST		8
+#define COALESCE_NB_PKTS	(COALESCE_BURST / 2)
+#define COALESCE_HOLD_MS	100
+
+static int
+tx_adapter_coalesce_hold(void)
+{
+	struct rte_event_eth_tx_adapter_queue_coalesce_conf conf;
+	struct rte_event ev[COALESCE_NB_PKTS];
+	struct rte_mbuf bufs[COALESCE_NB_PKTS];
+	struct rte_mbuf *r[COALESCE_NB_PKTS];
+	uint64_t hold_cycles, start;
+	uint16_t nb_rx;
+	uint8_t ev_qid;
+	uint32_t cap;
+	int err;
+	int i, l;
+
+	err = rte_event_eth_tx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+						&cap);
+	TEST_ASSERT(err == 0, "Failed to get adapter cap err %d\n", err);
+
+	if (cap & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT)
+		return TEST_SUCCESS;
+
+	err = tx_adapter_service_setup(&ev_qid);
+	TEST_ASSERT_SUCCESS(err, "Failed to setup adapter service");
+
+	hold_cycles = rte_get_timer_hz() * COALESCE_HOLD_MS / 1000;
+	memset(&conf, 0, sizeof(conf));
+	conf.burst_size = COALESCE_BURST;
+	conf.max_hold_cycles = hold_cycles;
+	err = rte_event_eth_tx_adapter_queue_coalesce_set(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0, &conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Fewer packets than the burst size */
+	memset(bufs, 0, sizeof(bufs));
+	memset(ev, 0, sizeof(ev));
+	for (i = 0; i < COALESCE_NB_PKTS; i++) {
+		bufs[i].port = TEST_ETHDEV_ID;
+		rte_event_eth_tx_adapter_txq_set(&bufs[i], 0);
+		ev[i].queue_id = ev_qid;
+		ev[i].op = RTE_EVENT_OP_NEW;
+		ev[i].event_type = RTE_EVENT_TYPE_CPU;
+		ev[i].sched_type = RTE_SCHED_TYPE_ATOMIC;
+		ev[i].mbuf = &bufs[i];
+	}
+	start = rte_get_timer_cycles();
+	err = rte_event_enqueue_burst(TEST_DEV_ID, 0, ev, COALESCE_NB_PKTS);
+	TEST_ASSERT(err == COALESCE_NB_PKTS, "Unable to enqueue to eventdev");
+
+	/*
+	 * Run the services for more iterations than the periodic flush
+	 * threshold, nothing is sent before the hold time.
+	 */
+	nb_rx = 0;
+	for (l = 0; l < 4 * 1024; l++) {
+		if (rte_get_timer_cycles() - start >= hold_cycles / 2)
+			break;
+		if (eid != ~0ULL)
+			rte_service_run_iter_on_app_lcore(eid, 0);
+		rte_service_run_iter_on_app_lcore(tid, 0);
+		nb_rx += rte_eth_rx_burst(TEST_ETHDEV_PAIR_ID, 0, &r[nb_rx],
+					COALESCE_NB_PKTS - nb_rx);
+	}
+	TEST_ASSERT(rte_get_timer_cycles() - start < hold_cycles,
+		"Test lcore too slow to check the hold time");
+	TEST_ASSERT_EQUAL(nb_rx, 0, "Sent %u packets before the hold time",
+			nb_rx);
+
+	/* Everything is sent once the hold time expired */
+	rte_delay_ms(COALESCE_HOLD_MS);
+	for (l = 0; l < EDEV_RETRY && nb_rx < COALESCE_NB_PKTS; l++) {
+		if (eid != ~0ULL)
+			rte_service_run_iter_on_app_lcore(eid, 0);
+		rte_service_run_iter_on_app_lcore(tid, 0);
+		nb_rx += rte_eth_rx_burst(TEST_ETHDEV_PAIR_ID, 0, &r[nb_rx],
+					COALESCE_NB_PKTS - nb_rx);
+	}
+	TEST_ASSERT_EQUAL(nb_rx, COALESCE_NB_PKTS,
+			"Expected %u packets got %u", COALESCE_NB_PKTS, nb_rx);
+	for (i = 0; i < COALESCE_NB_PKTS; i++)
+		TEST_ASSERT_EQUAL(r[i], &bufs[i], "mbuf comparison failed"
+				" expected %p received %p", &bufs[i], r[i]);
+
+	err = rte_event_eth_tx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_tx_adapter_free(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_event_dev_stop(TEST_DEV_ID);
+
+	return TEST_SUCCESS;
+}
+
 static int
 tx_adapter_dynamic_device(void)
 {
@@ -693,8 +892,12 @@ static struct unit_test_suite event_eth_tx_tests = {
 					tx_adapter_queue_add_del),
 		TEST_CASE_ST(tx_adapter_create, tx_adapter_free,
 					tx_adapter_start_stop),
+		TEST_CASE_ST(tx_adapter_create, tx_adapter_free,
+					tx_adapter_coalesce),
 		TEST_CASE_ST(tx_adapter_create, tx_adapter_free,
 					tx_adapter_service),
+		TEST_CASE_ST(tx_adapter_create, tx_adapter_free,
+					tx_adapter_coalesce_hold),
 		TEST_CASE_ST(NULL, NULL, tx_adapter_dynamic_device),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
@@ -25,6 +25,7 @@ test_event_timer_adapter_func(void)
 
 #include <rte_eventdev.h>
 #include <rte_event_timer_adapter.h>
+#include <rte_malloc.h>
 #include <rte_mempool.h>
 #include <rte_launch.h>
 #include <rte_lcore.h>
@@ -1263,6 +1264,116 @@ stat_inc_reset_ev_enq(void)
 	return TEST_SUCCESS;
 }
 
+static int
+xstats_lateness_hist(void)
+{
+	int ret, i, n, sum;
+	int num_evtims = BATCH_SIZE;
+	struct rte_event_timer *evtims[num_evtims];
+	struct rte_event evs[BATCH_SIZE];
+	struct rte_event_dev_xstats_name *names;
+	uint64_t *values;
+	uint64_t lat_hist, a2f_hist;
+	const struct rte_event_timer init_tim = {
+		.ev.op = RTE_EVENT_OP_NEW,
+		.ev.queue_id = TEST_QUEUE_ID,
+		.ev.sched_type = RTE_SCHED_TYPE_ATOMIC,
+		.ev.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+		.ev.event_type =  RTE_EVENT_TYPE_TIMER,
+		.state = RTE_EVENT_TIMER_NOT_ARMED,
+		.timeout_ticks = CALC_TICKS(1),
+	};
+
+	n = rte_event_timer_adapter_xstats_names_get(timdev, NULL, 0);
+	if (n == -ENOTSUP) {
+		printf("Timer adapter xstats not supported, skipping test\n");
+		return TEST_SKIPPED;
+	}
+	TEST_ASSERT(n > 0, "Failed to get xstats count: %d", n);
+
+	names = rte_zmalloc(NULL, sizeof(*names) * n, 0);
+	values = rte_zmalloc(NULL, sizeof(*values) * n, 0);
+	TEST_ASSERT(names != NULL && values != NULL,
+		    "Failed to allocate xstats arrays");
+
+	ret = rte_event_timer_adapter_xstats_names_get(timdev, names, n);
+	TEST_ASSERT_EQUAL(ret, n, "Failed to get xstats names");
+	TEST_ASSERT_SUCCESS(rte_event_timer_adapter_xstats_reset(timdev),
+			    "Failed to reset xstats");
+	ret = rte_event_timer_adapter_xstats_get(timdev, RTE_MAX_LCORE,
+						 values, n);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "Invalid lcore id accepted");
+
+	ret = rte_mempool_get_bulk(eventdev_test_mempool, (void **)evtims,
+				   num_evtims);
+	TEST_ASSERT_EQUAL(ret, 0, "Failed to get array of timer objs: ret = %d",
+			  ret);
+
+	for (i = 0; i < num_evtims; i++) {
+		*evtims[i] = init_tim;
+		evtims[i]->ev.event_ptr = evtims[i];
+	}
+
+	ret = rte_event_timer_arm_burst(timdev, evtims, num_evtims);
+	TEST_ASSERT_EQUAL(ret, num_evtims,
+			  "Failed to arm all event timers: attempted = %d, "
+			  "succeeded = %d, rte_errno = %s",
+			  num_evtims, ret, rte_strerror(rte_errno));
+
+	rte_delay_ms(500);
+
+	sum = 0;
+	for (i = 0; i < 100 && sum < num_evtims; i++) {
+		sum += rte_event_dequeue_burst(evdev, TEST_PORT_ID, evs,
+					       RTE_DIM(evs), 10);
+		rte_delay_ms(10);
+	}
+	TEST_ASSERT_EQUAL(sum, num_evtims, "Expected %d timer expiry events, "
+			  "got %d", num_evtims, sum);
+
+	ret = rte_event_timer_adapter_xstats_get(timdev, rte_lcore_id(),
+						 values, n);
+	TEST_ASSERT_EQUAL(ret, n, "Failed to get lcore xstats");
+
+	lat_hist = 0;
+	a2f_hist = 0;
+	for (i = 0; i < n; i++) {
+		if (!strcmp(names[i].name, "evtim_fired"))
+			TEST_ASSERT_EQUAL(values[i], (uint64_t)num_evtims,
+					  "Expected %d fired timers, got %"
+					  PRIu64, num_evtims, values[i]);
+		else if (!strncmp(names[i].name, "evtim_lateness_cycles_",
+				  strlen("evtim_lateness_cycles_")) &&
+			 strcmp(names[i].name, "evtim_lateness_cycles_sum"))
+			lat_hist += values[i];
+		else if (!strncmp(names[i].name, "evtim_arm_to_fire_cycles_",
+				  strlen("evtim_arm_to_fire_cycles_")) &&
+			 strcmp(names[i].name, "evtim_arm_to_fire_cycles_sum"))
+			a2f_hist += values[i];
+	}
+	TEST_ASSERT_EQUAL(lat_hist, (uint64_t)num_evtims,
+			  "Lateness histogram does not add up");
+	TEST_ASSERT_EQUAL(a2f_hist, (uint64_t)num_evtims,
+			  "Arm-to-fire histogram does not add up");
+
+	/* Reset and check again */
+	TEST_ASSERT_SUCCESS(rte_event_timer_adapter_xstats_reset(timdev),
+			    "Failed to reset xstats");
+	ret = rte_event_timer_adapter_xstats_get(timdev, LCORE_ID_ANY,
+						 values, n);
+	TEST_ASSERT_EQUAL(ret, n, "Failed to get xstats");
+	for (i = 0; i < n; i++)
+		TEST_ASSERT_EQUAL(values[i], 0, "xstat %s not reset",
+				  names[i].name);
+
+	rte_mempool_put_bulk(eventdev_test_mempool, (void **)evtims,
+			     num_evtims);
+	rte_free(names);
+	rte_free(values);
+
+	return TEST_SUCCESS;
+}
+
 /* Test various cases in arming timers */
 static int
 event_timer_arm(void)
@@ -1930,6 +2041,8 @@ static struct unit_test_suite event_timer_adptr_functional_testsuite  = {
 				adapter_stop),
 		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
 				stat_inc_reset_ev_enq),
+		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
+				xstats_lateness_hist),
 		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
 			     event_timer_arm),
 		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
@@ -34,6 +34,7 @@
 #include <rte_ip.h>
 #include <rte_tcp.h>
 #include <rte_mbuf_dyn.h>
+#include <rte_mbuf_tmpl.h>
 
 #define MEMPOOL_CACHE_SIZE      32
 #define MBUF_DATA_SIZE          2048
@@ -1232,11 +1233,13 @@ test_failing_mbuf_sanity_check(struct rte_mempool *pktmbuf_pool)
 		return -1;
 	}
 
-	badbuf = *buf;
-	badbuf.buf_iova = 0;
-	if (verify_mbuf_check_panics(&badbuf)) {
-		printf("Error with bad-physaddr mbuf test\n");
-		return -1;
+	if (RTE_IOVA_AS_PA) {
+		badbuf = *buf;
+		rte_mbuf_iova_set(&badbuf, 0);
+		if (verify_mbuf_check_panics(&badbuf)) {
+			printf("Error with bad-physaddr mbuf test\n");
+			return -1;
+		}
 	}
 
 	badbuf = *buf;
@@ -1917,6 +1920,67 @@ test_neg_pktmbuf_alloc_bulk(struct rte_mempool *pktmbuf_pool)
 	return 0;
 }
 
+/*
+ * Test for allocating a bulk of mbufs from a rearm template and freeing
+ * them back with the fast bulk free.
+ */
+static int
+test_pktmbuf_alloc_bulk_tmpl(struct rte_mempool *pktmbuf_pool)
+{
+	struct rte_mbuf *mbufs[MEMPOOL_CACHE_SIZE * 2] = { 0 };
+	struct rte_mbuf_rearm_tmpl tmpl;
+	const uint16_t port = 7;
+	unsigned int idx, avail;
+	struct rte_mbuf *m;
+
+	avail = rte_mempool_avail_count(pktmbuf_pool);
+	rte_pktmbuf_rearm_tmpl_init(pktmbuf_pool, port, &tmpl);
+
+	/* dirty the mbufs so that the template alloc has to reset them */
+	if (rte_pktmbuf_alloc_bulk(pktmbuf_pool, mbufs, RTE_DIM(mbufs)) != 0)
+		GOTO_FAIL("%s: bulk alloc failed", __func__);
+	for (idx = 0; idx < RTE_DIM(mbufs); idx++) {
+		m = mbufs[idx];
+		m->data_off = 0;
+		m->port = 0;
+		m->ol_flags = RTE_MBUF_F_RX_VLAN | RTE_MBUF_F_RX_RSS_HASH;
+		m->packet_type = RTE_PTYPE_L2_ETHER;
+		m->pkt_len = 64;
+		m->data_len = 64;
+		m->vlan_tci = 1;
+		m->vlan_tci_outer = 2;
+		m->tx_offload = UINT64_MAX;
+	}
+	rte_pktmbuf_free_bulk_fast(mbufs, RTE_DIM(mbufs));
+	if (rte_mempool_avail_count(pktmbuf_pool) != avail)
+		GOTO_FAIL("%s: mbufs not back in the pool", __func__);
+
+	memset(mbufs, 0, sizeof(mbufs));
+	if (rte_pktmbuf_alloc_bulk_tmpl(pktmbuf_pool, mbufs, RTE_DIM(mbufs),
+					&tmpl) != 0)
+		GOTO_FAIL("%s: template bulk alloc failed", __func__);
+	for (idx = 0; idx < RTE_DIM(mbufs); idx++) {
+		m = mbufs[idx];
+		if (m->data_off != RTE_MIN((uint16_t)RTE_PKTMBUF_HEADROOM,
+				rte_pktmbuf_data_room_size(pktmbuf_pool)) ||
+		    m->refcnt != 1 || m->nb_segs != 1 || m->port != port ||
+		    m->ol_flags != 0 || m->packet_type != 0 ||
+		    m->pkt_len != 0 || m->data_len != 0 ||
+		    m->vlan_tci != 0 || m->vlan_tci_outer != 0 ||
+		    m->tx_offload != 0 || m->next != NULL ||
+		    m->pool != pktmbuf_pool)
+			GOTO_FAIL("%s: mbuf %u not reset", __func__, idx);
+		rte_mbuf_sanity_check(m, 1);
+	}
+	rte_pktmbuf_free_bulk_fast(mbufs, RTE_DIM(mbufs));
+	if (rte_mempool_avail_count(pktmbuf_pool) != avail)
+		GOTO_FAIL("%s: mbufs not back in the pool", __func__);
+
+	return 0;
+fail:
+	return -1;
+}
+
 /*
  * Test to read mbuf packet using rte_pktmbuf_read
  */
@@ -2929,6 +2993,12 @@ test_mbuf(void)
 		goto err;
 	}
 
+	/* test for allocating and freeing a bulk of mbufs from a template */
+	if (test_pktmbuf_alloc_bulk_tmpl(pktmbuf_pool) < 0) {
+		printf("test_pktmbuf_alloc_bulk_tmpl() failed\n");
+		goto err;
+	}
+
 	/* test to read mbuf packet */
 	if (test_pktmbuf_read(pktmbuf_pool) < 0) {
 		printf("test_rte_pktmbuf_read() failed\n");
@@ -497,7 +497,7 @@ struct test_mempool_events_data {
 	bool invoked;
 };
 
-static void
+static int
 test_mempool_events_cb(enum rte_mempool_event event,
 		       struct rte_mempool *mp, void *user_data)
 {
@@ -506,6 +506,7 @@ test_mempool_events_cb(enum rte_mempool_event event,
 	data->mp = mp;
 	data->event = event;
 	data->invoked = true;
+	return 0;
 }
 
 static int
@@ -642,7 +643,7 @@ struct test_mempool_events_safety_data {
 	int ret;
 };
 
-static void
+static int
 test_mempool_events_safety_cb(enum rte_mempool_event event,
 			      struct rte_mempool *mp, void *user_data)
 {
@@ -652,6 +653,7 @@ test_mempool_events_safety_cb(enum rte_mempool_event event,
 	RTE_SET_USED(mp);
 	data->invoked = true;
 	data->ret = data->api_func(data->cb_func, data->cb_user_data);
+	return 0;
 }
 
 static int
@@ -835,6 +837,407 @@ test_mempool_flag_non_io_unset_when_populated_with_valid_iova(void)
 	return ret;
 }
 
+#define TEST_CACHE_SIZE 64
+#define TEST_CACHE_BURST 32
+
+/* free objects through a cache that never allocates */
+static int
+test_mempool_cache_produce(struct rte_mempool *mp,
+			   struct rte_mempool_cache *cache, unsigned int iter)
+{
+	void *objs[TEST_CACHE_BURST];
+	unsigned int i;
+
+	for (i = 0; i < iter; i++) {
+		if (rte_mempool_generic_get(mp, objs, RTE_DIM(objs),
+					    NULL) < 0)
+			return -1;
+		rte_mempool_generic_put(mp, objs, RTE_DIM(objs), cache);
+	}
+	return 0;
+}
+
+/* allocate objects through a cache that never frees */
+static int
+test_mempool_cache_consume(struct rte_mempool *mp,
+			   struct rte_mempool_cache *cache, unsigned int iter)
+{
+	void *objs[TEST_CACHE_BURST];
+	unsigned int i;
+
+	for (i = 0; i < iter; i++) {
+		if (rte_mempool_generic_get(mp, objs, RTE_DIM(objs),
+					    cache) < 0)
+			return -1;
+		rte_mempool_generic_put(mp, objs, RTE_DIM(objs), NULL);
+	}
+	return 0;
+}
+
+static int
+test_mempool_cache_adaptive(void)
+{
+	unsigned int put_lcore = rte_lcore_id();
+	unsigned int get_lcore = (put_lcore + 1) % RTE_MAX_LCORE;
+	struct rte_mempool_cache *put_cache, *get_cache;
+	struct rte_mempool_cache_stats stats;
+	struct rte_mempool *mp;
+	int ret;
+
+	mp = rte_mempool_create("test_cache_adaptive", MEMPOOL_SIZE,
+				MEMPOOL_ELT_SIZE, TEST_CACHE_SIZE, 0,
+				NULL, NULL, NULL, NULL, SOCKET_ID_ANY, 0);
+	RTE_TEST_ASSERT_NOT_NULL(mp, "Cannot create mempool: %s",
+				 rte_strerror(rte_errno));
+	put_cache = rte_mempool_default_cache(mp, put_lcore);
+	get_cache = rte_mempool_default_cache(mp, get_lcore);
+
+	ret = rte_mempool_cache_adaptive_set(mp, 1);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot enable adaptive cache");
+
+	ret = test_mempool_cache_produce(mp, put_cache, 32);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get objects");
+	ret = rte_mempool_cache_stats_get(mp, put_lcore, &stats);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get cache stats");
+	RTE_TEST_ASSERT(stats.resizes > 0 && stats.size < TEST_CACHE_SIZE,
+			"Producer cache not shrunk (size %u)", stats.size);
+	RTE_TEST_ASSERT(stats.flush_objs > 0 && stats.refill_objs == 0,
+			"Unexpected producer cache counters");
+
+	ret = test_mempool_cache_consume(mp, get_cache, 32);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get objects");
+	ret = rte_mempool_cache_stats_get(mp, get_lcore, &stats);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get cache stats");
+	RTE_TEST_ASSERT(stats.resizes > 0 && stats.size > TEST_CACHE_SIZE,
+			"Consumer cache not grown (size %u)", stats.size);
+
+	ret = rte_mempool_cache_adaptive_set(mp, 0);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot disable adaptive cache");
+	RTE_TEST_ASSERT(put_cache->size == TEST_CACHE_SIZE &&
+			get_cache->size == TEST_CACHE_SIZE,
+			"Cache size not restored");
+
+	rte_mempool_cache_flush(put_cache, mp);
+	rte_mempool_cache_flush(get_cache, mp);
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), mp->size,
+			      "Objects lost by adaptive caches");
+	ret = TEST_SUCCESS;
+
+exit:
+	rte_mempool_free(mp);
+	return ret;
+}
+
+static int
+test_mempool_cache_handoff(void)
+{
+	unsigned int put_lcore = rte_lcore_id();
+	unsigned int get_lcore = (put_lcore + 1) % RTE_MAX_LCORE;
+	unsigned int other_lcore = (put_lcore + 2) % RTE_MAX_LCORE;
+	struct rte_mempool_cache *put_cache, *get_cache;
+	struct rte_mempool_cache_stats stats;
+	struct rte_mempool *mp;
+	int ret;
+
+	mp = rte_mempool_create("test_cache_handoff", MEMPOOL_SIZE,
+				MEMPOOL_ELT_SIZE, TEST_CACHE_SIZE, 0,
+				NULL, NULL, NULL, NULL, SOCKET_ID_ANY, 0);
+	RTE_TEST_ASSERT_NOT_NULL(mp, "Cannot create mempool: %s",
+				 rte_strerror(rte_errno));
+	put_cache = rte_mempool_default_cache(mp, put_lcore);
+	get_cache = rte_mempool_default_cache(mp, get_lcore);
+
+	ret = rte_mempool_cache_handoff_add(mp, put_lcore, put_lcore);
+	RTE_TEST_ASSERT_EQUAL(ret, -EINVAL, "Handoff to itself accepted");
+	ret = rte_mempool_cache_handoff_add(mp, put_lcore, get_lcore);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot add handoff");
+	ret = rte_mempool_cache_handoff_add(mp, put_lcore, other_lcore);
+	RTE_TEST_ASSERT_EQUAL(ret, -EBUSY, "Handoff added twice");
+
+	/* freed objects go to the handoff ring, still counted as available */
+	ret = test_mempool_cache_produce(mp, put_cache, 8);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get objects");
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), mp->size,
+			      "Objects in handoff ring not available");
+	ret = rte_mempool_cache_stats_get(mp, put_lcore, &stats);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get cache stats");
+	RTE_TEST_ASSERT(stats.handoff_objs > 0, "No object handed off");
+
+	/* and are allocated from it on the other lcore */
+	ret = test_mempool_cache_consume(mp, get_cache, 1);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get objects");
+	ret = rte_mempool_cache_stats_get(mp, get_lcore, &stats);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get cache stats");
+	RTE_TEST_ASSERT(stats.handoff_objs > 0, "No object taken over");
+
+	ret = rte_mempool_cache_handoff_del(mp, put_lcore);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot remove handoff");
+	ret = rte_mempool_cache_handoff_del(mp, put_lcore);
+	RTE_TEST_ASSERT_EQUAL(ret, -ENOENT, "Handoff removed twice");
+
+	rte_mempool_cache_flush(put_cache, mp);
+	rte_mempool_cache_flush(get_cache, mp);
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), mp->size,
+			      "Objects lost by handoff");
+	ret = TEST_SUCCESS;
+
+exit:
+	rte_mempool_free(mp);
+	return ret;
+}
+
+#define TEST_ELASTIC_CHUNK 64
+
+struct test_mempool_elastic_data {
+	unsigned int init_count;
+	unsigned int chunk_add;
+	unsigned int chunk_del;
+	bool refuse;
+};
+
+static void
+test_mempool_elastic_obj_init(__rte_unused struct rte_mempool *mp,
+			      void *arg, __rte_unused void *obj,
+			      __rte_unused unsigned int idx)
+{
+	struct test_mempool_elastic_data *data = arg;
+
+	data->init_count++;
+}
+
+static int
+test_mempool_elastic_event_cb(enum rte_mempool_event event,
+			      __rte_unused struct rte_mempool *mp,
+			      void *user_data)
+{
+	struct test_mempool_elastic_data *data = user_data;
+
+	if (event == RTE_MEMPOOL_EVENT_CHUNK_ADD) {
+		data->chunk_add++;
+		if (data->refuse)
+			return -EPERM;
+	} else if (event == RTE_MEMPOOL_EVENT_CHUNK_DEL) {
+		data->chunk_del++;
+	}
+	return 0;
+}
+
+static int
+test_mempool_elastic(void)
+{
+	struct test_mempool_elastic_data data;
+	void *objs[TEST_ELASTIC_CHUNK * 2];
+	struct rte_mempool *mp;
+	int ret;
+
+	memset(&data, 0, sizeof(data));
+	mp = rte_mempool_create_empty("test_elastic", TEST_ELASTIC_CHUNK * 4,
+				      MEMPOOL_ELT_SIZE, 0, 0,
+				      SOCKET_ID_ANY, 0);
+	RTE_TEST_ASSERT_NOT_NULL(mp, "Cannot create mempool: %s",
+				 rte_strerror(rte_errno));
+	ret = rte_mempool_event_callback_register(test_mempool_elastic_event_cb,
+						  &data);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot register event callback");
+
+	ret = rte_mempool_populate_elastic(mp, 0,
+					   test_mempool_elastic_obj_init,
+					   &data);
+	RTE_TEST_ASSERT_EQUAL(ret, -EINVAL, "Empty chunks accepted");
+	ret = rte_mempool_populate_elastic(mp, TEST_ELASTIC_CHUNK,
+					   test_mempool_elastic_obj_init,
+					   &data);
+	RTE_TEST_ASSERT_EQUAL(ret, TEST_ELASTIC_CHUNK,
+			      "Cannot populate elastic mempool: %s",
+			      rte_strerror(-ret));
+	RTE_TEST_ASSERT_EQUAL(data.init_count, TEST_ELASTIC_CHUNK,
+			      "Objects not initialized");
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), TEST_ELASTIC_CHUNK,
+			      "Unpopulated objects reported available");
+
+	/* gets never grow the pool */
+	ret = rte_mempool_get_bulk(mp, objs, TEST_ELASTIC_CHUNK);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get objects");
+	RTE_TEST_ASSERT(rte_mempool_get(mp, &objs[TEST_ELASTIC_CHUNK]) < 0,
+			"Mempool grown by a get");
+	RTE_TEST_ASSERT_EQUAL(mp->populated_size, TEST_ELASTIC_CHUNK,
+			      "Mempool grown by a get");
+
+	ret = rte_mempool_elastic_grow(mp, 1);
+	RTE_TEST_ASSERT_EQUAL(ret, TEST_ELASTIC_CHUNK,
+			      "Cannot grow mempool: %s", rte_strerror(-ret));
+	RTE_TEST_ASSERT_EQUAL(mp->populated_size, TEST_ELASTIC_CHUNK * 2,
+			      "Mempool not grown");
+	RTE_TEST_ASSERT_EQUAL(data.init_count, TEST_ELASTIC_CHUNK * 2,
+			      "New objects not initialized");
+	RTE_TEST_ASSERT_EQUAL(data.chunk_add, 1, "Chunk add not reported");
+	ret = rte_mempool_elastic_grow(mp, 1);
+	RTE_TEST_ASSERT_EQUAL(ret, 0, "Mempool grown with objects available");
+	ret = rte_mempool_get(mp, &objs[TEST_ELASTIC_CHUNK]);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get object from new chunk");
+
+	/* the new chunk is in use */
+	ret = rte_mempool_elastic_shrink(mp, UINT_MAX);
+	RTE_TEST_ASSERT_EQUAL(ret, 0, "Chunk in use released");
+
+	rte_mempool_put_bulk(mp, objs, TEST_ELASTIC_CHUNK + 1);
+	ret = rte_mempool_elastic_shrink(mp, 0);
+	RTE_TEST_ASSERT_EQUAL(ret, 0, "Chunk released above the bound");
+	ret = rte_mempool_elastic_shrink(mp, 1);
+	RTE_TEST_ASSERT_EQUAL(ret, TEST_ELASTIC_CHUNK,
+			      "Idle chunk not released");
+	RTE_TEST_ASSERT_EQUAL(data.chunk_del, 1, "Chunk del not reported");
+	RTE_TEST_ASSERT_EQUAL(mp->populated_size, TEST_ELASTIC_CHUNK,
+			      "Mempool not shrunk");
+	RTE_TEST_ASSERT_EQUAL(mp->nb_mem_chunks, 1, "First chunk released");
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_ops_get_count(mp),
+			      TEST_ELASTIC_CHUNK, "Objects lost by shrink");
+
+	/* a refused chunk is freed and its objects never show up */
+	data.refuse = true;
+	ret = rte_mempool_elastic_grow(mp, TEST_ELASTIC_CHUNK * 2);
+	RTE_TEST_ASSERT_EQUAL(ret, -EPERM, "Refused chunk added");
+	RTE_TEST_ASSERT_EQUAL(data.chunk_del, 2, "Refused chunk not deleted");
+	RTE_TEST_ASSERT_EQUAL(mp->populated_size, TEST_ELASTIC_CHUNK,
+			      "Mempool grown by a refused chunk");
+	RTE_TEST_ASSERT_EQUAL(mp->nb_mem_chunks, 1, "Refused chunk kept");
+	data.refuse = false;
+
+	/* the pool cannot grow above its size */
+	ret = rte_mempool_elastic_grow(mp, mp->size + 1);
+	RTE_TEST_ASSERT_EQUAL(ret, TEST_ELASTIC_CHUNK * 3,
+			      "Cannot grow mempool to its size");
+	RTE_TEST_ASSERT_EQUAL(mp->populated_size, mp->size,
+			      "Mempool not grown to its size");
+	ret = rte_mempool_elastic_grow(mp, mp->size + 1);
+	RTE_TEST_ASSERT_EQUAL(ret, -ENOSPC, "Mempool grown above its size");
+	ret = TEST_SUCCESS;
+
+exit:
+	rte_mempool_event_callback_unregister(test_mempool_elastic_event_cb,
+					      &data);
+	rte_mempool_free(mp);
+	return ret;
+}
+
+static void
+test_mempool_numa_obj_count(__rte_unused struct rte_mempool *mp, void *arg,
+			    void *obj, __rte_unused unsigned int idx)
+{
+	const struct rte_memseg_list *msl = rte_mem_virt2memseg_list(obj);
+	unsigned int *count = arg;
+
+	if (msl != NULL)
+		count[msl->socket_id]++;
+}
+
+/* check objects are spread over sockets and taken from the local one first */
+static int
+test_mempool_numa(struct rte_mempool *mp)
+{
+	unsigned int count[RTE_MAX_NUMA_NODES] = { 0 };
+	const struct rte_memseg_list *msl;
+	int socket_id = rte_socket_id();
+	unsigned int i, total = 0;
+	void **objs = NULL;
+	int ret;
+
+	rte_mempool_obj_iter(mp, test_mempool_numa_obj_count, count);
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
+		total += count[i];
+	RTE_TEST_ASSERT_EQUAL(total, mp->size, "Objects of unknown socket");
+	RTE_TEST_ASSERT(count[socket_id] >= mp->size / rte_socket_count(),
+			"Socket %d has %u objects of %u", socket_id,
+			count[socket_id], mp->size);
+
+	objs = malloc(mp->size * sizeof(void *));
+	RTE_TEST_ASSERT_NOT_NULL(objs, "Cannot allocate object table");
+	rte_mempool_cache_flush(rte_mempool_default_cache(mp, rte_lcore_id()),
+				mp);
+
+	/* all objects are available, the local ones come first */
+	ret = rte_mempool_generic_get(mp, objs, mp->size, NULL);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get all objects");
+	for (i = 0; i < mp->size; i++) {
+		msl = rte_mem_virt2memseg_list(objs[i]);
+		if ((msl->socket_id == socket_id) != (i < count[socket_id]))
+			break;
+	}
+	rte_mempool_generic_put(mp, objs, mp->size, NULL);
+	RTE_TEST_ASSERT_EQUAL(i, mp->size, "Object %u taken from socket %d",
+			      i, msl->socket_id);
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), mp->size,
+			      "Objects lost in the pool");
+	ret = TEST_SUCCESS;
+
+exit:
+	free(objs);
+	return ret;
+}
+
+static int
+test_mempool_track(void)
+{
+	struct rte_mempool_track_event ev;
+	const void *put_caller;
+	struct rte_mempool *mp;
+	void *objs[4];
+	int ret;
+
+	mp = rte_mempool_create("test_track", MEMPOOL_SIZE, MEMPOOL_ELT_SIZE,
+				TEST_CACHE_SIZE, 0, NULL, NULL, NULL, NULL,
+				SOCKET_ID_ANY, 0);
+	RTE_TEST_ASSERT_NOT_NULL(mp, "Cannot create mempool: %s",
+				 rte_strerror(rte_errno));
+
+	ret = rte_mempool_track_obj_last(mp, mp, &ev);
+	RTE_TEST_ASSERT_EQUAL(ret, -EINVAL, "Tracking not enabled");
+	ret = rte_mempool_track_enable(mp, 0);
+	RTE_TEST_ASSERT_EQUAL(ret, -EINVAL, "Empty ring buffers accepted");
+	ret = rte_mempool_track_enable(mp, 100);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot enable tracking");
+
+	rte_mempool_track_owner_set(42);
+	ret = rte_mempool_get_bulk(mp, objs, RTE_DIM(objs));
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot get objects");
+	rte_mempool_put(mp, objs[0]);
+
+	ret = rte_mempool_track_obj_last(mp, objs[0], &ev);
+	RTE_TEST_ASSERT_SUCCESS(ret, "No event of a put object");
+	RTE_TEST_ASSERT_EQUAL(ev.op, RTE_MEMPOOL_TRACK_PUT, "Put not recorded");
+	put_caller = ev.caller;
+	ret = rte_mempool_track_obj_last(mp, objs[1], &ev);
+	RTE_TEST_ASSERT_SUCCESS(ret, "No event of a held object");
+	RTE_TEST_ASSERT_EQUAL(ev.op, RTE_MEMPOOL_TRACK_GET, "Get not recorded");
+	RTE_TEST_ASSERT_EQUAL(ev.owner, 42, "Wrong owner");
+	RTE_TEST_ASSERT(ev.caller != NULL, "No caller");
+	/* the get and the put are called from different places */
+	RTE_TEST_ASSERT(ev.caller != put_caller, "Caller is not the call site");
+	ret = rte_mempool_track_dump(stdout, mp);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot dump held objects");
+
+	/* events are not recorded while disabled */
+	rte_mempool_track_disable(mp);
+	rte_mempool_put(mp, objs[1]);
+	ret = rte_mempool_track_obj_last(mp, objs[1], &ev);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Events lost by disable");
+	RTE_TEST_ASSERT_EQUAL(ev.op, RTE_MEMPOOL_TRACK_GET,
+			      "Put recorded while disabled");
+
+	ret = rte_mempool_track_enable(mp, 100);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Cannot enable tracking again");
+	rte_mempool_put_bulk(mp, &objs[2], 2);
+	ret = rte_mempool_track_obj_last(mp, objs[3], &ev);
+	RTE_TEST_ASSERT_SUCCESS(ret, "No event of a put object");
+	RTE_TEST_ASSERT_EQUAL(ev.op, RTE_MEMPOOL_TRACK_PUT, "Put not recorded");
+	rte_mempool_track_owner_set(0);
+	ret = TEST_SUCCESS;
+
+exit:
+	rte_mempool_free(mp);
+	return ret;
+}
+
 #pragma pop_macro("RTE_TEST_TRACE_FAILURE")
 
 static int
@@ -848,6 +1251,7 @@ test_mempool(void)
 	struct rte_mempool *mp_stack_anon = NULL;
 	struct rte_mempool *mp_stack_mempool_iter = NULL;
 	struct rte_mempool *mp_stack = NULL;
+	struct rte_mempool *mp_numa = NULL;
 	struct rte_mempool *default_pool = NULL;
 	struct mp_data cb_arg = {
 		.ret = -1
@@ -944,6 +1348,27 @@ test_mempool(void)
 	}
 	rte_mempool_obj_iter(mp_stack, my_obj_init, NULL);
 
+	/* create a mempool spread over NUMA sockets */
+	mp_numa = rte_mempool_create_empty("test_numa",
+		MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE,
+		RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		SOCKET_ID_ANY, 0);
+
+	if (mp_numa == NULL) {
+		printf("cannot allocate mp_numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_set_ops_byname(mp_numa, "numa", NULL) < 0) {
+		printf("cannot set numa handler\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_populate_default(mp_numa) < 0) {
+		printf("cannot populate mp_numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	rte_mempool_obj_iter(mp_numa, my_obj_init, NULL);
+
 	/* Create a mempool based on Default handler */
 	printf("Testing %s mempool handler\n", default_pool_ops);
 	default_pool = rte_mempool_create_empty("default_pool",
@@ -1011,6 +1436,12 @@ test_mempool(void)
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		GOTO_ERR(ret, err);
 
+	/* test the NUMA mempool handler */
+	if (test_mempool_basic(mp_numa, 1) < 0)
+		GOTO_ERR(ret, err);
+	if (test_mempool_numa(mp_numa) < 0)
+		GOTO_ERR(ret, err);
+
 	if (test_mempool_basic(default_pool, 1) < 0)
 		GOTO_ERR(ret, err);
 
@@ -1028,6 +1459,20 @@ test_mempool(void)
 	if (test_mempool_flag_non_io_unset_when_populated_with_valid_iova() < 0)
 		GOTO_ERR(ret, err);
 
+	/* test adaptive cache sizing and cache handoff */
+	if (test_mempool_cache_adaptive() < 0)
+		GOTO_ERR(ret, err);
+	if (test_mempool_cache_handoff() < 0)
+		GOTO_ERR(ret, err);
+
+	/* test elastic mempool grow and shrink */
+	if (test_mempool_elastic() < 0)
+		GOTO_ERR(ret, err);
+
+	/* test object ownership tracking */
+	if (test_mempool_track() < 0)
+		GOTO_ERR(ret, err);
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -1038,6 +1483,7 @@ test_mempool(void)
 	rte_mempool_free(mp_stack_anon);
 	rte_mempool_free(mp_stack_mempool_iter);
 	rte_mempool_free(mp_stack);
+	rte_mempool_free(mp_numa);
 	rte_mempool_free(default_pool);
 
 	return ret;
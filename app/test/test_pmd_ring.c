@@ -9,11 +9,16 @@
 #include <rte_eth_ring.h>
 #include <rte_ethdev.h>
 #include <rte_bus_vdev.h>
+#include <rte_ip.h>
+#include <rte_udp.h>
 
 #define SOCKET0 0
 #define RING_SIZE 256
 #define NUM_RINGS 2
 #define NB_MBUF 512
+#define NUM_DIST_RINGS 4
+#define NUM_DIST_FLOWS 16
+#define NUM_DIST_PKTS_PER_FLOW 4
 
 static struct rte_mempool *mp;
 struct rte_ring *rxtx[NUM_RINGS];
@@ -571,6 +576,238 @@ test_stats_reset_for_port(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_pmd_ring_rx_zc(void)
+{
+	struct rte_mbuf bufs[RING_SIZE / 2];
+	struct rte_mbuf *pbufs[RING_SIZE / 2];
+	struct rte_ring_zc_data zcd;
+	struct rte_eth_conf null_conf;
+	struct rte_eth_stats stats;
+	struct rte_ring *ring;
+	struct rte_mbuf **ptrs;
+	int port, n, i;
+
+	printf("Testing zero-copy receive\n");
+
+	ring = rte_ring_create("RZC", RING_SIZE, SOCKET0,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT_NOT_NULL(ring, "rte_ring_create RZC failed");
+
+	port = rte_eth_from_rings("net_ringzc", &ring, 1, &ring, 1, SOCKET0);
+	TEST_ASSERT(port >= 0, "rte_eth_from_rings net_ringzc failed");
+	memset(&null_conf, 0, sizeof(null_conf));
+	TEST_ASSERT_SUCCESS(rte_eth_dev_configure(port, 1, 1, &null_conf),
+			"Configure failed for port %d", port);
+	TEST_ASSERT_SUCCESS(rte_eth_tx_queue_setup(port, 0, RING_SIZE,
+			SOCKET0, NULL), "TX queue setup failed");
+	TEST_ASSERT_SUCCESS(rte_eth_rx_queue_setup(port, 0, RING_SIZE,
+			SOCKET0, NULL, mp), "RX queue setup failed");
+	TEST_ASSERT_SUCCESS(rte_eth_dev_start(port), "Failed to start port");
+
+	for (i = 0; i < RING_SIZE / 2; i++)
+		pbufs[i] = &bufs[i];
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(port, 0, pbufs, RING_SIZE / 2),
+			RING_SIZE / 2, "Failed to transmit packet burst");
+
+	n = rte_eth_ring_rx_zc_burst_start(port, 0, RING_SIZE, &zcd);
+	TEST_ASSERT_EQUAL(n, RING_SIZE / 2, "Unexpected zero-copy burst %d", n);
+	TEST_ASSERT_EQUAL(zcd.n1, (unsigned int)n,
+			"Unexpected wrap-around in a fresh ring");
+
+	/* The mbuf pointers are read in place in the ring */
+	ptrs = zcd.ptr1;
+	for (i = 0; i < n; i++)
+		TEST_ASSERT(ptrs[i] == &bufs[i],
+				"Received data does not match that transmitted");
+
+	TEST_ASSERT_SUCCESS(rte_eth_ring_rx_zc_finish(port, 0, n),
+			"Failed to finish zero-copy receive");
+	TEST_ASSERT_EQUAL(rte_eth_rx_burst(port, 0, pbufs, RING_SIZE / 2), 0,
+			"Packets left in the ring");
+
+	rte_eth_stats_get(port, &stats);
+	TEST_ASSERT_EQUAL(stats.ipackets, (uint64_t)n,
+			"Unexpected Rx packets stats");
+
+	TEST_ASSERT_EQUAL(rte_eth_ring_rx_zc_burst_start(RTE_MAX_ETHPORTS, 0,
+			RING_SIZE, &zcd), -ENODEV, "Invalid port accepted");
+	TEST_ASSERT_EQUAL(rte_eth_ring_rx_zc_burst_start(port, 1,
+			RING_SIZE, &zcd), -EINVAL, "Invalid queue accepted");
+
+	TEST_ASSERT_SUCCESS(rte_eth_dev_stop(port), "Failed to stop port");
+	rte_vdev_uninit("net_ring_net_ringzc");
+	rte_ring_free(ring);
+
+	return TEST_SUCCESS;
+}
+
+static struct rte_mbuf *
+test_ring_udp_packet(uint16_t flow)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip;
+	struct rte_udp_hdr *udp;
+	struct rte_mbuf *m;
+
+	m = rte_pktmbuf_alloc(mp);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+			sizeof(*eth) + sizeof(*ip) + sizeof(*udp));
+	memset(eth, 0, sizeof(*eth) + sizeof(*ip) + sizeof(*udp));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + sizeof(*udp));
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 2));
+
+	udp = (struct rte_udp_hdr *)(ip + 1);
+	udp->src_port = rte_cpu_to_be_16(1024 + flow);
+	udp->dst_port = rte_cpu_to_be_16(4789);
+	udp->dgram_len = rte_cpu_to_be_16(sizeof(*udp));
+
+	return m;
+}
+
+static bool
+test_ring_mbuf_find(struct rte_mbuf **bufs, unsigned int n,
+		const struct rte_mbuf *m)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		if (bufs[i] == m)
+			return true;
+	return false;
+}
+
+static int
+test_pmd_ring_tx_distribute(void)
+{
+	struct rte_mbuf *pkts[NUM_DIST_FLOWS * NUM_DIST_PKTS_PER_FLOW];
+	struct rte_mbuf *sent[NUM_DIST_FLOWS * NUM_DIST_PKTS_PER_FLOW];
+	struct rte_ring *rings[NUM_DIST_RINGS];
+	int flow_ring[NUM_DIST_FLOWS];
+	struct rte_eth_conf null_conf;
+	char ring_name[RTE_RING_NAMESIZE];
+	const struct rte_udp_hdr *udp;
+	unsigned int nb_pkts = RTE_DIM(pkts);
+	unsigned int nb_rx = 0, nb_used = 0;
+	uint16_t flow;
+	int port, q, n, i;
+
+	printf("Testing Tx distribution over rings\n");
+
+	memset(&null_conf, 0, sizeof(null_conf));
+	for (i = 0; i < NUM_DIST_FLOWS; i++)
+		flow_ring[i] = -1;
+
+	for (i = 0; i < NUM_DIST_RINGS; i++) {
+		snprintf(ring_name, sizeof(ring_name), "RDIST%d", i);
+		rings[i] = rte_ring_create(ring_name, RING_SIZE, SOCKET0,
+				RING_F_SP_ENQ | RING_F_SC_DEQ);
+		TEST_ASSERT_NOT_NULL(rings[i], "rte_ring_create %s failed",
+				ring_name);
+	}
+
+	port = rte_eth_from_rings("net_ringdist", rings, NUM_DIST_RINGS,
+			rings, NUM_DIST_RINGS, SOCKET0);
+	TEST_ASSERT(port >= 0, "rte_eth_from_rings net_ringdist failed");
+
+	TEST_ASSERT_SUCCESS(rte_eth_ring_tx_distribute_set(port, 1),
+			"Failed to enable Tx distribution");
+
+	/* Single-producer rings cannot be shared by several Tx queues */
+	TEST_ASSERT(rte_eth_dev_configure(port, NUM_DIST_RINGS, 2,
+			&null_conf) < 0, "Configured 2 Tx queues on SP rings");
+
+	TEST_ASSERT_SUCCESS(rte_eth_dev_configure(port, NUM_DIST_RINGS, 1,
+			&null_conf), "Configure failed for port %d", port);
+	TEST_ASSERT_SUCCESS(rte_eth_tx_queue_setup(port, 0, RING_SIZE,
+			SOCKET0, NULL), "TX queue setup failed");
+	for (q = 0; q < NUM_DIST_RINGS; q++)
+		TEST_ASSERT_SUCCESS(rte_eth_rx_queue_setup(port, q, RING_SIZE,
+				SOCKET0, NULL, mp), "RX queue setup failed");
+	TEST_ASSERT_SUCCESS(rte_eth_dev_start(port), "Failed to start port");
+
+	for (i = 0; i < (int)nb_pkts; i++) {
+		pkts[i] = test_ring_udp_packet(i % NUM_DIST_FLOWS);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Failed to allocate packet");
+	}
+
+	TEST_ASSERT_EQUAL(rte_eth_tx_burst(port, 0, pkts, nb_pkts), nb_pkts,
+			"Failed to transmit packet burst");
+
+	/* All the packets of a flow must be received from the same ring */
+	for (q = 0; q < NUM_DIST_RINGS; q++) {
+		n = rte_eth_rx_burst(port, q, pkts, nb_pkts);
+		for (i = 0; i < n; i++) {
+			udp = rte_pktmbuf_mtod_offset(pkts[i],
+					const struct rte_udp_hdr *,
+					sizeof(struct rte_ether_hdr) +
+					sizeof(struct rte_ipv4_hdr));
+			flow = rte_be_to_cpu_16(udp->src_port) - 1024;
+			TEST_ASSERT(flow < NUM_DIST_FLOWS, "Unexpected flow %u",
+					flow);
+			TEST_ASSERT(flow_ring[flow] == -1 ||
+					flow_ring[flow] == q,
+					"Flow %u spread over several rings", flow);
+			flow_ring[flow] = q;
+		}
+		rte_pktmbuf_free_bulk(pkts, n);
+		nb_rx += n;
+		if (n != 0)
+			nb_used++;
+	}
+	TEST_ASSERT_EQUAL(nb_rx, nb_pkts, "Received %u packets, expected %u",
+			nb_rx, nb_pkts);
+	TEST_ASSERT(nb_used >= 2, "Flows sent to %u ring(s) only", nb_used);
+
+	/* The packets for a full ring are not sent and moved at the end */
+	for (i = rte_ring_free_count(rings[0]); i > 0; i--)
+		rte_ring_enqueue(rings[0], rings[0]);
+	for (i = 0; i < (int)nb_pkts; i++) {
+		pkts[i] = test_ring_udp_packet(i % NUM_DIST_FLOWS);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Failed to allocate packet");
+	}
+	memcpy(sent, pkts, sizeof(pkts));
+
+	n = rte_eth_tx_burst(port, 0, pkts, nb_pkts);
+	TEST_ASSERT(n > 0 && n < (int)nb_pkts,
+			"Sent %d packets with a full ring, out of %u", n, nb_pkts);
+	for (i = 0; i < (int)nb_pkts; i++)
+		TEST_ASSERT(test_ring_mbuf_find(pkts, nb_pkts, sent[i]),
+				"Packet %d lost by Tx", i);
+
+	/* The first packets are those sent, to the rings not full */
+	nb_rx = 0;
+	for (q = 1; q < NUM_DIST_RINGS; q++)
+		nb_rx += rte_eth_rx_burst(port, q, &sent[nb_rx],
+				nb_pkts - nb_rx);
+	TEST_ASSERT_EQUAL(nb_rx, (unsigned int)n,
+			"Received %u packets, %d sent", nb_rx, n);
+	for (i = 0; i < n; i++)
+		TEST_ASSERT(test_ring_mbuf_find(sent, n, pkts[i]),
+				"Sent packet %d not received", i);
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+	rte_ring_reset(rings[0]);
+
+	TEST_ASSERT_SUCCESS(rte_eth_dev_stop(port), "Failed to stop port");
+	TEST_ASSERT_SUCCESS(rte_eth_ring_tx_distribute_set(port, 0),
+			"Failed to disable Tx distribution");
+	rte_vdev_uninit("net_ring_net_ringdist");
+	for (i = 0; i < NUM_DIST_RINGS; i++)
+		rte_ring_free(rings[i]);
+
+	return TEST_SUCCESS;
+}
+
 static struct
 unit_test_suite test_pmd_ring_suite  = {
 	.setup = test_pmd_ringcreate_setup,
@@ -583,6 +820,8 @@ unit_test_suite test_pmd_ring_suite  = {
 		TEST_CASE(test_stats_reset_for_port),
 		TEST_CASE(test_pmd_ring_pair_create_attach),
 		TEST_CASE(test_command_line_ring_port),
+		TEST_CASE(test_pmd_ring_rx_zc),
+		TEST_CASE(test_pmd_ring_tx_distribute),
 		TEST_CASES_END()
 	}
 };
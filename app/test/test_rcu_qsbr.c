@@ -927,6 +927,170 @@ test_rcu_qsbr_dq_functional(int32_t size, int32_t esize, uint32_t flags)
 	return -1;
 }
 
+/*
+ * rte_rcu_qsbr_check: Check the quiescent state of readers of several
+ * thread groups, the groups whose readers acknowledged the token being
+ * skipped by the next checks.
+ */
+static int
+test_rcu_qsbr_check_groups(void)
+{
+	unsigned int last = RTE_MAX_LCORE - 1;
+	uint64_t token;
+	int ret;
+
+	printf("\nTest rte_rcu_qsbr_check() with thread groups\n");
+
+	rte_rcu_qsbr_init(t[0], RTE_MAX_LCORE);
+
+	rte_rcu_qsbr_thread_register(t[0], 0);
+	rte_rcu_qsbr_thread_register(t[0], last);
+	rte_rcu_qsbr_thread_online(t[0], 0);
+	rte_rcu_qsbr_thread_online(t[0], last);
+
+	token = rte_rcu_qsbr_start(t[0]);
+
+	/* Only the first thread reports its quiescent state */
+	rte_rcu_qsbr_quiescent(t[0], 0);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "group of last thread");
+
+	/* All the threads reported their quiescent state */
+	rte_rcu_qsbr_quiescent(t[0], last);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1), "all the groups");
+
+	/* New token, the groups are checked again */
+	token = rte_rcu_qsbr_start(t[0]);
+	rte_rcu_qsbr_quiescent(t[0], last);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "group of first thread");
+
+	/* An offline thread does not hold its group */
+	rte_rcu_qsbr_thread_offline(t[0], 0);
+	ret = rte_rcu_qsbr_check(t[0], token, false);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1), "offline thread");
+
+	rte_rcu_qsbr_thread_offline(t[0], last);
+	rte_rcu_qsbr_thread_unregister(t[0], 0);
+	rte_rcu_qsbr_thread_unregister(t[0], last);
+
+	return 0;
+}
+
+static uint32_t batch_freed;
+
+static void
+test_rcu_qsbr_free_resource_batch(void *p, void *e, unsigned int n)
+{
+	uint64_t *v = e;
+	unsigned int i;
+
+	/* The resources are consecutive values, 2 per resource */
+	for (i = 0; i < n * 2; i++) {
+		if (p != NULL || v[i] != batch_freed * 2 + i) {
+			printf("%s: Test failed\n", __func__);
+			cb_failed = 1;
+			return;
+		}
+	}
+	batch_freed += n;
+}
+
+/*
+ * rte_rcu_qsbr_dq_reclaim: Reclaim resources in batches, and check the
+ * statistics of the defer queue.
+ */
+static int
+test_rcu_qsbr_dq_batch(void)
+{
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+	struct rte_rcu_qsbr_dq_parameters params;
+	struct rte_rcu_qsbr_dq_stats stats;
+	struct rte_rcu_qsbr_dq *dq;
+	unsigned int freed, pending;
+	uint64_t e[2];
+	int i, ret;
+
+	printf("\nTest rte_rcu_qsbr_dq_reclaim() in batches and statistics\n");
+
+	rte_rcu_qsbr_init(t[0], RTE_MAX_LCORE);
+	batch_freed = 0;
+	cb_failed = 0;
+
+	memset(&params, 0, sizeof(struct rte_rcu_qsbr_dq_parameters));
+	snprintf(rcu_dq_name, sizeof(rcu_dq_name), "TEST_RCU");
+	params.name = rcu_dq_name;
+	params.flags = RTE_RCU_QSBR_DQ_RECLAIM_BATCH;
+	params.free_fn = test_rcu_qsbr_free_resource_batch;
+	params.v = t[0];
+	params.size = 64;
+	params.esize = sizeof(e);
+	/* No automatic reclamation */
+	params.trigger_reclaim_limit = params.size + 1;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq == NULL), "dq create valid params");
+
+	rte_rcu_qsbr_thread_register(t[0], 1);
+	rte_rcu_qsbr_thread_online(t[0], 1);
+
+	for (i = 0; i < 40; i++) {
+		e[0] = i * 2;
+		e[1] = i * 2 + 1;
+		ret = rte_rcu_qsbr_dq_enqueue(dq, e);
+		TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret != 0), "dq enqueue");
+	}
+
+	/* The grace period is not over */
+	ret = rte_rcu_qsbr_dq_reclaim(dq, ~0, &freed, &pending, NULL);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret != 0 || freed != 0 ||
+		pending != 40), "dq reclaim before grace period");
+
+	/* Reclaim all the resources, in 2 batches */
+	rte_rcu_qsbr_quiescent(t[0], 1);
+	ret = rte_rcu_qsbr_dq_reclaim(dq, ~0, &freed, &pending, NULL);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret != 0 || freed != 40 ||
+		pending != 0), "dq reclaim after grace period");
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (cb_failed == 1 || batch_freed != 40),
+		"CB failed");
+
+	ret = rte_rcu_qsbr_dq_stats_get(dq, &stats);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret != 0), "dq stats get");
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (stats.enqueued != 40 ||
+		stats.enqueue_fails != 0 || stats.reclaimed != 40 ||
+		stats.free_calls != 2 || stats.max_pending != 40),
+		"dq stats");
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end,
+		(stats.latency_cycles_max > stats.latency_cycles_total),
+		"dq latency stats");
+
+	ret = rte_rcu_qsbr_dq_stats_reset(dq);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret != 0), "dq stats reset");
+	rte_rcu_qsbr_dq_stats_get(dq, &stats);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (stats.enqueued != 0 ||
+		stats.reclaimed != 0 || stats.latency_cycles_max != 0),
+		"dq stats after reset");
+
+	ret = rte_rcu_qsbr_dq_stats_get(NULL, &stats);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret == 0), "dq stats get NULL dq");
+	ret = rte_rcu_qsbr_dq_stats_get(dq, NULL);
+	TEST_RCU_QSBR_GOTO_IF_ERROR(end, (ret == 0), "dq stats get NULL stats");
+
+	rte_rcu_qsbr_thread_offline(t[0], 1);
+	rte_rcu_qsbr_thread_unregister(t[0], 1);
+
+	ret = rte_rcu_qsbr_dq_delete(dq);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "dq delete valid params");
+
+	return 0;
+
+end:
+	rte_rcu_qsbr_thread_offline(t[0], 1);
+	rte_rcu_qsbr_thread_unregister(t[0], 1);
+	rte_rcu_qsbr_dq_delete(dq);
+	return -1;
+}
+
 /*
  * rte_rcu_qsbr_dump: Dump status of a single QS variable to a file
  */
@@ -1366,6 +1530,9 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_synchronize() < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_check_groups() < 0)
+		goto test_fail;
+
 	if (test_rcu_qsbr_dump() < 0)
 		goto test_fail;
 
@@ -1387,6 +1554,9 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_dq_enqueue() < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_dq_batch() < 0)
+		goto test_fail;
+
 	printf("\nFunctional tests\n");
 
 	if (test_rcu_qsbr_sw_sv_3qs() < 0)
@@ -0,0 +1,347 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_random.h>
+#include <rte_soring.h>
+
+#include "test.h"
+
+#define SORING_SIZE 64
+#define SORING_STAGES 2
+#define SORING_MT_BURST 8
+#define SORING_MT_NB_OBJS (1 << 18)
+
+static struct rte_soring *
+test_soring_create(uint32_t elems, uint32_t stages,
+		   enum rte_ring_sync_type synt)
+{
+	struct rte_soring_param prm = {
+		.name = "test_soring",
+		.elems = elems,
+		.elem_size = sizeof(uint32_t),
+		.stages = stages,
+		.prod_synt = synt,
+		.cons_synt = synt,
+	};
+	struct rte_soring *r;
+	ssize_t sz;
+
+	sz = rte_soring_get_memsize(&prm);
+	if (sz < 0)
+		return NULL;
+	r = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (r == NULL)
+		return NULL;
+	if (rte_soring_init(r, &prm) != 0) {
+		rte_free(r);
+		return NULL;
+	}
+	return r;
+}
+
+static int
+test_soring_param(void)
+{
+	struct rte_soring_param prm = {
+		.name = "test_soring",
+		.elems = SORING_SIZE,
+		.elem_size = sizeof(uint32_t),
+		.stages = 1,
+		.prod_synt = RTE_RING_SYNC_MT,
+		.cons_synt = RTE_RING_SYNC_ST,
+	};
+
+	TEST_ASSERT(rte_soring_get_memsize(&prm) > 0, "valid param refused");
+
+	prm.elem_size = 6;
+	TEST_ASSERT(rte_soring_get_memsize(&prm) < 0, "bad elem_size accepted");
+	prm.elem_size = sizeof(uint32_t);
+
+	prm.stages = 0;
+	TEST_ASSERT(rte_soring_get_memsize(&prm) < 0, "0 stages accepted");
+	prm.stages = RTE_SORING_STAGE_MAX + 1;
+	TEST_ASSERT(rte_soring_get_memsize(&prm) < 0, "too many stages accepted");
+	prm.stages = 1;
+
+	prm.elems = 0;
+	TEST_ASSERT(rte_soring_get_memsize(&prm) < 0, "0 elems accepted");
+	prm.elems = SORING_SIZE;
+
+	prm.prod_synt = RTE_RING_SYNC_MT_HTS;
+	TEST_ASSERT(rte_soring_get_memsize(&prm) < 0, "HTS sync accepted");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_soring_stages(void)
+{
+	uint32_t objs[SORING_SIZE], out[SORING_SIZE];
+	uint32_t ftoken[4], n, i;
+	struct rte_soring *r;
+	int ret = TEST_FAILED;
+
+	r = test_soring_create(SORING_SIZE, SORING_STAGES, RTE_RING_SYNC_MT);
+	TEST_ASSERT_NOT_NULL(r, "cannot create soring");
+
+	for (i = 0; i < RTE_DIM(objs); i++)
+		objs[i] = i;
+
+	if (rte_soring_enqueue_bulk(r, objs, SORING_SIZE + 1, NULL) != 0) {
+		printf("enqueue of more than the capacity succeeded\n");
+		goto out;
+	}
+	if (rte_soring_enqueue_bulk(r, objs, 32, NULL) != 32) {
+		printf("enqueue failed\n");
+		goto out;
+	}
+
+	/* Nothing to dequeue until the last stage releases. */
+	if (rte_soring_dequeue_burst(r, out, 32, NULL) != 0) {
+		printf("dequeue of elements not released succeeded\n");
+		goto out;
+	}
+	/* Nothing to acquire for a stage until the previous one releases. */
+	if (rte_soring_acquire_burst(r, NULL, 1, 32, &ftoken[0], NULL) != 0) {
+		printf("stage 1 acquired elements not released by stage 0\n");
+		goto out;
+	}
+
+	/* Acquire 4 ranges on stage 0 and release them out of order. */
+	for (i = 0; i < 4; i++) {
+		n = rte_soring_acquire_bulk(r, out, 0, 8, &ftoken[i], NULL);
+		if (n != 8 || out[0] != i * 8) {
+			printf("stage 0 acquire %u failed\n", i);
+			goto out;
+		}
+	}
+	rte_soring_release(r, NULL, 0, 8, ftoken[3]);
+	rte_soring_release(r, NULL, 0, 8, ftoken[1]);
+	if (rte_soring_acquire_burst(r, NULL, 1, 32, &ftoken[0], NULL) != 0) {
+		printf("stage 1 acquired elements before stage 0 order\n");
+		goto out;
+	}
+	rte_soring_release(r, NULL, 0, 8, ftoken[0]);
+	n = rte_soring_acquire_burst(r, out, 1, 32, &ftoken[0], NULL);
+	if (n != 16 || out[0] != 0 || out[15] != 15) {
+		printf("stage 1 acquired %u elements instead of 16\n", n);
+		goto out;
+	}
+	rte_soring_release(r, NULL, 0, 8, ftoken[2]);
+
+	/* Stage 1 modifies the elements in place. */
+	for (i = 0; i < n; i++)
+		out[i] += 1000;
+	rte_soring_release(r, out, 1, n, ftoken[0]);
+	n = rte_soring_acquire_burst(r, NULL, 1, 32, &ftoken[0], NULL);
+	if (n != 16) {
+		printf("stage 1 acquired %u elements instead of 16\n", n);
+		goto out;
+	}
+	rte_soring_release(r, NULL, 1, n, ftoken[0]);
+
+	if (rte_soring_dequeue_bulk(r, out, 32, NULL) != 32) {
+		printf("dequeue failed\n");
+		goto out;
+	}
+	for (i = 0; i < 32; i++) {
+		if (out[i] != (i < 16 ? i + 1000 : i)) {
+			printf("element %u is %u\n", i, out[i]);
+			goto out;
+		}
+	}
+	if (rte_soring_count(r) != 0) {
+		printf("soring not empty\n");
+		goto out;
+	}
+
+	ret = TEST_SUCCESS;
+out:
+	if (ret != TEST_SUCCESS)
+		rte_soring_dump(stdout, r);
+	rte_free(r);
+	return ret;
+}
+
+static int
+test_soring_capacity(void)
+{
+	uint32_t objs[SORING_SIZE], free_space;
+	struct rte_soring *r;
+	uint32_t ftoken;
+	int ret = TEST_FAILED;
+
+	/* Capacity is not rounded up to a power of 2. */
+	r = test_soring_create(SORING_SIZE - 4, 1, RTE_RING_SYNC_ST);
+	TEST_ASSERT_NOT_NULL(r, "cannot create soring");
+
+	if (rte_soring_get_capacity(r) != SORING_SIZE - 4 ||
+	    rte_soring_free_count(r) != SORING_SIZE - 4) {
+		printf("wrong initial capacity\n");
+		goto out;
+	}
+	/* The capacity cannot exceed the number of elements given at init. */
+	if (rte_soring_set_capacity(r, 0) == 0 ||
+	    rte_soring_set_capacity(r, SORING_SIZE - 3) == 0 ||
+	    rte_soring_set_capacity(r, SORING_SIZE) == 0) {
+		printf("invalid capacity accepted\n");
+		goto out;
+	}
+
+	if (rte_soring_set_capacity(r, SORING_SIZE - 8) != 0 ||
+	    rte_soring_enqueue_burst(r, objs, SORING_SIZE, &free_space) !=
+			SORING_SIZE - 8 || free_space != 0) {
+		printf("enqueue burst not limited by the capacity\n");
+		goto out;
+	}
+
+	/* Grow: the room is available at once. */
+	if (rte_soring_set_capacity(r, SORING_SIZE - 4) != 0 ||
+	    rte_soring_enqueue_bulk(r, objs, 4, NULL) != 4) {
+		printf("enqueue after capacity increase failed\n");
+		goto out;
+	}
+
+	/* Shrink below the count: no room until enough elements leave. */
+	if (rte_soring_set_capacity(r, 16) != 0 ||
+	    rte_soring_free_count(r) != 0 ||
+	    rte_soring_enqueue_burst(r, objs, 1, NULL) != 0) {
+		printf("enqueue after capacity decrease succeeded\n");
+		goto out;
+	}
+	if (rte_soring_acquire_bulk(r, NULL, 0, SORING_SIZE - 4, &ftoken,
+				    NULL) != SORING_SIZE - 4)
+		goto out;
+	rte_soring_release(r, NULL, 0, SORING_SIZE - 4, ftoken);
+	if (rte_soring_dequeue_bulk(r, objs, SORING_SIZE - 4 - 15, NULL) !=
+			SORING_SIZE - 4 - 15 ||
+	    rte_soring_free_count(r) != 1 ||
+	    rte_soring_enqueue_bulk(r, objs, 2, NULL) != 0 ||
+	    rte_soring_enqueue_bulk(r, objs, 1, NULL) != 1) {
+		printf("enqueue not limited by the decreased capacity\n");
+		goto out;
+	}
+
+	ret = TEST_SUCCESS;
+out:
+	if (ret != TEST_SUCCESS)
+		rte_soring_dump(stdout, r);
+	rte_free(r);
+	return ret;
+}
+
+static struct rte_soring *mt_soring;
+static volatile int mt_done;
+
+/* Worker lcores: process stage 0 or 1, releasing after a random delay. */
+static int
+test_soring_mt_worker(void *arg)
+{
+	uint32_t stage = (uintptr_t)arg;
+	uint32_t objs[SORING_MT_BURST];
+	uint32_t ftoken, n;
+
+	while (!__atomic_load_n(&mt_done, __ATOMIC_RELAXED)) {
+		n = rte_soring_acquire_burst(mt_soring, objs, stage,
+					     1 + rte_rand_max(SORING_MT_BURST),
+					     &ftoken, NULL);
+		if (n == 0) {
+			rte_pause();
+			continue;
+		}
+		rte_delay_us_block(rte_rand_max(2));
+		rte_soring_release(mt_soring, NULL, stage, n, ftoken);
+	}
+	return 0;
+}
+
+static int
+test_soring_mt(void)
+{
+	uint32_t objs[SORING_MT_BURST];
+	uint32_t next_in = 0, next_out = 0, i, n;
+	unsigned int lcore_id, stage = 0;
+	int ret = TEST_SUCCESS;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for %s, expecting at least 2\n",
+		       __func__);
+		return TEST_SKIPPED;
+	}
+
+	mt_soring = test_soring_create(SORING_SIZE, SORING_STAGES,
+				       RTE_RING_SYNC_ST);
+	TEST_ASSERT_NOT_NULL(mt_soring, "cannot create soring");
+	mt_done = 0;
+
+	/* Each stage is processed by at least one worker, possibly several. */
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		rte_eal_remote_launch(test_soring_mt_worker,
+				      (void *)(uintptr_t)stage, lcore_id);
+		stage = (stage + 1) % SORING_STAGES;
+	}
+
+	while (next_out < SORING_MT_NB_OBJS && ret == TEST_SUCCESS) {
+		n = RTE_MIN((uint32_t)SORING_MT_BURST,
+			    SORING_MT_NB_OBJS - next_in);
+		for (i = 0; i < n; i++)
+			objs[i] = next_in + i;
+		next_in += rte_soring_enqueue_burst(mt_soring, objs, n, NULL);
+
+		/* Only one worker: the main lcore processes stage 1. */
+		if (rte_lcore_count() == 2) {
+			uint32_t ftoken;
+
+			n = rte_soring_acquire_burst(mt_soring, NULL, 1,
+					SORING_MT_BURST, &ftoken, NULL);
+			rte_soring_release(mt_soring, NULL, 1, n, ftoken);
+		}
+
+		n = rte_soring_dequeue_burst(mt_soring, objs, SORING_MT_BURST,
+					     NULL);
+		for (i = 0; i < n; i++, next_out++) {
+			if (objs[i] != next_out) {
+				printf("dequeued %u instead of %u\n",
+				       objs[i], next_out);
+				ret = TEST_FAILED;
+				break;
+			}
+		}
+	}
+
+	__atomic_store_n(&mt_done, 1, __ATOMIC_RELAXED);
+	rte_eal_mp_wait_lcore();
+
+	if (ret != TEST_SUCCESS)
+		rte_soring_dump(stdout, mt_soring);
+	rte_free(mt_soring);
+	return ret;
+}
+
+static int
+test_soring(void)
+{
+	if (test_soring_param() != TEST_SUCCESS)
+		return TEST_FAILED;
+	if (test_soring_stages() != TEST_SUCCESS)
+		return TEST_FAILED;
+	if (test_soring_capacity() != TEST_SUCCESS)
+		return TEST_FAILED;
+	if (test_soring_mt() == TEST_FAILED)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(soring_autotest, test_soring);
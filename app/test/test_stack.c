@@ -339,6 +339,123 @@ test_stack_multithreaded(uint32_t flags)
 	return result;
 }
 
+/* Objects of the stress test, set while they are in the stack */
+static uint32_t *stress_objs;
+static unsigned int stress_num_objs;
+
+static int
+stack_thread_stress(__rte_unused void *args)
+{
+	void *obj_table[MAX_BULK];
+	unsigned int i, j, num;
+	uint32_t *obj;
+
+	for (i = 0; i < NUM_ITERS_PER_THREAD; i++) {
+		num = 1 + rte_rand() % MAX_BULK;
+
+		/* Other threads may hold too many objects, that is fine. */
+		if (rte_stack_pop(thread_test_args.s, obj_table, num) != num)
+			continue;
+
+		for (j = 0; j < num; j++) {
+			obj = obj_table[j];
+			if (obj < stress_objs ||
+			    obj >= stress_objs + stress_num_objs ||
+			    !__atomic_exchange_n(obj, 0, __ATOMIC_RELAXED)) {
+				printf("[%s():%u] Popped an object not in the stack\n",
+				       __func__, __LINE__);
+				return -1;
+			}
+		}
+
+		for (j = 0; j < num; j++)
+			__atomic_store_n((uint32_t *)obj_table[j], 1,
+					 __ATOMIC_RELAXED);
+
+		/* The elements of the objects just popped are free. */
+		if (rte_stack_push(thread_test_args.s, obj_table, num) != num) {
+			printf("[%s():%u] Failed to push %u pointers\n",
+			       __func__, __LINE__, num);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Push and pop a stack full of distinct objects from all lcores, so that
+ * its elements are reused as fast as possible, and check that each object
+ * is popped once and none is lost.
+ */
+static int
+test_stack_mt_stress(uint32_t flags)
+{
+	unsigned int i, lcore_id;
+	struct rte_stack *s;
+	void *obj;
+	int result = 0;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for test_stack_mt_stress, expecting at least 2\n");
+		return TEST_SKIPPED;
+	}
+
+	stress_num_objs = MAX_BULK * rte_lcore_count();
+	stress_objs = rte_calloc(NULL, stress_num_objs, sizeof(*stress_objs), 0);
+	s = rte_stack_create("test", stress_num_objs, rte_socket_id(), flags);
+	if (stress_objs == NULL || s == NULL) {
+		printf("[%s():%u] Failed to create a stack\n",
+		       __func__, __LINE__);
+		result = -1;
+		goto out;
+	}
+
+	for (i = 0; i < stress_num_objs; i++) {
+		stress_objs[i] = 1;
+		obj = &stress_objs[i];
+		if (rte_stack_push(s, &obj, 1) != 1) {
+			printf("[%s():%u] Failed to fill the stack\n",
+			       __func__, __LINE__);
+			result = -1;
+			goto out;
+		}
+	}
+
+	thread_test_args.s = s;
+
+	if (rte_eal_mp_remote_launch(stack_thread_stress, NULL, CALL_MAIN))
+		rte_panic("Failed to launch tests\n");
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			result = -1;
+	}
+	if (result < 0)
+		goto out;
+
+	for (i = 0; i < stress_num_objs; i++) {
+		if (rte_stack_pop(s, &obj, 1) != 1 ||
+		    !__atomic_exchange_n((uint32_t *)obj, 0, __ATOMIC_RELAXED)) {
+			printf("[%s():%u] Object lost or duplicated\n",
+			       __func__, __LINE__);
+			result = -1;
+			goto out;
+		}
+	}
+	if (rte_stack_count(s) != 0 ||
+	    rte_stack_free_count(s) != stress_num_objs) {
+		printf("[%s():%u] Wrong count after draining the stack\n",
+		       __func__, __LINE__);
+		result = -1;
+	}
+
+out:
+	rte_stack_free(s);
+	rte_free(stress_objs);
+	return result;
+}
+
 static int
 __test_stack(uint32_t flags)
 {
@@ -360,6 +477,9 @@ __test_stack(uint32_t flags)
 	if (test_stack_multithreaded(flags) < 0)
 		return -1;
 
+	if (test_stack_mt_stress(flags) < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -379,5 +499,12 @@ test_lf_stack(void)
 #endif
 }
 
+static int
+test_lf_idx_stack(void)
+{
+	return __test_stack(RTE_STACK_F_LF_IDX);
+}
+
 REGISTER_TEST_COMMAND(stack_autotest, test_stack);
 REGISTER_TEST_COMMAND(stack_lf_autotest, test_lf_stack);
+REGISTER_TEST_COMMAND(stack_lf_idx_autotest, test_lf_idx_stack);
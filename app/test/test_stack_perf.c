@@ -354,5 +354,12 @@ test_lf_stack_perf(void)
 #endif
 }
 
+static int
+test_lf_idx_stack_perf(void)
+{
+	return __test_stack_perf(RTE_STACK_F_LF_IDX);
+}
+
 REGISTER_TEST_COMMAND(stack_perf_autotest, test_stack_perf);
 REGISTER_TEST_COMMAND(stack_lf_perf_autotest, test_lf_stack_perf);
+REGISTER_TEST_COMMAND(stack_lf_idx_perf_autotest, test_lf_idx_stack_perf);
@@ -0,0 +1,252 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_mempool.h>
+#include <rte_random.h>
+#include <rte_string_fns.h>
+
+#include "test.h"
+
+#include "iotlb.h"
+
+/*
+ * Translation cost of the vhost IOTLB cache, driven through the internal
+ * functions used by the vhost-user message handler and the data path.
+ */
+
+#define IOTLB_PAGE_SIZE 4096
+#define IOTLB_MAX_PAGES 2048 /* size of the IOTLB cache */
+#define IOTLB_IOVA_BASE 0x100000000ULL
+#define IOTLB_UADDR_BASE 0x7f0000000000ULL
+#define IOTLB_BURST 32
+#define IOTLB_LOOKUPS (1 << 22)
+#define IOTLB_HOT_PAGES 64
+
+static const unsigned int nb_pages[] = { 16, 256, IOTLB_MAX_PAGES };
+
+static struct virtio_net *dev;
+static struct vhost_virtqueue *vq;
+static uint64_t iovas[IOTLB_LOOKUPS / IOTLB_BURST];
+
+static int
+iotlb_setup(void)
+{
+	dev = rte_zmalloc(NULL, sizeof(*dev), 0);
+	vq = rte_zmalloc(NULL, sizeof(*vq), 0);
+	if (dev == NULL || vq == NULL) {
+		printf("Cannot allocate virtqueue\n");
+		return -1;
+	}
+	dev->virtqueue[0] = vq;
+	dev->nr_vring = 1;
+	strlcpy(dev->ifname, "iotlb_perf", sizeof(dev->ifname));
+
+	return 0;
+}
+
+static void
+iotlb_teardown(void)
+{
+	if (vq != NULL) {
+		rte_free(vq->iotlb_cache);
+		rte_free(vq->iotlb_cache_next);
+		rte_mempool_free(vq->iotlb_pool);
+	}
+	rte_free(vq);
+	rte_free(dev);
+	vq = NULL;
+	dev = NULL;
+}
+
+static inline uint64_t
+page_iova(unsigned int page)
+{
+	/* Leave holes between the mappings, as a guest IOMMU does. */
+	return IOTLB_IOVA_BASE + (uint64_t)page * 2 * IOTLB_PAGE_SIZE;
+}
+
+/* Insert the pages in random order, return the cycles per insertion. */
+static int
+iotlb_fill(unsigned int nb, double *cycles)
+{
+	unsigned int order[IOTLB_MAX_PAGES];
+	unsigned int i, j, tmp;
+	uint64_t start;
+
+	for (i = 0; i < nb; i++)
+		order[i] = i;
+	for (i = nb - 1; i > 0; i--) {
+		j = rte_rand_max(i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	if (vhost_user_iotlb_init(dev, 0) != 0) {
+		printf("Cannot initialize IOTLB cache\n");
+		return -1;
+	}
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < nb; i++)
+		vhost_user_iotlb_cache_insert(dev, vq, page_iova(order[i]),
+				IOTLB_UADDR_BASE + order[i] * IOTLB_PAGE_SIZE,
+				IOTLB_PAGE_SIZE, VHOST_ACCESS_RW);
+	*cycles = (double)(rte_rdtsc_precise() - start) / nb;
+
+	return 0;
+}
+
+/*
+ * Translate IOTLB_BURST descriptors of 64 bytes per burst, in the read-side
+ * section of the data path. Return the cycles per translation, or -1 if a
+ * translation failed.
+ */
+static double
+iotlb_lookup(unsigned int nb_iovas)
+{
+	uint64_t start, size, vva, iova;
+	unsigned int i, j;
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < nb_iovas; i++) {
+		vhost_user_iotlb_rd_lock(vq);
+		for (j = 0; j < IOTLB_BURST; j++) {
+			iova = iovas[i] + (j * 64) % IOTLB_PAGE_SIZE;
+			size = 64;
+			vva = vhost_user_iotlb_cache_find(vq, iova, &size,
+					VHOST_ACCESS_RO);
+			if (unlikely(vva == 0 || size != 64)) {
+				vhost_user_iotlb_rd_unlock(vq);
+				return -1;
+			}
+		}
+		vhost_user_iotlb_rd_unlock(vq);
+	}
+
+	return (double)(rte_rdtsc_precise() - start) / (nb_iovas * IOTLB_BURST);
+}
+
+static int
+test_iotlb_translate(unsigned int nb)
+{
+	unsigned int nb_iovas = RTE_DIM(iovas);
+	double insert, same, seq, rnd;
+	unsigned int i;
+
+	if (iotlb_fill(nb, &insert) < 0)
+		return -1;
+
+	/* All the bursts in the same page: the last hit entry is used. */
+	for (i = 0; i < nb_iovas; i++)
+		iovas[i] = page_iova(0);
+	same = iotlb_lookup(nb_iovas);
+
+	/* Bursts in successive pages: one search per burst. */
+	for (i = 0; i < nb_iovas; i++)
+		iovas[i] = page_iova(i % nb);
+	seq = iotlb_lookup(nb_iovas);
+
+	/* Bursts in random pages: one search per burst, random memory access. */
+	for (i = 0; i < nb_iovas; i++)
+		iovas[i] = page_iova(rte_rand_max(nb));
+	rnd = iotlb_lookup(nb_iovas);
+
+	if (same < 0 || seq < 0 || rnd < 0) {
+		printf("Translation failed with %u entries\n", nb);
+		return -1;
+	}
+
+	printf("%8u %12.2f %12.2f %12.2f %12.2f\n", nb, insert, same, seq, rnd);
+
+	return 0;
+}
+
+/*
+ * With a full cache, insert pages looked up once between lookups of a set
+ * of hot pages, and count the hot pages still in the cache afterwards:
+ * LRU eviction must keep them all.
+ */
+static int
+test_iotlb_lru(void)
+{
+	unsigned int i, hot, evicted = 0;
+	uint64_t size, vva;
+	double insert;
+
+	if (iotlb_fill(IOTLB_MAX_PAGES, &insert) < 0)
+		return -1;
+
+	vhost_user_iotlb_rd_lock(vq);
+	for (hot = 0; hot < IOTLB_HOT_PAGES; hot++) {
+		size = 64;
+		vhost_user_iotlb_cache_find(vq, page_iova(hot), &size,
+				VHOST_ACCESS_RO);
+	}
+	vhost_user_iotlb_rd_unlock(vq);
+
+	for (i = IOTLB_MAX_PAGES; i < 4 * IOTLB_MAX_PAGES; i++) {
+		hot = i % IOTLB_HOT_PAGES;
+		vhost_user_iotlb_rd_lock(vq);
+		size = 64;
+		vhost_user_iotlb_cache_find(vq, page_iova(hot), &size,
+				VHOST_ACCESS_RO);
+		size = 64;
+		vhost_user_iotlb_cache_find(vq, page_iova(i), &size,
+				VHOST_ACCESS_RO);
+		vhost_user_iotlb_rd_unlock(vq);
+
+		vhost_user_iotlb_cache_insert(dev, vq, page_iova(i),
+				IOTLB_UADDR_BASE + i * IOTLB_PAGE_SIZE,
+				IOTLB_PAGE_SIZE, VHOST_ACCESS_RW);
+	}
+
+	vhost_user_iotlb_rd_lock(vq);
+	for (hot = 0; hot < IOTLB_HOT_PAGES; hot++) {
+		size = 64;
+		vva = vhost_user_iotlb_cache_find(vq, page_iova(hot), &size,
+				VHOST_ACCESS_RO);
+		if (vva == 0)
+			evicted++;
+	}
+	vhost_user_iotlb_rd_unlock(vq);
+
+	printf("LRU: %u of %u hot pages evicted by %u insertions in a full cache\n",
+		evicted, IOTLB_HOT_PAGES, 3 * IOTLB_MAX_PAGES);
+
+	return evicted == 0 ? 0 : -1;
+}
+
+static int
+test_vhost_iotlb_perf(void)
+{
+	unsigned int i;
+	int ret = -1;
+
+	if (iotlb_setup() < 0)
+		goto out;
+
+	printf("\nCycles per IOTLB operation, %u translations of 64B per burst\n",
+		IOTLB_BURST);
+	printf("%8s %12s %12s %12s %12s\n", "entries", "insert",
+		"same page", "seq pages", "rand pages");
+	for (i = 0; i < RTE_DIM(nb_pages); i++)
+		if (test_iotlb_translate(nb_pages[i]) < 0)
+			goto out;
+
+	if (test_iotlb_lru() < 0)
+		goto out;
+
+	ret = 0;
+out:
+	iotlb_teardown();
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(vhost_iotlb_perf_autotest, test_vhost_iotlb_perf);
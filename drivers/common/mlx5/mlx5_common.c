@@ -555,8 +555,11 @@ mlx5_dev_mempool_unregister_cb(struct rte_mempool *mp, void *arg)
  *   Associated mempool.
  * @param arg
  *   Pointer to a device shared context.
+ *
+ * @return
+ *   Always 0, chunks are never refused.
  */
-static void
+static int
 mlx5_dev_mempool_event_cb(enum rte_mempool_event event, struct rte_mempool *mp,
 			  void *arg)
 {
@@ -572,7 +575,12 @@ mlx5_dev_mempool_event_cb(enum rte_mempool_event event, struct rte_mempool *mp,
 	case RTE_MEMPOOL_EVENT_DESTROY:
 		mlx5_dev_mempool_unregister(cdev, mp);
 		break;
+	case RTE_MEMPOOL_EVENT_CHUNK_ADD:
+	case RTE_MEMPOOL_EVENT_CHUNK_DEL:
+		/* Later chunks use the generic MR lookup by address. */
+		break;
 	}
+	return 0;
 }
 
 int
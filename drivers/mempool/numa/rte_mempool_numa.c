@@ -0,0 +1,346 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+/* Number of objects returned at once to a remote socket. */
+#define NUMA_PUT_BURST 32
+/* Number of memory chunks whose socket is known. */
+#define NUMA_MAX_CHUNKS 128
+
+/* A virtually contiguous memory area of the pool, on one socket. */
+struct numa_chunk {
+	uintptr_t start;
+	uintptr_t end;
+	unsigned int socket_idx;
+};
+
+/* Objects freed on an lcore, waiting to go back to a remote socket. */
+struct numa_put_buf {
+	unsigned int len;
+	void *objs[NUMA_PUT_BURST];
+} __rte_cache_aligned;
+
+struct numa_pool {
+	unsigned int nb_sockets;
+	unsigned int nb_chunks;
+	bool populating;
+	/* Index of each socket id in rings[]. */
+	unsigned int socket_idx[RTE_MAX_NUMA_NODES];
+	/* Free objects of each socket. */
+	struct rte_ring *rings[RTE_MAX_NUMA_NODES];
+	struct numa_chunk chunks[NUMA_MAX_CHUNKS];
+	/* Per-lcore buffers, nb_sockets for each lcore. */
+	struct numa_put_buf *bufs;
+};
+
+static inline unsigned int
+numa_socket_idx(const struct numa_pool *p, int socket_id)
+{
+	if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+		return 0;
+	return p->socket_idx[socket_id];
+}
+
+/* Socket of an object, the local one if the object memory is unknown. */
+static inline unsigned int
+numa_obj_socket_idx(const struct numa_pool *p, const void *obj,
+		    unsigned int local)
+{
+	unsigned int i, nb_chunks;
+	uintptr_t addr = (uintptr_t)obj;
+
+	nb_chunks = __atomic_load_n(&p->nb_chunks, __ATOMIC_ACQUIRE);
+	for (i = 0; i < nb_chunks; i++) {
+		const struct numa_chunk *chunk = &p->chunks[i];
+
+		if (addr - chunk->start < chunk->end - chunk->start)
+			return chunk->socket_idx;
+	}
+	return local;
+}
+
+/* The rings can hold all the objects of the pool, enqueue cannot fail. */
+static inline void
+numa_ring_enqueue(struct rte_ring *r, void * const *obj_table,
+		  unsigned int n)
+{
+	if (n != 0)
+		rte_ring_enqueue_bulk(r, obj_table, n, NULL);
+}
+
+/* Return the objects buffered by an lcore to their socket. */
+static void
+numa_flush(struct numa_pool *p, unsigned int lcore_id)
+{
+	struct numa_put_buf *buf = &p->bufs[lcore_id * p->nb_sockets];
+	unsigned int idx;
+
+	for (idx = 0; idx < p->nb_sockets; idx++) {
+		numa_ring_enqueue(p->rings[idx], buf[idx].objs, buf[idx].len);
+		buf[idx].len = 0;
+	}
+}
+
+static int
+numa_alloc(struct rte_mempool *mp)
+{
+	char rg_name[RTE_RING_NAMESIZE];
+	unsigned int nb_sockets, idx;
+	uint32_t rg_flags = 0;
+	struct numa_pool *p;
+	int socket_id;
+	int ret;
+
+	if (mp->flags & RTE_MEMPOOL_F_SP_PUT)
+		rg_flags |= RING_F_SP_ENQ;
+	if (mp->flags & RTE_MEMPOOL_F_SC_GET)
+		rg_flags |= RING_F_SC_DEQ;
+
+	nb_sockets = RTE_MAX(rte_socket_count(), 1U);
+	p = rte_zmalloc_socket("MEMPOOL_NUMA", sizeof(*p), RTE_CACHE_LINE_SIZE,
+			       mp->socket_id);
+	if (p == NULL)
+		return -ENOMEM;
+	p->nb_sockets = nb_sockets;
+
+	p->bufs = rte_zmalloc_socket("MEMPOOL_NUMA_BUFS",
+			sizeof(*p->bufs) * RTE_MAX_LCORE * nb_sockets,
+			RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (p->bufs == NULL) {
+		ret = -ENOMEM;
+		goto fail;
+	}
+
+	for (idx = 0; idx < nb_sockets; idx++) {
+		socket_id = rte_socket_id_by_idx(idx);
+		if (socket_id >= 0 && socket_id < RTE_MAX_NUMA_NODES)
+			p->socket_idx[socket_id] = idx;
+		else
+			socket_id = mp->socket_id;
+
+		ret = snprintf(rg_name, sizeof(rg_name),
+			RTE_MEMPOOL_MZ_FORMAT "_%u", mp->name, idx);
+		if (ret < 0 || ret >= (int)sizeof(rg_name)) {
+			ret = -ENAMETOOLONG;
+			goto fail;
+		}
+
+		/* Each ring can hold all the objects of the pool. */
+		p->rings[idx] = rte_ring_create(rg_name,
+			rte_align32pow2(mp->size + 1), socket_id, rg_flags);
+		if (p->rings[idx] == NULL) {
+			ret = -rte_errno;
+			goto fail;
+		}
+	}
+
+	mp->pool_data = p;
+	return 0;
+
+fail:
+	for (idx = 0; idx < nb_sockets; idx++)
+		rte_ring_free(p->rings[idx]);
+	rte_free(p->bufs);
+	rte_free(p);
+	return ret;
+}
+
+static void
+numa_free(struct rte_mempool *mp)
+{
+	struct numa_pool *p = mp->pool_data;
+	unsigned int idx, lcore_id;
+
+	/* Return the objects left in the buffers of all lcores. */
+	if (p->nb_sockets > 1)
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			numa_flush(p, lcore_id);
+
+	for (idx = 0; idx < p->nb_sockets; idx++)
+		rte_ring_free(p->rings[idx]);
+	rte_free(p->bufs);
+	rte_free(p);
+}
+
+static int
+numa_enqueue(struct rte_mempool *mp, void * const *obj_table,
+	     unsigned int n)
+{
+	struct numa_pool *p = mp->pool_data;
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int i, idx, local, nb_local = 0;
+	void *local_objs[NUMA_PUT_BURST];
+	struct numa_put_buf *buf;
+	bool buffered;
+
+	if (p->nb_sockets == 1) {
+		numa_ring_enqueue(p->rings[0], obj_table, n);
+		return 0;
+	}
+
+	local = numa_socket_idx(p, rte_socket_id());
+	/* Only EAL threads own a buffer, do not keep objects at populate. */
+	buffered = lcore_id != LCORE_ID_ANY && !p->populating;
+
+	for (i = 0; i < n; i++) {
+		idx = numa_obj_socket_idx(p, obj_table[i], local);
+		if (idx == local) {
+			local_objs[nb_local++] = obj_table[i];
+			if (nb_local == NUMA_PUT_BURST) {
+				numa_ring_enqueue(p->rings[local], local_objs,
+						  nb_local);
+				nb_local = 0;
+			}
+		} else if (buffered) {
+			/*
+			 * Flush all the buffers of the lcore when one is full,
+			 * so that no object stays in a buffer for longer than
+			 * it takes the lcore to put a burst of remote objects.
+			 */
+			buf = &p->bufs[lcore_id * p->nb_sockets + idx];
+			buf->objs[buf->len++] = obj_table[i];
+			if (buf->len == NUMA_PUT_BURST)
+				numa_flush(p, lcore_id);
+		} else {
+			numa_ring_enqueue(p->rings[idx], &obj_table[i], 1);
+		}
+	}
+	numa_ring_enqueue(p->rings[local], local_objs, nb_local);
+
+	return 0;
+}
+
+static int
+numa_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct numa_pool *p = mp->pool_data;
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int i, idx, local, got;
+
+	local = numa_socket_idx(p, rte_socket_id());
+	if (rte_ring_dequeue_bulk(p->rings[local], obj_table, n, NULL) == n)
+		return 0;
+
+	if (p->nb_sockets == 1)
+		return -ENOBUFS;
+
+	/* Make the objects this lcore keeps available, then go remote. */
+	if (lcore_id != LCORE_ID_ANY)
+		numa_flush(p, lcore_id);
+	for (i = 1; i < p->nb_sockets; i++) {
+		idx = (local + i) % p->nb_sockets;
+		if (rte_ring_dequeue_bulk(p->rings[idx], obj_table, n,
+					  NULL) == n)
+			return 0;
+	}
+
+	/* No socket has enough objects alone, gather them. */
+	for (i = 0, got = 0; i < p->nb_sockets && got < n; i++) {
+		idx = (local + i) % p->nb_sockets;
+		got += rte_ring_dequeue_burst(p->rings[idx], &obj_table[got],
+					      n - got, NULL);
+	}
+	if (got == n)
+		return 0;
+
+	for (i = 0; i < got; i++) {
+		idx = numa_obj_socket_idx(p, obj_table[i], local);
+		numa_ring_enqueue(p->rings[idx], &obj_table[i], 1);
+	}
+	return -ENOBUFS;
+}
+
+static unsigned int
+numa_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_pool *p = mp->pool_data;
+	unsigned int i, count = 0;
+
+	for (i = 0; i < p->nb_sockets; i++)
+		count += rte_ring_count(p->rings[i]);
+	if (p->nb_sockets > 1)
+		for (i = 0; i < RTE_MAX_LCORE * p->nb_sockets; i++)
+			count += p->bufs[i].len;
+
+	return count;
+}
+
+static int
+numa_populate(struct rte_mempool *mp, unsigned int max_objs, void *vaddr,
+	      rte_iova_t iova, size_t len,
+	      rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct numa_pool *p = mp->pool_data;
+	const struct rte_memseg_list *msl;
+	struct numa_chunk *chunk;
+	unsigned int socket_idx;
+	uintptr_t start = (uintptr_t)vaddr;
+	int ret;
+
+	msl = rte_mem_virt2memseg_list(vaddr);
+	socket_idx = numa_socket_idx(p, msl != NULL ? msl->socket_id :
+				     mp->socket_id);
+
+	/*
+	 * Extend the previous chunk, or add a new one. Objects of unknown
+	 * memory would be returned to the wrong socket, refuse them.
+	 */
+	chunk = p->nb_chunks != 0 ? &p->chunks[p->nb_chunks - 1] : NULL;
+	if (chunk != NULL && chunk->end == start &&
+	    chunk->socket_idx == socket_idx) {
+		chunk->end = start + len;
+	} else if (p->nb_chunks >= NUMA_MAX_CHUNKS) {
+		RTE_LOG(ERR, MEMPOOL,
+			"Mempool %s spans more than %u memory chunks\n",
+			mp->name, NUMA_MAX_CHUNKS);
+		return -ENOSPC;
+	} else {
+		chunk = &p->chunks[p->nb_chunks];
+		chunk->start = start;
+		chunk->end = start + len;
+		chunk->socket_idx = socket_idx;
+		__atomic_store_n(&p->nb_chunks, p->nb_chunks + 1,
+				 __ATOMIC_RELEASE);
+	}
+
+	p->populating = true;
+	ret = rte_mempool_op_populate_default(mp, max_objs, vaddr, iova, len,
+					      obj_cb, obj_cb_arg);
+	p->populating = false;
+
+	return ret;
+}
+
+static int
+numa_get_info(__rte_unused const struct rte_mempool *mp,
+	      struct rte_mempool_info *info)
+{
+	info->contig_block_size = 0;
+	info->flags = RTE_MEMPOOL_INFO_F_SOCKET_SPREAD;
+
+	return 0;
+}
+
+static const struct rte_mempool_ops ops_numa = {
+	.name = "numa",
+	.alloc = numa_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+	.get_info = numa_get_info,
+};
+
+RTE_MEMPOOL_REGISTER_OPS(ops_numa);
@@ -192,10 +192,12 @@ static int
 memif_dev_info(struct rte_eth_dev *dev __rte_unused, struct rte_eth_dev_info *dev_info)
 {
 	dev_info->max_mac_addrs = 1;
-	dev_info->max_rx_pktlen = RTE_ETHER_MAX_LEN;
+	/* packets larger than a buffer are chained in both modes */
+	dev_info->max_rx_pktlen = RTE_ETHER_MAX_JUMBO_FRAME_LEN;
 	dev_info->max_rx_queues = ETH_MEMIF_MAX_NUM_Q_PAIRS;
 	dev_info->max_tx_queues = ETH_MEMIF_MAX_NUM_Q_PAIRS;
 	dev_info->min_rx_bufsize = 0;
+	dev_info->rx_offload_capa = RTE_ETH_RX_OFFLOAD_SCATTER;
 	dev_info->tx_offload_capa = RTE_ETH_TX_OFFLOAD_MULTI_SEGS;
 
 	return 0;
@@ -245,6 +247,38 @@ memif_get_buffer(struct pmd_process_private *proc_private, memif_desc_t *d)
 	return ((uint8_t *)proc_private->regions[d->region]->addr + d->offset);
 }
 
+/*
+ * Find the region exposing a buffer of a zero-copy client. The region of
+ * the previous buffer of the queue is tried first, as the buffers of a
+ * mempool are usually in the same memseg list.
+ */
+static __rte_always_inline int
+memif_find_region_zc(struct pmd_process_private *proc_private,
+		     struct memif_queue *mq, const void *addr)
+{
+	struct memif_region *r;
+	memif_region_index_t i;
+
+	r = proc_private->regions[mq->zc_region];
+	if (likely(r != NULL && RTE_PTR_DIFF(addr, r->addr) <
+			RTE_MIN(r->region_size, (memif_region_size_t)UINT32_MAX)))
+		return mq->zc_region;
+
+	/* Region 0 holds the rings, the others the memseg lists. The
+	 * descriptor offset is 32 bits wide.
+	 */
+	for (i = 1; i < proc_private->regions_num; i++) {
+		r = proc_private->regions[i];
+		if (RTE_PTR_DIFF(addr, r->addr) <
+				RTE_MIN(r->region_size, (memif_region_size_t)UINT32_MAX)) {
+			mq->zc_region = i;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
 /* Free mbufs received by server */
 static void
 memif_free_stored_mbufs(struct pmd_process_private *proc_private, struct memif_queue *mq)
@@ -442,11 +476,12 @@ eth_memif_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		rte_eth_devices[mq->in_port].process_private;
 	memif_ring_t *ring = memif_get_ring_from_queue(proc_private, mq);
 	uint16_t cur_slot, last_slot, n_slots, ring_size, mask, s0, head;
-	uint16_t n_rx_pkts = 0;
+	uint16_t n_rx_pkts = 0, n_wrap, i;
+	uint32_t buf_len;
 	memif_desc_t *d0;
 	struct rte_mbuf *mbuf, *mbuf_tail;
 	struct rte_mbuf *mbuf_head = NULL;
-	int ret;
+	int ret, region;
 	struct rte_eth_link link;
 
 	if (unlikely((pmd->flags & ETH_MEMIF_FLAG_CONNECTED) == 0))
@@ -530,23 +565,46 @@ eth_memif_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	if (n_slots < 32)
 		goto no_free_mbufs;
 
-	ret = rte_pktmbuf_alloc_bulk(mq->mempool, &mq->buffers[head & mask], n_slots);
+	/* The free slots may wrap around the end of the ring. */
+	s0 = head & mask;
+	n_wrap = RTE_MIN(n_slots, (uint16_t)(ring_size - s0));
+	ret = rte_pktmbuf_alloc_bulk_tmpl(mq->mempool, &mq->buffers[s0],
+					  n_wrap, &mq->rearm_tmpl);
 	if (unlikely(ret < 0))
 		goto no_free_mbufs;
+	if (n_wrap < n_slots) {
+		ret = rte_pktmbuf_alloc_bulk_tmpl(mq->mempool, &mq->buffers[0],
+						  n_slots - n_wrap,
+						  &mq->rearm_tmpl);
+		if (unlikely(ret < 0))
+			n_slots = n_wrap;
+	}
 
+	buf_len = rte_pktmbuf_data_room_size(mq->mempool) - RTE_PKTMBUF_HEADROOM;
 	while (n_slots--) {
-		s0 = head++ & mask;
+		s0 = head & mask;
 		if (n_slots > 0)
-			rte_prefetch0(mq->buffers[head & mask]);
-		d0 = &ring->desc[s0];
-		/* store buffer header */
+			rte_prefetch0(mq->buffers[(head + 1) & mask]);
 		mbuf = mq->buffers[s0];
-		/* populate descriptor */
-		d0->length = rte_pktmbuf_data_room_size(mq->mempool) -
-				RTE_PKTMBUF_HEADROOM;
-		d0->region = 1;
-		d0->offset = rte_pktmbuf_mtod(mbuf, uint8_t *) -
-			(uint8_t *)proc_private->regions[d0->region]->addr;
+		region = memif_find_region_zc(proc_private, mq,
+					      rte_pktmbuf_mtod(mbuf, void *));
+		if (unlikely(region < 0)) {
+			MIF_LOG(ERR, "Mbuf outside of the shared memory regions");
+			/* Free this mbuf and the next ones, not posted */
+			for (i = 0; i <= n_slots; i++)
+				rte_pktmbuf_free_seg(mq->buffers[(head + i) & mask]);
+			break;
+		}
+		/* Populate the whole descriptor at once, which the compiler
+		 * turns into a single vector store where available.
+		 */
+		ring->desc[s0] = (memif_desc_t){
+			.length = buf_len,
+			.region = region,
+			.offset = RTE_PTR_DIFF(rte_pktmbuf_mtod(mbuf, void *),
+					       proc_private->regions[region]->addr),
+		};
+		head++;
 	}
 no_free_mbufs:
 	/* The ring->head acts as a guard variable between Tx and Rx
@@ -695,16 +753,32 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 }
 
 
+/*
+ * Post the segments of a packet to the ring, one descriptor each.
+ * Return the number of slots used, 0 if the packet was dropped because a
+ * segment is not in the shared memory, or -1 if the ring is full.
+ */
 static int
 memif_tx_one_zc(struct pmd_process_private *proc_private, struct memif_queue *mq,
 		memif_ring_t *ring, struct rte_mbuf *mbuf, const uint16_t mask,
 		uint16_t slot, uint16_t n_free)
 {
+	struct rte_mbuf *mbuf_head = mbuf;
 	memif_desc_t *d0;
 	uint16_t nb_segs = mbuf->nb_segs;
-	int used_slots = 1;
+	uint32_t n_bytes = 0;
+	int used_slots = 0;
+	int region;
+
+	/* the whole chain must fit in the ring */
+	if (unlikely(nb_segs > n_free))
+		return -1;
 
 next_in_chain:
+	region = memif_find_region_zc(proc_private, mq,
+				      rte_pktmbuf_mtod(mbuf, void *));
+	if (unlikely(region < 0))
+		goto drop;
 	/* store pointer to mbuf to free it later */
 	mq->buffers[slot & mask] = mbuf;
 	/* Increment refcnt to make sure the buffer is not freed before server
@@ -714,28 +788,33 @@ memif_tx_one_zc(struct pmd_process_private *proc_private, struct memif_queue *mq
 	/* populate descriptor */
 	d0 = &ring->desc[slot & mask];
 	d0->length = rte_pktmbuf_data_len(mbuf);
-	mq->n_bytes += rte_pktmbuf_data_len(mbuf);
-	/* FIXME: get region index */
-	d0->region = 1;
-	d0->offset = rte_pktmbuf_mtod(mbuf, uint8_t *) -
-		(uint8_t *)proc_private->regions[d0->region]->addr;
+	n_bytes += rte_pktmbuf_data_len(mbuf);
+	d0->region = region;
+	d0->offset = RTE_PTR_DIFF(rte_pktmbuf_mtod(mbuf, void *),
+				  proc_private->regions[region]->addr);
 	d0->flags = 0;
+	used_slots++;
 
 	/* check if buffer is chained */
 	if (--nb_segs > 0) {
-		if (n_free < 2)
-			return 0;
 		/* mark buffer as chained */
 		d0->flags |= MEMIF_DESC_FLAG_NEXT;
 		/* advance mbuf */
 		mbuf = mbuf->next;
-		/* update counters */
-		used_slots++;
 		slot++;
-		n_free--;
 		goto next_in_chain;
 	}
+
+	mq->n_bytes += n_bytes;
 	return used_slots;
+
+drop:
+	/* e.g. an external buffer: undo the segments already posted */
+	for (mbuf = mbuf_head; used_slots > 0; used_slots--, mbuf = mbuf->next)
+		rte_mbuf_refcnt_update(mbuf, -1);
+	rte_pktmbuf_free(mbuf_head);
+	mq->n_err++;
+	return 0;
 }
 
 static uint16_t
@@ -747,6 +826,7 @@ eth_memif_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		rte_eth_devices[mq->in_port].process_private;
 	memif_ring_t *ring = memif_get_ring_from_queue(proc_private, mq);
 	uint16_t slot, n_free, ring_size, mask, n_tx_pkts = 0;
+	uint64_t n_err = mq->n_err;
 	struct rte_eth_link link;
 
 	if (unlikely((pmd->flags & ETH_MEMIF_FLAG_CONNECTED) == 0))
@@ -785,7 +865,7 @@ eth_memif_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			}
 			used_slots = memif_tx_one_zc(proc_private, mq, ring, *bufs++,
 				mask, slot, n_free);
-			if (unlikely(used_slots < 1))
+			if (unlikely(used_slots < 0))
 				goto no_free_slots;
 			n_tx_pkts++;
 			slot += used_slots;
@@ -793,7 +873,7 @@ eth_memif_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 			used_slots = memif_tx_one_zc(proc_private, mq, ring, *bufs++,
 				mask, slot, n_free);
-			if (unlikely(used_slots < 1))
+			if (unlikely(used_slots < 0))
 				goto no_free_slots;
 			n_tx_pkts++;
 			slot += used_slots;
@@ -801,7 +881,7 @@ eth_memif_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 			used_slots = memif_tx_one_zc(proc_private, mq, ring, *bufs++,
 				mask, slot, n_free);
-			if (unlikely(used_slots < 1))
+			if (unlikely(used_slots < 0))
 				goto no_free_slots;
 			n_tx_pkts++;
 			slot += used_slots;
@@ -809,7 +889,7 @@ eth_memif_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 			used_slots = memif_tx_one_zc(proc_private, mq, ring, *bufs++,
 				mask, slot, n_free);
-			if (unlikely(used_slots < 1))
+			if (unlikely(used_slots < 0))
 				goto no_free_slots;
 			n_tx_pkts++;
 			slot += used_slots;
@@ -817,7 +897,7 @@ eth_memif_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		}
 		used_slots = memif_tx_one_zc(proc_private, mq, ring, *bufs++,
 			mask, slot, n_free);
-		if (unlikely(used_slots < 1))
+		if (unlikely(used_slots < 0))
 			goto no_free_slots;
 		n_tx_pkts++;
 		slot += used_slots;
@@ -846,8 +926,8 @@ eth_memif_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		}
 	}
 
-	/* increment queue counters */
-	mq->n_pkts += n_tx_pkts;
+	/* increment queue counters, the dropped packets are not sent */
+	mq->n_pkts += n_tx_pkts - (mq->n_err - n_err);
 
 	return n_tx_pkts;
 }
@@ -911,17 +991,19 @@ memif_region_init_zc(const struct rte_memseg_list *msl, const struct rte_memseg
 		}
 
 		r->addr = msl->base_va;
-		r->region_size = ms->len;
 		r->fd = rte_memseg_get_fd(ms);
 		if (r->fd < 0)
 			return -1;
 		r->pkt_buffer_offset = 0;
 
 		proc_private->regions[proc_private->regions_num - 1] = r;
-	} else {
-		r->region_size += ms->len;
 	}
 
+	/* The region spans up to the end of the last segment of the list,
+	 * including the holes between its allocated segments.
+	 */
+	r->region_size = RTE_PTR_DIFF(RTE_PTR_ADD(ms->addr, ms->len), msl->base_va);
+
 	return 0;
 }
 
@@ -1113,6 +1195,8 @@ memif_init_queues(struct rte_eth_dev *dev)
 						  (1 << mq->log2_ring_size), 0);
 			if (mq->buffers == NULL)
 				return -ENOMEM;
+			/* first memseg list region */
+			mq->zc_region = 1;
 		}
 	}
 
@@ -1137,6 +1221,8 @@ memif_init_queues(struct rte_eth_dev *dev)
 						  (1 << mq->log2_ring_size), 0);
 			if (mq->buffers == NULL)
 				return -ENOMEM;
+			/* first memseg list region */
+			mq->zc_region = 1;
 		}
 	}
 	return 0;
@@ -1384,6 +1470,7 @@ memif_rx_queue_setup(struct rte_eth_dev *dev,
 
 	mq->mempool = mb_pool;
 	mq->in_port = dev->data->port_id;
+	rte_pktmbuf_rearm_tmpl_init(mb_pool, mq->in_port, &mq->rearm_tmpl);
 	dev->data->rx_queues[qid] = mq;
 
 	return 0;
@@ -1470,6 +1557,7 @@ memif_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *stats)
 		stats->q_obytes[i] = mq->n_bytes;
 		stats->opackets += mq->n_pkts;
 		stats->obytes += mq->n_bytes;
+		stats->oerrors += mq->n_err;
 	}
 	return 0;
 }
@@ -1486,12 +1574,14 @@ memif_stats_reset(struct rte_eth_dev *dev)
 		    dev->data->rx_queues[i];
 		mq->n_pkts = 0;
 		mq->n_bytes = 0;
+		mq->n_err = 0;
 	}
 	for (i = 0; i < pmd->run.num_s2c_rings; i++) {
 		mq = (pmd->role == MEMIF_ROLE_CLIENT) ? dev->data->rx_queues[i] :
 		    dev->data->tx_queues[i];
 		mq->n_pkts = 0;
 		mq->n_bytes = 0;
+		mq->n_err = 0;
 	}
 
 	return 0;
@@ -10,6 +10,7 @@
 #include <ethdev_driver.h>
 #include <rte_ether.h>
 #include <rte_interrupts.h>
+#include <rte_mbuf_tmpl.h>
 
 #include "memif.h"
 
@@ -46,10 +47,13 @@ struct memif_region {
 
 struct memif_queue {
 	struct rte_mempool *mempool;		/**< mempool for RX packets */
+	struct rte_mbuf_rearm_tmpl rearm_tmpl;	/**< RX mbuf rearm template */
 	struct pmd_internals *pmd;		/**< device internals */
 
 	memif_ring_type_t type;			/**< ring type */
 	memif_region_index_t region;		/**< shared memory region index */
+	memif_region_index_t zc_region;
+	/**< last region of a zero-copy buffer, tried first by the lookup */
 
 	uint16_t in_port;			/**< port id */
 
@@ -67,6 +71,7 @@ struct memif_queue {
 	/* rx/tx info */
 	uint64_t n_pkts;			/**< number of rx/tx packets */
 	uint64_t n_bytes;			/**< number of rx/tx bytes */
+	uint64_t n_err;				/**< number of dropped tx packets */
 
 	struct rte_intr_handle *intr_handle;	/**< interrupt handle */
 
@@ -1060,8 +1060,11 @@ mlx5_dev_ctx_shared_rx_mempool_unregister_cb(struct rte_mempool *mp, void *arg)
  *   An Rx mempool registered explicitly when the port is started.
  * @param arg
  *   Pointer to a device shared context.
+ *
+ * @return
+ *   Always 0, chunks are never refused.
  */
-static void
+static int
 mlx5_dev_ctx_shared_rx_mempool_event_cb(enum rte_mempool_event event,
 					struct rte_mempool *mp, void *arg)
 {
@@ -1069,6 +1072,7 @@ mlx5_dev_ctx_shared_rx_mempool_event_cb(enum rte_mempool_event event,
 
 	if (event == RTE_MEMPOOL_EVENT_DESTROY)
 		mlx5_dev_mempool_unregister(sh->cdev, mp);
+	return 0;
 }
 
 int
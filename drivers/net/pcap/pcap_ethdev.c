@@ -19,6 +19,8 @@
 #include <rte_os_shim.h>
 
 #include "pcap_osdep.h"
+#include "pcap_replay.h"
+#include "pcap_writer.h"
 
 #define RTE_ETH_PCAP_SNAPSHOT_LEN 65535
 #define RTE_ETH_PCAP_SNAPLEN RTE_ETHER_MAX_JUMBO_FRAME_LEN
@@ -33,6 +35,11 @@
 #define ETH_PCAP_IFACE_ARG    "iface"
 #define ETH_PCAP_PHY_MAC_ARG  "phy_mac"
 #define ETH_PCAP_INFINITE_RX_ARG  "infinite_rx"
+#define ETH_PCAP_REPLAY_ARG   "replay"
+#define ETH_PCAP_REPLAY_SPEED_ARG "replay_speed"
+#define ETH_PCAP_TX_BULK_ARG  "tx_bulk"
+#define ETH_PCAP_TX_DIRECT_ARG "tx_direct"
+#define ETH_PCAP_TX_ROTATE_SIZE_ARG "tx_rotate_size"
 
 #define ETH_PCAP_ARG_MAXLEN	64
 
@@ -80,6 +87,7 @@ struct pcap_tx_queue {
 	uint16_t port_id;
 	uint16_t queue_id;
 	struct queue_stat tx_stat;
+	struct pcap_writer_stats writer_stat;
 	char name[PATH_MAX];
 	char type[ETH_PCAP_ARG_MAXLEN];
 };
@@ -93,12 +101,20 @@ struct pmd_internals {
 	int single_iface;
 	int phy_mac;
 	unsigned int infinite_rx;
+	unsigned int replay;
+	double replay_speed;
+	unsigned int tx_bulk;
+	unsigned int tx_direct;
+	uint64_t tx_rotate_size;
+	uint64_t xstats_reset_cycles;
 };
 
 struct pmd_process_private {
 	pcap_t *rx_pcap[RTE_PMD_PCAP_MAX_QUEUES];
+	struct pcap_replay *rx_replay[RTE_PMD_PCAP_MAX_QUEUES];
 	pcap_t *tx_pcap[RTE_PMD_PCAP_MAX_QUEUES];
 	pcap_dumper_t *tx_dumper[RTE_PMD_PCAP_MAX_QUEUES];
+	struct pcap_writer *tx_writer[RTE_PMD_PCAP_MAX_QUEUES];
 };
 
 struct pmd_devargs {
@@ -121,6 +137,11 @@ struct pmd_devargs_all {
 	unsigned int is_rx_pcap;
 	unsigned int is_rx_iface;
 	unsigned int infinite_rx;
+	unsigned int replay;
+	double replay_speed;
+	unsigned int tx_bulk;
+	unsigned int tx_direct;
+	uint64_t tx_rotate_size;
 };
 
 static const char *valid_arguments[] = {
@@ -132,6 +153,11 @@ static const char *valid_arguments[] = {
 	ETH_PCAP_IFACE_ARG,
 	ETH_PCAP_PHY_MAC_ARG,
 	ETH_PCAP_INFINITE_RX_ARG,
+	ETH_PCAP_REPLAY_ARG,
+	ETH_PCAP_REPLAY_SPEED_ARG,
+	ETH_PCAP_TX_BULK_ARG,
+	ETH_PCAP_TX_DIRECT_ARG,
+	ETH_PCAP_TX_ROTATE_SIZE_ARG,
 	NULL
 };
 
@@ -337,6 +363,64 @@ eth_pcap_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+static uint16_t
+eth_pcap_rx_replay(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	const struct pcap_replay_pkt *pkt;
+	struct pmd_process_private *pp;
+	struct rte_mbuf *mbuf;
+	struct pcap_rx_queue *pcap_q = queue;
+	struct pcap_replay *replay;
+	uint16_t num_rx = 0;
+	uint32_t rx_bytes = 0;
+	uint64_t now;
+	int ret;
+
+	pp = rte_eth_devices[pcap_q->port_id].process_private;
+	replay = pp->rx_replay[pcap_q->queue_id];
+
+	if (unlikely(replay == NULL || nb_pkts == 0))
+		return 0;
+
+	/* Packets stay in the file mapping, mbufs only point to them */
+	now = rte_get_timer_cycles();
+	while (num_rx < nb_pkts) {
+		pkt = pcap_replay_peek(replay, now);
+		if (pkt == NULL)
+			break;
+
+		mbuf = rte_pktmbuf_alloc(pcap_q->mb_pool);
+		if (unlikely(mbuf == NULL)) {
+			pcap_q->rx_stat.rx_nombuf++;
+			break;
+		}
+
+		ret = pcap_replay_attach(replay, mbuf);
+		if (unlikely(ret < 0)) {
+			rte_pktmbuf_free(mbuf);
+			/* Retry once the application frees packets */
+			if (ret == -ENOBUFS) {
+				pcap_q->rx_stat.rx_nombuf++;
+				break;
+			}
+			pcap_q->rx_stat.err_pkts++;
+			continue;
+		}
+
+		*RTE_MBUF_DYNFIELD(mbuf, timestamp_dynfield_offset,
+			rte_mbuf_timestamp_t *) = pkt->ts / 1000;
+		mbuf->ol_flags |= timestamp_rx_dynflag;
+		mbuf->port = pcap_q->port_id;
+		bufs[num_rx] = mbuf;
+		num_rx++;
+		rx_bytes += mbuf->data_len;
+	}
+	pcap_q->rx_stat.pkts += num_rx;
+	pcap_q->rx_stat.bytes += rx_bytes;
+
+	return num_rx;
+}
+
 static uint16_t
 eth_null_rx(void *queue __rte_unused,
 		struct rte_mbuf **bufs __rte_unused,
@@ -429,6 +513,54 @@ eth_pcap_tx_dumper(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return nb_pkts;
 }
 
+/*
+ * Callback to handle writing packets to a pcap file through a large buffer.
+ */
+static uint16_t
+eth_pcap_tx_writer(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	unsigned int i;
+	struct pmd_process_private *pp;
+	struct pcap_tx_queue *writer_q = queue;
+	uint16_t num_tx = 0;
+	uint32_t tx_bytes = 0;
+	struct timeval ts;
+	struct pcap_writer *writer;
+	int ret;
+
+	pp = rte_eth_devices[writer_q->port_id].process_private;
+	writer = pp->tx_writer[writer_q->queue_id];
+
+	if (writer == NULL)
+		return 0;
+
+	/* Empty bursts still write the records kept for too long */
+	if (nb_pkts == 0) {
+		pcap_writer_poll(writer);
+		return 0;
+	}
+
+	for (i = 0; i < nb_pkts; i++) {
+		/* tv_usec holds nanoseconds */
+		calculate_timestamp(&ts);
+		ret = pcap_writer_write(writer, bufs[i], ts.tv_sec,
+				ts.tv_usec);
+		if (likely(ret >= 0)) {
+			num_tx++;
+			tx_bytes += ret;
+		}
+		rte_pktmbuf_free(bufs[i]);
+	}
+
+	/* Records are written to the file once the buffer is full */
+	pcap_writer_poll(writer);
+	writer_q->tx_stat.pkts += num_tx;
+	writer_q->tx_stat.bytes += tx_bytes;
+	writer_q->tx_stat.err_pkts += nb_pkts - num_tx;
+
+	return nb_pkts;
+}
+
 /*
  * Callback to handle dropping packets in the infinite rx case.
  */
@@ -624,7 +756,18 @@ eth_dev_start(struct rte_eth_dev *dev)
 	for (i = 0; i < dev->data->nb_tx_queues; i++) {
 		tx = &internals->tx_queue[i];
 
-		if (!pp->tx_dumper[i] &&
+		if (internals->tx_bulk &&
+				strcmp(tx->type, ETH_PCAP_TX_PCAP_ARG) == 0) {
+			if (!pp->tx_writer[i]) {
+				pp->tx_writer[i] = pcap_writer_open(tx->name,
+						internals->tx_direct,
+						internals->tx_rotate_size,
+						&tx->writer_stat,
+						dev->device->numa_node);
+				if (pp->tx_writer[i] == NULL)
+					return -1;
+			}
+		} else if (!pp->tx_dumper[i] &&
 				strcmp(tx->type, ETH_PCAP_TX_PCAP_ARG) == 0) {
 			if (open_single_tx_pcap(tx->name,
 				&pp->tx_dumper[i]) < 0)
@@ -640,6 +783,14 @@ eth_dev_start(struct rte_eth_dev *dev)
 	for (i = 0; i < dev->data->nb_rx_queues; i++) {
 		rx = &internals->rx_queue[i];
 
+		if (internals->replay && pp->rx_replay[i] == NULL) {
+			pp->rx_replay[i] = pcap_replay_open(rx->name,
+					internals->replay_speed,
+					internals->infinite_rx);
+			if (pp->rx_replay[i] == NULL)
+				return -1;
+		}
+
 		if (pp->rx_pcap[i] != NULL)
 			continue;
 
@@ -697,6 +848,11 @@ eth_dev_stop(struct rte_eth_dev *dev)
 			pcap_close(pp->tx_pcap[i]);
 			pp->tx_pcap[i] = NULL;
 		}
+
+		if (pp->tx_writer[i] != NULL) {
+			pcap_writer_close(pp->tx_writer[i]);
+			pp->tx_writer[i] = NULL;
+		}
 	}
 
 	for (i = 0; i < dev->data->nb_rx_queues; i++) {
@@ -705,6 +861,12 @@ eth_dev_stop(struct rte_eth_dev *dev)
 			pcap_close(pp->rx_pcap[i]);
 			pp->rx_pcap[i] = NULL;
 		}
+
+		/* Mapping stays until the mbufs attached to it are freed */
+		if (pp->rx_replay[i] != NULL) {
+			pcap_replay_close(pp->rx_replay[i]);
+			pp->rx_replay[i] = NULL;
+		}
 	}
 
 status_down:
@@ -807,6 +969,92 @@ eth_stats_reset(struct rte_eth_dev *dev)
 	return 0;
 }
 
+struct pcap_xstats_name_off {
+	char name[RTE_ETH_XSTATS_NAME_SIZE];
+	uint64_t offset;
+};
+
+static const struct pcap_xstats_name_off pcap_writer_stat_strings[] = {
+	{"tx_write_bytes",
+	 offsetof(struct pcap_tx_queue, writer_stat.bytes)},
+	{"tx_write_dropped",
+	 offsetof(struct pcap_tx_queue, writer_stat.dropped)},
+	{"tx_write_files",
+	 offsetof(struct pcap_tx_queue, writer_stat.files)},
+};
+
+/* Writer stats summed over queues, then the write rate */
+#define PCAP_NB_XSTATS (RTE_DIM(pcap_writer_stat_strings) + 1)
+
+static int
+eth_xstats_get_names(struct rte_eth_dev *dev,
+		struct rte_eth_xstat_name *xstats_names,
+		unsigned int limit __rte_unused)
+{
+	const struct pmd_internals *internal = dev->data->dev_private;
+	unsigned int t;
+
+	if (!internal->tx_bulk)
+		return 0;
+	if (xstats_names == NULL)
+		return PCAP_NB_XSTATS;
+
+	for (t = 0; t < RTE_DIM(pcap_writer_stat_strings); t++)
+		strlcpy(xstats_names[t].name, pcap_writer_stat_strings[t].name,
+			sizeof(xstats_names[t].name));
+	strlcpy(xstats_names[t].name, "tx_write_bytes_per_sec",
+		sizeof(xstats_names[t].name));
+
+	return PCAP_NB_XSTATS;
+}
+
+static int
+eth_xstats_get(struct rte_eth_dev *dev, struct rte_eth_xstat *xstats,
+		unsigned int n)
+{
+	const struct pmd_internals *internal = dev->data->dev_private;
+	uint64_t cycles;
+	unsigned int i;
+	unsigned int t;
+
+	if (!internal->tx_bulk)
+		return 0;
+	if (n < PCAP_NB_XSTATS)
+		return PCAP_NB_XSTATS;
+
+	for (t = 0; t < RTE_DIM(pcap_writer_stat_strings); t++) {
+		xstats[t].id = t;
+		xstats[t].value = 0;
+		for (i = 0; i < dev->data->nb_tx_queues; i++)
+			xstats[t].value += *(const uint64_t *)
+				((const char *)&internal->tx_queue[i] +
+				 pcap_writer_stat_strings[t].offset);
+	}
+
+	/* Average since the last reset, xstats[0] being the bytes */
+	cycles = rte_get_timer_cycles() - internal->xstats_reset_cycles;
+	xstats[t].id = t;
+	xstats[t].value = cycles == 0 ? 0 :
+		(uint64_t)((double)xstats[0].value * hz / cycles);
+
+	return PCAP_NB_XSTATS;
+}
+
+static int
+eth_xstats_reset(struct rte_eth_dev *dev)
+{
+	struct pmd_internals *internal = dev->data->dev_private;
+	unsigned int i;
+
+	eth_stats_reset(dev);
+	for (i = 0; i < dev->data->nb_tx_queues; i++)
+		memset(&internal->tx_queue[i].writer_stat, 0,
+			sizeof(internal->tx_queue[i].writer_stat));
+	internal->xstats_reset_cycles = rte_get_timer_cycles();
+
+	return 0;
+}
+
 static inline void
 infinite_rx_ring_free(struct rte_ring *pkts)
 {
@@ -835,7 +1083,7 @@ eth_dev_close(struct rte_eth_dev *dev)
 		return 0;
 
 	/* Device wide flag, but cleanup must be performed per queue. */
-	if (internals->infinite_rx) {
+	if (internals->infinite_rx && !internals->replay) {
 		for (i = 0; i < dev->data->nb_rx_queues; i++) {
 			struct pcap_rx_queue *pcap_q = &internals->rx_queue[i];
 
@@ -880,7 +1128,8 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	pcap_q->queue_id = rx_queue_id;
 	dev->data->rx_queues[rx_queue_id] = pcap_q;
 
-	if (internals->infinite_rx) {
+	/* Replay loops over the file mapping, nothing to preload */
+	if (internals->infinite_rx && !internals->replay) {
 		struct pmd_process_private *pp;
 		char ring_name[RTE_RING_NAMESIZE];
 		static uint32_t ring_number;
@@ -1004,6 +1253,9 @@ static const struct eth_dev_ops ops = {
 	.link_update = eth_link_update,
 	.stats_get = eth_stats_get,
 	.stats_reset = eth_stats_reset,
+	.xstats_get = eth_xstats_get,
+	.xstats_get_names = eth_xstats_get_names,
+	.xstats_reset = eth_xstats_reset,
 };
 
 static int
@@ -1066,6 +1318,18 @@ open_tx_pcap(const char *key, const char *value, void *extra_args)
 	return 0;
 }
 
+/*
+ * Stores the name of a pcap file to be opened by the buffered writer
+ * when the device is started.
+ */
+static int
+add_tx_pcap(const char *key, const char *value, void *extra_args)
+{
+	struct pmd_devargs *dumpers = extra_args;
+
+	return add_queue(dumpers, value, key, NULL, NULL);
+}
+
 /*
  * Opens an interface for reading and writing
  */
@@ -1186,6 +1450,60 @@ get_infinite_rx_arg(const char *key __rte_unused,
 	return 0;
 }
 
+static int
+get_bool_arg(const char *key, const char *value, void *extra_args)
+{
+	unsigned int *enable = extra_args;
+
+	if (value == NULL || extra_args == NULL)
+		return -EINVAL;
+
+	if (strcmp(value, "0") != 0 && strcmp(value, "1") != 0) {
+		PMD_LOG(ERR, "Invalid %s value: %s, expected 0 or 1",
+			key, value);
+		return -EINVAL;
+	}
+	*enable = value[0] == '1';
+	return 0;
+}
+
+static int
+get_replay_speed_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	double *replay_speed = extra_args;
+	char *end;
+
+	if (value == NULL || extra_args == NULL)
+		return -EINVAL;
+
+	errno = 0;
+	*replay_speed = strtod(value, &end);
+	if (errno != 0 || end == value || *end != '\0' ||
+			!(*replay_speed >= 0)) {
+		PMD_LOG(ERR, "Invalid replay speed: %s", value);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static int
+get_tx_rotate_size_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	uint64_t *rotate_size = extra_args;
+
+	if (value == NULL || extra_args == NULL)
+		return -EINVAL;
+
+	*rotate_size = rte_str_to_size(value);
+	if (*rotate_size == 0 && strcmp(value, "0") != 0) {
+		PMD_LOG(ERR, "Invalid file rotation size: %s", value);
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static int
 pmd_init_internals(struct rte_vdev_device *vdev,
 		const unsigned int nb_rx_queues,
@@ -1345,8 +1663,16 @@ eth_from_pcaps(struct rte_vdev_device *vdev,
 	}
 
 	internals->infinite_rx = infinite_rx;
+	internals->replay = devargs_all->replay;
+	internals->replay_speed = devargs_all->replay_speed;
+	internals->tx_bulk = devargs_all->tx_bulk;
+	internals->tx_direct = devargs_all->tx_direct;
+	internals->tx_rotate_size = devargs_all->tx_rotate_size;
+	internals->xstats_reset_cycles = rte_get_timer_cycles();
 	/* Assign rx ops. */
-	if (infinite_rx)
+	if (devargs_all->replay)
+		eth_dev->rx_pkt_burst = eth_pcap_rx_replay;
+	else if (infinite_rx)
 		eth_dev->rx_pkt_burst = eth_pcap_rx_infinite;
 	else if (devargs_all->is_rx_pcap || devargs_all->is_rx_iface ||
 			single_iface)
@@ -1355,7 +1681,9 @@ eth_from_pcaps(struct rte_vdev_device *vdev,
 		eth_dev->rx_pkt_burst = eth_null_rx;
 
 	/* Assign tx ops. */
-	if (devargs_all->is_tx_pcap)
+	if (devargs_all->is_tx_pcap && devargs_all->tx_bulk)
+		eth_dev->tx_pkt_burst = eth_pcap_tx_writer;
+	else if (devargs_all->is_tx_pcap)
 		eth_dev->tx_pkt_burst = eth_pcap_tx_dumper;
 	else if (devargs_all->is_tx_iface || single_iface)
 		eth_dev->tx_pkt_burst = eth_pcap_tx;
@@ -1409,6 +1737,11 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 		.is_tx_pcap = 0,
 		.is_tx_iface = 0,
 		.infinite_rx = 0,
+		.replay = 0,
+		.replay_speed = 0,
+		.tx_bulk = 0,
+		.tx_direct = 0,
+		.tx_rotate_size = 0,
 	};
 
 	name = rte_vdev_device_name(dev);
@@ -1512,6 +1845,28 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 					"for %s", name);
 		}
 
+		/*
+		 * We check whether we want to replay the pcap file from
+		 * a memory mapping, and at which pace.
+		 */
+		if (rte_kvargs_count(kvlist, ETH_PCAP_REPLAY_ARG) == 1) {
+			ret = rte_kvargs_process(kvlist, ETH_PCAP_REPLAY_ARG,
+					&get_bool_arg, &devargs_all.replay);
+			if (ret < 0)
+				goto free_kvlist;
+		}
+		if (rte_kvargs_count(kvlist, ETH_PCAP_REPLAY_SPEED_ARG) == 1) {
+			ret = rte_kvargs_process(kvlist,
+					ETH_PCAP_REPLAY_SPEED_ARG,
+					&get_replay_speed_arg,
+					&devargs_all.replay_speed);
+			if (ret < 0)
+				goto free_kvlist;
+		}
+		if (devargs_all.replay)
+			PMD_LOG(INFO, "replay has been enabled at speed %g for %s",
+					devargs_all.replay_speed, name);
+
 		ret = rte_kvargs_process(kvlist, ETH_PCAP_RX_PCAP_ARG,
 				&open_rx_pcap, &pcaps);
 	} else if (devargs_all.is_rx_iface) {
@@ -1545,8 +1900,42 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 	 * a pcap file, or drop packets on tx
 	 */
 	if (devargs_all.is_tx_pcap) {
-		ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_PCAP_ARG,
-				&open_tx_pcap, &dumpers);
+		/*
+		 * We check whether we want to write the pcap files through
+		 * a large buffer, directly to the disk and in several files.
+		 */
+		if (rte_kvargs_count(kvlist, ETH_PCAP_TX_BULK_ARG) == 1) {
+			ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_BULK_ARG,
+					&get_bool_arg, &devargs_all.tx_bulk);
+			if (ret < 0)
+				goto free_kvlist;
+		}
+		if (rte_kvargs_count(kvlist, ETH_PCAP_TX_DIRECT_ARG) == 1) {
+			ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_DIRECT_ARG,
+					&get_bool_arg, &devargs_all.tx_direct);
+			if (ret < 0)
+				goto free_kvlist;
+		}
+		if (rte_kvargs_count(kvlist, ETH_PCAP_TX_ROTATE_SIZE_ARG) == 1) {
+			ret = rte_kvargs_process(kvlist,
+					ETH_PCAP_TX_ROTATE_SIZE_ARG,
+					&get_tx_rotate_size_arg,
+					&devargs_all.tx_rotate_size);
+			if (ret < 0)
+				goto free_kvlist;
+		}
+		/* Direct writes and rotation are done by the writer */
+		if (devargs_all.tx_direct || devargs_all.tx_rotate_size != 0)
+			devargs_all.tx_bulk = 1;
+
+		if (devargs_all.tx_bulk) {
+			PMD_LOG(INFO, "tx_bulk has been enabled for %s", name);
+			ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_PCAP_ARG,
+					&add_tx_pcap, &dumpers);
+		} else {
+			ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_PCAP_ARG,
+					&open_tx_pcap, &dumpers);
+		}
 	} else if (devargs_all.is_tx_iface) {
 		ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_IFACE_ARG,
 				&open_tx_iface, &dumpers);
@@ -1652,4 +2041,9 @@ RTE_PMD_REGISTER_PARAM_STRING(net_pcap,
 	ETH_PCAP_TX_IFACE_ARG "=<ifc> "
 	ETH_PCAP_IFACE_ARG "=<ifc> "
 	ETH_PCAP_PHY_MAC_ARG "=<int>"
-	ETH_PCAP_INFINITE_RX_ARG "=<0|1>");
+	ETH_PCAP_INFINITE_RX_ARG "=<0|1> "
+	ETH_PCAP_REPLAY_ARG "=<0|1> "
+	ETH_PCAP_REPLAY_SPEED_ARG "=<float> "
+	ETH_PCAP_TX_BULK_ARG "=<0|1> "
+	ETH_PCAP_TX_DIRECT_ARG "=<0|1> "
+	ETH_PCAP_TX_ROTATE_SIZE_ARG "=<size>");
@@ -0,0 +1,501 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <unistd.h>
+#endif
+
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_eal_paging.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_os_shim.h>
+
+#include "pcap_osdep.h"
+#include "pcap_replay.h"
+
+#define PCAP_MAGIC_USEC 0xa1b2c3d4
+#define PCAP_MAGIC_NSEC 0xa1b23c4d
+#define PCAP_FILE_HDR_LEN 24
+#define PCAP_PKT_HDR_LEN 16
+
+#define PCAPNG_BLOCK_SHB 0x0a0d0d0a
+#define PCAPNG_BLOCK_IDB 0x00000001
+#define PCAPNG_BLOCK_SPB 0x00000003
+#define PCAPNG_BLOCK_EPB 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1a2b3c4d
+#define PCAPNG_OPT_END 0
+#define PCAPNG_OPT_IF_TSRESOL 9
+#define PCAPNG_TSRESOL_POW2 0x80
+#define PCAPNG_TSRESOL_DEFAULT 6
+
+/* Interfaces of a pcapng section with a known timestamp resolution */
+#define PCAP_REPLAY_IF_MAX 64U
+
+/*
+ * The mapping is split in chunks, each with its own external buffer
+ * reference counter: a single 16-bit counter for the whole file would
+ * overflow with as many packets in flight.
+ */
+#define PCAP_REPLAY_CHUNK_SHIFT 19
+
+/*
+ * References of a chunk above which its packets are copied: when a looped
+ * file is replayed faster than the mbufs are freed, the counter would wrap.
+ */
+#define PCAP_REPLAY_CHUNK_REFCNT_MAX (UINT16_MAX - 1)
+
+enum pcap_replay_format {
+	PCAP_REPLAY_PCAP,
+	PCAP_REPLAY_PCAPNG,
+};
+
+/* Conversion of timestamp ticks to nanoseconds */
+struct pcap_replay_tsres {
+	uint64_t mul;
+	uint64_t div;
+	uint8_t shift;                  /* Power of 2 resolution if not 0 */
+};
+
+struct pcap_replay {
+	uint8_t *base;                  /* File mapping */
+	size_t size;                    /* Mapping size */
+	size_t pos;                     /* Offset of the next record */
+	size_t start;                   /* Offset of the first record */
+	enum pcap_replay_format format;
+	bool swapped;                   /* Byte order differs from the host */
+	bool loop;                      /* Restart at the end of the file */
+
+	struct pcap_replay_pkt pkt;     /* Pending packet */
+	size_t pkt_pos;                 /* Offset of the pending packet record */
+	size_t pkt_next;                /* Offset of the record after it */
+	bool pkt_valid;                 /* Pending packet is parsed */
+	uint64_t nb_loop_pkts;          /* Packets consumed since the start */
+
+	struct pcap_replay_tsres tsres; /* pcap file resolution */
+	struct pcap_replay_tsres if_tsres[PCAP_REPLAY_IF_MAX];
+	uint32_t nb_ifs;                /* Interfaces of the pcapng section */
+
+	double cycles_per_ns;           /* Pacing rate, 0 if disabled */
+	uint64_t first_ts;              /* Timestamp of the first packet */
+	uint64_t first_cycles;          /* Cycles when it is due */
+	uint64_t deadline;              /* Cycles when the pending one is due */
+	bool ts_set;                    /* first_ts is set */
+	bool cycles_set;                /* first_cycles is set */
+
+	uint32_t nb_chunks_live;        /* Chunks with references */
+	uint32_t nb_chunks;
+	struct rte_mbuf_ext_shared_info chunks[];
+};
+
+static void
+pcap_replay_tsres_set(struct pcap_replay_tsres *tsres, uint8_t tsresol)
+{
+	uint8_t exp = tsresol & ~PCAPNG_TSRESOL_POW2;
+
+	tsres->mul = 1;
+	tsres->div = 1;
+	tsres->shift = 0;
+	if (tsresol & PCAPNG_TSRESOL_POW2) {
+		tsres->shift = RTE_MAX(exp, 1);
+		return;
+	}
+	/* 10^19 is the largest power of 10 fitting 64 bits */
+	exp = RTE_MIN(exp, 19);
+	for (; exp < 9; exp++)
+		tsres->mul *= 10;
+	for (; exp > 9; exp--)
+		tsres->div *= 10;
+}
+
+static uint64_t
+pcap_replay_ts_to_ns(const struct pcap_replay_tsres *tsres, uint64_t ticks)
+{
+	unsigned int shift = tsres->shift;
+
+	if (shift == 0)
+		return ticks * tsres->mul / tsres->div;
+	/* Keep the product of the fractional part within 64 bits */
+	if (shift > 30) {
+		ticks >>= shift - 30;
+		shift = 30;
+	}
+	return (ticks >> shift) * NS_PER_S +
+		(((ticks & ((UINT64_C(1) << shift) - 1)) * NS_PER_S) >> shift);
+}
+
+static uint16_t
+pcap_replay_read16(const struct pcap_replay *replay, size_t off)
+{
+	uint16_t v;
+
+	memcpy(&v, replay->base + off, sizeof(v));
+	return replay->swapped ? rte_bswap16(v) : v;
+}
+
+static uint32_t
+pcap_replay_read32(const struct pcap_replay *replay, size_t off)
+{
+	uint32_t v;
+
+	memcpy(&v, replay->base + off, sizeof(v));
+	return replay->swapped ? rte_bswap32(v) : v;
+}
+
+/* Parse the packet record at the current position. */
+static bool
+pcap_replay_parse_pcap(struct pcap_replay *replay)
+{
+	size_t pos = replay->pos;
+	uint32_t caplen;
+
+	if (replay->size - pos < PCAP_PKT_HDR_LEN)
+		return false;
+	caplen = pcap_replay_read32(replay, pos + 8);
+	if (replay->size - pos - PCAP_PKT_HDR_LEN < caplen)
+		return false;
+
+	replay->pkt.ts = (uint64_t)pcap_replay_read32(replay, pos) * NS_PER_S +
+		pcap_replay_ts_to_ns(&replay->tsres,
+			pcap_replay_read32(replay, pos + 4));
+	replay->pkt.data = replay->base + pos + PCAP_PKT_HDR_LEN;
+	replay->pkt.caplen = caplen;
+	replay->pkt_pos = pos;
+	replay->pkt_next = pos + PCAP_PKT_HDR_LEN + caplen;
+	return true;
+}
+
+/* Parse the options of an interface description block. */
+static void
+pcap_replay_parse_idb(struct pcap_replay *replay, size_t pos, uint32_t len)
+{
+	struct pcap_replay_tsres *tsres;
+	size_t end = pos + len - 4;
+	uint16_t code;
+	uint16_t opt_len;
+
+	if (replay->nb_ifs >= PCAP_REPLAY_IF_MAX) {
+		replay->nb_ifs++;
+		return;
+	}
+	tsres = &replay->if_tsres[replay->nb_ifs++];
+	pcap_replay_tsres_set(tsres, PCAPNG_TSRESOL_DEFAULT);
+
+	for (pos += 16; end - pos >= 4; pos += 4 + RTE_ALIGN(opt_len, 4)) {
+		code = pcap_replay_read16(replay, pos);
+		opt_len = pcap_replay_read16(replay, pos + 2);
+		if (code == PCAPNG_OPT_END || end - pos - 4 < opt_len)
+			break;
+		if (code == PCAPNG_OPT_IF_TSRESOL && opt_len == 1)
+			pcap_replay_tsres_set(tsres, replay->base[pos + 4]);
+	}
+}
+
+/* Parse blocks from the current position up to the next packet. */
+static bool
+pcap_replay_parse_pcapng(struct pcap_replay *replay)
+{
+	const struct pcap_replay_tsres *tsres;
+	size_t pos = replay->pos;
+	uint32_t bom;
+	uint32_t type;
+	uint32_t len;
+	uint32_t caplen;
+	uint32_t ifid;
+	uint64_t ticks;
+
+	for (;; pos += len) {
+		if (replay->size - pos < 12)
+			return false;
+		type = pcap_replay_read32(replay, pos);
+		if (type == PCAPNG_BLOCK_SHB) {
+			if (replay->size - pos < 16)
+				return false;
+			memcpy(&bom, replay->base + pos + 8, sizeof(bom));
+			if (bom == PCAPNG_BYTE_ORDER_MAGIC)
+				replay->swapped = false;
+			else if (bom == rte_bswap32(PCAPNG_BYTE_ORDER_MAGIC))
+				replay->swapped = true;
+			else
+				return false;
+			replay->nb_ifs = 0;
+		}
+		len = pcap_replay_read32(replay, pos + 4);
+		if (len < 12 || len % 4 != 0 || replay->size - pos < len)
+			return false;
+
+		switch (type) {
+		case PCAPNG_BLOCK_IDB:
+			if (len < 20)
+				return false;
+			pcap_replay_parse_idb(replay, pos, len);
+			break;
+		case PCAPNG_BLOCK_EPB:
+			if (len < 32)
+				return false;
+			caplen = pcap_replay_read32(replay, pos + 20);
+			if (len - 32 < caplen)
+				return false;
+			ifid = pcap_replay_read32(replay, pos + 8);
+			ticks = (uint64_t)pcap_replay_read32(replay, pos + 12) << 32 |
+				pcap_replay_read32(replay, pos + 16);
+			tsres = ifid < RTE_MIN(replay->nb_ifs, PCAP_REPLAY_IF_MAX) ?
+				&replay->if_tsres[ifid] : &replay->tsres;
+			replay->pkt.ts = pcap_replay_ts_to_ns(tsres, ticks);
+			replay->pkt.data = replay->base + pos + 28;
+			replay->pkt.caplen = caplen;
+			replay->pkt_pos = pos;
+			replay->pkt_next = pos + len;
+			return true;
+		case PCAPNG_BLOCK_SPB:
+			if (len < 16)
+				return false;
+			/* No timestamp, keep the one of the previous packet */
+			replay->pkt.data = replay->base + pos + 12;
+			replay->pkt.caplen = RTE_MIN(len - 16,
+				pcap_replay_read32(replay, pos + 8));
+			replay->pkt_pos = pos;
+			replay->pkt_next = pos + len;
+			return true;
+		default:
+			break;
+		}
+	}
+}
+
+static bool
+pcap_replay_parse(struct pcap_replay *replay)
+{
+	if (replay->format == PCAP_REPLAY_PCAP)
+		return pcap_replay_parse_pcap(replay);
+	return pcap_replay_parse_pcapng(replay);
+}
+
+static void
+pcap_replay_free(struct pcap_replay *replay)
+{
+	rte_mem_unmap(replay->base, replay->size);
+	rte_free(replay);
+}
+
+static void
+pcap_replay_chunk_release(struct pcap_replay *replay)
+{
+	if (__atomic_sub_fetch(&replay->nb_chunks_live, 1,
+			__ATOMIC_ACQ_REL) == 0)
+		pcap_replay_free(replay);
+}
+
+/* Called when the last mbuf attached to a chunk is freed. */
+static void
+pcap_replay_chunk_free_cb(void *addr __rte_unused, void *opaque)
+{
+	pcap_replay_chunk_release(opaque);
+}
+
+struct pcap_replay *
+pcap_replay_open(const char *filename, double speed, bool loop)
+{
+	struct pcap_replay *replay;
+	struct stat st;
+	uint32_t nb_chunks;
+	uint32_t magic;
+	uint8_t *base;
+	uint32_t i;
+	int fd;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		PMD_LOG(ERR, "Couldn't open %s: %s", filename, strerror(errno));
+		return NULL;
+	}
+	if (fstat(fd, &st) < 0) {
+		PMD_LOG(ERR, "Couldn't stat %s: %s", filename, strerror(errno));
+		close(fd);
+		return NULL;
+	}
+	if ((uint64_t)st.st_size < sizeof(magic) ||
+			(uint64_t)st.st_size > SIZE_MAX) {
+		PMD_LOG(ERR, "Invalid size of %s", filename);
+		close(fd);
+		return NULL;
+	}
+
+	/* Private mapping so that applications may modify packets in place */
+	base = rte_mem_map(NULL, st.st_size, RTE_PROT_READ | RTE_PROT_WRITE,
+			RTE_MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == NULL) {
+		PMD_LOG(ERR, "Couldn't map %s: %s", filename,
+			rte_strerror(rte_errno));
+		return NULL;
+	}
+
+	nb_chunks = ((st.st_size - 1) >> PCAP_REPLAY_CHUNK_SHIFT) + 1;
+	replay = rte_zmalloc("pcap_replay", sizeof(*replay) +
+			nb_chunks * sizeof(replay->chunks[0]), 0);
+	if (replay == NULL) {
+		PMD_LOG(ERR, "Couldn't allocate replay of %s", filename);
+		rte_mem_unmap(base, st.st_size);
+		return NULL;
+	}
+	replay->base = base;
+	replay->size = st.st_size;
+	replay->loop = loop;
+
+	memcpy(&magic, base, sizeof(magic));
+	switch (magic) {
+	case PCAP_MAGIC_USEC:
+	case RTE_STATIC_BSWAP32(PCAP_MAGIC_USEC):
+		pcap_replay_tsres_set(&replay->tsres, 6);
+		break;
+	case PCAP_MAGIC_NSEC:
+	case RTE_STATIC_BSWAP32(PCAP_MAGIC_NSEC):
+		pcap_replay_tsres_set(&replay->tsres, 9);
+		break;
+	case PCAPNG_BLOCK_SHB:
+		replay->format = PCAP_REPLAY_PCAPNG;
+		/* Packets of unknown interfaces */
+		pcap_replay_tsres_set(&replay->tsres, PCAPNG_TSRESOL_DEFAULT);
+		break;
+	default:
+		PMD_LOG(ERR, "%s is neither a pcap nor a pcapng file",
+			filename);
+		pcap_replay_free(replay);
+		return NULL;
+	}
+	if (replay->format == PCAP_REPLAY_PCAP) {
+		if (replay->size < PCAP_FILE_HDR_LEN) {
+			PMD_LOG(ERR, "Truncated header of %s", filename);
+			pcap_replay_free(replay);
+			return NULL;
+		}
+		replay->swapped = magic != PCAP_MAGIC_USEC &&
+			magic != PCAP_MAGIC_NSEC;
+		replay->start = PCAP_FILE_HDR_LEN;
+	}
+	replay->pos = replay->start;
+
+	/* Speed 2 plays twice as fast as recorded, 0 disables pacing */
+	if (speed > 0)
+		replay->cycles_per_ns = (double)rte_get_timer_hz() /
+			NS_PER_S / speed;
+
+	/* The queue holds a reference of every chunk until closed */
+	replay->nb_chunks = nb_chunks;
+	replay->nb_chunks_live = nb_chunks;
+	for (i = 0; i < nb_chunks; i++) {
+		replay->chunks[i].free_cb = pcap_replay_chunk_free_cb;
+		replay->chunks[i].fcb_opaque = replay;
+		rte_mbuf_ext_refcnt_set(&replay->chunks[i], 1);
+	}
+
+	return replay;
+}
+
+/*
+ * Drop the references of the queue. The mapping is released once
+ * the mbufs attached to it are freed as well.
+ */
+void
+pcap_replay_close(struct pcap_replay *replay)
+{
+	uint32_t i;
+
+	for (i = 0; i < replay->nb_chunks; i++)
+		if (rte_mbuf_ext_refcnt_update(&replay->chunks[i], -1) == 0)
+			pcap_replay_chunk_release(replay);
+}
+
+/*
+ * Get the next packet if it is due at cycles "now",
+ * NULL if it is not yet or if the replay is over.
+ */
+const struct pcap_replay_pkt *
+pcap_replay_peek(struct pcap_replay *replay, uint64_t now)
+{
+	uint64_t deadline;
+
+	if (!replay->pkt_valid) {
+		if (!pcap_replay_parse(replay)) {
+			/* Don't spin on a file without packets */
+			if (!replay->loop || replay->nb_loop_pkts == 0)
+				return NULL;
+			replay->pos = replay->start;
+			replay->nb_loop_pkts = 0;
+			/* Next loop starts right after the last packet */
+			replay->first_cycles = replay->deadline;
+			replay->ts_set = false;
+			if (!pcap_replay_parse(replay))
+				return NULL;
+		}
+		replay->pkt_valid = true;
+
+		if (replay->cycles_per_ns > 0) {
+			if (!replay->cycles_set) {
+				replay->first_cycles = now;
+				replay->cycles_set = true;
+			}
+			if (!replay->ts_set) {
+				replay->first_ts = replay->pkt.ts;
+				replay->ts_set = true;
+			}
+			deadline = replay->first_cycles;
+			/* Packets out of order are sent right away */
+			if (replay->pkt.ts > replay->first_ts)
+				deadline += (replay->pkt.ts - replay->first_ts) *
+					replay->cycles_per_ns;
+			replay->deadline = deadline;
+		}
+	}
+
+	if (replay->cycles_per_ns > 0 && now < replay->deadline)
+		return NULL;
+	return &replay->pkt;
+}
+
+/*
+ * Attach the packet returned by the last peek to an mbuf, or copy it
+ * if its chunk has too many references, and move to the next one.
+ * Return -ENOBUFS, keeping the packet pending, if it cannot be copied.
+ */
+int
+pcap_replay_attach(struct pcap_replay *replay, struct rte_mbuf *mbuf)
+{
+	struct rte_mbuf_ext_shared_info *shinfo;
+	uint32_t caplen = replay->pkt.caplen;
+
+	shinfo = &replay->chunks[replay->pkt_pos >> PCAP_REPLAY_CHUNK_SHIFT];
+	if (caplen <= UINT16_MAX &&
+			unlikely(rte_mbuf_ext_refcnt_read(shinfo) >=
+				PCAP_REPLAY_CHUNK_REFCNT_MAX) &&
+			rte_pktmbuf_tailroom(mbuf) < caplen)
+		return -ENOBUFS;
+
+	replay->pkt_valid = false;
+	replay->pos = replay->pkt_next;
+	replay->nb_loop_pkts++;
+	if (caplen > UINT16_MAX)
+		return -EINVAL;
+
+	if (unlikely(rte_mbuf_ext_refcnt_read(shinfo) >=
+			PCAP_REPLAY_CHUNK_REFCNT_MAX)) {
+		memcpy(rte_pktmbuf_mtod(mbuf, void *), replay->pkt.data,
+				caplen);
+	} else {
+		rte_mbuf_ext_refcnt_update(shinfo, 1);
+		rte_pktmbuf_attach_extbuf(mbuf, replay->pkt.data,
+				RTE_BAD_IOVA, caplen, shinfo);
+	}
+	mbuf->data_len = caplen;
+	mbuf->pkt_len = caplen;
+
+	return 0;
+}
@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#ifndef _PCAP_REPLAY_H_
+#define _PCAP_REPLAY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <rte_mbuf.h>
+
+/* Replay of a memory-mapped pcap or pcapng file */
+struct pcap_replay;
+
+/* Next packet of a replayed file */
+struct pcap_replay_pkt {
+	uint8_t *data;                  /* Packet data, in the file mapping */
+	uint32_t caplen;                /* Captured length */
+	uint64_t ts;                    /* Capture timestamp in nanoseconds */
+};
+
+struct pcap_replay *pcap_replay_open(const char *filename, double speed,
+		bool loop);
+void pcap_replay_close(struct pcap_replay *replay);
+const struct pcap_replay_pkt *pcap_replay_peek(struct pcap_replay *replay,
+		uint64_t now);
+int pcap_replay_attach(struct pcap_replay *replay, struct rte_mbuf *mbuf);
+
+#endif /* _PCAP_REPLAY_H_ */
@@ -0,0 +1,300 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <unistd.h>
+#endif
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_os_shim.h>
+
+#include "pcap_osdep.h"
+#include "pcap_writer.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#define PCAP_MAGIC_NSEC 0xa1b23c4d
+#define PCAP_VERSION_MAJOR 2
+#define PCAP_VERSION_MINOR 4
+#define PCAP_LINKTYPE_ETHERNET 1
+#define PCAP_SNAPLEN 65535
+
+/* Large enough to amortize write syscalls over thousands of packets */
+#define PCAP_WRITER_BUF_SIZE (4 << 20)
+/* Alignment of the buffer and of direct writes */
+#define PCAP_WRITER_ALIGN 4096
+/* Maximum time records stay in the buffer of a polled queue */
+#define PCAP_WRITER_FLUSH_MS 100
+
+struct pcap_file_hdr {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	int32_t thiszone;
+	uint32_t sigfigs;
+	uint32_t snaplen;
+	uint32_t linktype;
+};
+
+struct pcap_pkt_hdr {
+	uint32_t sec;
+	uint32_t nsec;
+	uint32_t caplen;
+	uint32_t len;
+};
+
+struct pcap_writer {
+	int fd;
+	bool direct;                    /* File is opened with O_DIRECT */
+	bool failed;                    /* Write error, packets are dropped */
+	uint64_t rotate_size;           /* Maximum file size, 0 if unlimited */
+	uint64_t file_len;              /* Bytes written to the current file */
+	uint32_t file_idx;              /* Index of the current file */
+	uint8_t *buf;                   /* Records not written yet */
+	size_t buf_len;
+	uint32_t buf_pkts;              /* Records added since the last write */
+	uint64_t flush_cycles;          /* Last write */
+	uint64_t flush_period;          /* Maximum cycles between writes */
+	struct pcap_writer_stats *stats;
+	char name[PATH_MAX];            /* File name, before rotation suffix */
+};
+
+/* Open the file of the current index and buffer its header. */
+static int
+pcap_writer_file_open(struct pcap_writer *writer)
+{
+	struct pcap_file_hdr hdr = {
+		.magic = PCAP_MAGIC_NSEC,
+		.version_major = PCAP_VERSION_MAJOR,
+		.version_minor = PCAP_VERSION_MINOR,
+		.snaplen = PCAP_SNAPLEN,
+		.linktype = PCAP_LINKTYPE_ETHERNET,
+	};
+	char name[PATH_MAX + 16];
+	int flags = O_WRONLY | O_CREAT | O_TRUNC | O_BINARY;
+
+#ifdef O_DIRECT
+	if (writer->direct)
+		flags |= O_DIRECT;
+#endif
+	/* Rotated files are suffixed with their index */
+	if (writer->file_idx == 0)
+		strlcpy(name, writer->name, sizeof(name));
+	else
+		snprintf(name, sizeof(name), "%s.%u", writer->name,
+			writer->file_idx);
+
+	writer->fd = open(name, flags, 0644);
+	if (writer->fd < 0) {
+		PMD_LOG(ERR, "Couldn't open %s for writing: %s", name,
+			strerror(errno));
+		return -1;
+	}
+
+	memcpy(writer->buf + writer->buf_len, &hdr, sizeof(hdr));
+	writer->buf_len += sizeof(hdr);
+	writer->file_len = 0;
+	writer->stats->files++;
+	return 0;
+}
+
+/*
+ * Write the buffer to the file. Direct writes leave the unaligned tail
+ * in the buffer unless the file is about to be closed.
+ */
+static int
+pcap_writer_flush(struct pcap_writer *writer, bool last)
+{
+	size_t len = writer->buf_len;
+	size_t off = 0;
+	ssize_t ret;
+
+	writer->flush_cycles = rte_get_timer_cycles();
+	if (writer->failed)
+		return -1;
+
+#ifdef O_DIRECT
+	if (writer->direct) {
+		if (!last) {
+			len = RTE_ALIGN_FLOOR(len, PCAP_WRITER_ALIGN);
+		} else if (len % PCAP_WRITER_ALIGN != 0) {
+			/* The file ends with this write */
+			fcntl(writer->fd, F_SETFL,
+				fcntl(writer->fd, F_GETFL) & ~O_DIRECT);
+		}
+	}
+#endif
+	if (len == 0)
+		return 0;
+
+	while (off < len) {
+		ret = write(writer->fd, writer->buf + off, len - off);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			PMD_LOG(ERR, "Couldn't write %s: %s, dropping packets",
+				writer->name, strerror(errno));
+			/* Records in the tail of direct writes are not counted */
+			writer->stats->dropped += writer->buf_pkts;
+			writer->buf_pkts = 0;
+			writer->buf_len = 0;
+			writer->failed = true;
+			return -1;
+		}
+		off += ret;
+	}
+
+	writer->buf_len -= len;
+	if (writer->buf_len != 0)
+		memmove(writer->buf, writer->buf + len, writer->buf_len);
+	writer->buf_pkts = 0;
+	writer->file_len += len;
+	writer->stats->bytes += len;
+	return 0;
+}
+
+static void
+pcap_writer_file_close(struct pcap_writer *writer)
+{
+	pcap_writer_flush(writer, true);
+	close(writer->fd);
+	writer->fd = -1;
+}
+
+struct pcap_writer *
+pcap_writer_open(const char *filename, bool direct, uint64_t rotate_size,
+		struct pcap_writer_stats *stats, int socket_id)
+{
+	struct pcap_writer *writer;
+
+#ifndef O_DIRECT
+	if (direct) {
+		PMD_LOG(ERR, "Direct writes are not supported");
+		return NULL;
+	}
+#endif
+	writer = rte_zmalloc_socket("pcap_writer", sizeof(*writer), 0,
+			socket_id);
+	if (writer == NULL) {
+		PMD_LOG(ERR, "Couldn't allocate writer of %s", filename);
+		return NULL;
+	}
+	writer->buf = rte_malloc_socket("pcap_writer_buf",
+			PCAP_WRITER_BUF_SIZE, PCAP_WRITER_ALIGN, socket_id);
+	if (writer->buf == NULL) {
+		PMD_LOG(ERR, "Couldn't allocate buffer of %s", filename);
+		rte_free(writer);
+		return NULL;
+	}
+	strlcpy(writer->name, filename, sizeof(writer->name));
+	writer->direct = direct;
+	writer->rotate_size = rotate_size;
+	writer->stats = stats;
+	writer->flush_cycles = rte_get_timer_cycles();
+	writer->flush_period = rte_get_timer_hz() * PCAP_WRITER_FLUSH_MS / 1000;
+
+	if (pcap_writer_file_open(writer) < 0) {
+		rte_free(writer->buf);
+		rte_free(writer);
+		return NULL;
+	}
+
+	return writer;
+}
+
+void
+pcap_writer_close(struct pcap_writer *writer)
+{
+	if (writer->fd >= 0)
+		pcap_writer_file_close(writer);
+	rte_free(writer->buf);
+	rte_free(writer);
+}
+
+/*
+ * Buffer the record of a packet, copying its segments.
+ * Return the captured length, or a negative value if the packet is dropped.
+ */
+int
+pcap_writer_write(struct pcap_writer *writer, const struct rte_mbuf *mbuf,
+		uint32_t sec, uint32_t nsec)
+{
+	struct pcap_pkt_hdr hdr;
+	uint32_t caplen = RTE_MIN(rte_pktmbuf_pkt_len(mbuf),
+			(uint32_t)PCAP_SNAPLEN);
+	size_t rec_len = sizeof(hdr) + caplen;
+	const struct rte_mbuf *seg;
+	uint8_t *dst;
+	uint32_t len;
+	uint32_t left;
+
+	if (unlikely(writer->failed)) {
+		writer->stats->dropped++;
+		return -EIO;
+	}
+
+	/* Start a new file rather than exceed the size limit */
+	if (writer->rotate_size != 0 &&
+			writer->file_len + writer->buf_len + rec_len >
+				writer->rotate_size &&
+			writer->file_len + writer->buf_len >
+				sizeof(struct pcap_file_hdr)) {
+		pcap_writer_file_close(writer);
+		writer->file_idx++;
+		if (writer->failed || pcap_writer_file_open(writer) < 0) {
+			writer->failed = true;
+			writer->stats->dropped++;
+			return -EIO;
+		}
+	}
+
+	if (PCAP_WRITER_BUF_SIZE - writer->buf_len < rec_len &&
+			pcap_writer_flush(writer, false) < 0) {
+		writer->stats->dropped++;
+		return -EIO;
+	}
+
+	hdr.sec = sec;
+	hdr.nsec = nsec;
+	hdr.caplen = caplen;
+	hdr.len = rte_pktmbuf_pkt_len(mbuf);
+	dst = writer->buf + writer->buf_len;
+	memcpy(dst, &hdr, sizeof(hdr));
+	dst += sizeof(hdr);
+
+	for (seg = mbuf, left = caplen; seg != NULL && left != 0;
+			seg = seg->next) {
+		len = RTE_MIN(seg->data_len, left);
+		memcpy(dst, rte_pktmbuf_mtod(seg, const void *), len);
+		dst += len;
+		left -= len;
+	}
+
+	writer->buf_len += rec_len;
+	writer->buf_pkts++;
+	return caplen;
+}
+
+/*
+ * Write the buffer if records stayed there for too long,
+ * in case no more packets are coming.
+ */
+void
+pcap_writer_poll(struct pcap_writer *writer)
+{
+	if (writer->buf_len != 0 &&
+			rte_get_timer_cycles() - writer->flush_cycles >
+				writer->flush_period)
+		pcap_writer_flush(writer, false);
+}
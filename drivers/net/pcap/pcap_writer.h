@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#ifndef _PCAP_WRITER_H_
+#define _PCAP_WRITER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <rte_mbuf.h>
+
+/* Buffered writer of a pcap file with nanosecond timestamps */
+struct pcap_writer;
+
+/* Statistics of a writer, kept across reopening */
+struct pcap_writer_stats {
+	uint64_t bytes;                 /* Bytes written to files */
+	uint64_t dropped;               /* Packets lost on write errors */
+	uint64_t files;                 /* Files opened */
+};
+
+struct pcap_writer *pcap_writer_open(const char *filename, bool direct,
+		uint64_t rotate_size, struct pcap_writer_stats *stats,
+		int socket_id);
+void pcap_writer_close(struct pcap_writer *writer);
+int pcap_writer_write(struct pcap_writer *writer, const struct rte_mbuf *mbuf,
+		uint32_t sec, uint32_t nsec);
+void pcap_writer_poll(struct pcap_writer *writer);
+
+#endif /* _PCAP_WRITER_H_ */
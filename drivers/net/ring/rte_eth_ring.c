@@ -11,6 +11,9 @@
 #include <rte_bus_vdev.h>
 #include <rte_kvargs.h>
 #include <rte_errno.h>
+#include <rte_hash_crc.h>
+#include <rte_ip.h>
+#include <rte_net.h>
 
 #define ETH_RING_NUMA_NODE_ACTION_ARG	"nodeaction"
 #define ETH_RING_ACTION_CREATE		"CREATE"
@@ -38,10 +41,16 @@ enum dev_action {
 	DEV_ATTACH
 };
 
+/* Number of packets distributed to the Tx rings at once */
+#define ETH_RING_TX_DISTRIBUTE_BURST	32
+
+struct pmd_internals;
+
 struct ring_queue {
 	struct rte_ring *rng;
 	rte_atomic64_t rx_pkts;
 	rte_atomic64_t tx_pkts;
+	struct pmd_internals *internals;
 };
 
 struct pmd_internals {
@@ -53,6 +62,8 @@ struct pmd_internals {
 
 	struct rte_ether_addr address;
 	enum dev_action action;
+	/* Tx queues spread the packets over all the Tx rings */
+	bool tx_distribute;
 };
 
 static struct rte_eth_link pmd_link = {
@@ -96,8 +107,150 @@ eth_ring_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 	return nb_tx;
 }
 
+/*
+ * Hash of the flow of a packet: the RSS hash if it was received with one,
+ * else a CRC of its IP addresses and, for TCP, UDP and SCTP, ports.
+ */
+static uint32_t
+eth_ring_flow_hash(const struct rte_mbuf *m)
+{
+	struct rte_net_hdr_lens hdr_lens;
+	uint32_t ptype, l4_ptype, off;
+	uint32_t hash = 0;
+
+	if (m->ol_flags & RTE_MBUF_F_RX_RSS_HASH)
+		return m->hash.rss;
+
+	ptype = rte_net_get_ptype(m, &hdr_lens, RTE_PTYPE_L2_MASK |
+			RTE_PTYPE_L3_MASK | RTE_PTYPE_L4_MASK);
+	off = hdr_lens.l2_len;
+
+	if (RTE_ETH_IS_IPV4_HDR(ptype)) {
+		const struct rte_ipv4_hdr *ip;
+		struct rte_ipv4_hdr ip_copy;
+
+		ip = rte_pktmbuf_read(m, off, sizeof(*ip), &ip_copy);
+		if (ip == NULL)
+			return 0;
+		hash = rte_hash_crc_4byte(ip->src_addr, hash);
+		hash = rte_hash_crc_4byte(ip->dst_addr, hash);
+	} else if (RTE_ETH_IS_IPV6_HDR(ptype)) {
+		const struct rte_ipv6_hdr *ip6;
+		struct rte_ipv6_hdr ip6_copy;
+
+		ip6 = rte_pktmbuf_read(m, off, sizeof(*ip6), &ip6_copy);
+		if (ip6 == NULL)
+			return 0;
+		hash = rte_hash_crc(ip6->src_addr, sizeof(ip6->src_addr) +
+				sizeof(ip6->dst_addr), hash);
+	} else {
+		return 0;
+	}
+
+	l4_ptype = ptype & RTE_PTYPE_L4_MASK;
+	if (l4_ptype == RTE_PTYPE_L4_TCP || l4_ptype == RTE_PTYPE_L4_UDP ||
+			l4_ptype == RTE_PTYPE_L4_SCTP) {
+		const uint32_t *ports;
+		uint32_t ports_copy;
+
+		/* The ports are the first 4 bytes of the L4 header */
+		ports = rte_pktmbuf_read(m, off + hdr_lens.l3_len,
+				sizeof(*ports), &ports_copy);
+		if (ports != NULL)
+			hash = rte_hash_crc_4byte(*ports, hash);
+	}
+
+	return hash;
+}
+
+/*
+ * Spread the packets over all the Tx rings of the port, by flow hash, so
+ * that each ring can be consumed by a different core while the packets of
+ * a flow stay in order. As for rte_eth_tx_burst(), the packets which are
+ * not sent are moved at the end of bufs.
+ */
+static uint16_t
+eth_ring_tx_distribute(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
+{
+	struct ring_queue *r = q;
+	struct pmd_internals *internals = r->internals;
+	const unsigned int nb_rings = internals->max_tx_queues;
+	struct rte_mbuf *ring_bufs[RTE_PMD_RING_MAX_TX_RINGS]
+			[ETH_RING_TX_DISTRIBUTE_BURST];
+	struct rte_mbuf *unsent[ETH_RING_TX_DISTRIBUTE_BURST];
+	uint16_t nb_ring_bufs[RTE_PMD_RING_MAX_TX_RINGS];
+	uint16_t nb_tx = 0, nb_unsent = 0;
+	uint16_t i, j, n, burst;
+	unsigned int ring;
+
+	for (i = 0; i < nb_bufs; i += burst) {
+		burst = RTE_MIN(nb_bufs - i, ETH_RING_TX_DISTRIBUTE_BURST);
+
+		memset(nb_ring_bufs, 0, sizeof(nb_ring_bufs[0]) * nb_rings);
+		for (j = 0; j < burst; j++) {
+			ring = eth_ring_flow_hash(bufs[i + j]) % nb_rings;
+			ring_bufs[ring][nb_ring_bufs[ring]++] = bufs[i + j];
+		}
+
+		/* The sent packets are stored back in the part of bufs
+		 * already distributed.
+		 */
+		for (ring = 0; ring < nb_rings; ring++) {
+			if (nb_ring_bufs[ring] == 0)
+				continue;
+
+			n = (uint16_t)rte_ring_enqueue_burst(
+					internals->tx_ring_queues[ring].rng,
+					(void **)ring_bufs[ring],
+					nb_ring_bufs[ring], NULL);
+			for (j = 0; j < n; j++)
+				bufs[nb_tx++] = ring_bufs[ring][j];
+			for (; j < nb_ring_bufs[ring]; j++)
+				unsent[nb_unsent++] = ring_bufs[ring][j];
+		}
+
+		if (unlikely(nb_unsent != 0)) {
+			memcpy(&bufs[nb_tx], unsent,
+					sizeof(unsent[0]) * nb_unsent);
+			break;
+		}
+	}
+
+	r->tx_pkts.cnt += nb_tx;
+	return nb_tx;
+}
+
+static int
+eth_ring_tx_distribute_check(struct rte_eth_dev *dev)
+{
+	struct pmd_internals *internals = dev->data->dev_private;
+	unsigned int i;
+
+	if (dev->data->nb_tx_queues <= 1)
+		return 0;
+
+	/* Each Tx queue sends to all the rings. */
+	for (i = 0; i < internals->max_tx_queues; i++) {
+		if (rte_ring_is_prod_single(internals->tx_ring_queues[i].rng)) {
+			PMD_LOG(ERR, "Tx ring %u is single producer, cannot distribute %u Tx queues",
+				i, dev->data->nb_tx_queues);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
 static int
-eth_dev_configure(struct rte_eth_dev *dev __rte_unused) { return 0; }
+eth_dev_configure(struct rte_eth_dev *dev)
+{
+	struct pmd_internals *internals = dev->data->dev_private;
+
+	if (internals->tx_distribute)
+		return eth_ring_tx_distribute_check(dev);
+
+	return 0;
+}
 
 static int
 eth_dev_start(struct rte_eth_dev *dev)
@@ -375,6 +528,7 @@ do_eth_dev_ring_create(const char *name,
 	}
 	for (i = 0; i < nb_tx_queues; i++) {
 		internals->tx_ring_queues[i].rng = tx_queues[i];
+		internals->tx_ring_queues[i].internals = internals;
 		data->tx_queues[i] = &internals->tx_ring_queues[i];
 	}
 
@@ -472,6 +626,99 @@ rte_eth_from_ring(struct rte_ring *r)
 			r->memzone ? r->memzone->socket_id : SOCKET_ID_ANY);
 }
 
+static struct rte_eth_dev *
+eth_ring_get_dev(uint16_t port_id)
+{
+	struct rte_eth_dev *dev;
+
+	if (!rte_eth_dev_is_valid_port(port_id))
+		return NULL;
+
+	dev = &rte_eth_devices[port_id];
+	if (dev->dev_ops != &ops)
+		return NULL;
+
+	return dev;
+}
+
+int
+rte_eth_ring_tx_distribute_set(uint16_t port_id, int enable)
+{
+	struct pmd_internals *internals;
+	struct rte_eth_dev *dev;
+
+	dev = eth_ring_get_dev(port_id);
+	if (dev == NULL)
+		return -ENODEV;
+
+	if (dev->data->dev_started) {
+		PMD_LOG(ERR, "Port %u must be stopped", port_id);
+		return -EBUSY;
+	}
+
+	if (enable) {
+		int ret = eth_ring_tx_distribute_check(dev);
+
+		if (ret < 0)
+			return ret;
+	}
+
+	internals = dev->data->dev_private;
+	internals->tx_distribute = !!enable;
+	dev->tx_pkt_burst = enable ? eth_ring_tx_distribute : eth_ring_tx;
+
+	return 0;
+}
+
+int
+rte_eth_ring_rx_zc_burst_start(uint16_t port_id, uint16_t queue_id,
+		unsigned int n, struct rte_ring_zc_data *zcd)
+{
+	struct rte_eth_dev *dev;
+	struct ring_queue *r;
+
+	dev = eth_ring_get_dev(port_id);
+	if (dev == NULL)
+		return -ENODEV;
+
+	if (queue_id >= dev->data->nb_rx_queues)
+		return -EINVAL;
+
+	r = dev->data->rx_queues[queue_id];
+	switch (rte_ring_get_cons_sync_type(r->rng)) {
+	case RTE_RING_SYNC_ST:
+	case RTE_RING_SYNC_MT_HTS:
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	return (int)rte_ring_dequeue_zc_burst_start(r->rng, n, zcd, NULL);
+}
+
+int
+rte_eth_ring_rx_zc_finish(uint16_t port_id, uint16_t queue_id, unsigned int n)
+{
+	struct rte_eth_dev *dev;
+	struct ring_queue *r;
+
+	dev = eth_ring_get_dev(port_id);
+	if (dev == NULL)
+		return -ENODEV;
+
+	if (queue_id >= dev->data->nb_rx_queues)
+		return -EINVAL;
+
+	r = dev->data->rx_queues[queue_id];
+	rte_ring_dequeue_zc_finish(r->rng, n);
+	if (r->rng->flags & RING_F_SC_DEQ)
+		r->rx_pkts.cnt += n;
+	else
+		rte_atomic64_add(&(r->rx_pkts), n);
+
+	return 0;
+}
+
 static int
 eth_dev_ring_create(const char *name,
 		struct rte_vdev_device *vdev,
@@ -633,6 +880,7 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 	struct node_action_list *info = NULL;
 	struct rte_eth_dev *eth_dev = NULL;
 	struct ring_internal_args *internal_args;
+	struct pmd_internals *internals;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -645,11 +893,14 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 			PMD_LOG(ERR, "Failed to probe %s", name);
 			return -1;
 		}
+		internals = eth_dev->data->dev_private;
+
 		eth_dev->dev_ops = &ops;
 		eth_dev->device = &dev->device;
 
 		eth_dev->rx_pkt_burst = eth_ring_rx;
-		eth_dev->tx_pkt_burst = eth_ring_tx;
+		eth_dev->tx_pkt_burst = internals->tx_distribute ?
+				eth_ring_tx_distribute : eth_ring_tx;
 
 		rte_eth_dev_probing_finish(eth_dev);
 
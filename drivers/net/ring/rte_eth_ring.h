@@ -9,6 +9,7 @@
 extern "C" {
 #endif
 
+#include <rte_compat.h>
 #include <rte_ring.h>
 
 /**
@@ -50,6 +51,89 @@ int rte_eth_from_rings(const char *name,
  */
 int rte_eth_from_ring(struct rte_ring *r);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable or disable the distribution of the transmitted packets over all
+ * the Tx rings of a port.
+ *
+ * When enabled, each Tx queue of the port spreads its packets over all
+ * the rings given as Tx queues at creation, by flow: the RSS hash of the
+ * packet if it has one, else a hash of its IP addresses and L4 ports. The
+ * packets of a flow are kept in order in one ring, so each ring can be
+ * consumed by a different core or process. If several Tx queues are
+ * configured, the rings must be multi-producer.
+ *
+ * @param port_id
+ *    the port number of a rings-based ethdev, which must be stopped
+ * @param enable
+ *    1 to distribute the packets over the rings, 0 to send the packets of
+ *    each Tx queue to its own ring (default)
+ * @return
+ *    - 0 on success.
+ *    - -ENODEV if the port is not a rings-based ethdev.
+ *    - -EBUSY if the port is started.
+ *    - -EINVAL if a ring is single-producer while several Tx queues are
+ *      configured.
+ */
+__rte_experimental
+int rte_eth_ring_tx_distribute_set(uint16_t port_id, int enable);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Start to receive up to n packets from an Rx queue without copying the
+ * mbuf pointers, which are accessed in place in the ring.
+ *
+ * The mbuf pointers are returned through zcd, as for
+ * rte_ring_dequeue_zc_burst_start(), and stay in the ring until
+ * rte_eth_ring_rx_zc_finish() is called. The ring of the queue must be
+ * single-consumer or multi-consumer HTS.
+ *
+ * @param port_id
+ *    the port number of a rings-based ethdev
+ * @param queue_id
+ *    the Rx queue index
+ * @param n
+ *    the maximum number of packets to receive
+ * @param zcd
+ *    returns the location of the mbuf pointers in the ring
+ * @return
+ *    - the number of packets available, from 0 to n.
+ *    - -ENODEV if the port is not a rings-based ethdev.
+ *    - -EINVAL if the queue is invalid.
+ *    - -ENOTSUP if the ring of the queue does not support zero-copy.
+ */
+__rte_experimental
+int rte_eth_ring_rx_zc_burst_start(uint16_t port_id, uint16_t queue_id,
+		unsigned int n, struct rte_ring_zc_data *zcd);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Complete a zero-copy receive started with
+ * rte_eth_ring_rx_zc_burst_start(), removing the first n packets from the
+ * ring. The mbufs are owned by the caller after this call.
+ *
+ * @param port_id
+ *    the port number of a rings-based ethdev
+ * @param queue_id
+ *    the Rx queue index
+ * @param n
+ *    the number of packets received, at most the number returned by
+ *    rte_eth_ring_rx_zc_burst_start()
+ * @return
+ *    - 0 on success.
+ *    - -ENODEV if the port is not a rings-based ethdev.
+ *    - -EINVAL if the queue is invalid.
+ */
+__rte_experimental
+int rte_eth_ring_rx_zc_finish(uint16_t port_id, uint16_t queue_id,
+		unsigned int n);
+
 #ifdef __cplusplus
 }
 #endif
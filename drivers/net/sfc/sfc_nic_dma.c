@@ -148,20 +148,40 @@ sfc_nic_dma_register_mempool(struct sfc_adapter *sa, struct rte_mempool *mp)
 	return result;
 }
 
-static void
+static int
 sfc_mempool_event_cb(enum rte_mempool_event event, struct rte_mempool *mp,
 		     void *user_data)
 {
 	struct sfc_adapter *sa = user_data;
+	int rc = 0;
 
-	if (event != RTE_MEMPOOL_EVENT_READY)
-		return;
-
-	sfc_adapter_lock(sa);
-
-	(void)sfc_nic_dma_register_mempool(sa, mp);
+	switch (event) {
+	case RTE_MEMPOOL_EVENT_READY:
+		sfc_adapter_lock(sa);
+		(void)sfc_nic_dma_register_mempool(sa, mp);
+		sfc_adapter_unlock(sa);
+		break;
+	case RTE_MEMPOOL_EVENT_CHUNK_ADD:
+		/*
+		 * Registration skips the memory chunks mapped already.
+		 * Refuse the new chunk if its mbufs cannot be mapped,
+		 * e.g. when all NIC DMA regions are in use.
+		 */
+		sfc_adapter_lock(sa);
+		rc = sfc_nic_dma_register_mempool(sa, mp);
+		sfc_adapter_unlock(sa);
+		break;
+	case RTE_MEMPOOL_EVENT_CHUNK_DEL:
+		/*
+		 * NIC DMA regions cannot be removed and may cover other
+		 * memory, the mapping of the chunk is simply left in place.
+		 */
+		break;
+	default:
+		break;
+	}
 
-	sfc_adapter_unlock(sa);
+	return -rc;
 }
 
 struct sfc_mempool_walk_data {
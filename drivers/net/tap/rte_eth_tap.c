@@ -44,6 +44,7 @@
 #include <tap_flow.h>
 #include <tap_netlink.h>
 #include <tap_tcmsgs.h>
+#include <tap_uring.h>
 
 /* Linux based path to the TUN device */
 #define TUN_TAP_DEV_PATH        "/dev/net/tun"
@@ -54,6 +55,7 @@
 #define ETH_TAP_REMOTE_ARG      "remote"
 #define ETH_TAP_MAC_ARG         "mac"
 #define ETH_TAP_MAC_FIXED       "fixed"
+#define ETH_TAP_IO_URING_ARG    "io_uring"
 
 #define ETH_TAP_USR_MAC_FMT     "xx:xx:xx:xx:xx:xx"
 #define ETH_TAP_CMP_MAC_FMT     "0123456789ABCDEFabcdef"
@@ -92,6 +94,7 @@ static const char *valid_arguments[] = {
 	ETH_TAP_IFACE_ARG,
 	ETH_TAP_REMOTE_ARG,
 	ETH_TAP_MAC_ARG,
+	ETH_TAP_IO_URING_ARG,
 	NULL
 };
 
@@ -409,6 +412,33 @@ tap_rxq_pool_free(struct rte_mbuf *pool)
 	rte_pktmbuf_free(pool);
 }
 
+/* Receive a burst of packets read through io_uring. A read is always
+ * posted, so the Rx trigger is not needed.
+ */
+static uint16_t
+pmd_rx_burst_uring(struct rx_queue *rxq, struct tap_uring_rxq *uring,
+		   struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	unsigned long num_rx_bytes = 0;
+	uint16_t num_rx, i;
+
+	num_rx = tap_uring_rx(uring, bufs, nb_pkts);
+	for (i = 0; i < num_rx; i++) {
+		struct rte_mbuf *mbuf = bufs[i];
+
+		mbuf->port = rxq->in_port;
+		mbuf->packet_type = rte_net_get_ptype(mbuf, NULL,
+						      RTE_PTYPE_ALL_MASK);
+		if (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_CHECKSUM)
+			tap_verify_csum(mbuf);
+		num_rx_bytes += mbuf->pkt_len;
+	}
+	rxq->stats.ipackets += num_rx;
+	rxq->stats.ibytes += num_rx_bytes;
+
+	return num_rx;
+}
+
 /* Callback to handle the rx burst of packets to the correct interface and
  * file descriptor(s) in a multi-queue setup.
  */
@@ -421,10 +451,15 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	unsigned long num_rx_bytes = 0;
 	uint32_t trigger = tap_trigger;
 
+	process_private = rte_eth_devices[rxq->in_port].process_private;
+	if (process_private->rxq_uring[rxq->queue_id] != NULL)
+		return pmd_rx_burst_uring(rxq,
+				process_private->rxq_uring[rxq->queue_id],
+				bufs, nb_pkts);
+
 	if (trigger == rxq->trigger_seen)
 		return 0;
 
-	process_private = rte_eth_devices[rxq->in_port].process_private;
 	for (num_rx = 0; num_rx < nb_pkts; ) {
 		struct rte_mbuf *mbuf = rxq->pool;
 		struct rte_mbuf *seg = NULL;
@@ -572,120 +607,173 @@ tap_tx_l3_cksum(char *packet, uint64_t ol_flags, unsigned int l2_len,
 	}
 }
 
+/* Fill the iovecs to write a packet: the packet information, the copy of
+ * the headers if checksums are offloaded, then the data. Return the number
+ * of iovecs, or -1 on error.
+ */
+static inline int
+tap_tx_iovecs_fill(struct tx_queue *txq, struct rte_mbuf *mbuf,
+		   struct iovec *iovecs, struct tun_pi *pi, char *m_copy)
+{
+	uint16_t l234_hlen;
+	struct rte_mbuf *seg = mbuf;
+	int proto;
+	int j;
+	int k; /* current index in iovecs for copying segments */
+	uint16_t seg_len; /* length of first segment */
+	uint16_t nb_segs;
+	uint16_t *l4_cksum; /* l4 checksum (pseudo header + payload) */
+	uint32_t l4_raw_cksum = 0; /* TCP/UDP payload raw checksum */
+	uint16_t l4_phdr_cksum = 0; /* TCP/UDP pseudo header checksum */
+	uint16_t is_cksum = 0; /* in case cksum should be offloaded */
+
+	pi->flags = 0;
+	pi->proto = 0x00;
+	l4_cksum = NULL;
+	if (txq->type == ETH_TUNTAP_TYPE_TUN) {
+		/*
+		 * TUN and TAP are created with IFF_NO_PI disabled.
+		 * For TUN PMD this mandatory as fields are used by
+		 * Kernel tun.c to determine whether its IP or non IP
+		 * packets.
+		 *
+		 * The logic fetches the first byte of data from mbuf
+		 * then compares whether its v4 or v6. If first byte
+		 * is 4 or 6, then protocol field is updated.
+		 */
+		char *buff_data = rte_pktmbuf_mtod(seg, void *);
+		proto = (*buff_data & 0xf0);
+		pi->proto = (proto == 0x40) ?
+			rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) :
+			((proto == 0x60) ?
+				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) :
+				0x00);
+	}
+
+	k = 0;
+	iovecs[k].iov_base = pi;
+	iovecs[k].iov_len = sizeof(*pi);
+	k++;
+
+	nb_segs = mbuf->nb_segs;
+	if (txq->csum &&
+	    ((mbuf->ol_flags & (RTE_MBUF_F_TX_IP_CKSUM | RTE_MBUF_F_TX_IPV4) ||
+	      (mbuf->ol_flags & RTE_MBUF_F_TX_L4_MASK) == RTE_MBUF_F_TX_UDP_CKSUM ||
+	      (mbuf->ol_flags & RTE_MBUF_F_TX_L4_MASK) == RTE_MBUF_F_TX_TCP_CKSUM))) {
+		is_cksum = 1;
+
+		/* Support only packets with at least layer 4
+		 * header included in the first segment
+		 */
+		seg_len = rte_pktmbuf_data_len(mbuf);
+		l234_hlen = mbuf->l2_len + mbuf->l3_len + mbuf->l4_len;
+		if (seg_len < l234_hlen)
+			return -1;
+
+		/* To change checksums, work on a * copy of l2, l3
+		 * headers + l4 pseudo header
+		 */
+		rte_memcpy(m_copy, rte_pktmbuf_mtod(mbuf, void *),
+				l234_hlen);
+		tap_tx_l3_cksum(m_copy, mbuf->ol_flags,
+			       mbuf->l2_len, mbuf->l3_len, mbuf->l4_len,
+			       &l4_cksum, &l4_phdr_cksum,
+			       &l4_raw_cksum);
+		iovecs[k].iov_base = m_copy;
+		iovecs[k].iov_len = l234_hlen;
+		k++;
+
+		/* Update next iovecs[] beyond l2, l3, l4 headers */
+		if (seg_len > l234_hlen) {
+			iovecs[k].iov_len = seg_len - l234_hlen;
+			iovecs[k].iov_base =
+				rte_pktmbuf_mtod(seg, char *) +
+					l234_hlen;
+			tap_tx_l4_add_rcksum(iovecs[k].iov_base,
+				iovecs[k].iov_len, l4_cksum,
+				&l4_raw_cksum);
+			k++;
+			nb_segs++;
+		}
+		seg = seg->next;
+	}
+
+	for (j = k; j <= nb_segs; j++) {
+		iovecs[j].iov_len = rte_pktmbuf_data_len(seg);
+		iovecs[j].iov_base = rte_pktmbuf_mtod(seg, void *);
+		if (is_cksum)
+			tap_tx_l4_add_rcksum(iovecs[j].iov_base,
+				iovecs[j].iov_len, l4_cksum,
+				&l4_raw_cksum);
+		seg = seg->next;
+	}
+
+	if (is_cksum)
+		tap_tx_l4_cksum(l4_cksum, l4_phdr_cksum, l4_raw_cksum);
+
+	return j;
+}
+
 static inline int
 tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			struct rte_mbuf **pmbufs,
 			uint16_t *num_packets, unsigned long *num_tx_bytes)
 {
 	int i;
-	uint16_t l234_hlen;
 	struct pmd_process_private *process_private;
+	struct tap_uring_txq *uring;
+	bool use_uring;
 
 	process_private = rte_eth_devices[txq->out_port].process_private;
+	uring = process_private->txq_uring[txq->queue_id];
+	use_uring = uring != NULL;
+
+	/* post all the segments of a packet or none */
+	if (use_uring) {
+		i = tap_uring_tx_reserve(uring, num_mbufs);
+		if (i == -EAGAIN)
+			return -EAGAIN;
+		/* more GSO segments than the queue has slots: use writev() */
+		if (i < 0)
+			use_uring = false;
+	}
 
 	for (i = 0; i < num_mbufs; i++) {
 		struct rte_mbuf *mbuf = pmbufs[i];
-		struct iovec iovecs[mbuf->nb_segs + 2];
-		struct tun_pi pi = { .flags = 0, .proto = 0x00 };
-		struct rte_mbuf *seg = mbuf;
-		char m_copy[mbuf->data_len];
-		int proto;
+		struct tap_uring_tx_slot *slot;
 		int n;
-		int j;
-		int k; /* current index in iovecs for copying segments */
-		uint16_t seg_len; /* length of first segment */
-		uint16_t nb_segs;
-		uint16_t *l4_cksum; /* l4 checksum (pseudo header + payload) */
-		uint32_t l4_raw_cksum = 0; /* TCP/UDP payload raw checksum */
-		uint16_t l4_phdr_cksum = 0; /* TCP/UDP pseudo header checksum */
-		uint16_t is_cksum = 0; /* in case cksum should be offloaded */
-
-		l4_cksum = NULL;
-		if (txq->type == ETH_TUNTAP_TYPE_TUN) {
-			/*
-			 * TUN and TAP are created with IFF_NO_PI disabled.
-			 * For TUN PMD this mandatory as fields are used by
-			 * Kernel tun.c to determine whether its IP or non IP
-			 * packets.
-			 *
-			 * The logic fetches the first byte of data from mbuf
-			 * then compares whether its v4 or v6. If first byte
-			 * is 4 or 6, then protocol field is updated.
-			 */
-			char *buff_data = rte_pktmbuf_mtod(seg, void *);
-			proto = (*buff_data & 0xf0);
-			pi.proto = (proto == 0x40) ?
-				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) :
-				((proto == 0x60) ?
-					rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) :
-					0x00);
-		}
-
-		k = 0;
-		iovecs[k].iov_base = &pi;
-		iovecs[k].iov_len = sizeof(pi);
-		k++;
-
-		nb_segs = mbuf->nb_segs;
-		if (txq->csum &&
-		    ((mbuf->ol_flags & (RTE_MBUF_F_TX_IP_CKSUM | RTE_MBUF_F_TX_IPV4) ||
-		      (mbuf->ol_flags & RTE_MBUF_F_TX_L4_MASK) == RTE_MBUF_F_TX_UDP_CKSUM ||
-		      (mbuf->ol_flags & RTE_MBUF_F_TX_L4_MASK) == RTE_MBUF_F_TX_TCP_CKSUM))) {
-			is_cksum = 1;
 
-			/* Support only packets with at least layer 4
-			 * header included in the first segment
-			 */
-			seg_len = rte_pktmbuf_data_len(mbuf);
-			l234_hlen = mbuf->l2_len + mbuf->l3_len + mbuf->l4_len;
-			if (seg_len < l234_hlen)
+		if (use_uring && mbuf->nb_segs <= TAP_URING_TX_SEGS_MAX) {
+			slot = tap_uring_tx_slot_get(uring);
+			if (slot == NULL)
 				return -1;
 
-			/* To change checksums, work on a * copy of l2, l3
-			 * headers + l4 pseudo header
-			 */
-			rte_memcpy(m_copy, rte_pktmbuf_mtod(mbuf, void *),
-					l234_hlen);
-			tap_tx_l3_cksum(m_copy, mbuf->ol_flags,
-				       mbuf->l2_len, mbuf->l3_len, mbuf->l4_len,
-				       &l4_cksum, &l4_phdr_cksum,
-				       &l4_raw_cksum);
-			iovecs[k].iov_base = m_copy;
-			iovecs[k].iov_len = l234_hlen;
-			k++;
+			n = tap_tx_iovecs_fill(txq, mbuf, slot->iovecs,
+					       &slot->pi, slot->hdr);
+			if (n < 0)
+				return -1;
 
-			/* Update next iovecs[] beyond l2, l3, l4 headers */
-			if (seg_len > l234_hlen) {
-				iovecs[k].iov_len = seg_len - l234_hlen;
-				iovecs[k].iov_base =
-					rte_pktmbuf_mtod(seg, char *) +
-						l234_hlen;
-				tap_tx_l4_add_rcksum(iovecs[k].iov_base,
-					iovecs[k].iov_len, l4_cksum,
-					&l4_raw_cksum);
-				k++;
-				nb_segs++;
-			}
-			seg = seg->next;
-		}
+			/* the write is submitted at the end of the burst */
+			tap_uring_tx_post(uring, slot, mbuf, n);
+		} else {
+			struct iovec iovecs[mbuf->nb_segs + 2];
+			struct tun_pi pi;
+			char m_copy[mbuf->data_len];
 
-		for (j = k; j <= nb_segs; j++) {
-			iovecs[j].iov_len = rte_pktmbuf_data_len(seg);
-			iovecs[j].iov_base = rte_pktmbuf_mtod(seg, void *);
-			if (is_cksum)
-				tap_tx_l4_add_rcksum(iovecs[j].iov_base,
-					iovecs[j].iov_len, l4_cksum,
-					&l4_raw_cksum);
-			seg = seg->next;
-		}
+			/* keep the order of the writes already posted */
+			if (uring != NULL)
+				tap_uring_tx_submit(uring);
 
-		if (is_cksum)
-			tap_tx_l4_cksum(l4_cksum, l4_phdr_cksum, l4_raw_cksum);
+			n = tap_tx_iovecs_fill(txq, mbuf, iovecs, &pi, m_copy);
+			if (n < 0)
+				return -1;
 
-		/* copy the tx frame data */
-		n = writev(process_private->txq_fds[txq->queue_id], iovecs, j);
-		if (n <= 0)
-			return -1;
+			/* copy the tx frame data */
+			n = writev(process_private->txq_fds[txq->queue_id],
+				   iovecs, n);
+			if (n <= 0)
+				return -1;
+		}
 
 		(*num_packets)++;
 		(*num_tx_bytes) += rte_pktmbuf_pkt_len(mbuf);
@@ -699,10 +787,12 @@ static uint16_t
 pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 	struct tx_queue *txq = queue;
+	struct pmd_process_private *process_private;
 	uint16_t num_tx = 0;
 	uint16_t num_packets = 0;
 	unsigned long num_tx_bytes = 0;
 	uint32_t max_size;
+	bool full = false;
 	int i;
 
 	if (unlikely(nb_pkts == 0))
@@ -770,8 +860,12 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 		ret = tap_write_mbufs(txq, num_mbufs, mbuf,
 				&num_packets, &num_tx_bytes);
-		if (ret == -1) {
-			txq->stats.errs++;
+		if (ret < 0) {
+			/* a full io_uring queue is not an error */
+			if (ret == -EAGAIN)
+				full = true;
+			else
+				txq->stats.errs++;
 			/* free tso mbufs */
 			if (num_tso_mbufs > 0)
 				rte_pktmbuf_free_bulk(mbuf, num_tso_mbufs);
@@ -785,8 +879,14 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			rte_pktmbuf_free_bulk(mbuf, num_tso_mbufs);
 	}
 
+	/* submit the writes posted to io_uring at once */
+	process_private = rte_eth_devices[txq->out_port].process_private;
+	if (process_private->txq_uring[txq->queue_id] != NULL)
+		tap_uring_tx_submit(process_private->txq_uring[txq->queue_id]);
+
 	txq->stats.opackets += num_packets;
-	txq->stats.errs += nb_pkts - num_tx;
+	if (!full)
+		txq->stats.errs += nb_pkts - num_tx;
 	txq->stats.obytes += num_tx_bytes;
 
 	return num_tx;
@@ -1174,6 +1274,10 @@ tap_dev_close(struct rte_eth_dev *dev)
 	}
 
 	for (i = 0; i < RTE_PMD_TAP_MAX_QUEUES; i++) {
+		tap_uring_rxq_free(process_private->rxq_uring[i]);
+		process_private->rxq_uring[i] = NULL;
+		tap_uring_txq_free(process_private->txq_uring[i]);
+		process_private->txq_uring[i] = NULL;
 		if (process_private->rxq_fds[i] != -1) {
 			rxq = &internals->rxq[i];
 			close(process_private->rxq_fds[i]);
@@ -1238,6 +1342,8 @@ tap_rx_queue_release(struct rte_eth_dev *dev, uint16_t qid)
 	if (!rxq)
 		return;
 	process_private = rte_eth_devices[rxq->in_port].process_private;
+	tap_uring_rxq_free(process_private->rxq_uring[rxq->queue_id]);
+	process_private->rxq_uring[rxq->queue_id] = NULL;
 	if (process_private->rxq_fds[rxq->queue_id] != -1) {
 		close(process_private->rxq_fds[rxq->queue_id]);
 		process_private->rxq_fds[rxq->queue_id] = -1;
@@ -1257,6 +1363,8 @@ tap_tx_queue_release(struct rte_eth_dev *dev, uint16_t qid)
 	if (!txq)
 		return;
 	process_private = rte_eth_devices[txq->out_port].process_private;
+	tap_uring_txq_free(process_private->txq_uring[txq->queue_id]);
+	process_private->txq_uring[txq->queue_id] = NULL;
 
 	if (process_private->txq_fds[txq->queue_id] != -1) {
 		close(process_private->txq_fds[txq->queue_id]);
@@ -1595,6 +1703,7 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		iov_max = TAP_IOV_DEFAULT_MAX;
 	}
 	uint16_t nb_desc = RTE_MIN(nb_rx_desc, iov_max - 1);
+	uint16_t nb_pool = nb_desc;
 	struct iovec (*iovecs)[nb_desc + 1];
 	int data_off = RTE_PKTMBUF_HEADROOM;
 	int ret = 0;
@@ -1630,10 +1739,31 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		goto error;
 	}
 
+	tap_uring_rxq_free(process_private->rxq_uring[rx_queue_id]);
+	process_private->rxq_uring[rx_queue_id] = NULL;
+	if (internals->io_uring &&
+	    !(rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_SCATTER)) {
+		process_private->rxq_uring[rx_queue_id] =
+			tap_uring_rxq_create(fd, mp, nb_rx_desc, &rxq->stats,
+					     socket_id);
+		if (process_private->rxq_uring[rx_queue_id] == NULL)
+			TAP_LOG(NOTICE,
+				"%s: io_uring unavailable for RX queue %d (%s), using readv()",
+				dev->device->name, rx_queue_id,
+				rte_strerror(rte_errno));
+	}
+
+	/*
+	 * The pool below is used by readv(), in secondary processes only
+	 * if io_uring is used. They read without scatter, in the first mbuf.
+	 */
+	if (process_private->rxq_uring[rx_queue_id] != NULL)
+		nb_pool = 1;
+
 	(*rxq->iovecs)[0].iov_len = sizeof(struct tun_pi);
 	(*rxq->iovecs)[0].iov_base = &rxq->pi;
 
-	for (i = 1; i <= nb_desc; i++) {
+	for (i = 1; i <= nb_pool; i++) {
 		*tmp = rte_pktmbuf_alloc(rxq->mp);
 		if (!*tmp) {
 			TAP_LOG(WARNING,
@@ -1649,13 +1779,16 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		tmp = &(*tmp)->next;
 	}
 
-	TAP_LOG(DEBUG, "  RX TUNTAP device name %s, qid %d on fd %d",
+	TAP_LOG(DEBUG, "  RX TUNTAP device name %s, qid %d on fd %d%s",
 		internals->name, rx_queue_id,
-		process_private->rxq_fds[rx_queue_id]);
+		process_private->rxq_fds[rx_queue_id],
+		process_private->rxq_uring[rx_queue_id] ? " io_uring" : "");
 
 	return 0;
 
 error:
+	tap_uring_rxq_free(process_private->rxq_uring[rx_queue_id]);
+	process_private->rxq_uring[rx_queue_id] = NULL;
 	tap_rxq_pool_free(rxq->pool);
 	rxq->pool = NULL;
 	rte_free(rxq->iovecs);
@@ -1666,8 +1799,8 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 static int
 tap_tx_queue_setup(struct rte_eth_dev *dev,
 		   uint16_t tx_queue_id,
-		   uint16_t nb_tx_desc __rte_unused,
-		   unsigned int socket_id __rte_unused,
+		   uint16_t nb_tx_desc,
+		   unsigned int socket_id,
 		   const struct rte_eth_txconf *tx_conf)
 {
 	struct pmd_internals *internals = dev->data->dev_private;
@@ -1692,11 +1825,26 @@ tap_tx_queue_setup(struct rte_eth_dev *dev,
 	ret = tap_setup_queue(dev, internals, tx_queue_id, 0);
 	if (ret == -1)
 		return -1;
+
+	tap_uring_txq_free(process_private->txq_uring[tx_queue_id]);
+	process_private->txq_uring[tx_queue_id] = NULL;
+	if (internals->io_uring) {
+		process_private->txq_uring[tx_queue_id] =
+			tap_uring_txq_create(ret, nb_tx_desc, &txq->stats,
+					     socket_id);
+		if (process_private->txq_uring[tx_queue_id] == NULL)
+			TAP_LOG(NOTICE,
+				"%s: io_uring unavailable for TX queue %d (%s), using writev()",
+				dev->device->name, tx_queue_id,
+				rte_strerror(rte_errno));
+	}
+
 	TAP_LOG(DEBUG,
-		"  TX TUNTAP device name %s, qid %d on fd %d csum %s",
+		"  TX TUNTAP device name %s, qid %d on fd %d csum %s%s",
 		internals->name, tx_queue_id,
 		process_private->txq_fds[tx_queue_id],
-		txq->csum ? "on" : "off");
+		txq->csum ? "on" : "off",
+		process_private->txq_uring[tx_queue_id] ? " io_uring" : "");
 
 	return 0;
 }
@@ -1956,7 +2104,7 @@ static const struct eth_dev_ops ops = {
 static int
 eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 		   char *remote_iface, struct rte_ether_addr *mac_addr,
-		   enum rte_tuntap_type type)
+		   enum rte_tuntap_type type, int io_uring)
 {
 	int numa_node = rte_socket_id();
 	struct rte_eth_dev *dev;
@@ -1992,6 +2140,7 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 	pmd->ka_fd = -1;
 	pmd->nlsk_fd = -1;
 	pmd->gso_ctx_mp = NULL;
+	pmd->io_uring = io_uring;
 
 	pmd->ioctl_sock = socket(AF_INET, SOCK_DGRAM, 0);
 	if (pmd->ioctl_sock == -1) {
@@ -2301,6 +2450,23 @@ set_mac_type(const char *key __rte_unused,
 	return -1;
 }
 
+static int
+set_io_uring(const char *key __rte_unused,
+	     const char *value,
+	     void *extra_args)
+{
+	int *io_uring = extra_args;
+
+	if (value == NULL || (strcmp(value, "0") && strcmp(value, "1"))) {
+		TAP_LOG(ERR, "TAP io_uring (%s) must be 0 or 1",
+			value ? value : "");
+		return -1;
+	}
+	*io_uring = value[0] == '1';
+
+	return 0;
+}
+
 /*
  * Open a TUN interface device. TUN PMD
  * 1) sets tap_type as false
@@ -2316,6 +2482,7 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 	char tun_name[RTE_ETH_NAME_MAX_LEN];
 	char remote_iface[RTE_ETH_NAME_MAX_LEN];
 	struct rte_eth_dev *eth_dev;
+	int io_uring = 0;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -2351,6 +2518,15 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 				if (ret == -1)
 					goto leave;
 			}
+
+			if (rte_kvargs_count(kvlist, ETH_TAP_IO_URING_ARG) == 1) {
+				ret = rte_kvargs_process(kvlist,
+					ETH_TAP_IO_URING_ARG,
+					&set_io_uring,
+					&io_uring);
+				if (ret == -1)
+					goto leave;
+			}
 		}
 	}
 	pmd_link.link_speed = RTE_ETH_SPEED_NUM_10G;
@@ -2358,7 +2534,7 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 	TAP_LOG(DEBUG, "Initializing pmd_tun for %s", name);
 
 	ret = eth_dev_tap_create(dev, tun_name, remote_iface, 0,
-				 ETH_TUNTAP_TYPE_TUN);
+				 ETH_TUNTAP_TYPE_TUN, io_uring);
 
 leave:
 	if (ret == -1) {
@@ -2488,6 +2664,7 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	struct rte_ether_addr user_mac = { .addr_bytes = {0} };
 	struct rte_eth_dev *eth_dev;
 	int tap_devices_count_increased = 0;
+	int io_uring = 0;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -2571,6 +2748,15 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 				if (ret == -1)
 					goto leave;
 			}
+
+			if (rte_kvargs_count(kvlist, ETH_TAP_IO_URING_ARG) == 1) {
+				ret = rte_kvargs_process(kvlist,
+							 ETH_TAP_IO_URING_ARG,
+							 &set_io_uring,
+							 &io_uring);
+				if (ret == -1)
+					goto leave;
+			}
 		}
 	}
 	pmd_link.link_speed = speed;
@@ -2589,7 +2775,7 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	tap_devices_count++;
 	tap_devices_count_increased = 1;
 	ret = eth_dev_tap_create(dev, tap_name, remote_iface, &user_mac,
-		ETH_TUNTAP_TYPE_TAP);
+		ETH_TUNTAP_TYPE_TAP, io_uring);
 
 leave:
 	if (ret == -1) {
@@ -2638,9 +2824,11 @@ RTE_PMD_REGISTER_VDEV(net_tap, pmd_tap_drv);
 RTE_PMD_REGISTER_VDEV(net_tun, pmd_tun_drv);
 RTE_PMD_REGISTER_ALIAS(net_tap, eth_tap);
 RTE_PMD_REGISTER_PARAM_STRING(net_tun,
-			      ETH_TAP_IFACE_ARG "=<string> ");
+			      ETH_TAP_IFACE_ARG "=<string> "
+			      ETH_TAP_IO_URING_ARG "=<0|1>");
 RTE_PMD_REGISTER_PARAM_STRING(net_tap,
 			      ETH_TAP_IFACE_ARG "=<string> "
 			      ETH_TAP_MAC_ARG "=" ETH_TAP_MAC_ARG_FMT " "
-			      ETH_TAP_REMOTE_ARG "=<string>");
+			      ETH_TAP_REMOTE_ARG "=<string> "
+			      ETH_TAP_IO_URING_ARG "=<0|1>");
 RTE_LOG_REGISTER_DEFAULT(tap_logtype, NOTICE);
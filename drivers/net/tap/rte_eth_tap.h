@@ -25,6 +25,9 @@
 #endif
 #define MAX_GSO_MBUFS 64
 
+struct tap_uring_rxq;
+struct tap_uring_txq;
+
 enum rte_tuntap_type {
 	ETH_TUNTAP_TYPE_UNKNOWN,
 	ETH_TUNTAP_TYPE_TUN,
@@ -92,11 +95,15 @@ struct pmd_internals {
 	struct rte_intr_handle *intr_handle;         /* LSC interrupt handle. */
 	int ka_fd;                        /* keep-alive file descriptor */
 	struct rte_mempool *gso_ctx_mp;     /* Mempool for GSO packets */
+	int io_uring;                     /* 1 if io_uring is requested */
 };
 
 struct pmd_process_private {
 	int rxq_fds[RTE_PMD_TAP_MAX_QUEUES];
 	int txq_fds[RTE_PMD_TAP_MAX_QUEUES];
+	/* io_uring of the queues, NULL when using readv()/writev() */
+	struct tap_uring_rxq *rxq_uring[RTE_PMD_TAP_MAX_QUEUES];
+	struct tap_uring_txq *txq_uring[RTE_PMD_TAP_MAX_QUEUES];
 };
 
 /* tap_intr.c */
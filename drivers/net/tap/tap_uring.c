@@ -0,0 +1,717 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+/**
+ * @file
+ * io_uring backend of the tap driver.
+ *
+ * The reads and writes of a queue are prepared in the submission ring of
+ * an io_uring instance shared with the kernel, and submitted with a single
+ * system call per burst. Their results are taken from the completion ring
+ * without any system call.
+ *
+ * The Rx queue keeps a read posted on each of its slots, the packet being
+ * received directly in an mbuf, with the packet information in its
+ * headroom. The memory of the mempool is registered to the kernel when
+ * possible, so that the reads do not map the mbufs each time.
+ *
+ * The Tx queue posts a vectored write per packet, the mbuf being freed on
+ * completion.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+#include <rte_eth_tap.h>
+#include <tap_autoconf.h>
+#include <tap_uring.h>
+
+#if defined(HAVE_IO_URING) && defined(__NR_io_uring_setup)
+
+#include <linux/io_uring.h>
+
+/* Maximum number of mempool memory chunks registered for an Rx queue */
+#define TAP_URING_RX_BUFS_MAX 64
+
+/* Maximum number of packets received in a burst */
+#define TAP_URING_RX_BURST 64
+
+/* user_data of the cancel requests */
+#define TAP_URING_CANCEL UINT64_MAX
+
+struct tap_uring {
+	int fd;                         /* io_uring file descriptor */
+	/* Submission ring, each entry of the array is its own index */
+	uint32_t *sq_head;
+	uint32_t *sq_tail;
+	uint32_t sq_mask;
+	uint32_t sq_entries;
+	uint32_t sq_prepared;           /* Tail of the prepared entries */
+	uint32_t sq_submitted;          /* Tail of the submitted entries */
+	struct io_uring_sqe *sqes;
+	/* Completion ring */
+	uint32_t *cq_head;
+	uint32_t *cq_tail;
+	uint32_t cq_mask;
+	struct io_uring_cqe *cqes;
+	/* Mappings of the rings */
+	void *sq_ring;
+	size_t sq_ring_sz;
+	void *cq_ring;
+	size_t cq_ring_sz;
+	size_t sqes_sz;
+};
+
+struct tap_uring_rxq {
+	struct tap_uring ring;
+	int fd;                         /* Queue file descriptor */
+	struct rte_mempool *mp;         /* Mempool for RX packets */
+	struct pkt_stats *stats;        /* Stats for this RX queue */
+	uint32_t nb_slots;              /* Number of slots */
+	uint32_t nb_inflight;           /* Number of posted reads */
+	uint32_t nb_bufs;               /* Number of registered buffers */
+	uint32_t last_buf;              /* Registered buffer of last mbuf */
+	struct iovec bufs[TAP_URING_RX_BUFS_MAX]; /* Registered buffers */
+	struct rte_mbuf *mbufs[];       /* mbuf of the read of each slot */
+};
+
+struct tap_uring_txq {
+	struct tap_uring ring;
+	int fd;                         /* Queue file descriptor */
+	struct pkt_stats *stats;        /* Stats for this TX queue */
+	uint32_t nb_slots;              /* Number of slots */
+	uint32_t nb_free;               /* Number of free slots */
+	uint32_t *free;                 /* Stack of the free slots */
+	struct tap_uring_tx_slot slots[];
+};
+
+static void
+tap_uring_fini(struct tap_uring *ring)
+{
+	if (ring->sqes != NULL)
+		munmap(ring->sqes, ring->sqes_sz);
+	if (ring->cq_ring != NULL && ring->cq_ring != ring->sq_ring)
+		munmap(ring->cq_ring, ring->cq_ring_sz);
+	if (ring->sq_ring != NULL)
+		munmap(ring->sq_ring, ring->sq_ring_sz);
+	if (ring->fd >= 0)
+		close(ring->fd);
+	ring->sqes = NULL;
+	ring->cq_ring = NULL;
+	ring->sq_ring = NULL;
+	ring->fd = -1;
+}
+
+static void *
+tap_uring_mmap(struct tap_uring *ring, size_t size, off_t offset)
+{
+	void *addr;
+
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		    MAP_SHARED | MAP_POPULATE, ring->fd, offset);
+
+	return addr == MAP_FAILED ? NULL : addr;
+}
+
+static int
+tap_uring_init(struct tap_uring *ring, uint32_t entries)
+{
+	struct io_uring_params p;
+	uint32_t *sq_array;
+	uint32_t i;
+	int ret;
+
+	memset(ring, 0, sizeof(*ring));
+	memset(&p, 0, sizeof(p));
+	ring->fd = syscall(__NR_io_uring_setup, entries, &p);
+	if (ring->fd < 0)
+		return -errno;
+
+	/* Without fast poll, each read waiting for a packet would hold a
+	 * kernel worker thread.
+	 */
+	if (!(p.features & IORING_FEAT_FAST_POLL)) {
+		ret = -ENOTSUP;
+		goto error;
+	}
+
+	ring->sq_ring_sz = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+	ring->cq_ring_sz = p.cq_off.cqes +
+		p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->sq_ring_sz = RTE_MAX(ring->sq_ring_sz, ring->cq_ring_sz);
+		ring->cq_ring_sz = ring->sq_ring_sz;
+	}
+	ring->sqes_sz = p.sq_entries * sizeof(struct io_uring_sqe);
+
+	ring->sq_ring = tap_uring_mmap(ring, ring->sq_ring_sz,
+				       IORING_OFF_SQ_RING);
+	if (ring->sq_ring == NULL)
+		goto error_errno;
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+		ring->cq_ring = ring->sq_ring;
+	else
+		ring->cq_ring = tap_uring_mmap(ring, ring->cq_ring_sz,
+					       IORING_OFF_CQ_RING);
+	if (ring->cq_ring == NULL)
+		goto error_errno;
+	ring->sqes = tap_uring_mmap(ring, ring->sqes_sz, IORING_OFF_SQES);
+	if (ring->sqes == NULL)
+		goto error_errno;
+
+	ring->sq_head = RTE_PTR_ADD(ring->sq_ring, p.sq_off.head);
+	ring->sq_tail = RTE_PTR_ADD(ring->sq_ring, p.sq_off.tail);
+	ring->sq_mask = *(uint32_t *)RTE_PTR_ADD(ring->sq_ring,
+						 p.sq_off.ring_mask);
+	ring->sq_entries = p.sq_entries;
+	ring->sq_prepared = *ring->sq_tail;
+	ring->sq_submitted = ring->sq_prepared;
+	sq_array = RTE_PTR_ADD(ring->sq_ring, p.sq_off.array);
+	for (i = 0; i < p.sq_entries; i++)
+		sq_array[i] = i;
+
+	ring->cq_head = RTE_PTR_ADD(ring->cq_ring, p.cq_off.head);
+	ring->cq_tail = RTE_PTR_ADD(ring->cq_ring, p.cq_off.tail);
+	ring->cq_mask = *(uint32_t *)RTE_PTR_ADD(ring->cq_ring,
+						 p.cq_off.ring_mask);
+	ring->cqes = RTE_PTR_ADD(ring->cq_ring, p.cq_off.cqes);
+
+	return 0;
+
+error_errno:
+	ret = -errno;
+error:
+	tap_uring_fini(ring);
+	return ret;
+}
+
+/* Get a zeroed submission entry to prepare, NULL if the ring is full */
+static inline struct io_uring_sqe *
+tap_uring_sqe_get(struct tap_uring *ring)
+{
+	struct io_uring_sqe *sqe;
+	uint32_t head;
+
+	head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+	if (ring->sq_prepared - head >= ring->sq_entries)
+		return NULL;
+
+	sqe = &ring->sqes[ring->sq_prepared++ & ring->sq_mask];
+	memset(sqe, 0, sizeof(*sqe));
+
+	return sqe;
+}
+
+/* Submit the prepared entries and wait for wait_nr completions */
+static int
+tap_uring_submit(struct tap_uring *ring, uint32_t wait_nr)
+{
+	uint32_t to_submit = ring->sq_prepared - ring->sq_submitted;
+	int ret;
+
+	if (to_submit == 0 && wait_nr == 0)
+		return 0;
+
+	/* Make the entries visible to the kernel before the tail */
+	__atomic_store_n(ring->sq_tail, ring->sq_prepared, __ATOMIC_RELEASE);
+	ret = syscall(__NR_io_uring_enter, ring->fd, to_submit, wait_nr,
+		      wait_nr ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	if (ret < 0)
+		return -errno;
+	/* The entries not consumed are submitted again next time */
+	ring->sq_submitted += ret;
+
+	return ret;
+}
+
+static inline uint32_t
+tap_uring_cq_ready(struct tap_uring *ring)
+{
+	return __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE) -
+		*ring->cq_head;
+}
+
+static inline struct io_uring_cqe *
+tap_uring_cqe(struct tap_uring *ring, uint32_t i)
+{
+	return &ring->cqes[(*ring->cq_head + i) & ring->cq_mask];
+}
+
+static inline void
+tap_uring_cq_advance(struct tap_uring *ring, uint32_t nb)
+{
+	/* The entries are read before the kernel may reuse them */
+	__atomic_store_n(ring->cq_head, *ring->cq_head + nb, __ATOMIC_RELEASE);
+}
+
+/* Cancel all the requests posted on a ring */
+static void
+tap_uring_cancel(struct tap_uring *ring, uint64_t user_data)
+{
+	struct io_uring_sqe *sqe;
+
+	sqe = tap_uring_sqe_get(ring);
+	if (sqe == NULL) {
+		tap_uring_submit(ring, 0);
+		sqe = tap_uring_sqe_get(ring);
+		if (sqe == NULL)
+			return;
+	}
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = user_data;
+	sqe->user_data = TAP_URING_CANCEL;
+}
+
+static void
+tap_uring_rx_buf_add(struct rte_mempool *mp __rte_unused, void *opaque,
+		     struct rte_mempool_memhdr *memhdr,
+		     unsigned int mem_idx __rte_unused)
+{
+	struct tap_uring_rxq *rxq = opaque;
+
+	if (rxq->nb_bufs < TAP_URING_RX_BUFS_MAX) {
+		rxq->bufs[rxq->nb_bufs].iov_base = memhdr->addr;
+		rxq->bufs[rxq->nb_bufs].iov_len = memhdr->len;
+	}
+	rxq->nb_bufs++;
+}
+
+static void
+tap_uring_rx_bufs_register(struct tap_uring_rxq *rxq)
+{
+	rxq->nb_bufs = 0;
+	rte_mempool_mem_iter(rxq->mp, tap_uring_rx_buf_add, rxq);
+
+	/* The registration may also fail because of the locked memory
+	 * limit: the reads still work, only slower.
+	 */
+	if (rxq->nb_bufs > TAP_URING_RX_BUFS_MAX ||
+	    syscall(__NR_io_uring_register, rxq->ring.fd,
+		    IORING_REGISTER_BUFFERS, rxq->bufs, rxq->nb_bufs) < 0) {
+		TAP_LOG(DEBUG, "cannot register mempool %s, using plain reads",
+			rxq->mp->name);
+		rxq->nb_bufs = 0;
+	}
+}
+
+/* Find the registered buffer holding an area, starting with the last one */
+static inline int
+tap_uring_rx_buf_find(struct tap_uring_rxq *rxq, const void *addr,
+		      uint32_t len)
+{
+	const struct iovec *buf;
+	uint32_t i, idx;
+
+	for (i = 0; i < rxq->nb_bufs; i++) {
+		idx = (rxq->last_buf + i) % rxq->nb_bufs;
+		buf = &rxq->bufs[idx];
+		if (addr >= buf->iov_base &&
+		    RTE_PTR_DIFF(RTE_PTR_ADD(addr, len), buf->iov_base) <=
+				buf->iov_len) {
+			rxq->last_buf = idx;
+			return idx;
+		}
+	}
+
+	return -1;
+}
+
+/* Post the read of a packet in an mbuf on a slot */
+static inline void
+tap_uring_rx_post(struct tap_uring_rxq *rxq, uint32_t slot,
+		  struct rte_mbuf *mbuf)
+{
+	struct io_uring_sqe *sqe;
+	uint32_t len;
+	void *addr;
+	int buf;
+
+	/* There is at most a prepared entry per slot */
+	sqe = tap_uring_sqe_get(&rxq->ring);
+	RTE_ASSERT(sqe != NULL);
+
+	/* The packet information is read in the headroom */
+	addr = rte_pktmbuf_mtod_offset(mbuf, char *,
+				       -(int)sizeof(struct tun_pi));
+	len = rte_pktmbuf_tailroom(mbuf) + sizeof(struct tun_pi);
+	buf = tap_uring_rx_buf_find(rxq, addr, len);
+	if (buf >= 0) {
+		sqe->opcode = IORING_OP_READ_FIXED;
+		sqe->buf_index = buf;
+	} else {
+		sqe->opcode = IORING_OP_READ;
+	}
+	sqe->fd = rxq->fd;
+	sqe->addr = (uintptr_t)addr;
+	sqe->len = len;
+	sqe->user_data = slot;
+	rxq->mbufs[slot] = mbuf;
+}
+
+void
+tap_uring_rxq_free(struct tap_uring_rxq *rxq)
+{
+	struct tap_uring *ring;
+	struct io_uring_cqe *cqe;
+	uint32_t i, nb;
+	int ret;
+
+	if (rxq == NULL)
+		return;
+	ring = &rxq->ring;
+
+	/* The mbufs are freed once their reads are cancelled or done */
+	for (i = 0; i < rxq->nb_slots; i++)
+		if (rxq->mbufs[i] != NULL)
+			tap_uring_cancel(ring, i);
+	while (rxq->nb_inflight > 0) {
+		ret = tap_uring_submit(ring, 1);
+		if (ret < 0 && ret != -EINTR) {
+			TAP_LOG(ERR, "failed to cancel %u reads: %s",
+				rxq->nb_inflight, strerror(-ret));
+			break;
+		}
+		nb = tap_uring_cq_ready(ring);
+		for (i = 0; i < nb; i++) {
+			cqe = tap_uring_cqe(ring, i);
+			if (cqe->user_data == TAP_URING_CANCEL)
+				continue;
+			rte_pktmbuf_free(rxq->mbufs[cqe->user_data]);
+			rxq->mbufs[cqe->user_data] = NULL;
+			rxq->nb_inflight--;
+		}
+		tap_uring_cq_advance(ring, nb);
+	}
+
+	tap_uring_fini(ring);
+	rte_free(rxq);
+}
+
+struct tap_uring_rxq *
+tap_uring_rxq_create(int fd, struct rte_mempool *mp, uint16_t nb_desc,
+		     struct pkt_stats *stats, int socket_id)
+{
+	struct tap_uring_rxq *rxq;
+	struct rte_mbuf *mbuf;
+	uint32_t entries;
+	uint32_t i;
+	int ret;
+
+	if (RTE_PKTMBUF_HEADROOM < sizeof(struct tun_pi)) {
+		rte_errno = ENOTSUP;
+		return NULL;
+	}
+
+	entries = rte_align32pow2(RTE_MIN(RTE_MAX(nb_desc, 1),
+					  TAP_URING_DESC_MAX));
+	rxq = rte_zmalloc_socket("tap_uring_rxq", sizeof(*rxq) +
+				 entries * sizeof(rxq->mbufs[0]),
+				 RTE_CACHE_LINE_SIZE, socket_id);
+	if (rxq == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	ret = tap_uring_init(&rxq->ring, entries);
+	if (ret < 0) {
+		rte_free(rxq);
+		rte_errno = -ret;
+		return NULL;
+	}
+	rxq->fd = fd;
+	rxq->mp = mp;
+	rxq->stats = stats;
+	rxq->nb_slots = RTE_MIN(entries, rxq->ring.sq_entries);
+	tap_uring_rx_bufs_register(rxq);
+
+	for (i = 0; i < rxq->nb_slots; i++) {
+		mbuf = rte_pktmbuf_alloc(mp);
+		if (mbuf == NULL) {
+			ret = -ENOMEM;
+			goto error;
+		}
+		tap_uring_rx_post(rxq, i, mbuf);
+		rxq->nb_inflight++;
+	}
+	ret = tap_uring_submit(&rxq->ring, 0);
+	if (ret < 0)
+		goto error;
+
+	return rxq;
+
+error:
+	tap_uring_rxq_free(rxq);
+	rte_errno = -ret;
+	return NULL;
+}
+
+uint16_t
+tap_uring_rx(struct tap_uring_rxq *rxq, struct rte_mbuf **bufs,
+	     uint16_t nb_pkts)
+{
+	struct tap_uring *ring = &rxq->ring;
+	struct rte_mbuf *repl[TAP_URING_RX_BURST];
+	struct io_uring_cqe *cqe;
+	struct rte_mbuf *mbuf;
+	struct tun_pi *pi;
+	uint32_t nb, i, slot;
+	uint16_t num_rx = 0;
+
+	nb = RTE_MIN(tap_uring_cq_ready(ring),
+		     RTE_MIN(nb_pkts, (uint32_t)TAP_URING_RX_BURST));
+	if (nb == 0)
+		return 0;
+
+	/* Replace the mbufs before handing them out, to keep a read posted
+	 * on each slot.
+	 */
+	if (unlikely(rte_pktmbuf_alloc_bulk(rxq->mp, repl, nb) != 0)) {
+		rxq->stats->rx_nombuf++;
+		return 0;
+	}
+
+	for (i = 0; i < nb; i++) {
+		cqe = tap_uring_cqe(ring, i);
+		slot = cqe->user_data;
+		mbuf = rxq->mbufs[slot];
+		pi = rte_pktmbuf_mtod_offset(mbuf, struct tun_pi *,
+					     -(int)sizeof(*pi));
+
+		/* Read error, or packet couldn't fit in the mbuf */
+		if (unlikely(cqe->res < (int)sizeof(*pi) ||
+			     (pi->flags & TUN_PKT_STRIP))) {
+			rxq->stats->ierrors++;
+			rte_pktmbuf_free(repl[i]);
+			tap_uring_rx_post(rxq, slot, mbuf);
+			continue;
+		}
+
+		mbuf->data_len = cqe->res - sizeof(*pi);
+		mbuf->pkt_len = mbuf->data_len;
+		bufs[num_rx++] = mbuf;
+		tap_uring_rx_post(rxq, slot, repl[i]);
+	}
+	tap_uring_cq_advance(ring, nb);
+	tap_uring_submit(ring, 0);
+
+	return num_rx;
+}
+
+/* Free the mbufs of the completed writes and their slots */
+static void
+tap_uring_tx_complete(struct tap_uring_txq *txq)
+{
+	struct tap_uring *ring = &txq->ring;
+	struct io_uring_cqe *cqe;
+	uint32_t nb, i, slot;
+
+	nb = tap_uring_cq_ready(ring);
+	for (i = 0; i < nb; i++) {
+		cqe = tap_uring_cqe(ring, i);
+		slot = cqe->user_data;
+		if (unlikely(cqe->res < 0))
+			txq->stats->errs++;
+		rte_pktmbuf_free(txq->slots[slot].mbuf);
+		txq->slots[slot].mbuf = NULL;
+		txq->free[txq->nb_free++] = slot;
+	}
+	tap_uring_cq_advance(ring, nb);
+}
+
+void
+tap_uring_txq_free(struct tap_uring_txq *txq)
+{
+	int ret;
+
+	if (txq == NULL)
+		return;
+
+	/* Writes to a tap are not cancellable, wait for them */
+	while (txq->nb_free < txq->nb_slots) {
+		ret = tap_uring_submit(&txq->ring, 1);
+		if (ret < 0 && ret != -EINTR) {
+			TAP_LOG(ERR, "failed to wait for %u writes: %s",
+				txq->nb_slots - txq->nb_free, strerror(-ret));
+			break;
+		}
+		tap_uring_tx_complete(txq);
+	}
+
+	tap_uring_fini(&txq->ring);
+	rte_free(txq);
+}
+
+struct tap_uring_txq *
+tap_uring_txq_create(int fd, uint16_t nb_desc, struct pkt_stats *stats,
+		     int socket_id)
+{
+	struct tap_uring_txq *txq;
+	uint32_t entries;
+	uint32_t i;
+	int ret;
+
+	entries = rte_align32pow2(RTE_MIN(RTE_MAX(nb_desc, 1),
+					  TAP_URING_DESC_MAX));
+	txq = rte_zmalloc_socket("tap_uring_txq", sizeof(*txq) +
+				 entries * (sizeof(txq->slots[0]) +
+					    sizeof(txq->free[0])),
+				 RTE_CACHE_LINE_SIZE, socket_id);
+	if (txq == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	ret = tap_uring_init(&txq->ring, entries);
+	if (ret < 0) {
+		rte_free(txq);
+		rte_errno = -ret;
+		return NULL;
+	}
+	txq->fd = fd;
+	txq->stats = stats;
+	txq->nb_slots = RTE_MIN(entries, txq->ring.sq_entries);
+	txq->free = (uint32_t *)&txq->slots[entries];
+	for (i = 0; i < txq->nb_slots; i++)
+		txq->free[i] = txq->nb_slots - i - 1;
+	txq->nb_free = txq->nb_slots;
+
+	return txq;
+}
+
+int
+tap_uring_tx_reserve(struct tap_uring_txq *txq, uint16_t nb_writes)
+{
+	if (nb_writes > txq->nb_slots)
+		return -EINVAL;
+
+	if (txq->nb_free < nb_writes) {
+		/* Writes to a tap usually complete on submission */
+		tap_uring_tx_submit(txq);
+		if (txq->nb_free < nb_writes)
+			return -EAGAIN;
+	}
+
+	return 0;
+}
+
+struct tap_uring_tx_slot *
+tap_uring_tx_slot_get(struct tap_uring_txq *txq)
+{
+	if (txq->nb_free == 0) {
+		/* Writes to a tap usually complete on submission */
+		tap_uring_tx_submit(txq);
+		if (txq->nb_free == 0)
+			return NULL;
+	}
+
+	return &txq->slots[txq->free[txq->nb_free - 1]];
+}
+
+void
+tap_uring_tx_post(struct tap_uring_txq *txq, struct tap_uring_tx_slot *slot,
+		  struct rte_mbuf *mbuf, int nb_iovecs)
+{
+	struct io_uring_sqe *sqe;
+	struct rte_mbuf *seg;
+
+	/* There is at most a prepared entry per slot */
+	sqe = tap_uring_sqe_get(&txq->ring);
+	RTE_ASSERT(sqe != NULL);
+
+	/* Keep the segments until the write completes */
+	for (seg = mbuf; seg != NULL; seg = seg->next)
+		rte_mbuf_refcnt_update(seg, 1);
+	slot->mbuf = mbuf;
+	txq->nb_free--;
+
+	sqe->opcode = IORING_OP_WRITEV;
+	sqe->fd = txq->fd;
+	sqe->addr = (uintptr_t)slot->iovecs;
+	sqe->len = nb_iovecs;
+	sqe->user_data = slot - txq->slots;
+}
+
+void
+tap_uring_tx_submit(struct tap_uring_txq *txq)
+{
+	tap_uring_submit(&txq->ring, 0);
+	tap_uring_tx_complete(txq);
+}
+
+#else /* HAVE_IO_URING */
+
+struct tap_uring_rxq *
+tap_uring_rxq_create(int fd __rte_unused, struct rte_mempool *mp __rte_unused,
+		     uint16_t nb_desc __rte_unused,
+		     struct pkt_stats *stats __rte_unused,
+		     int socket_id __rte_unused)
+{
+	rte_errno = ENOTSUP;
+	return NULL;
+}
+
+void
+tap_uring_rxq_free(struct tap_uring_rxq *rxq __rte_unused)
+{
+}
+
+uint16_t
+tap_uring_rx(struct tap_uring_rxq *rxq __rte_unused,
+	     struct rte_mbuf **bufs __rte_unused,
+	     uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
+
+struct tap_uring_txq *
+tap_uring_txq_create(int fd __rte_unused, uint16_t nb_desc __rte_unused,
+		     struct pkt_stats *stats __rte_unused,
+		     int socket_id __rte_unused)
+{
+	rte_errno = ENOTSUP;
+	return NULL;
+}
+
+void
+tap_uring_txq_free(struct tap_uring_txq *txq __rte_unused)
+{
+}
+
+int
+tap_uring_tx_reserve(struct tap_uring_txq *txq __rte_unused,
+		     uint16_t nb_writes __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+struct tap_uring_tx_slot *
+tap_uring_tx_slot_get(struct tap_uring_txq *txq __rte_unused)
+{
+	return NULL;
+}
+
+void
+tap_uring_tx_post(struct tap_uring_txq *txq __rte_unused,
+		  struct tap_uring_tx_slot *slot __rte_unused,
+		  struct rte_mbuf *mbuf __rte_unused,
+		  int nb_iovecs __rte_unused)
+{
+}
+
+void
+tap_uring_tx_submit(struct tap_uring_txq *txq __rte_unused)
+{
+}
+
+#endif /* HAVE_IO_URING */
@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#ifndef _TAP_URING_H_
+#define _TAP_URING_H_
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <linux/if_tun.h>
+
+#include <rte_mbuf.h>
+
+/* Maximum number of reads or writes posted on a queue */
+#define TAP_URING_DESC_MAX 4096
+
+/* Maximum number of segments of a packet written through io_uring */
+#define TAP_URING_TX_SEGS_MAX 32
+
+/* Larger than the longest l2 + l3 + l4 headers of an mbuf */
+#define TAP_URING_TX_HDR_MAX 1024
+
+struct pkt_stats;
+struct tap_uring_rxq;
+struct tap_uring_txq;
+
+/* Storage of a packet write, until its completion */
+struct tap_uring_tx_slot {
+	struct rte_mbuf *mbuf;          /* Packet, freed on completion */
+	struct tun_pi pi;               /* Packet info for iovecs */
+	/* Packet info, headers copy and segments */
+	struct iovec iovecs[TAP_URING_TX_SEGS_MAX + 2];
+	char hdr[TAP_URING_TX_HDR_MAX]; /* Headers copy for checksums */
+};
+
+struct tap_uring_rxq *tap_uring_rxq_create(int fd, struct rte_mempool *mp,
+		uint16_t nb_desc, struct pkt_stats *stats, int socket_id);
+void tap_uring_rxq_free(struct tap_uring_rxq *rxq);
+uint16_t tap_uring_rx(struct tap_uring_rxq *rxq, struct rte_mbuf **bufs,
+		uint16_t nb_pkts);
+
+struct tap_uring_txq *tap_uring_txq_create(int fd, uint16_t nb_desc,
+		struct pkt_stats *stats, int socket_id);
+void tap_uring_txq_free(struct tap_uring_txq *txq);
+/*
+ * Check that nb_writes writes can be posted, reaping the completed ones.
+ * Return -EAGAIN if the slots are busy, -EINVAL if there are not enough.
+ */
+int tap_uring_tx_reserve(struct tap_uring_txq *txq, uint16_t nb_writes);
+struct tap_uring_tx_slot *tap_uring_tx_slot_get(struct tap_uring_txq *txq);
+void tap_uring_tx_post(struct tap_uring_txq *txq,
+		struct tap_uring_tx_slot *slot, struct rte_mbuf *mbuf,
+		int nb_iovecs);
+void tap_uring_tx_submit(struct tap_uring_txq *txq);
+
+#endif /* _TAP_URING_H_ */
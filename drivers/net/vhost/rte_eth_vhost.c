@@ -34,6 +34,9 @@ enum {VIRTIO_RXQ, VIRTIO_TXQ, VIRTIO_QNUM};
 #define ETH_VHOST_VIRTIO_NET_F_HOST_TSO "tso"
 #define ETH_VHOST_LINEAR_BUF  "linear-buffer"
 #define ETH_VHOST_EXT_BUF  "ext-buffer"
+#define ETH_VHOST_VRING_STATS "vring-stats"
+#define ETH_VHOST_COALESCE_PKTS "coalesce-pkts"
+#define ETH_VHOST_COALESCE_USECS "coalesce-usecs"
 #define VHOST_MAX_PKT_BURST 32
 
 static const char *valid_arguments[] = {
@@ -45,6 +48,9 @@ static const char *valid_arguments[] = {
 	ETH_VHOST_VIRTIO_NET_F_HOST_TSO,
 	ETH_VHOST_LINEAR_BUF,
 	ETH_VHOST_EXT_BUF,
+	ETH_VHOST_VRING_STATS,
+	ETH_VHOST_COALESCE_PKTS,
+	ETH_VHOST_COALESCE_USECS,
 	NULL
 };
 
@@ -110,6 +116,8 @@ struct pmd_internal {
 	int vid;
 	rte_atomic32_t started;
 	uint8_t vlan_strip;
+	uint16_t coalesce_pkts;
+	uint16_t coalesce_usecs;
 };
 
 struct internal_list {
@@ -227,12 +235,60 @@ static const struct vhost_xstats_name_off vhost_txport_stat_strings[] = {
 #define VHOST_NB_XSTATS_TXPORT (sizeof(vhost_txport_stat_strings) / \
 				sizeof(vhost_txport_stat_strings[0]))
 
+/*
+ * Fill the virtqueues whose vhost library statistics are reported,
+ * if they are enabled and the device is attached.
+ */
+static unsigned int
+vhost_dev_vring_xstats_queues(struct rte_eth_dev *dev, uint16_t *qids)
+{
+	struct pmd_internal *internal = dev->data->dev_private;
+	unsigned int i, n = 0;
+	uint16_t nr_vring;
+
+	if (!(internal->flags & RTE_VHOST_USER_NET_STATS_ENABLE) ||
+	    rte_atomic32_read(&internal->dev_attached) == 0)
+		return 0;
+
+	nr_vring = rte_vhost_get_vring_num(internal->vid);
+	for (i = 0; i < dev->data->nb_rx_queues; i++)
+		if (i * VIRTIO_QNUM + VIRTIO_TXQ < nr_vring)
+			qids[n++] = i * VIRTIO_QNUM + VIRTIO_TXQ;
+	for (i = 0; i < dev->data->nb_tx_queues; i++)
+		if (i * VIRTIO_QNUM + VIRTIO_RXQ < nr_vring)
+			qids[n++] = i * VIRTIO_QNUM + VIRTIO_RXQ;
+
+	return n;
+}
+
+/* Number of vhost library statistics of each virtqueue. */
+static unsigned int
+vhost_dev_vring_xstats_num(struct rte_eth_dev *dev, const uint16_t *qids,
+			   unsigned int nb_qids)
+{
+	struct pmd_internal *internal = dev->data->dev_private;
+	int ret;
+
+	if (nb_qids == 0)
+		return 0;
+
+	ret = rte_vhost_vring_stats_get_names(internal->vid, qids[0], NULL, 0);
+	return ret < 0 ? 0 : ret;
+}
+
 static int
 vhost_dev_xstats_reset(struct rte_eth_dev *dev)
 {
+	struct pmd_internal *internal = dev->data->dev_private;
+	uint16_t qids[RTE_MAX_QUEUES_PER_PORT * 2];
 	struct vhost_queue *vq = NULL;
+	unsigned int nb_qids;
 	unsigned int i = 0;
 
+	nb_qids = vhost_dev_vring_xstats_queues(dev, qids);
+	for (i = 0; i < nb_qids; i++)
+		rte_vhost_vring_stats_reset(internal->vid, qids[i]);
+
 	for (i = 0; i < dev->data->nb_rx_queues; i++) {
 		vq = dev->data->rx_queues[i];
 		if (!vq)
@@ -250,15 +306,23 @@ vhost_dev_xstats_reset(struct rte_eth_dev *dev)
 }
 
 static int
-vhost_dev_xstats_get_names(struct rte_eth_dev *dev __rte_unused,
+vhost_dev_xstats_get_names(struct rte_eth_dev *dev,
 			   struct rte_eth_xstat_name *xstats_names,
-			   unsigned int limit __rte_unused)
+			   unsigned int limit)
 {
-	unsigned int t = 0;
+	struct pmd_internal *internal = dev->data->dev_private;
+	uint16_t qids[RTE_MAX_QUEUES_PER_PORT * 2];
+	struct rte_vhost_stat_name *names;
+	unsigned int nb_qids, nb_vring_stats;
+	unsigned int q, t = 0;
 	int count = 0;
 	int nstats = VHOST_NB_XSTATS_RXPORT + VHOST_NB_XSTATS_TXPORT;
 
-	if (!xstats_names)
+	nb_qids = vhost_dev_vring_xstats_queues(dev, qids);
+	nb_vring_stats = vhost_dev_vring_xstats_num(dev, qids, nb_qids);
+	nstats += nb_qids * nb_vring_stats;
+
+	if (!xstats_names || limit < (unsigned int)nstats)
 		return nstats;
 	for (t = 0; t < VHOST_NB_XSTATS_RXPORT; t++) {
 		snprintf(xstats_names[count].name,
@@ -272,6 +336,27 @@ vhost_dev_xstats_get_names(struct rte_eth_dev *dev __rte_unused,
 			 "tx_%s", vhost_txport_stat_strings[t].name);
 		count++;
 	}
+
+	if (nb_vring_stats == 0)
+		return count;
+
+	names = calloc(nb_vring_stats, sizeof(*names));
+	if (names == NULL)
+		return -ENOMEM;
+	for (q = 0; q < nb_qids; q++) {
+		if (rte_vhost_vring_stats_get_names(internal->vid, qids[q],
+				names, nb_vring_stats) != (int)nb_vring_stats) {
+			free(names);
+			return -EINVAL;
+		}
+		for (t = 0; t < nb_vring_stats; t++) {
+			strlcpy(xstats_names[count].name, names[t].name,
+				sizeof(xstats_names[count].name));
+			count++;
+		}
+	}
+	free(names);
+
 	return count;
 }
 
@@ -279,12 +364,20 @@ static int
 vhost_dev_xstats_get(struct rte_eth_dev *dev, struct rte_eth_xstat *xstats,
 		     unsigned int n)
 {
-	unsigned int i;
+	struct pmd_internal *internal = dev->data->dev_private;
+	uint16_t qids[RTE_MAX_QUEUES_PER_PORT * 2];
+	struct rte_vhost_stat *vring_stats;
+	unsigned int nb_qids, nb_vring_stats;
+	unsigned int i, q;
 	unsigned int t;
 	unsigned int count = 0;
 	struct vhost_queue *vq = NULL;
 	unsigned int nxstats = VHOST_NB_XSTATS_RXPORT + VHOST_NB_XSTATS_TXPORT;
 
+	nb_qids = vhost_dev_vring_xstats_queues(dev, qids);
+	nb_vring_stats = vhost_dev_vring_xstats_num(dev, qids, nb_qids);
+	nxstats += nb_qids * nb_vring_stats;
+
 	if (n < nxstats)
 		return nxstats;
 
@@ -314,6 +407,27 @@ vhost_dev_xstats_get(struct rte_eth_dev *dev, struct rte_eth_xstat *xstats,
 		xstats[count].id = count;
 		count++;
 	}
+
+	if (nb_vring_stats == 0)
+		return count;
+
+	vring_stats = calloc(nb_vring_stats, sizeof(*vring_stats));
+	if (vring_stats == NULL)
+		return -ENOMEM;
+	for (q = 0; q < nb_qids; q++) {
+		if (rte_vhost_vring_stats_get(internal->vid, qids[q],
+				vring_stats, nb_vring_stats) != (int)nb_vring_stats) {
+			free(vring_stats);
+			return -EINVAL;
+		}
+		for (t = 0; t < nb_vring_stats; t++) {
+			xstats[count].value = vring_stats[t].value;
+			xstats[count].id = count;
+			count++;
+		}
+	}
+	free(vring_stats);
+
 	return count;
 }
 
@@ -446,6 +560,10 @@ eth_vhost_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 		++nb_send;
 	}
 
+	/* An empty burst sends the notification deferred by coalescing. */
+	if (unlikely(nb_bufs == 0) && r->internal->coalesce_pkts > 1)
+		rte_vhost_enqueue_burst(r->vid, r->virtqueue_id, bufs, 0);
+
 	/* Enqueue packets to guest RX queue */
 	while (nb_send) {
 		uint16_t nb_pkts;
@@ -822,6 +940,13 @@ new_device(int vid)
 	for (i = 0; i < rte_vhost_get_vring_num(vid); i++)
 		rte_vhost_enable_guest_notification(vid, i, 0);
 
+	if (internal->coalesce_pkts > 1) {
+		for (i = 0; i < rte_vhost_get_vring_num(vid); i++)
+			rte_vhost_vring_coalesce_set(vid, i,
+					internal->coalesce_pkts,
+					internal->coalesce_usecs);
+	}
+
 	rte_vhost_get_mtu(vid, &eth_dev->data->mtu);
 
 	eth_dev->data->dev_link.link_status = RTE_ETH_LINK_UP;
@@ -1454,7 +1579,8 @@ static const struct eth_dev_ops ops = {
 static int
 eth_dev_vhost_create(struct rte_vdev_device *dev, char *iface_name,
 	int16_t queues, const unsigned int numa_node, uint64_t flags,
-	uint64_t disable_flags)
+	uint64_t disable_flags, uint16_t coalesce_pkts,
+	uint16_t coalesce_usecs)
 {
 	const char *name = rte_vdev_device_name(dev);
 	struct rte_eth_dev_data *data;
@@ -1496,6 +1622,8 @@ eth_dev_vhost_create(struct rte_vdev_device *dev, char *iface_name,
 	internal->vid = -1;
 	internal->flags = flags;
 	internal->disable_flags = disable_flags;
+	internal->coalesce_pkts = coalesce_pkts;
+	internal->coalesce_usecs = coalesce_usecs;
 	data->dev_link = pmd_link;
 	data->dev_flags = RTE_ETH_DEV_INTR_LSC |
 				RTE_ETH_DEV_AUTOFILL_QUEUE_XSTATS;
@@ -1563,6 +1691,9 @@ rte_pmd_vhost_probe(struct rte_vdev_device *dev)
 	int tso = 0;
 	int linear_buf = 0;
 	int ext_buf = 0;
+	int vring_stats = 0;
+	uint16_t coalesce_pkts = 0;
+	uint16_t coalesce_usecs = 0;
 	struct rte_eth_dev *eth_dev;
 	const char *name = rte_vdev_device_name(dev);
 
@@ -1672,11 +1803,46 @@ rte_pmd_vhost_probe(struct rte_vdev_device *dev)
 			flags |= RTE_VHOST_USER_EXTBUF_SUPPORT;
 	}
 
+	if (rte_kvargs_count(kvlist, ETH_VHOST_VRING_STATS) == 1) {
+		ret = rte_kvargs_process(kvlist,
+				ETH_VHOST_VRING_STATS,
+				&open_int, &vring_stats);
+		if (ret < 0)
+			goto out_free;
+
+		if (vring_stats == 1)
+			flags |= RTE_VHOST_USER_NET_STATS_ENABLE;
+	}
+
+	if (rte_kvargs_count(kvlist, ETH_VHOST_COALESCE_PKTS) == 1) {
+		ret = rte_kvargs_process(kvlist,
+				ETH_VHOST_COALESCE_PKTS,
+				&open_int, &coalesce_pkts);
+		if (ret < 0)
+			goto out_free;
+	}
+
+	if (rte_kvargs_count(kvlist, ETH_VHOST_COALESCE_USECS) == 1) {
+		ret = rte_kvargs_process(kvlist,
+				ETH_VHOST_COALESCE_USECS,
+				&open_int, &coalesce_usecs);
+		if (ret < 0)
+			goto out_free;
+	}
+
+	if (coalesce_pkts > 1 && coalesce_usecs == 0) {
+		VHOST_LOG(ERR, "%s requires %s\n", ETH_VHOST_COALESCE_PKTS,
+			ETH_VHOST_COALESCE_USECS);
+		ret = -EINVAL;
+		goto out_free;
+	}
+
 	if (dev->device.numa_node == SOCKET_ID_ANY)
 		dev->device.numa_node = rte_socket_id();
 
 	ret = eth_dev_vhost_create(dev, iface_name, queues,
-				   dev->device.numa_node, flags, disable_flags);
+				   dev->device.numa_node, flags, disable_flags,
+				   coalesce_pkts, coalesce_usecs);
 	if (ret == -1)
 		VHOST_LOG(ERR, "Failed to create %s\n", name);
 
@@ -1720,4 +1886,7 @@ RTE_PMD_REGISTER_PARAM_STRING(net_vhost,
 	"postcopy-support=<0|1> "
 	"tso=<0|1> "
 	"linear-buffer=<0|1> "
-	"ext-buffer=<0|1>");
+	"ext-buffer=<0|1> "
+	"vring-stats=<0|1> "
+	"coalesce-pkts=<int> "
+	"coalesce-usecs=<int>");
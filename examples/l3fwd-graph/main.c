@@ -23,14 +23,19 @@
 #include <rte_cycles.h>
 #include <rte_eal.h>
 #include <rte_ethdev.h>
+#include <rte_event_eth_rx_adapter.h>
+#include <rte_event_eth_tx_adapter.h>
+#include <rte_eventdev.h>
 #include <rte_graph_worker.h>
 #include <rte_launch.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
 #include <rte_mempool.h>
 #include <rte_node_eth_api.h>
+#include <rte_node_eventdev_api.h>
 #include <rte_node_ip4_api.h>
 #include <rte_per_lcore.h>
+#include <rte_service.h>
 #include <rte_string_fns.h>
 #include <rte_vect.h>
 
@@ -55,6 +60,15 @@
 
 #define NB_SOCKETS 8
 
+/* Event mode always uses the first event device */
+#define EVENT_DEV_ID		 0
+#define EVENT_ADAPTER_ID	 0
+#define EVENT_NB_EVENTS_LIMIT	 4096
+#define EVENT_WORKER_QUEUE	 0
+#define EVENT_TX_QUEUE		 1
+#define EVENT_VECTOR_SIZE_DEFAULT RTE_GRAPH_BURST_SIZE
+#define EVENT_VECTOR_TMO_NS_DEFAULT 1E6 /* 1ms */
+
 /* Static global variables used within this file. */
 static uint16_t nb_rxd = RTE_TEST_RX_DESC_DEFAULT;
 static uint16_t nb_txd = RTE_TEST_TX_DESC_DEFAULT;
@@ -76,6 +90,13 @@ xmm_t val_eth[RTE_MAX_ETHPORTS];
 /* Mask of enabled ports */
 static uint32_t enabled_port_mask;
 
+/* Event mode, packet I/O through eventdev and its ethdev adapters */
+static bool event_mode;
+static uint8_t event_sched_type = RTE_SCHED_TYPE_ATOMIC;
+static bool event_vector;
+static uint16_t event_vector_size = EVENT_VECTOR_SIZE_DEFAULT;
+static uint64_t event_vector_tmo_ns = EVENT_VECTOR_TMO_NS_DEFAULT;
+
 struct lcore_rx_queue {
 	uint16_t port_id;
 	uint8_t queue_id;
@@ -131,6 +152,11 @@ static struct rte_mempool *pktmbuf_pool[RTE_MAX_ETHPORTS][NB_SOCKETS];
 
 static struct rte_node_ethdev_config ethdev_conf[RTE_MAX_ETHPORTS];
 
+static struct rte_mempool *vector_pool[RTE_MAX_ETHPORTS];
+static uint8_t event_ports[RTE_MAX_LCORE];
+static uint16_t event_eth_ports[RTE_MAX_ETHPORTS];
+static struct rte_node_eventdev_config eventdev_conf;
+
 struct ipv4_l3fwd_lpm_route {
 	uint32_t ip;
 	uint8_t depth;
@@ -262,7 +288,11 @@ print_usage(const char *prgname)
 		" [--eth-dest=X,MM:MM:MM:MM:MM:MM]"
 		" [--max-pkt-len PKTLEN]"
 		" [--no-numa]"
-		" [--per-port-pool]\n\n"
+		" [--per-port-pool]"
+		" [--mode]"
+		" [--eventq-sched]"
+		" [--event-vector [--event-vector-size SIZE]"
+		" [--event-vector-tmo NS]]\n\n"
 
 		"  -p PORTMASK: Hexadecimal bitmask of ports to configure\n"
 		"  -P : Enable promiscuous mode\n"
@@ -271,10 +301,64 @@ print_usage(const char *prgname)
 		"port X\n"
 		"  --max-pkt-len PKTLEN: maximum packet length in decimal (64-9600)\n"
 		"  --no-numa: Disable numa awareness\n"
-		"  --per-port-pool: Use separate buffer pool per port\n\n",
+		"  --per-port-pool: Use separate buffer pool per port\n"
+		"  --mode: Packet transfer mode for I/O, poll or eventdev\n"
+		"          Default mode = poll\n"
+		"  --eventq-sched: Event queue synchronization method\n"
+		"                  ordered, atomic or parallel.\n"
+		"                  Default: atomic\n"
+		"                  Valid only if --mode=eventdev\n"
+		"  --event-vector: Enable event vectorization\n"
+		"  --event-vector-size: Max vector size if event vectorization is enabled\n"
+		"  --event-vector-tmo: Max timeout to form vector in nanoseconds"
+		" if event vectorization is enabled\n\n",
 		prgname);
 }
 
+static int
+parse_mode(const char *optarg)
+{
+	if (!strcmp(optarg, "poll"))
+		event_mode = false;
+	else if (!strcmp(optarg, "eventdev"))
+		event_mode = true;
+	else
+		return -1;
+
+	return 0;
+}
+
+static int
+parse_eventq_sched(const char *optarg)
+{
+	if (!strcmp(optarg, "ordered"))
+		event_sched_type = RTE_SCHED_TYPE_ORDERED;
+	else if (!strcmp(optarg, "atomic"))
+		event_sched_type = RTE_SCHED_TYPE_ATOMIC;
+	else if (!strcmp(optarg, "parallel"))
+		event_sched_type = RTE_SCHED_TYPE_PARALLEL;
+	else
+		return -1;
+
+	return 0;
+}
+
+static int
+parse_uint(const char *arg, uint64_t max, uint64_t *val)
+{
+	unsigned long long v;
+	char *end = NULL;
+
+	errno = 0;
+	v = strtoull(arg, &end, 0);
+	if (errno != 0 || arg[0] == '\0' || end == NULL || *end != '\0' ||
+	    v == 0 || v > max)
+		return -1;
+
+	*val = v;
+	return 0;
+}
+
 static int
 parse_max_pkt_len(const char *pktlen)
 {
@@ -405,6 +489,11 @@ static const char short_options[] = "p:" /* portmask */
 #define CMD_LINE_OPT_NO_NUMA	   "no-numa"
 #define CMD_LINE_OPT_MAX_PKT_LEN   "max-pkt-len"
 #define CMD_LINE_OPT_PER_PORT_POOL "per-port-pool"
+#define CMD_LINE_OPT_MODE	   "mode"
+#define CMD_LINE_OPT_EVENTQ_SCHED  "eventq-sched"
+#define CMD_LINE_OPT_ENABLE_VECTOR "event-vector"
+#define CMD_LINE_OPT_VECTOR_SIZE   "event-vector-size"
+#define CMD_LINE_OPT_VECTOR_TMO_NS "event-vector-tmo"
 enum {
 	/* Long options mapped to a short option */
 
@@ -417,6 +506,11 @@ enum {
 	CMD_LINE_OPT_NO_NUMA_NUM,
 	CMD_LINE_OPT_MAX_PKT_LEN_NUM,
 	CMD_LINE_OPT_PARSE_PER_PORT_POOL,
+	CMD_LINE_OPT_MODE_NUM,
+	CMD_LINE_OPT_EVENTQ_SCHED_NUM,
+	CMD_LINE_OPT_ENABLE_VECTOR_NUM,
+	CMD_LINE_OPT_VECTOR_SIZE_NUM,
+	CMD_LINE_OPT_VECTOR_TMO_NS_NUM,
 };
 
 static const struct option lgopts[] = {
@@ -425,13 +519,19 @@ static const struct option lgopts[] = {
 	{CMD_LINE_OPT_NO_NUMA, 0, 0, CMD_LINE_OPT_NO_NUMA_NUM},
 	{CMD_LINE_OPT_MAX_PKT_LEN, 1, 0, CMD_LINE_OPT_MAX_PKT_LEN_NUM},
 	{CMD_LINE_OPT_PER_PORT_POOL, 0, 0, CMD_LINE_OPT_PARSE_PER_PORT_POOL},
+	{CMD_LINE_OPT_MODE, 1, 0, CMD_LINE_OPT_MODE_NUM},
+	{CMD_LINE_OPT_EVENTQ_SCHED, 1, 0, CMD_LINE_OPT_EVENTQ_SCHED_NUM},
+	{CMD_LINE_OPT_ENABLE_VECTOR, 0, 0, CMD_LINE_OPT_ENABLE_VECTOR_NUM},
+	{CMD_LINE_OPT_VECTOR_SIZE, 1, 0, CMD_LINE_OPT_VECTOR_SIZE_NUM},
+	{CMD_LINE_OPT_VECTOR_TMO_NS, 1, 0, CMD_LINE_OPT_VECTOR_TMO_NS_NUM},
 	{NULL, 0, 0, 0},
 };
 
 /*
  * This expression is used to calculate the number of mbufs needed
  * depending on user input, taking  into account memory for rx and
- * tx hardware rings, cache per lcore and mtable per port per lcore.
+ * tx hardware rings, cache per lcore, mtable per port per lcore and
+ * events in flight in event mode.
  * RTE_MAX is used to ensure that NB_MBUF never goes below a minimum
  * value of 8192
  */
@@ -439,7 +539,8 @@ static const struct option lgopts[] = {
 	RTE_MAX((nports * nb_rx_queue * nb_rxd +                               \
 		 nports * nb_lcores * RTE_GRAPH_BURST_SIZE +                   \
 		 nports * n_tx_queue * nb_txd +                                \
-		 nb_lcores * MEMPOOL_CACHE_SIZE), 8192u)
+		 nb_lcores * MEMPOOL_CACHE_SIZE +                              \
+		 (event_mode ? EVENT_NB_EVENTS_LIMIT : 0)), 8192u)
 
 /* Parse the argument given in the command line of the application */
 static int
@@ -449,6 +550,7 @@ parse_args(int argc, char **argv)
 	int option_index;
 	char **argvopt;
 	int opt, ret;
+	uint64_t val;
 
 	argvopt = argv;
 
@@ -499,6 +601,45 @@ parse_args(int argc, char **argv)
 			per_port_pool = 1;
 			break;
 
+		case CMD_LINE_OPT_MODE_NUM:
+			if (parse_mode(optarg)) {
+				fprintf(stderr, "Invalid mode\n");
+				print_usage(prgname);
+				return -1;
+			}
+			break;
+
+		case CMD_LINE_OPT_EVENTQ_SCHED_NUM:
+			if (parse_eventq_sched(optarg)) {
+				fprintf(stderr, "Invalid event queue sched\n");
+				print_usage(prgname);
+				return -1;
+			}
+			break;
+
+		case CMD_LINE_OPT_ENABLE_VECTOR_NUM:
+			printf("Event vectorization is enabled\n");
+			event_vector = true;
+			break;
+
+		case CMD_LINE_OPT_VECTOR_SIZE_NUM:
+			if (parse_uint(optarg, UINT16_MAX, &val)) {
+				fprintf(stderr, "Invalid event vector size\n");
+				print_usage(prgname);
+				return -1;
+			}
+			event_vector_size = val;
+			break;
+
+		case CMD_LINE_OPT_VECTOR_TMO_NS_NUM:
+			if (parse_uint(optarg, UINT64_MAX, &val)) {
+				fprintf(stderr, "Invalid event vector timeout\n");
+				print_usage(prgname);
+				return -1;
+			}
+			event_vector_tmo_ns = val;
+			break;
+
 		default:
 			print_usage(prgname);
 			return -1;
@@ -736,6 +877,333 @@ config_port_max_pkt_len(struct rte_eth_conf *conf,
 	return 0;
 }
 
+/* Event mode feeds a single Rx queue per port to the Rx adapter */
+static void
+event_eth_rx_queue_setup(uint16_t portid, uint32_t nb_mbuf)
+{
+	struct rte_eth_dev_info dev_info;
+	struct rte_eth_rxconf rxq_conf;
+	struct rte_mempool *pool;
+	uint8_t socketid;
+	int ret;
+
+	if (numa_on)
+		socketid = (uint8_t)rte_socket_id();
+	else
+		socketid = 0;
+
+	if (!per_port_pool)
+		pool = pktmbuf_pool[0][socketid];
+	else
+		pool = pktmbuf_pool[portid][socketid];
+
+	printf("rxq=%d,%d,%d ", portid, 0, socketid);
+	fflush(stdout);
+
+	rte_eth_dev_info_get(portid, &dev_info);
+	rxq_conf = dev_info.default_rxconf;
+	rxq_conf.offloads = port_conf.rxmode.offloads;
+	ret = rte_eth_rx_queue_setup(portid, 0, nb_rxd, socketid, &rxq_conf,
+				     pool);
+	if (ret < 0)
+		rte_exit(EXIT_FAILURE,
+			 "rte_eth_rx_queue_setup: err=%d, port=%d\n", ret,
+			 portid);
+
+	if (event_vector && vector_pool[portid] == NULL) {
+		char s[64];
+
+		snprintf(s, sizeof(s), "vector_pool_%d", portid);
+		vector_pool[portid] = rte_event_vector_pool_create(
+			s, (nb_mbuf + event_vector_size - 1) / event_vector_size,
+			0, event_vector_size, socketid);
+		if (vector_pool[portid] == NULL)
+			rte_exit(EXIT_FAILURE,
+				 "Failed to create vector pool for port %d\n",
+				 portid);
+	}
+}
+
+static void
+event_service_enable(uint32_t service_id)
+{
+	uint8_t min_service_count = UINT8_MAX;
+	uint32_t slcore_array[RTE_MAX_LCORE];
+	unsigned int slcore = 0;
+	uint8_t service_count;
+	int32_t slcore_count;
+
+	slcore_count = rte_service_lcore_list(slcore_array, RTE_MAX_LCORE);
+	if (slcore_count <= 0)
+		rte_exit(EXIT_FAILURE,
+			 "Event mode needs service cores, see -s option\n");
+
+	/* Get the core which has least number of services running. */
+	while (slcore_count--) {
+		/* Reset default mapping */
+		if (rte_service_map_lcore_set(service_id,
+					      slcore_array[slcore_count], 0))
+			rte_exit(EXIT_FAILURE, "Unable to map service %u\n",
+				 service_id);
+		service_count = rte_service_lcore_count_services(
+			slcore_array[slcore_count]);
+		if (service_count < min_service_count) {
+			slcore = slcore_array[slcore_count];
+			min_service_count = service_count;
+		}
+	}
+	if (rte_service_map_lcore_set(service_id, slcore, 1))
+		rte_exit(EXIT_FAILURE, "Unable to map service %u\n",
+			 service_id);
+	rte_service_runstate_set(service_id, 1);
+	rte_service_lcore_start(slcore);
+}
+
+/* Event device and adapters setup. 8< */
+static uint16_t
+event_setup(void)
+{
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter_queue_conf eth_q_conf;
+	struct rte_event_port_conf port_conf_def;
+	struct rte_event_queue_conf queue_conf;
+	struct rte_event_dev_config dev_conf;
+	struct rte_event_dev_info dev_info;
+	uint32_t caps, service_id, lcore_id;
+	uint8_t queue_id, tx_port_id;
+	uint16_t nb_workers = 0;
+	bool tx_internal = true;
+	bool rx_internal = true;
+	uint16_t nb_eth = 0;
+	uint16_t portid, i;
+	int ret;
+
+	if (rte_event_dev_count() == 0)
+		rte_exit(EXIT_FAILURE, "No event device found\n");
+
+	RTE_ETH_FOREACH_DEV(portid) {
+		if ((enabled_port_mask & (1 << portid)) == 0)
+			continue;
+		event_eth_ports[nb_eth++] = portid;
+
+		ret = rte_event_eth_rx_adapter_caps_get(EVENT_DEV_ID, portid,
+							&caps);
+		if (ret)
+			rte_exit(EXIT_FAILURE, "Unable to get Rx adapter caps\n");
+		if (!(caps & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT))
+			rx_internal = false;
+		if (event_vector &&
+		    !(caps & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR))
+			rte_exit(EXIT_FAILURE,
+				 "Event vectorization is not supported, port %u\n",
+				 portid);
+
+		ret = rte_event_eth_tx_adapter_caps_get(EVENT_DEV_ID, portid,
+							&caps);
+		if (ret)
+			rte_exit(EXIT_FAILURE, "Unable to get Tx adapter caps\n");
+		if (!(caps & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT))
+			tx_internal = false;
+	}
+
+	rte_event_dev_info_get(EVENT_DEV_ID, &dev_info);
+
+	/* One event port per worker lcore, each driving its own graph */
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		struct lcore_conf *qconf = &lcore_conf[lcore_id];
+
+		/* Keep one event port for each adapter */
+		if (nb_workers + 2 > dev_info.max_event_ports)
+			break;
+
+		snprintf(qconf->rx_queue_list[0].node_name, RTE_NODE_NAMESIZE,
+			 "eventdev_rx-%u-%u", EVENT_DEV_ID, nb_workers);
+		qconf->n_rx_queue = 1;
+		/* Graphs get created in lcore order */
+		qconf->graph_id = nb_workers;
+		event_ports[nb_workers] = nb_workers;
+		nb_workers++;
+	}
+	if (nb_workers == 0)
+		rte_exit(EXIT_FAILURE, "No worker lcore for event mode\n");
+
+	memset(&dev_conf, 0, sizeof(dev_conf));
+	/* Tx adapter without internal port needs a queue of its own */
+	dev_conf.nb_event_queues = tx_internal ? 1 : 2;
+	dev_conf.nb_event_ports = nb_workers;
+	dev_conf.nb_events_limit = EVENT_NB_EVENTS_LIMIT;
+	if (dev_info.max_num_events < dev_conf.nb_events_limit)
+		dev_conf.nb_events_limit = dev_info.max_num_events;
+	dev_conf.nb_event_queue_flows =
+		RTE_MIN(dev_info.max_event_queue_flows, 1024u);
+	dev_conf.nb_event_port_dequeue_depth =
+		dev_info.max_event_port_dequeue_depth;
+	dev_conf.nb_event_port_enqueue_depth =
+		dev_info.max_event_port_enqueue_depth;
+	ret = rte_event_dev_configure(EVENT_DEV_ID, &dev_conf);
+	if (ret < 0)
+		rte_exit(EXIT_FAILURE, "Unable to configure event device\n");
+
+	rte_event_queue_default_conf_get(EVENT_DEV_ID, 0, &queue_conf);
+	queue_conf.schedule_type = event_sched_type;
+	queue_conf.nb_atomic_flows = dev_conf.nb_event_queue_flows;
+	ret = rte_event_queue_setup(EVENT_DEV_ID, EVENT_WORKER_QUEUE,
+				    &queue_conf);
+	if (ret < 0)
+		rte_exit(EXIT_FAILURE, "Unable to setup event queue\n");
+
+	if (!tx_internal) {
+		queue_conf.event_queue_cfg = RTE_EVENT_QUEUE_CFG_SINGLE_LINK;
+		queue_conf.schedule_type = RTE_SCHED_TYPE_ATOMIC;
+		queue_conf.priority = RTE_EVENT_DEV_PRIORITY_HIGHEST;
+		ret = rte_event_queue_setup(EVENT_DEV_ID, EVENT_TX_QUEUE,
+					    &queue_conf);
+		if (ret < 0)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to setup Tx adapter event queue\n");
+	}
+
+	rte_event_port_default_conf_get(EVENT_DEV_ID, 0, &port_conf_def);
+	queue_id = EVENT_WORKER_QUEUE;
+	for (i = 0; i < nb_workers; i++) {
+		ret = rte_event_port_setup(EVENT_DEV_ID, event_ports[i],
+					   &port_conf_def);
+		if (ret < 0)
+			rte_exit(EXIT_FAILURE, "Unable to setup event port %u\n",
+				 event_ports[i]);
+		ret = rte_event_port_link(EVENT_DEV_ID, event_ports[i],
+					  &queue_id, NULL, 1);
+		if (ret != 1)
+			rte_exit(EXIT_FAILURE, "Unable to link event port %u\n",
+				 event_ports[i]);
+	}
+
+	/* Rx adapter spreads flows over the worker queue */
+	ret = rte_event_eth_rx_adapter_create(EVENT_ADAPTER_ID, EVENT_DEV_ID,
+					      &port_conf_def);
+	if (ret)
+		rte_exit(EXIT_FAILURE, "Unable to create Rx adapter\n");
+
+	memset(&eth_q_conf, 0, sizeof(eth_q_conf));
+	eth_q_conf.ev.queue_id = EVENT_WORKER_QUEUE;
+	eth_q_conf.ev.sched_type = event_sched_type;
+	eth_q_conf.ev.priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+	for (i = 0; i < nb_eth; i++) {
+		if (event_vector) {
+			ret = rte_event_eth_rx_adapter_vector_limits_get(
+				EVENT_DEV_ID, event_eth_ports[i], &limits);
+			if (ret)
+				rte_exit(EXIT_FAILURE,
+					 "Unable to get vector limits\n");
+			if (event_vector_size < limits.min_sz ||
+			    event_vector_size > limits.max_sz ||
+			    (limits.log2_sz &&
+			     !rte_is_power_of_2(event_vector_size)) ||
+			    event_vector_tmo_ns < limits.min_timeout_ns ||
+			    event_vector_tmo_ns > limits.max_timeout_ns)
+				rte_exit(EXIT_FAILURE,
+					 "Event vector config out of limits\n");
+
+			eth_q_conf.rx_queue_flags |=
+				RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+			eth_q_conf.vector_sz = event_vector_size;
+			eth_q_conf.vector_timeout_ns = event_vector_tmo_ns;
+			eth_q_conf.vector_mp =
+				vector_pool[event_eth_ports[i]];
+		}
+		ret = rte_event_eth_rx_adapter_queue_add(
+			EVENT_ADAPTER_ID, event_eth_ports[i], -1,
+			&eth_q_conf);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to add port %u to Rx adapter\n",
+				 event_eth_ports[i]);
+	}
+
+	if (!rx_internal) {
+		ret = rte_event_eth_rx_adapter_service_id_get(EVENT_ADAPTER_ID,
+							      &service_id);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to get Rx adapter service\n");
+		event_service_enable(service_id);
+	}
+
+	ret = rte_event_eth_rx_adapter_start(EVENT_ADAPTER_ID);
+	if (ret)
+		rte_exit(EXIT_FAILURE, "Unable to start Rx adapter\n");
+
+	/* Tx adapter transmits what the eventdev_tx nodes enqueue */
+	ret = rte_event_eth_tx_adapter_create(EVENT_ADAPTER_ID, EVENT_DEV_ID,
+					      &port_conf_def);
+	if (ret)
+		rte_exit(EXIT_FAILURE, "Unable to create Tx adapter\n");
+
+	for (i = 0; i < nb_eth; i++) {
+		ret = rte_event_eth_tx_adapter_queue_add(
+			EVENT_ADAPTER_ID, event_eth_ports[i], -1);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to add port %u to Tx adapter\n",
+				 event_eth_ports[i]);
+	}
+
+	if (!tx_internal) {
+		ret = rte_event_eth_tx_adapter_event_port_get(EVENT_ADAPTER_ID,
+							      &tx_port_id);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to get Tx adapter event port\n");
+		queue_id = EVENT_TX_QUEUE;
+		ret = rte_event_port_link(EVENT_DEV_ID, tx_port_id, &queue_id,
+					  NULL, 1);
+		if (ret != 1)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to link Tx adapter event port\n");
+
+		ret = rte_event_eth_tx_adapter_service_id_get(EVENT_ADAPTER_ID,
+							      &service_id);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to get Tx adapter service\n");
+		event_service_enable(service_id);
+	}
+
+	ret = rte_event_eth_tx_adapter_start(EVENT_ADAPTER_ID);
+	if (ret)
+		rte_exit(EXIT_FAILURE, "Unable to start Tx adapter\n");
+
+	/* Centralized schedulers such as event_sw run as a service */
+	if (!(dev_info.event_dev_cap & RTE_EVENT_DEV_CAP_DISTRIBUTED_SCHED)) {
+		ret = rte_event_dev_service_id_get(EVENT_DEV_ID, &service_id);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to get event device service\n");
+		event_service_enable(service_id);
+	}
+
+	/* Eventdev node config */
+	eventdev_conf.dev_id = EVENT_DEV_ID;
+	eventdev_conf.tx_queue_id = EVENT_TX_QUEUE;
+	eventdev_conf.tx_internal_port = tx_internal;
+	eventdev_conf.ev_ports = event_ports;
+	eventdev_conf.nb_ev_ports = nb_workers;
+	eventdev_conf.eth_ports = event_eth_ports;
+	eventdev_conf.nb_eth_ports = nb_eth;
+
+	return nb_workers;
+}
+/* >8 End of event device and adapters setup. */
+
+static void
+event_stop(void)
+{
+	rte_event_eth_rx_adapter_stop(EVENT_ADAPTER_ID);
+	rte_event_eth_tx_adapter_stop(EVENT_ADAPTER_ID);
+	rte_event_dev_stop(EVENT_DEV_ID);
+	rte_event_dev_close(EVENT_DEV_ID);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -747,6 +1215,11 @@ main(int argc, char **argv)
 		"ethdev_tx-*",
 		"pkt_drop",
 	};
+	static const char * const event_patterns[] = {
+		"ip4*",
+		"eventdev_tx-*",
+		"pkt_drop",
+	};
 	uint8_t nb_rx_queue, queue, socketid;
 	struct rte_graph_param graph_conf;
 	struct rte_eth_dev_info dev_info;
@@ -785,15 +1258,19 @@ main(int argc, char **argv)
 	if (ret < 0)
 		rte_exit(EXIT_FAILURE, "Invalid L3FWD_GRAPH parameters\n");
 
-	if (check_lcore_params() < 0)
-		rte_exit(EXIT_FAILURE, "check_lcore_params() failed\n");
+	/* Rx queues are polled by the Rx adapter in event mode */
+	if (!event_mode) {
+		if (check_lcore_params() < 0)
+			rte_exit(EXIT_FAILURE, "check_lcore_params() failed\n");
 
-	ret = init_lcore_rx_queues();
-	if (ret < 0)
-		rte_exit(EXIT_FAILURE, "init_lcore_rx_queues() failed\n");
+		ret = init_lcore_rx_queues();
+		if (ret < 0)
+			rte_exit(EXIT_FAILURE,
+				 "init_lcore_rx_queues() failed\n");
 
-	if (check_port_config() < 0)
-		rte_exit(EXIT_FAILURE, "check_port_config() failed\n");
+		if (check_port_config() < 0)
+			rte_exit(EXIT_FAILURE, "check_port_config() failed\n");
+	}
 
 	nb_ports = rte_eth_dev_count_avail();
 	nb_lcores = rte_lcore_count();
@@ -813,7 +1290,7 @@ main(int argc, char **argv)
 		printf("Initializing port %d ... ", portid);
 		fflush(stdout);
 
-		nb_rx_queue = get_port_n_rx_queues(portid);
+		nb_rx_queue = event_mode ? 1 : get_port_n_rx_queues(portid);
 		n_tx_queue = nb_lcores;
 		if (n_tx_queue > MAX_TX_QUEUE_PER_PORT)
 			n_tx_queue = MAX_TX_QUEUE_PER_PORT;
@@ -886,6 +1363,10 @@ main(int argc, char **argv)
 		if (ret < 0)
 			rte_exit(EXIT_FAILURE, "init_mem() failed\n");
 
+		if (event_mode)
+			event_eth_rx_queue_setup(portid, per_port_pool ?
+						 NB_MBUF(1) : NB_MBUF(nb_ports));
+
 		/* Init one TX queue per couple (lcore,port) */
 		queueid = 0;
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
@@ -983,11 +1464,21 @@ main(int argc, char **argv)
 
 	printf("\n");
 
-	/* Ethdev node config, skip rx queue mapping */
-	ret = rte_node_eth_config(ethdev_conf, nb_conf, nb_graphs);
+	if (event_mode) {
+		/* One graph per event port, ethdev_* nodes are not used */
+		nb_graphs = event_setup();
+		ret = rte_node_eventdev_config(&eventdev_conf, nb_graphs);
+		if (ret)
+			rte_exit(EXIT_FAILURE,
+				 "rte_node_eventdev_config: err=%d\n", ret);
+	} else {
+		/* Ethdev node config, skip rx queue mapping */
+		ret = rte_node_eth_config(ethdev_conf, nb_conf, nb_graphs);
+		if (ret)
+			rte_exit(EXIT_FAILURE, "rte_node_eth_config: err=%d\n",
+				 ret);
+	}
 	/* >8 End of graph creation. */
-	if (ret)
-		rte_exit(EXIT_FAILURE, "rte_node_eth_config: err=%d\n", ret);
 
 	/* Start ports */
 	RTE_ETH_FOREACH_DEV(portid)
@@ -1012,6 +1503,13 @@ main(int argc, char **argv)
 			rte_eth_promiscuous_enable(portid);
 	}
 
+	if (event_mode) {
+		ret = rte_event_dev_start(EVENT_DEV_ID);
+		if (ret < 0)
+			rte_exit(EXIT_FAILURE, "rte_event_dev_start: err=%d\n",
+				 ret);
+	}
+
 	printf("\n");
 
 	check_all_ports_link_status(enabled_port_mask);
@@ -1022,7 +1520,7 @@ main(int argc, char **argv)
 			       sizeof(*node_patterns));
 	if (!node_patterns)
 		return -ENOMEM;
-	memcpy(node_patterns, default_patterns,
+	memcpy(node_patterns, event_mode ? event_patterns : default_patterns,
 	       nb_patterns * sizeof(*node_patterns));
 
 	memset(&graph_conf, 0, sizeof(graph_conf));
@@ -1059,6 +1557,12 @@ main(int argc, char **argv)
 				 "rte_graph_create(): graph_id invalid"
 				 " for lcore %u\n", lcore_id);
 
+		/* eventdev_tx nodes enqueue through event port graph_id */
+		if (event_mode && graph_id != qconf->graph_id)
+			rte_exit(EXIT_FAILURE,
+				 "Graph %s does not match its event port\n",
+				 qconf->name);
+
 		qconf->graph_id = graph_id;
 		qconf->graph = rte_graph_lookup(qconf->name);
 		/* >8 End of graph initialization. */
@@ -1137,6 +1641,9 @@ main(int argc, char **argv)
 	}
 	free(node_patterns);
 
+	if (event_mode)
+		event_stop();
+
 	/* Stop ports */
 	RTE_ETH_FOREACH_DEV(portid) {
 		if ((enabled_port_mask & (1 << portid)) == 0)
@@ -262,6 +262,7 @@ open_dma(const char *value)
 
 	while (i < args_nr) {
 		char *arg_temp = dma_arg[i];
+		uint16_t qid;
 		uint8_t sub_nr;
 
 		sub_nr = rte_strsplit(arg_temp, strlen(arg_temp), ptrs, 2, '@');
@@ -270,7 +271,13 @@ open_dma(const char *value)
 			goto out;
 		}
 
+		/* txd: vhost enqueue (guest Rx), rxd: vhost dequeue (guest Tx) */
 		start = strstr(ptrs[0], "txd");
+		qid = VIRTIO_RXQ;
+		if (start == NULL) {
+			start = strstr(ptrs[0], "rxd");
+			qid = VIRTIO_TXQ;
+		}
 		if (start == NULL) {
 			ret = -1;
 			goto out;
@@ -338,7 +345,7 @@ open_dma(const char *value)
 		dmas_id[dma_count++] = dev_id;
 
 done:
-		(dma_info + vid)->dmas[VIRTIO_RXQ].dev_id = dev_id;
+		(dma_info + vid)->dmas[qid].dev_id = dev_id;
 		i++;
 	}
 out:
@@ -613,7 +620,7 @@ us_vhost_usage(const char *prgname)
 	"		--tx-csum [0|1] disable/enable TX checksum offload.\n"
 	"		--tso [0|1] disable/enable TCP segment offload.\n"
 	"		--client register a vhost-user socket as client mode.\n"
-	"		--dmas register dma channel for specific vhost device.\n"
+	"		--dmas register dma channel for specific vhost device enqueue (txd) or dequeue (rxd).\n"
 	"		--total-num-mbufs [0-N] set the number of mbufs to be allocated in mbuf pools, the default value is 147456.\n",
 	       prgname);
 }
@@ -1400,6 +1407,16 @@ drain_virtio_tx(struct vhost_dev *vdev)
 	if (builtin_net_driver) {
 		count = vs_dequeue_pkts(vdev, VIRTIO_TXQ, mbuf_pool,
 					pkts, MAX_PKT_BURST);
+	} else if (dma_bind[vdev->vid].dmas[VIRTIO_TXQ].async_enabled) {
+		int16_t dma_id = dma_bind[vdev->vid].dmas[VIRTIO_TXQ].dev_id;
+		int nr_inflight;
+
+		/* Returns the packets whose copies completed, in guest order */
+		count = rte_vhost_async_try_dequeue_burst(vdev->vid, VIRTIO_TXQ,
+					mbuf_pool, pkts, MAX_PKT_BURST,
+					&nr_inflight, dma_id, 0);
+		if (likely(nr_inflight >= 0))
+			vdev->pkts_deq_inflight = nr_inflight;
 	} else {
 		count = rte_vhost_dequeue_burst(vdev->vid, VIRTIO_TXQ,
 					mbuf_pool, pkts, MAX_PKT_BURST);
@@ -1482,6 +1499,36 @@ switch_worker(void *arg __rte_unused)
 	return 0;
 }
 
+/*
+ * Free the packets of the async copies in flight on a queue, enqueue or
+ * dequeue, once their copies complete. The queue must not be in use.
+ */
+static void
+vhost_clear_queue_thread_unsafe(struct vhost_dev *vdev, uint16_t queue_id)
+{
+	uint16_t *pkts_inflight = queue_id == VIRTIO_RXQ ?
+		&vdev->pkts_inflight : &vdev->pkts_deq_inflight;
+	int16_t dma_id = dma_bind[vdev->vid].dmas[queue_id].dev_id;
+	struct rte_mbuf *m_cpl[MAX_PKT_BURST];
+	uint16_t n_pkt;
+	int left;
+
+	while (*pkts_inflight) {
+		n_pkt = rte_vhost_clear_queue_thread_unsafe(vdev->vid, queue_id,
+				m_cpl, RTE_MIN(*pkts_inflight, MAX_PKT_BURST),
+				dma_id, 0);
+		free_pkts(m_cpl, n_pkt);
+		__atomic_sub_fetch(pkts_inflight, n_pkt, __ATOMIC_SEQ_CST);
+	}
+
+	/* The library must not have more packets in flight than accounted */
+	left = rte_vhost_async_get_inflight(vdev->vid, queue_id);
+	if (left > 0)
+		RTE_LOG(ERR, VHOST_DATA,
+			"(%d) %d packets still in flight on queue %u\n",
+			vdev->vid, left, queue_id);
+}
+
 /*
  * Remove a device from the specific data core linked list and from the
  * main linked list. Synchronization  occurs through the use of the
@@ -1538,20 +1585,13 @@ destroy_device(int vid)
 		"(%d) device has been removed from data core\n",
 		vdev->vid);
 
-	if (dma_bind[vid].dmas[VIRTIO_RXQ].async_enabled) {
-		uint16_t n_pkt = 0;
-		int16_t dma_id = dma_bind[vid].dmas[VIRTIO_RXQ].dev_id;
-		struct rte_mbuf *m_cpl[vdev->pkts_inflight];
-
-		while (vdev->pkts_inflight) {
-			n_pkt = rte_vhost_clear_queue_thread_unsafe(vid, VIRTIO_RXQ,
-						m_cpl, vdev->pkts_inflight, dma_id, 0);
-			free_pkts(m_cpl, n_pkt);
-			__atomic_sub_fetch(&vdev->pkts_inflight, n_pkt, __ATOMIC_SEQ_CST);
-		}
+	for (i = VIRTIO_RXQ; i < VIRTIO_QNUM; i++) {
+		if (!dma_bind[vid].dmas[i].async_enabled)
+			continue;
 
-		rte_vhost_async_channel_unregister(vid, VIRTIO_RXQ);
-		dma_bind[vid].dmas[VIRTIO_RXQ].async_enabled = false;
+		vhost_clear_queue_thread_unsafe(vdev, i);
+		rte_vhost_async_channel_unregister(vid, i);
+		dma_bind[vid].dmas[i].async_enabled = false;
 	}
 
 	rte_free(vdev);
@@ -1621,13 +1661,13 @@ new_device(int vid)
 		"(%d) device has been added to data core %d\n",
 		vid, vdev->coreid);
 
-	if (dma_bind[vid].dmas[VIRTIO_RXQ].dev_id != INVALID_DMA_ID) {
-		int ret;
+	for (i = VIRTIO_RXQ; i < VIRTIO_QNUM; i++) {
+		if (dma_bind[vid].dmas[i].dev_id == INVALID_DMA_ID)
+			continue;
 
-		ret = rte_vhost_async_channel_register(vid, VIRTIO_RXQ);
-		if (ret == 0)
-			dma_bind[vid].dmas[VIRTIO_RXQ].async_enabled = true;
-		return ret;
+		if (rte_vhost_async_channel_register(vid, i) != 0)
+			return -1;
+		dma_bind[vid].dmas[i].async_enabled = true;
 	}
 
 	return 0;
@@ -1645,23 +1685,11 @@ vring_state_changed(int vid, uint16_t queue_id, int enable)
 	if (!vdev)
 		return -1;
 
-	if (queue_id != VIRTIO_RXQ)
+	if (queue_id >= VIRTIO_QNUM)
 		return 0;
 
-	if (dma_bind[vid].dmas[queue_id].async_enabled) {
-		if (!enable) {
-			uint16_t n_pkt = 0;
-			int16_t dma_id = dma_bind[vid].dmas[VIRTIO_RXQ].dev_id;
-			struct rte_mbuf *m_cpl[vdev->pkts_inflight];
-
-			while (vdev->pkts_inflight) {
-				n_pkt = rte_vhost_clear_queue_thread_unsafe(vid, queue_id,
-							m_cpl, vdev->pkts_inflight, dma_id, 0);
-				free_pkts(m_cpl, n_pkt);
-				__atomic_sub_fetch(&vdev->pkts_inflight, n_pkt, __ATOMIC_SEQ_CST);
-			}
-		}
-	}
+	if (dma_bind[vid].dmas[queue_id].async_enabled && !enable)
+		vhost_clear_queue_thread_unsafe(vdev, queue_id);
 
 	return 0;
 }
@@ -53,6 +53,8 @@ struct vhost_dev {
 	size_t hdr_len;
 	uint16_t nr_vrings;
 	uint16_t pkts_inflight;
+	/**< Packets of the async dequeue not completed yet. */
+	uint16_t pkts_deq_inflight;
 	struct rte_vhost_memory *mem;
 	struct device_statistics stats;
 	TAILQ_ENTRY(vhost_dev) global_vdev_entry;
@@ -73,6 +73,7 @@ eal_long_options[] = {
 	{OPT_HELP,              0, NULL, OPT_HELP_NUM             },
 	{OPT_HUGE_DIR,          1, NULL, OPT_HUGE_DIR_NUM         },
 	{OPT_HUGE_UNLINK,       2, NULL, OPT_HUGE_UNLINK_NUM      },
+	{OPT_HUGE_ALLOC_THREADS, 1, NULL, OPT_HUGE_ALLOC_THREADS_NUM},
 	{OPT_IOVA_MODE,	        1, NULL, OPT_IOVA_MODE_NUM        },
 	{OPT_LCORES,            1, NULL, OPT_LCORES_NUM           },
 	{OPT_LOG_LEVEL,         1, NULL, OPT_LOG_LEVEL_NUM        },
@@ -311,6 +312,7 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 	internal_cfg->hugepage_dir = NULL;
 	internal_cfg->hugepage_file.unlink_before_mapping = false;
 	internal_cfg->hugepage_file.unlink_existing = true;
+	internal_cfg->huge_alloc_threads = 1;
 	internal_cfg->force_sockets = 0;
 	/* zero out the NUMA config */
 	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
@@ -2112,6 +2114,13 @@ eal_check_common_options(struct internal_config *internal_cfg)
 				"with --"OPT_MATCH_ALLOCATIONS"\n");
 		return -1;
 	}
+	if (internal_cfg->huge_alloc_threads > 1 &&
+			(internal_cfg->legacy_mem ||
+			 internal_cfg->single_file_segments)) {
+		RTE_LOG(WARNING, EAL, "Option --"OPT_HUGE_ALLOC_THREADS
+			" is ignored in legacy memory mode and with --"
+			OPT_SINGLE_FILE_SEGMENTS"\n");
+	}
 	if (internal_cfg->legacy_mem && internal_cfg->memory == 0) {
 		RTE_LOG(NOTICE, EAL, "Static memory layout is selected, "
 			"amount of reserved memory can be adjusted with "
@@ -80,6 +80,8 @@ struct internal_config {
 	 */
 	volatile unsigned match_allocations;
 	/**< true to free hugepages exactly as allocated */
+	unsigned int huge_alloc_threads;
+	/**< number of threads faulting preallocated hugepages in at init */
 	volatile unsigned single_file_segments;
 	/**< true if storing all pages within single files (per-page-size,
 	 * per-node) non-legacy mode only.
@@ -703,7 +703,7 @@ rte_eal_init(int argc, char **argv)
 	}
 	if (iova_mode == RTE_IOVA_DC) {
 		RTE_LOG(DEBUG, EAL, "Specific IOVA mode is not requested, autodetecting\n");
-		if (has_phys_addr) {
+		if (RTE_IOVA_AS_PA && has_phys_addr) {
 			RTE_LOG(DEBUG, EAL, "Selecting IOVA mode according to bus requests\n");
 			iova_mode = rte_bus_get_iommu_class();
 			if (iova_mode == RTE_IOVA_DC)
@@ -712,6 +712,11 @@ rte_eal_init(int argc, char **argv)
 			iova_mode = RTE_IOVA_VA;
 		}
 	}
+	if (!RTE_IOVA_AS_PA && iova_mode == RTE_IOVA_PA) {
+		rte_eal_init_alert("Cannot use IOVA as 'PA' as it is disabled during build");
+		rte_errno = EINVAL;
+		return -1;
+	}
 	rte_eal_get_configuration()->iova_mode = iova_mode;
 	RTE_LOG(INFO, EAL, "Selected IOVA mode '%s'\n",
 		rte_eal_iova_mode() == RTE_IOVA_PA ? "PA" : "VA");
@@ -16,7 +16,9 @@
 #include <fnmatch.h>
 #include <stddef.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <limits.h>
+#include <time.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #if defined(RTE_ARCH_X86)
@@ -451,6 +453,7 @@ eal_usage(const char *prgname)
 	       "  --"OPT_LEGACY_MEM"        Legacy memory mode (no dynamic allocation, contiguous segments)\n"
 	       "  --"OPT_SINGLE_FILE_SEGMENTS" Put all hugepage memory in single files\n"
 	       "  --"OPT_MATCH_ALLOCATIONS" Free hugepages exactly as allocated\n"
+	       "  --"OPT_HUGE_ALLOC_THREADS" Number of threads faulting preallocated hugepages in\n"
 	       "\n");
 	/* Allow the application to print its usage message too if hook is set */
 	if (hook) {
@@ -540,6 +543,32 @@ eal_parse_vfio_vf_token(const char *vf_token)
 	return -1;
 }
 
+static int
+eal_parse_huge_alloc_threads(const char *arg)
+{
+	struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	unsigned long nb_threads;
+	char *end;
+
+	errno = 0;
+	nb_threads = strtoul(arg, &end, 0);
+	if (errno != 0 || *arg == '\0' || *end != '\0' ||
+			nb_threads == 0 || nb_threads > RTE_MAX_LCORE)
+		return -1;
+
+	internal_conf->huge_alloc_threads = nb_threads;
+	return 0;
+}
+
+/* The TSC is not calibrated before memory init, use the monotonic clock. */
+static uint64_t
+eal_time_ms(const struct timespec *start, const struct timespec *end)
+{
+	return (uint64_t)(end->tv_sec - start->tv_sec) * 1000 +
+		(end->tv_nsec - start->tv_nsec) / 1000000;
+}
+
 /* Parse the arguments for --log-level only */
 static void
 eal_log_level_parse(int argc, char **argv)
@@ -716,6 +745,16 @@ eal_parse_args(int argc, char **argv)
 			internal_conf->match_allocations = 1;
 			break;
 
+		case OPT_HUGE_ALLOC_THREADS_NUM:
+			if (eal_parse_huge_alloc_threads(optarg) < 0) {
+				RTE_LOG(ERR, EAL, "invalid parameters for --"
+						OPT_HUGE_ALLOC_THREADS "\n");
+				eal_usage(prgname);
+				ret = -1;
+				goto out;
+			}
+			break;
+
 		default:
 			if (opt < OPT_LONG_MIN_NUM && isprint(opt)) {
 				RTE_LOG(ERR, EAL, "Option %c is not supported "
@@ -870,6 +909,7 @@ rte_eal_init(int argc, char **argv)
 	char cpuset[RTE_CPU_AFFINITY_STR_LEN];
 	char thread_name[RTE_MAX_THREAD_NAME_LEN];
 	bool phys_addrs;
+	struct timespec ts_hugepage, ts_memory, ts_heap, ts_end;
 	const struct rte_config *config = rte_eal_get_configuration();
 	struct internal_config *internal_conf =
 		eal_get_internal_configuration();
@@ -983,7 +1023,13 @@ rte_eal_init(int argc, char **argv)
 		if (iova_mode == RTE_IOVA_DC) {
 			RTE_LOG(DEBUG, EAL, "Buses did not request a specific IOVA mode.\n");
 
-			if (!phys_addrs) {
+			if (!RTE_IOVA_AS_PA) {
+				/* physical addresses are not supported by
+				 * the build, pick IOVA as VA mode.
+				 */
+				iova_mode = RTE_IOVA_VA;
+				RTE_LOG(DEBUG, EAL, "Physical addresses are unsupported, selecting IOVA as VA mode.\n");
+			} else if (!phys_addrs) {
 				/* if we have no access to physical addresses,
 				 * pick IOVA as VA mode.
 				 */
@@ -1032,9 +1078,16 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 
+	if (!RTE_IOVA_AS_PA && rte_eal_iova_mode() == RTE_IOVA_PA) {
+		rte_eal_init_alert("Cannot use IOVA as 'PA' as it is disabled during build");
+		rte_errno = EINVAL;
+		return -1;
+	}
+
 	RTE_LOG(INFO, EAL, "Selected IOVA mode '%s'\n",
 		rte_eal_iova_mode() == RTE_IOVA_PA ? "PA" : "VA");
 
+	clock_gettime(CLOCK_MONOTONIC, &ts_hugepage);
 	if (internal_conf->no_hugetlbfs == 0) {
 		/* rte_config isn't initialized yet */
 		ret = internal_conf->process_type == RTE_PROC_PRIMARY ?
@@ -1079,6 +1132,7 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 #endif
+	clock_gettime(CLOCK_MONOTONIC, &ts_memory);
 	/* in secondary processes, memory init may allocate additional fbarrays
 	 * not present in primary processes, so to avoid any potential issues,
 	 * initialize memzones first.
@@ -1098,11 +1152,21 @@ rte_eal_init(int argc, char **argv)
 	/* the directories are locked during eal_hugepage_info_init */
 	eal_hugedirs_unlock();
 
+	clock_gettime(CLOCK_MONOTONIC, &ts_heap);
 	if (rte_eal_malloc_heap_init() < 0) {
 		rte_eal_init_alert("Cannot init malloc heap");
 		rte_errno = ENODEV;
 		return -1;
 	}
+	clock_gettime(CLOCK_MONOTONIC, &ts_end);
+
+	/* the hugepage info phase includes the log and VFIO setup */
+	RTE_LOG(INFO, EAL, "Memory init took %" PRIu64 " ms: hugepage info %"
+		PRIu64 " ms, memory %" PRIu64 " ms, heap %" PRIu64 " ms\n",
+		eal_time_ms(&ts_hugepage, &ts_end),
+		eal_time_ms(&ts_hugepage, &ts_memory),
+		eal_time_ms(&ts_memory, &ts_heap),
+		eal_time_ms(&ts_heap, &ts_end));
 
 	if (rte_eal_tailqs_init() < 0) {
 		rte_eal_init_alert("Cannot init tail queues for objects");
@@ -3,6 +3,7 @@
  */
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -14,8 +15,10 @@
 #include <unistd.h>
 #include <limits.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <signal.h>
 #include <setjmp.h>
+#include <time.h>
 #ifdef F_ADD_SEALS /* if file sealing is supported, so is memfd */
 #include <linux/memfd.h>
 #define MEMFD_SUPPORTED
@@ -31,12 +34,14 @@
 #include <rte_log.h>
 #include <rte_eal.h>
 #include <rte_memory.h>
+#include <rte_per_lcore.h>
 
 #include "eal_filesystem.h"
 #include "eal_internal_cfg.h"
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "eal_thread.h"
 
 const int anonymous_hugepages_supported =
 #ifdef MAP_HUGE_SHIFT
@@ -97,11 +102,12 @@ static struct {
 /** local copy of a memory map, used to synchronize memory hotplug in MP */
 static struct rte_memseg_list local_memsegs[RTE_MAX_MEMSEG_LISTS];
 
-static sigjmp_buf huge_jmpenv;
+/* pages may be faulted in by several threads at init */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -110,11 +116,14 @@ static void huge_sigbus_handler(int signo __rte_unused)
  */
 static int huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 static struct sigaction huge_action_old;
 static int huge_need_recover;
+/* the handler is installed by the first thread and restored by the last */
+static pthread_mutex_t huge_sigbus_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int huge_sigbus_refcnt;
 
 static void
 huge_register_sigbus(void)
@@ -122,22 +131,29 @@ huge_register_sigbus(void)
 	sigset_t mask;
 	struct sigaction action;
 
-	sigemptyset(&mask);
-	sigaddset(&mask, SIGBUS);
-	action.sa_flags = 0;
-	action.sa_mask = mask;
-	action.sa_handler = huge_sigbus_handler;
+	pthread_mutex_lock(&huge_sigbus_lock);
+	if (huge_sigbus_refcnt++ == 0) {
+		sigemptyset(&mask);
+		sigaddset(&mask, SIGBUS);
+		action.sa_flags = 0;
+		action.sa_mask = mask;
+		action.sa_handler = huge_sigbus_handler;
 
-	huge_need_recover = !sigaction(SIGBUS, &action, &huge_action_old);
+		huge_need_recover = !sigaction(SIGBUS, &action,
+				&huge_action_old);
+	}
+	pthread_mutex_unlock(&huge_sigbus_lock);
 }
 
 static void
 huge_recover_sigbus(void)
 {
-	if (huge_need_recover) {
+	pthread_mutex_lock(&huge_sigbus_lock);
+	if (--huge_sigbus_refcnt == 0 && huge_need_recover) {
 		sigaction(SIGBUS, &huge_action_old, NULL);
 		huge_need_recover = 0;
 	}
+	pthread_mutex_unlock(&huge_sigbus_lock);
 }
 
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
@@ -620,6 +636,7 @@ alloc_seg(struct rte_memseg *ms, void *addr, int socket_id,
 	if (va != addr) {
 		RTE_LOG(DEBUG, EAL, "%s(): wrong mmap() address\n", __func__);
 		munmap(va, alloc_sz);
+		huge_recover_sigbus();
 		goto resized;
 	}
 
@@ -810,6 +827,162 @@ struct alloc_walk_param {
 	int socket;
 	bool exact;
 };
+
+/* a share of the segments of a list allocated by one thread */
+struct alloc_seg_thread {
+	pthread_t tid;
+	bool launched;
+	struct rte_memseg_list *msl;
+	struct hugepage_info *hi;
+	unsigned int msl_idx;
+	int socket;
+	int start_idx;
+	int end_idx;
+	/* first segment not allocated, end_idx if all were */
+	int fail_idx;
+};
+
+static void *
+alloc_seg_thread_main(void *arg)
+{
+	struct alloc_seg_thread *t = arg;
+	int idx;
+
+	for (idx = t->start_idx; idx < t->end_idx; idx++) {
+		struct rte_memseg *ms;
+		void *map_addr;
+
+		ms = rte_fbarray_get(&t->msl->memseg_arr, idx);
+		map_addr = RTE_PTR_ADD(t->msl->base_va,
+				(size_t)idx * t->msl->page_sz);
+		if (alloc_seg(ms, map_addr, t->socket, t->hi, t->msl_idx,
+				idx))
+			break;
+	}
+	t->fail_idx = idx;
+	return NULL;
+}
+
+static unsigned int
+alloc_seg_nb_threads(unsigned int need)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+
+	/* only the preallocation at init is done in parallel, and pages of
+	 * single file segments share the file and its reference count.
+	 */
+	if (internal_conf->init_complete ||
+			internal_conf->single_file_segments)
+		return 1;
+
+	return RTE_MIN(RTE_MAX(internal_conf->huge_alloc_threads, 1U), need);
+}
+
+/*
+ * Allocate the segments from start_idx with several threads, faulting the
+ * pages in, and zeroing them in the kernel, in parallel. Returns the number
+ * of segments allocated contiguously from start_idx, the segments allocated
+ * after a failure are freed.
+ */
+static unsigned int
+alloc_seg_parallel(struct rte_memseg_list *msl, unsigned int msl_idx,
+		int start_idx, unsigned int need, unsigned int nb_threads,
+		struct hugepage_info *hi, int socket)
+{
+	struct alloc_seg_thread *threads, *t;
+	struct timespec begin, end;
+	rte_cpuset_t allowed, cpuset;
+	pthread_attr_t attr;
+	unsigned int i, cpu, done;
+	bool failed;
+	int idx;
+
+	threads = calloc(nb_threads, sizeof(*threads));
+	if (threads == NULL)
+		return 0;
+
+	if (pthread_attr_init(&attr) != 0) {
+		free(threads);
+		return 0;
+	}
+
+	/* fault the pages from the cores of their socket */
+	CPU_ZERO(&cpuset);
+	if (pthread_getaffinity_np(pthread_self(), sizeof(allowed),
+			&allowed) == 0) {
+		for (cpu = 0; cpu < RTE_MAX_LCORE; cpu++) {
+			if (CPU_ISSET(cpu, &allowed) &&
+					eal_cpu_detected(cpu) &&
+					eal_cpu_socket_id(cpu) ==
+						(unsigned int)socket)
+				CPU_SET(cpu, &cpuset);
+		}
+	}
+	if (CPU_COUNT(&cpuset) != 0)
+		pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+
+	idx = start_idx;
+	for (i = 0; i < nb_threads; i++) {
+		t = &threads[i];
+		t->msl = msl;
+		t->hi = hi;
+		t->msl_idx = msl_idx;
+		t->socket = socket;
+		t->start_idx = idx;
+		idx += need / nb_threads + (i < need % nb_threads);
+		t->end_idx = idx;
+	}
+
+	/* the calling thread takes the first share */
+	for (i = 1; i < nb_threads; i++) {
+		t = &threads[i];
+		t->launched = pthread_create(&t->tid, &attr,
+				alloc_seg_thread_main, t) == 0;
+	}
+	for (i = 0; i < nb_threads; i++) {
+		t = &threads[i];
+		if (!t->launched)
+			alloc_seg_thread_main(t);
+	}
+	for (i = 1; i < nb_threads; i++) {
+		t = &threads[i];
+		if (t->launched)
+			pthread_join(t->tid, NULL);
+	}
+	pthread_attr_destroy(&attr);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	/* keep the segments allocated up to the first failure */
+	done = 0;
+	failed = false;
+	for (i = 0; i < nb_threads; i++) {
+		t = &threads[i];
+		if (failed) {
+			for (idx = t->start_idx; idx < t->fail_idx; idx++) {
+				if (free_seg(rte_fbarray_get(&msl->memseg_arr,
+						idx), hi, msl_idx, idx))
+					RTE_LOG(DEBUG, EAL, "Cannot free page\n");
+			}
+			continue;
+		}
+		done += t->fail_idx - t->start_idx;
+		failed = t->fail_idx != t->end_idx;
+	}
+	free(threads);
+
+	RTE_LOG(DEBUG, EAL, "Faulted in %u pages of size %zuM on socket %i "
+		"with %u threads in %" PRIu64 " ms\n", done,
+		(size_t)(msl->page_sz >> 20), socket, nb_threads,
+		(uint64_t)(end.tv_sec - begin.tv_sec) * 1000 +
+		(end.tv_nsec - begin.tv_nsec) / 1000000);
+
+	return done;
+}
+
 static int
 alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 {
@@ -818,7 +991,7 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 	struct rte_memseg_list *cur_msl;
 	size_t page_sz;
 	int cur_idx, start_idx, j, dir_fd = -1;
-	unsigned int msl_idx, need, i;
+	unsigned int msl_idx, need, i, nb_threads, prealloc = 0;
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
@@ -886,6 +1059,14 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		}
 	}
 
+	/* segments allocated in parallel are only recorded below, the
+	 * others are allocated, or retried after a failure, one by one.
+	 */
+	nb_threads = alloc_seg_nb_threads(need);
+	if (nb_threads > 1)
+		prealloc = alloc_seg_parallel(cur_msl, msl_idx, start_idx,
+				need, nb_threads, wa->hi, wa->socket);
+
 	for (i = 0; i < need; i++, cur_idx++) {
 		struct rte_memseg *cur;
 		void *map_addr;
@@ -894,8 +1075,8 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		map_addr = RTE_PTR_ADD(cur_msl->base_va,
 				cur_idx * page_sz);
 
-		if (alloc_seg(cur, map_addr, wa->socket, wa->hi,
-				msl_idx, cur_idx)) {
+		if (i >= prealloc && alloc_seg(cur, map_addr, wa->socket,
+				wa->hi, msl_idx, cur_idx)) {
 			RTE_LOG(DEBUG, EAL, "attempted to allocate %i segments, but only %i were allocated\n",
 				need, i);
 
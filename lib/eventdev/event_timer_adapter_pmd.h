@@ -52,6 +52,18 @@ typedef int (*rte_event_timer_adapter_stats_get_t)(
 typedef int (*rte_event_timer_adapter_stats_reset_t)(
 		const struct rte_event_timer_adapter *adapter);
 /**< @internal Reset statistics for event timer adapter */
+typedef int (*rte_event_timer_adapter_xstats_names_get_t)(
+		const struct rte_event_timer_adapter *adapter,
+		struct rte_event_dev_xstats_name *xstats_names,
+		unsigned int size);
+/**< @internal Get extended statistics names for event timer adapter */
+typedef int (*rte_event_timer_adapter_xstats_get_t)(
+		const struct rte_event_timer_adapter *adapter,
+		unsigned int lcore_id, uint64_t *values, unsigned int size);
+/**< @internal Get extended statistics for event timer adapter */
+typedef int (*rte_event_timer_adapter_xstats_reset_t)(
+		const struct rte_event_timer_adapter *adapter);
+/**< @internal Reset extended statistics for event timer adapter */
 
 /**
  * @internal Structure containing the functions exported by an event timer
@@ -74,6 +86,12 @@ struct event_timer_adapter_ops {
 	/**< Arm event timers with same expiration time */
 	rte_event_timer_cancel_burst_t		cancel_burst;
 	/**< Cancel one or more event timers */
+	rte_event_timer_adapter_xstats_names_get_t	xstats_names_get;
+	/**< Get adapter extended statistics names */
+	rte_event_timer_adapter_xstats_get_t	xstats_get;
+	/**< Get adapter extended statistics */
+	rte_event_timer_adapter_xstats_reset_t	xstats_reset;
+	/**< Reset adapter extended statistics */
 };
 
 /**
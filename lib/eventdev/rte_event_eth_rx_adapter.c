@@ -44,6 +44,9 @@
 
 #define RXA_ADAPTER_ARRAY "rte_event_eth_rx_adapter_array"
 
+#define NSEC2TICK(__ns, __freq) (((__ns) * (__freq)) / 1E9)
+#define TICK2NSEC(_ticks, _freq) (((_ticks) * (1E9)) / (_freq))
+
 /*
  * Used to store port and queue ID of interrupting Rx queue
  */
@@ -77,6 +80,20 @@ struct eth_rx_vector_data {
 	uint64_t vector_timeout_ticks;
 	struct rte_mempool *vector_pool;
 	struct rte_event_vector *vector_ev;
+	/* Adaptive vector sizing enabled */
+	uint8_t adaptive;
+	/* Vector size and timeout bounds used in adaptive mode */
+	uint16_t min_sz;
+	uint16_t max_sz;
+	uint64_t min_timeout_ticks;
+	uint64_t max_timeout_ticks;
+	/* Vector size and timeout configured at queue add */
+	uint16_t conf_vector_count;
+	uint64_t conf_timeout_ticks;
+	/* Mbufs vectorized since adapt_ts */
+	uint64_t adapt_pkts;
+	/* Start of the current arrival rate measurement window */
+	uint64_t adapt_ts;
 } __rte_cache_aligned;
 
 TAILQ_HEAD(eth_rx_vector_data_list, eth_rx_vector_data);
@@ -858,6 +875,39 @@ rxa_init_vector(struct event_eth_rx_adapter *rx_adapter,
 	TAILQ_INSERT_TAIL(&rx_adapter->vector_list, vec, next);
 }
 
+/* Pick the vector size and timeout from the mbuf arrival rate observed over
+ * a window of at least max_timeout_ticks. The size is the number of mbufs
+ * expected within the maximum timeout and the timeout is the time needed to
+ * fill a vector of that size. If even the minimum size cannot be filled
+ * within the maximum timeout, holding mbufs only adds latency and the
+ * minimum timeout is used.
+ */
+static void
+rxa_vector_adapt(struct eth_rx_vector_data *vec, uint64_t now)
+{
+	uint64_t window, expected, fill_ticks;
+
+	window = now - vec->adapt_ts;
+	if (window < vec->max_timeout_ticks)
+		return;
+
+	expected = vec->adapt_pkts * vec->max_timeout_ticks / window;
+	if (expected < vec->min_sz) {
+		vec->max_vector_count = vec->min_sz;
+		vec->vector_timeout_ticks = vec->min_timeout_ticks;
+	} else {
+		vec->max_vector_count = RTE_MIN(expected, vec->max_sz);
+		fill_ticks = vec->max_vector_count * window / vec->adapt_pkts;
+		fill_ticks += fill_ticks >> 2;
+		vec->vector_timeout_ticks = RTE_MAX(RTE_MIN(fill_ticks,
+						vec->max_timeout_ticks),
+						vec->min_timeout_ticks);
+	}
+
+	vec->adapt_pkts = 0;
+	vec->adapt_ts = now;
+}
+
 static inline uint16_t
 rxa_create_event_vector(struct event_eth_rx_adapter *rx_adapter,
 			struct eth_rx_queue_info *queue_info,
@@ -879,8 +929,9 @@ rxa_create_event_vector(struct event_eth_rx_adapter *rx_adapter,
 		}
 		rxa_init_vector(rx_adapter, vec);
 	}
+	vec->adapt_pkts += num;
 	while (num) {
-		if (vec->vector_ev->nb_elem == vec->max_vector_count) {
+		if (vec->vector_ev->nb_elem >= vec->max_vector_count) {
 			/* Event ready. */
 			ev->event = vec->event;
 			ev->vec = vec->vector_ev;
@@ -906,7 +957,7 @@ rxa_create_event_vector(struct event_eth_rx_adapter *rx_adapter,
 		vec->ts = rte_rdtsc();
 	}
 
-	if (vec->vector_ev->nb_elem == vec->max_vector_count) {
+	if (vec->vector_ev->nb_elem >= vec->max_vector_count) {
 		ev->event = vec->event;
 		ev->vec = vec->vector_ev;
 		ev++;
@@ -915,6 +966,9 @@ rxa_create_event_vector(struct event_eth_rx_adapter *rx_adapter,
 		TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
 	}
 
+	if (vec->adaptive)
+		rxa_vector_adapt(vec, vec->ts);
+
 	return filled;
 }
 
@@ -1924,7 +1978,6 @@ rxa_set_vector_data(struct eth_rx_queue_info *queue_info, uint16_t vector_count,
 		    uint64_t vector_ns, struct rte_mempool *mp, uint32_t qid,
 		    uint16_t port_id)
 {
-#define NSEC2TICK(__ns, __freq) (((__ns) * (__freq)) / 1E9)
 	struct eth_rx_vector_data *vector_data;
 	uint32_t flow_id;
 
@@ -1935,6 +1988,9 @@ rxa_set_vector_data(struct eth_rx_queue_info *queue_info, uint16_t vector_count,
 	vector_data->vector_pool = mp;
 	vector_data->vector_timeout_ticks =
 		NSEC2TICK(vector_ns, rte_get_timer_hz());
+	vector_data->conf_vector_count = vector_count;
+	vector_data->conf_timeout_ticks = vector_data->vector_timeout_ticks;
+	vector_data->adaptive = 0;
 	vector_data->ts = 0;
 	flow_id = queue_info->event & 0xFFFFF;
 	flow_id =
@@ -1942,6 +1998,35 @@ rxa_set_vector_data(struct eth_rx_queue_info *queue_info, uint16_t vector_count,
 	vector_data->event = (queue_info->event & ~0xFFFFF) | flow_id;
 }
 
+/* Check the vector timeouts twice per smallest timeout of the queues */
+static void
+rxa_vector_tmo_ticks_update(struct event_eth_rx_adapter *rx_adapter)
+{
+	uint64_t tmo_ticks = 0, ticks;
+	uint16_t d, q;
+
+	RTE_ETH_FOREACH_DEV(d) {
+		struct eth_device_info *dev_info = &rx_adapter->eth_devices[d];
+
+		if (dev_info->rx_queue == NULL || dev_info->internal_event_port)
+			continue;
+		for (q = 0; q < dev_info->dev->data->nb_rx_queues; q++) {
+			struct eth_rx_queue_info *queue_info =
+				&dev_info->rx_queue[q];
+			struct eth_rx_vector_data *vec =
+				&queue_info->vector_data;
+
+			if (!queue_info->queue_enabled || !queue_info->ena_vector)
+				continue;
+			ticks = (vec->adaptive ? vec->min_timeout_ticks :
+				 vec->conf_timeout_ticks) >> 1;
+			tmo_ticks = tmo_ticks ? RTE_MIN(tmo_ticks, ticks) : ticks;
+		}
+	}
+
+	rx_adapter->vector_tmo_ticks = tmo_ticks;
+}
+
 static void
 rxa_sw_del(struct event_eth_rx_adapter *rx_adapter,
 	   struct eth_device_info *dev_info, int32_t rx_queue_id)
@@ -3018,6 +3103,16 @@ rte_event_eth_rx_adapter_queue_stats_get(uint8_t id,
 		stats->rx_packets = q_stats->rx_packets;
 		stats->rx_poll_count = q_stats->rx_poll_count;
 		stats->rx_dropped = q_stats->rx_dropped;
+		if (queue_info->ena_vector) {
+			stats->rx_vector_sz =
+				queue_info->vector_data.max_vector_count;
+			stats->rx_vector_timeout_ns = TICK2NSEC(
+				queue_info->vector_data.vector_timeout_ticks,
+				rte_get_timer_hz());
+		} else {
+			stats->rx_vector_sz = 0;
+			stats->rx_vector_timeout_ns = 0;
+		}
 	}
 
 	dev = &rte_eventdevs[rx_adapter->eventdev_id];
@@ -3218,7 +3313,6 @@ rte_event_eth_rx_adapter_queue_conf_get(uint8_t id,
 			uint16_t rx_queue_id,
 			struct rte_event_eth_rx_adapter_queue_conf *queue_conf)
 {
-#define TICK2NSEC(_ticks, _freq) (((_ticks) * (1E9)) / (_freq))
 	struct rte_eventdev *dev;
 	struct event_eth_rx_adapter *rx_adapter;
 	struct eth_device_info *dev_info;
@@ -3263,11 +3357,11 @@ rte_event_eth_rx_adapter_queue_conf_get(uint8_t id,
 
 	queue_conf->ev.event = queue_info->event;
 
-	queue_conf->vector_sz = queue_info->vector_data.max_vector_count;
+	queue_conf->vector_sz = queue_info->vector_data.conf_vector_count;
 	queue_conf->vector_mp = queue_info->vector_data.vector_pool;
 	/* need to be converted from ticks to ns */
 	queue_conf->vector_timeout_ns = TICK2NSEC(
-		queue_info->vector_data.vector_timeout_ticks, rte_get_timer_hz());
+		queue_info->vector_data.conf_timeout_ticks, rte_get_timer_hz());
 
 	if (queue_info->event_buf != NULL)
 		queue_conf->event_buf_size = queue_info->event_buf->events_size;
@@ -3286,6 +3380,157 @@ rte_event_eth_rx_adapter_queue_conf_get(uint8_t id,
 	return 0;
 }
 
+int
+rte_event_eth_rx_adapter_queue_vector_adapt_set(uint8_t id,
+		uint16_t eth_dev_id,
+		uint16_t rx_queue_id,
+		const struct rte_event_eth_rx_adapter_vector_adapt_conf *conf)
+{
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct event_eth_rx_adapter *rx_adapter;
+	struct eth_rx_vector_data *vec;
+	struct eth_device_info *dev_info;
+	struct eth_rx_queue_info *queue_info;
+	uint64_t hz;
+	int ret;
+
+	if (rxa_memzone_lookup())
+		return -ENOMEM;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	if (rx_queue_id >= rte_eth_devices[eth_dev_id].data->nb_rx_queues) {
+		RTE_EDEV_LOG_ERR("Invalid rx queue_id %u", rx_queue_id);
+		return -EINVAL;
+	}
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if (rx_adapter == NULL || conf == NULL)
+		return -EINVAL;
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	if (dev_info->rx_queue == NULL ||
+	    !dev_info->rx_queue[rx_queue_id].queue_enabled) {
+		RTE_EDEV_LOG_ERR("Rx queue %u not added", rx_queue_id);
+		return -EINVAL;
+	}
+
+	if (dev_info->internal_event_port)
+		return -ENOTSUP;
+
+	queue_info = &dev_info->rx_queue[rx_queue_id];
+	if (!queue_info->ena_vector) {
+		RTE_EDEV_LOG_ERR("Rx queue %u is not vectorized", rx_queue_id);
+		return -EINVAL;
+	}
+
+	vec = &queue_info->vector_data;
+	if (conf->enable) {
+		ret = rte_event_eth_rx_adapter_vector_limits_get(
+			rx_adapter->eventdev_id, eth_dev_id, &limits);
+		if (ret < 0)
+			return ret;
+
+		if (conf->min_sz == 0 || conf->min_sz > conf->max_sz ||
+		    conf->min_sz < limits.min_sz ||
+		    conf->max_sz > limits.max_sz ||
+		    conf->min_timeout_ns > conf->max_timeout_ns ||
+		    conf->min_timeout_ns < limits.min_timeout_ns ||
+		    conf->max_timeout_ns > limits.max_timeout_ns ||
+		    vec->vector_pool->elt_size <
+		    (sizeof(struct rte_event_vector) +
+		     (sizeof(uintptr_t) * conf->max_sz))) {
+			RTE_EDEV_LOG_ERR("Invalid adaptive event vector"
+					 " configuration, eth port: %" PRIu16
+					 " adapter id: %" PRIu8,
+					 eth_dev_id, id);
+			return -EINVAL;
+		}
+	}
+
+	hz = rte_get_timer_hz();
+
+	rte_spinlock_lock(&rx_adapter->rx_lock);
+	if (conf->enable) {
+		vec->min_sz = conf->min_sz;
+		vec->max_sz = conf->max_sz;
+		vec->min_timeout_ticks = NSEC2TICK(conf->min_timeout_ns, hz);
+		vec->max_timeout_ticks = NSEC2TICK(conf->max_timeout_ns, hz);
+		vec->max_vector_count = RTE_MAX(RTE_MIN(vec->max_vector_count,
+						vec->max_sz), vec->min_sz);
+		vec->vector_timeout_ticks =
+			RTE_MAX(RTE_MIN(vec->vector_timeout_ticks,
+					vec->max_timeout_ticks),
+				vec->min_timeout_ticks);
+		vec->adapt_pkts = 0;
+		vec->adapt_ts = rte_rdtsc();
+		rx_adapter->vector_tmo_ticks =
+			RTE_MIN(vec->min_timeout_ticks >> 1,
+				rx_adapter->vector_tmo_ticks);
+	} else {
+		vec->max_vector_count = vec->conf_vector_count;
+		vec->vector_timeout_ticks = vec->conf_timeout_ticks;
+		vec->adaptive = 0;
+		rxa_vector_tmo_ticks_update(rx_adapter);
+	}
+	vec->adaptive = conf->enable;
+	rte_spinlock_unlock(&rx_adapter->rx_lock);
+
+	return 0;
+}
+
+int
+rte_event_eth_rx_adapter_queue_vector_adapt_get(uint8_t id,
+		uint16_t eth_dev_id,
+		uint16_t rx_queue_id,
+		struct rte_event_eth_rx_adapter_vector_adapt_conf *conf)
+{
+	struct event_eth_rx_adapter *rx_adapter;
+	struct eth_rx_vector_data *vec;
+	struct eth_device_info *dev_info;
+	uint64_t hz;
+
+	if (rxa_memzone_lookup())
+		return -ENOMEM;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	if (rx_queue_id >= rte_eth_devices[eth_dev_id].data->nb_rx_queues) {
+		RTE_EDEV_LOG_ERR("Invalid rx queue_id %u", rx_queue_id);
+		return -EINVAL;
+	}
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if (rx_adapter == NULL || conf == NULL)
+		return -EINVAL;
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	if (dev_info->rx_queue == NULL ||
+	    !dev_info->rx_queue[rx_queue_id].queue_enabled) {
+		RTE_EDEV_LOG_ERR("Rx queue %u not added", rx_queue_id);
+		return -EINVAL;
+	}
+
+	if (dev_info->internal_event_port)
+		return -ENOTSUP;
+
+	vec = &dev_info->rx_queue[rx_queue_id].vector_data;
+	hz = rte_get_timer_hz();
+
+	memset(conf, 0, sizeof(*conf));
+	conf->enable = vec->adaptive;
+	if (vec->adaptive) {
+		conf->min_sz = vec->min_sz;
+		conf->max_sz = vec->max_sz;
+		conf->min_timeout_ns = TICK2NSEC(vec->min_timeout_ticks, hz);
+		conf->max_timeout_ns = TICK2NSEC(vec->max_timeout_ticks, hz);
+	}
+
+	return 0;
+}
+
 #define RXA_ADD_DICT(stats, s) rte_tel_data_add_dict_u64(d, #s, stats.s)
 
 static int
@@ -3485,6 +3730,8 @@ handle_rxa_get_queue_stats(const char *cmd __rte_unused,
 	RXA_ADD_DICT(q_stats, rx_poll_count);
 	RXA_ADD_DICT(q_stats, rx_packets);
 	RXA_ADD_DICT(q_stats, rx_dropped);
+	RXA_ADD_DICT(q_stats, rx_vector_sz);
+	RXA_ADD_DICT(q_stats, rx_vector_timeout_ns);
 
 	return 0;
 
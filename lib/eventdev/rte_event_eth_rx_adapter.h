@@ -38,6 +38,8 @@
  *  - rte_event_eth_rx_adapter_queue_stats_get()
  *  - rte_event_eth_rx_adapter_queue_stats_reset()
  *  - rte_event_eth_rx_adapter_event_port_get()
+ *  - rte_event_eth_rx_adapter_queue_vector_adapt_set()
+ *  - rte_event_eth_rx_adapter_queue_vector_adapt_get()
  *
  * The application creates an ethernet to event adapter using
  * rte_event_eth_rx_adapter_create_ext() or rte_event_eth_rx_adapter_create()
@@ -222,6 +224,15 @@ struct rte_event_eth_rx_adapter_queue_stats {
 	/**< Received packet count */
 	uint64_t rx_dropped;
 	/**< Received packet dropped count */
+	uint64_t rx_vector_sz;
+	/**< Current event vector size, 0 if the queue is not vectorized.
+	 * Varies over time if adaptive event vector sizing is enabled.
+	 * @see rte_event_eth_rx_adapter_queue_vector_adapt_set
+	 */
+	uint64_t rx_vector_timeout_ns;
+	/**< Current event vector timeout, 0 if the queue is not vectorized.
+	 * Varies over time if adaptive event vector sizing is enabled.
+	 */
 };
 
 /**
@@ -284,6 +295,43 @@ struct rte_event_eth_rx_adapter_vector_limits {
 	 */
 };
 
+/**
+ * Adaptive event vector sizing configuration of an Rx queue.
+ *
+ * When enabled, the service function based adapter periodically measures
+ * the mbuf arrival rate of the queue and picks the event vector size and
+ * timeout within the configured bounds: vectors grow towards max_sz as the
+ * rate increases, and the timeout shrinks towards min_timeout_ns when the
+ * rate is too low to fill vectors, so that lightly loaded queues do not
+ * pay the full timeout in latency.
+ *
+ * @see rte_event_eth_rx_adapter_queue_vector_adapt_set
+ */
+struct rte_event_eth_rx_adapter_vector_adapt_conf {
+	uint8_t enable;
+	/**< Enable adaptive sizing. When disabled, the vector size and timeout
+	 * configured at queue add are used.
+	 */
+	uint16_t min_sz;
+	/**< Minimum vector size, must be at least
+	 * rte_event_eth_rx_adapter_vector_limits::min_sz.
+	 */
+	uint16_t max_sz;
+	/**< Maximum vector size, must be at most
+	 * rte_event_eth_rx_adapter_vector_limits::max_sz and fit in the
+	 * elements of the queue's vector mempool.
+	 */
+	uint64_t min_timeout_ns;
+	/**< Minimum vector timeout, must be at least
+	 * rte_event_eth_rx_adapter_vector_limits::min_timeout_ns.
+	 */
+	uint64_t max_timeout_ns;
+	/**< Maximum vector timeout, must be at most
+	 * rte_event_eth_rx_adapter_vector_limits::max_timeout_ns. This is also
+	 * the minimum duration over which the arrival rate is measured.
+	 */
+};
+
 /**
  * A structure to hold adapter config params
  */
@@ -704,6 +752,70 @@ __rte_experimental
 int
 rte_event_eth_rx_adapter_event_port_get(uint8_t id, uint8_t *event_port_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Configure adaptive event vector sizing of a vectorized Rx queue. This is
+ * only supported for Rx queues serviced by the adapter service function.
+ *
+ * @param id
+ *  Adapter identifier.
+ *
+ * @param eth_dev_id
+ *  Port identifier of Ethernet device.
+ *
+ * @param rx_queue_id
+ *  Ethernet device receive queue index.
+ *
+ * @param conf
+ *  Pointer to the adaptive sizing configuration.
+ *
+ * @return
+ *  - 0: Success.
+ *  - -EINVAL: Invalid parameter, or the queue is not added or not
+ *    vectorized.
+ *  - -ENOTSUP: The queue uses an internal event port.
+ */
+__rte_experimental
+int
+rte_event_eth_rx_adapter_queue_vector_adapt_set(uint8_t id,
+		uint16_t eth_dev_id,
+		uint16_t rx_queue_id,
+		const struct rte_event_eth_rx_adapter_vector_adapt_conf *conf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the adaptive event vector sizing configuration of an Rx queue.
+ * The vector size and timeout currently in use are reported by
+ * rte_event_eth_rx_adapter_queue_stats_get().
+ *
+ * @param id
+ *  Adapter identifier.
+ *
+ * @param eth_dev_id
+ *  Port identifier of Ethernet device.
+ *
+ * @param rx_queue_id
+ *  Ethernet device receive queue index.
+ *
+ * @param[out] conf
+ *  Pointer to the structure to be filled with the configuration.
+ *
+ * @return
+ *  - 0: Success.
+ *  - -EINVAL: Invalid parameter or the queue is not added.
+ *  - -ENOTSUP: The queue uses an internal event port.
+ */
+__rte_experimental
+int
+rte_event_eth_rx_adapter_queue_vector_adapt_get(uint8_t id,
+		uint16_t eth_dev_id,
+		uint16_t rx_queue_id,
+		struct rte_event_eth_rx_adapter_vector_adapt_conf *conf);
+
 #ifdef __cplusplus
 }
 #endif
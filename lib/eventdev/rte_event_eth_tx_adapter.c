@@ -3,6 +3,7 @@
  */
 #include <rte_spinlock.h>
 #include <rte_service_component.h>
+#include <rte_tailq.h>
 #include <ethdev_driver.h>
 
 #include "eventdev_pmd.h"
@@ -17,6 +18,9 @@
 #define TXA_MAX_NB_TX		128
 #define TXA_INVALID_DEV_ID	INT32_C(-1)
 #define TXA_INVALID_SERVICE_ID	INT64_C(-1)
+#define TXA_COALESCE_MAX_BURST	RTE_EVENT_ETH_TX_ADAPTER_COALESCE_MAX_BURST
+/* log2(TXA_COALESCE_MAX_BURST) + 1 */
+#define TXA_BURST_HIST_NB	9
 
 #define txa_evdev(id) (&rte_eventdevs[txa_dev_id_array[(id)]])
 
@@ -88,12 +92,35 @@ struct txa_retry {
 struct txa_service_queue_info {
 	/* Queue has been added */
 	uint8_t added;
+	/* Queue is on the adapter's list of queues holding packets */
+	uint8_t pending;
+	/* Coalescing target burst size, 0 if coalescing is disabled */
+	uint16_t burst_size;
 	/* Retry callback argument */
 	struct txa_retry txa_retry;
 	/* Tx buffer */
 	struct rte_eth_dev_tx_buffer *tx_buf;
+	/* Max time buffered packets are held when coalescing */
+	uint64_t max_hold_cycles;
+	/* Time by which the buffered packets must be sent */
+	uint64_t deadline;
+	/* Next entry on the pending list */
+	TAILQ_ENTRY(txa_service_queue_info) next;
 };
 
+/* Extended statistics of the service implementation */
+struct txa_service_xstats {
+	/* Number of Tx bursts by burst size, log2 buckets */
+	uint64_t burst_hist[TXA_BURST_HIST_NB];
+	/* Coalesced bursts sent because the target size was reached */
+	uint64_t coalesce_size_flush;
+	/* Coalesced bursts sent because the hold time expired */
+	uint64_t coalesce_deadline_flush;
+};
+
+#define TXA_XSTATS_NB \
+	(sizeof(struct txa_service_xstats) / sizeof(uint64_t))
+
 /* PMD private structure */
 struct txa_service_data {
 	/* Max mbufs processed in any service function invocation */
@@ -114,6 +141,14 @@ struct txa_service_data {
 	struct txa_service_ethdev *txa_ethdev;
 	/* Statistics */
 	struct rte_event_eth_tx_adapter_stats stats;
+	/* Extended statistics */
+	struct txa_service_xstats xstats;
+	/* Number of Tx queues in coalescing mode */
+	uint32_t nb_coalesce_queues;
+	/* Timer cycles at the start of the current service invocation */
+	uint64_t now;
+	/* Coalescing Tx queues with buffered packets */
+	TAILQ_HEAD(, txa_service_queue_info) pending;
 	/* Adapter Identifier */
 	uint8_t id;
 	/* Conf arg must be freed */
@@ -435,14 +470,15 @@ txa_service_register(struct txa_service_data *txa)
 
 static struct rte_eth_dev_tx_buffer *
 txa_service_tx_buf_alloc(struct txa_service_data *txa,
-			const struct rte_eth_dev *dev)
+			const struct rte_eth_dev *dev,
+			uint16_t size)
 {
 	struct rte_eth_dev_tx_buffer *tb;
 	uint16_t port_id;
 
 	port_id = dev->data->port_id;
 	tb = rte_zmalloc_socket(txa->mem_name,
-				RTE_ETH_TX_BUFFER_SIZE(TXA_BATCH_SIZE),
+				RTE_ETH_TX_BUFFER_SIZE(size),
 				0,
 				rte_eth_dev_socket_id(port_id));
 	if (tb == NULL)
@@ -509,6 +545,78 @@ txa_service_buffer_retry(struct rte_mbuf **pkts, uint16_t unsent,
 	stats->tx_dropped += unsent - sent;
 }
 
+static inline void
+txa_service_pending_del(struct txa_service_data *txa,
+			struct txa_service_queue_info *tqi)
+{
+	if (tqi->pending) {
+		TAILQ_REMOVE(&txa->pending, tqi, next);
+		tqi->pending = 0;
+	}
+}
+
+static inline uint16_t
+txa_service_queue_flush(struct txa_service_data *txa,
+			struct txa_service_queue_info *tqi)
+{
+	struct rte_eth_dev_tx_buffer *tb;
+	uint16_t n;
+
+	tb = tqi->tx_buf;
+	n = tb->length;
+	if (n == 0)
+		return 0;
+
+	txa->xstats.burst_hist[RTE_MIN(rte_fls_u32(n),
+				       TXA_BURST_HIST_NB) - 1]++;
+	txa_service_pending_del(txa, tqi);
+
+	return rte_eth_tx_buffer_flush(tqi->txa_retry.port_id,
+				       tqi->txa_retry.tx_queue, tb);
+}
+
+static inline uint16_t
+txa_service_buffer(struct txa_service_data *txa,
+		struct txa_service_queue_info *tqi,
+		struct rte_mbuf *m)
+{
+	struct rte_eth_dev_tx_buffer *tb;
+
+	tb = tqi->tx_buf;
+	if (tqi->burst_size && !tqi->pending) {
+		tqi->deadline = txa->now + tqi->max_hold_cycles;
+		tqi->pending = 1;
+		TAILQ_INSERT_TAIL(&txa->pending, tqi, next);
+	}
+
+	tb->pkts[tb->length++] = m;
+	if (tb->length < tb->size)
+		return 0;
+
+	if (tqi->burst_size)
+		txa->xstats.coalesce_size_flush++;
+	return txa_service_queue_flush(txa, tqi);
+}
+
+static void
+txa_service_coalesce_flush(struct txa_service_data *txa)
+{
+	struct txa_service_queue_info *tqi;
+	struct txa_service_queue_info *tmp;
+	uint16_t nb_tx;
+
+	nb_tx = 0;
+	RTE_TAILQ_FOREACH_SAFE(tqi, &txa->pending, next, tmp) {
+		if (txa->now < tqi->deadline)
+			continue;
+
+		txa->xstats.coalesce_deadline_flush++;
+		nb_tx += txa_service_queue_flush(txa, tqi);
+	}
+
+	txa->stats.tx_packets += nb_tx;
+}
+
 static uint16_t
 txa_process_event_vector(struct txa_service_data *txa,
 			 struct rte_event_vector *vec)
@@ -528,10 +636,8 @@ txa_process_event_vector(struct txa_service_data *txa,
 			rte_mempool_put(rte_mempool_from_obj(vec), vec);
 			return 0;
 		}
-		for (i = 0; i < vec->nb_elem; i++) {
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf,
-						   mbufs[i]);
-		}
+		for (i = 0; i < vec->nb_elem; i++)
+			nb_tx += txa_service_buffer(txa, tqi, mbufs[i]);
 	} else {
 		for (i = 0; i < vec->nb_elem; i++) {
 			port = mbufs[i]->port;
@@ -541,8 +647,7 @@ txa_process_event_vector(struct txa_service_data *txa,
 				rte_pktmbuf_free(mbufs[i]);
 				continue;
 			}
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf,
-						   mbufs[i]);
+			nb_tx += txa_service_buffer(txa, tqi, mbufs[i]);
 		}
 	}
 	rte_mempool_put(rte_mempool_from_obj(vec), vec);
@@ -579,7 +684,7 @@ txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 				continue;
 			}
 
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf, m);
+			nb_tx += txa_service_buffer(txa, tqi, m);
 		} else {
 			nb_tx += txa_process_event_vector(txa, ev[i].vec);
 		}
@@ -608,6 +713,9 @@ txa_service_func(void *args)
 	if (!rte_spinlock_trylock(&txa->tx_lock))
 		return 0;
 
+	if (txa->nb_coalesce_queues)
+		txa->now = rte_get_timer_cycles();
+
 	for (nb_tx = 0; nb_tx < max_nb_tx; nb_tx += n) {
 
 		n = rte_event_dequeue_burst(dev_id, port, ev, RTE_DIM(ev), 0);
@@ -616,6 +724,9 @@ txa_service_func(void *args)
 		txa_service_tx(txa, ev, n);
 	}
 
+	if (!TAILQ_EMPTY(&txa->pending))
+		txa_service_coalesce_flush(txa);
+
 	if ((txa->loop_cnt++ & (TXA_FLUSH_THRESHOLD - 1)) == 0) {
 
 		struct txa_service_ethdev *tdi;
@@ -641,8 +752,11 @@ txa_service_func(void *args)
 				if (unlikely(tqi == NULL || !tqi->added))
 					continue;
 
-				nb_tx += rte_eth_tx_buffer_flush(i, q,
-							tqi->tx_buf);
+				/* Flushed by size or hold time only */
+				if (tqi->burst_size)
+					continue;
+
+				nb_tx += txa_service_queue_flush(txa, tqi);
 			}
 		}
 
@@ -714,6 +828,7 @@ txa_service_adapter_create_ext(uint8_t id, struct rte_eventdev *dev,
 	txa->conf_cb = conf_cb;
 	txa->conf_arg = conf_arg;
 	txa->service_id = TXA_INVALID_SERVICE_ID;
+	TAILQ_INIT(&txa->pending);
 	rte_spinlock_init(&txa->tx_lock);
 	txa_service_data_array[id] = txa;
 
@@ -813,7 +928,7 @@ txa_service_queue_add(uint8_t id,
 	if (ret)
 		goto err_unlock;
 
-	tb = txa_service_tx_buf_alloc(txa, eth_dev);
+	tb = txa_service_tx_buf_alloc(txa, eth_dev, TXA_BATCH_SIZE);
 	if (tb == NULL)
 		goto err_unlock;
 
@@ -895,9 +1010,19 @@ txa_service_queue_del(uint8_t id,
 	if (tqi == NULL || !tqi->added)
 		return 0;
 
+	rte_spinlock_lock(&txa->tx_lock);
+	/* Send the mbufs still buffered before releasing the buffer */
+	txa->stats.tx_packets += txa_service_queue_flush(txa, tqi);
+	txa_service_pending_del(txa, tqi);
+	if (tqi->burst_size) {
+		tqi->burst_size = 0;
+		txa->nb_coalesce_queues--;
+	}
 	tb = tqi->tx_buf;
 	tqi->added = 0;
 	tqi->tx_buf = NULL;
+	rte_spinlock_unlock(&txa->tx_lock);
+
 	rte_free(tb);
 	txa->nb_queues--;
 	txa->txa_ethdev[port_id].nb_queues--;
@@ -955,6 +1080,117 @@ txa_service_stop(uint8_t id)
 	return txa_service_ctrl(id, 0);
 }
 
+static int
+txa_service_coalesce_set(uint8_t id, const struct rte_eth_dev *dev,
+		uint16_t tx_queue_id,
+		const struct rte_event_eth_tx_adapter_queue_coalesce_conf *conf)
+{
+	struct txa_service_data *txa;
+	struct txa_service_queue_info *tqi;
+	struct rte_eth_dev_tx_buffer *tb;
+	uint16_t size;
+	uint16_t nb_tx;
+
+	txa = txa_service_id_to_data(id);
+
+	rte_spinlock_lock(&txa->tx_lock);
+
+	tqi = txa_service_queue(txa, dev->data->port_id, tx_queue_id);
+	if (tqi == NULL || !tqi->added) {
+		rte_spinlock_unlock(&txa->tx_lock);
+		return -EINVAL;
+	}
+
+	size = conf->burst_size ? conf->burst_size : TXA_BATCH_SIZE;
+	if (size != tqi->tx_buf->size) {
+		tb = txa_service_tx_buf_alloc(txa, dev, size);
+		if (tb == NULL) {
+			rte_spinlock_unlock(&txa->tx_lock);
+			return -ENOMEM;
+		}
+		rte_eth_tx_buffer_init(tb, size);
+		rte_eth_tx_buffer_set_err_callback(tb,
+			txa_service_buffer_retry, &tqi->txa_retry);
+
+		nb_tx = txa_service_queue_flush(txa, tqi);
+		txa->stats.tx_packets += nb_tx;
+		rte_free(tqi->tx_buf);
+		tqi->tx_buf = tb;
+	}
+
+	if (conf->burst_size && !tqi->burst_size)
+		txa->nb_coalesce_queues++;
+	else if (!conf->burst_size && tqi->burst_size)
+		txa->nb_coalesce_queues--;
+
+	if (!conf->burst_size)
+		txa_service_pending_del(txa, tqi);
+	else if (tqi->pending)
+		tqi->deadline = tqi->deadline - tqi->max_hold_cycles +
+				conf->max_hold_cycles;
+
+	tqi->burst_size = conf->burst_size;
+	tqi->max_hold_cycles = conf->max_hold_cycles;
+
+	rte_spinlock_unlock(&txa->tx_lock);
+	return 0;
+}
+
+static int
+txa_service_coalesce_get(uint8_t id, const struct rte_eth_dev *dev,
+		uint16_t tx_queue_id,
+		struct rte_event_eth_tx_adapter_queue_coalesce_conf *conf)
+{
+	struct txa_service_data *txa;
+	struct txa_service_queue_info *tqi;
+
+	txa = txa_service_id_to_data(id);
+	tqi = txa_service_queue(txa, dev->data->port_id, tx_queue_id);
+	if (tqi == NULL || !tqi->added)
+		return -EINVAL;
+
+	conf->burst_size = tqi->burst_size;
+	conf->max_hold_cycles = tqi->max_hold_cycles;
+	return 0;
+}
+
+static int
+txa_service_xstats_names_get(struct rte_event_dev_xstats_name *xstats_names)
+{
+	unsigned int n;
+
+	for (n = 0; n < TXA_BURST_HIST_NB; n++)
+		snprintf(xstats_names[n].name, sizeof(xstats_names[n].name),
+			"tx_burst_size_%u_%u", 1U << n, (2U << n) - 1);
+
+	snprintf(xstats_names[n++].name, sizeof(xstats_names[0].name),
+		"tx_coalesce_size_flushes");
+	snprintf(xstats_names[n++].name, sizeof(xstats_names[0].name),
+		"tx_coalesce_deadline_flushes");
+
+	return n;
+}
+
+static int
+txa_service_xstats_get(uint8_t id, uint64_t *values)
+{
+	struct txa_service_data *txa;
+
+	txa = txa_service_id_to_data(id);
+	memcpy(values, &txa->xstats, sizeof(txa->xstats));
+	return TXA_XSTATS_NB;
+}
+
+static int
+txa_service_xstats_reset(uint8_t id)
+{
+	struct txa_service_data *txa;
+
+	txa = txa_service_id_to_data(id);
+	memset(&txa->xstats, 0, sizeof(txa->xstats));
+	return 0;
+}
+
 
 int
 rte_event_eth_tx_adapter_create(uint8_t id, uint8_t dev_id,
@@ -1218,3 +1454,111 @@ rte_event_eth_tx_adapter_stop(uint8_t id)
 	rte_eventdev_trace_eth_tx_adapter_stop(id, ret);
 	return ret;
 }
+
+static int
+txa_coalesce_check(uint8_t id, uint16_t eth_dev_id)
+{
+	uint32_t caps;
+
+	caps = 0;
+	if (txa_dev_caps_get(id))
+		txa_dev_caps_get(id)(txa_evdev(id),
+				     &rte_eth_devices[eth_dev_id], &caps);
+
+	return (caps & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT) ?
+		-ENOTSUP : 0;
+}
+
+int
+rte_event_eth_tx_adapter_queue_coalesce_set(uint8_t id,
+		uint16_t eth_dev_id,
+		int32_t queue,
+		const struct rte_event_eth_tx_adapter_queue_coalesce_conf *conf)
+{
+	struct rte_eth_dev *eth_dev;
+	uint16_t q;
+	int ret;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+	TXA_CHECK_OR_ERR_RET(id);
+
+	eth_dev = &rte_eth_devices[eth_dev_id];
+	TXA_CHECK_TXQ(eth_dev, queue);
+
+	if (conf == NULL || conf->burst_size > TXA_COALESCE_MAX_BURST)
+		return -EINVAL;
+
+	ret = txa_coalesce_check(id, eth_dev_id);
+	if (ret)
+		return ret;
+
+	if (queue != -1)
+		return txa_service_coalesce_set(id, eth_dev, queue, conf);
+
+	for (q = 0; q < eth_dev->data->nb_tx_queues; q++) {
+		if (!txa_service_is_queue_added(txa_service_id_to_data(id),
+						eth_dev, q))
+			continue;
+		ret = txa_service_coalesce_set(id, eth_dev, q, conf);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+int
+rte_event_eth_tx_adapter_queue_coalesce_get(uint8_t id,
+		uint16_t eth_dev_id,
+		uint16_t queue,
+		struct rte_event_eth_tx_adapter_queue_coalesce_conf *conf)
+{
+	struct rte_eth_dev *eth_dev;
+	int ret;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+	TXA_CHECK_OR_ERR_RET(id);
+
+	eth_dev = &rte_eth_devices[eth_dev_id];
+	if (queue >= eth_dev->data->nb_tx_queues || conf == NULL)
+		return -EINVAL;
+
+	ret = txa_coalesce_check(id, eth_dev_id);
+	if (ret)
+		return ret;
+
+	return txa_service_coalesce_get(id, eth_dev, queue, conf);
+}
+
+int
+rte_event_eth_tx_adapter_xstats_names_get(uint8_t id,
+		struct rte_event_dev_xstats_name *xstats_names,
+		unsigned int size)
+{
+	TXA_CHECK_OR_ERR_RET(id);
+
+	if (xstats_names == NULL || size < TXA_XSTATS_NB)
+		return TXA_XSTATS_NB;
+
+	return txa_service_xstats_names_get(xstats_names);
+}
+
+int
+rte_event_eth_tx_adapter_xstats_get(uint8_t id, uint64_t *values,
+		unsigned int size)
+{
+	TXA_CHECK_OR_ERR_RET(id);
+
+	if (values == NULL || size < TXA_XSTATS_NB)
+		return TXA_XSTATS_NB;
+
+	return txa_service_xstats_get(id, values);
+}
+
+int
+rte_event_eth_tx_adapter_xstats_reset(uint8_t id)
+{
+	TXA_CHECK_OR_ERR_RET(id);
+
+	return txa_service_xstats_reset(id);
+}
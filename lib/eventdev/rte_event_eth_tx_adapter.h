@@ -34,6 +34,11 @@
  *  - rte_event_eth_tx_adapter_enqueue()
  *  - rte_event_eth_tx_adapter_event_port_get()
  *  - rte_event_eth_tx_adapter_service_id_get()
+ *  - rte_event_eth_tx_adapter_queue_coalesce_set()
+ *  - rte_event_eth_tx_adapter_queue_coalesce_get()
+ *  - rte_event_eth_tx_adapter_xstats_names_get()
+ *  - rte_event_eth_tx_adapter_xstats_get()
+ *  - rte_event_eth_tx_adapter_xstats_reset()
  *
  * The application creates the adapter using
  * rte_event_eth_tx_adapter_create() or rte_event_eth_tx_adapter_create_ext().
@@ -68,6 +73,14 @@
  * and rte_event_eth_tx_adapter_txq_get() functions to access the transmit
  * queue index, using these macros will help with minimizing application
  * impact due to a change in how the transmit queue index is specified.
+ *
+ * By default the common implementation buffers mbufs per transmit queue and
+ * sends them when the buffer fills up or periodically from the service
+ * function. A transmit queue can be switched to coalescing mode using
+ * rte_event_eth_tx_adapter_queue_coalesce_set(), in which case the adapter
+ * accumulates up to a target burst size before calling rte_eth_tx_burst(),
+ * bounded by a maximum hold time for the oldest buffered mbuf. The resulting
+ * Tx burst size distribution is reported through the adapter xstats.
  */
 
 #ifdef __cplusplus
@@ -135,6 +148,30 @@ struct rte_event_eth_tx_adapter_stats {
 	/**< Number of packets dropped */
 };
 
+/** Maximum target burst size of a coalescing Tx queue */
+#define RTE_EVENT_ETH_TX_ADAPTER_COALESCE_MAX_BURST	256
+
+/**
+ * Tx queue coalescing configuration, used by the common implementation.
+ *
+ * @see rte_event_eth_tx_adapter_queue_coalesce_set
+ */
+struct rte_event_eth_tx_adapter_queue_coalesce_conf {
+	uint16_t burst_size;
+	/**< Target Tx burst size. Mbufs are buffered until this many are
+	 * available for the queue and then sent in a single
+	 * rte_eth_tx_burst() call. A value of 0 disables coalescing and
+	 * restores the default buffering behavior. Must not exceed
+	 * #RTE_EVENT_ETH_TX_ADAPTER_COALESCE_MAX_BURST.
+	 */
+	uint64_t max_hold_cycles;
+	/**< Maximum time, in rte_get_timer_cycles() units, the oldest
+	 * buffered mbuf is held before the queue is flushed irrespective of
+	 * burst_size. A value of 0 flushes at the end of every service
+	 * function invocation.
+	 */
+};
+
 /**
  * Create a new ethernet Tx adapter with the specified identifier.
  *
@@ -423,6 +460,127 @@ rte_event_eth_tx_adapter_stats_reset(uint8_t id);
 int
 rte_event_eth_tx_adapter_service_id_get(uint8_t id, uint32_t *service_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Configure Tx burst coalescing for a Tx queue added to the adapter.
+ * A queue value of -1 is used to indicate all queues within the device
+ * that have been added to this adapter. Coalescing is only supported by
+ * the common (service function based) implementation.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param eth_dev_id
+ *  Ethernet Port Identifier.
+ * @param queue
+ *  Tx queue index.
+ * @param conf
+ *  Coalescing configuration.
+ * @return
+ *  - 0: Success.
+ *  - -EINVAL: Invalid parameter or queue not added to the adapter.
+ *  - -ENOTSUP: The adapter uses an internal port for this device.
+ *  - -ENOMEM: Failed to allocate the Tx buffer.
+ */
+__rte_experimental
+int
+rte_event_eth_tx_adapter_queue_coalesce_set(uint8_t id,
+		uint16_t eth_dev_id,
+		int32_t queue,
+		const struct rte_event_eth_tx_adapter_queue_coalesce_conf *conf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the Tx burst coalescing configuration of a Tx queue.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param eth_dev_id
+ *  Ethernet Port Identifier.
+ * @param queue
+ *  Tx queue index.
+ * @param[out] conf
+ *  Pointer to the structure to be filled with the queue configuration.
+ * @return
+ *  - 0: Success.
+ *  - -EINVAL: Invalid parameter or queue not added to the adapter.
+ *  - -ENOTSUP: The adapter uses an internal port for this device.
+ */
+__rte_experimental
+int
+rte_event_eth_tx_adapter_queue_coalesce_get(uint8_t id,
+		uint16_t eth_dev_id,
+		uint16_t queue,
+		struct rte_event_eth_tx_adapter_queue_coalesce_conf *conf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the names of the extended statistics of an adapter. These include
+ * a histogram of the Tx burst sizes passed to rte_eth_tx_burst() by the
+ * common implementation, in power of two buckets, and the number of
+ * coalesced bursts sent on reaching the target size or the hold time.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param[out] xstats_names
+ *  Array to be filled with the statistics names, may be NULL.
+ * @param size
+ *  Number of elements in the xstats_names array.
+ * @return
+ *  - Number of extended statistics. If this is greater than size, or
+ *    xstats_names is NULL, the array is not filled.
+ *  - <0: Error code on failure.
+ */
+__rte_experimental
+int
+rte_event_eth_tx_adapter_xstats_names_get(uint8_t id,
+		struct rte_event_dev_xstats_name *xstats_names,
+		unsigned int size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the extended statistics of an adapter, in the order of the names
+ * returned by rte_event_eth_tx_adapter_xstats_names_get().
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param[out] values
+ *  Array to be filled with the statistics values, may be NULL.
+ * @param size
+ *  Number of elements in the values array.
+ * @return
+ *  - Number of extended statistics. If this is greater than size, or
+ *    values is NULL, the array is not filled.
+ *  - <0: Error code on failure.
+ */
+__rte_experimental
+int
+rte_event_eth_tx_adapter_xstats_get(uint8_t id, uint64_t *values,
+		unsigned int size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset the extended statistics of an adapter.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @return
+ *  - 0: Success.
+ *  - <0: Error code on failure.
+ */
+__rte_experimental
+int
+rte_event_eth_tx_adapter_xstats_reset(uint8_t id);
+
 #ifdef __cplusplus
 }
 #endif
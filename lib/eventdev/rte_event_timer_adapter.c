@@ -3,9 +3,11 @@
  * All rights reserved.
  */
 
+#include <ctype.h>
 #include <string.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stdlib.h>
 
 #include <rte_memzone.h>
 #include <rte_errno.h>
@@ -14,6 +16,7 @@
 #include <rte_common.h>
 #include <rte_timer.h>
 #include <rte_service_component.h>
+#include <rte_telemetry.h>
 
 #include "event_timer_adapter_pmd.h"
 #include "eventdev_pmd.h"
@@ -445,6 +448,37 @@ rte_event_timer_adapter_stats_reset(struct rte_event_timer_adapter *adapter)
 	return adapter->ops->stats_reset(adapter);
 }
 
+int
+rte_event_timer_adapter_xstats_names_get(
+		struct rte_event_timer_adapter *adapter,
+		struct rte_event_dev_xstats_name *xstats_names,
+		unsigned int size)
+{
+	ADAPTER_VALID_OR_ERR_RET(adapter, -EINVAL);
+	FUNC_PTR_OR_ERR_RET(adapter->ops->xstats_names_get, -ENOTSUP);
+	return adapter->ops->xstats_names_get(adapter, xstats_names, size);
+}
+
+int
+rte_event_timer_adapter_xstats_get(struct rte_event_timer_adapter *adapter,
+		unsigned int lcore_id, uint64_t *values, unsigned int size)
+{
+	ADAPTER_VALID_OR_ERR_RET(adapter, -EINVAL);
+	FUNC_PTR_OR_ERR_RET(adapter->ops->xstats_get, -ENOTSUP);
+	if (lcore_id != LCORE_ID_ANY && lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	return adapter->ops->xstats_get(adapter, lcore_id, values, size);
+}
+
+int
+rte_event_timer_adapter_xstats_reset(struct rte_event_timer_adapter *adapter)
+{
+	ADAPTER_VALID_OR_ERR_RET(adapter, -EINVAL);
+	FUNC_PTR_OR_ERR_RET(adapter->ops->xstats_reset, -ENOTSUP);
+	return adapter->ops->xstats_reset(adapter);
+}
+
 /*
  * Software event timer adapter buffer helper functions
  */
@@ -460,6 +494,41 @@ rte_event_timer_adapter_stats_reset(struct rte_event_timer_adapter *adapter)
 
 #define EXP_TIM_BUF_SZ 128
 
+/* Lateness and arm-to-fire histograms use log2 buckets of timer cycles; the
+ * first bucket holds everything below 2^SWTIM_HIST_SHIFT cycles and the last
+ * one is open ended.
+ */
+#define SWTIM_HIST_SHIFT 10
+#define SWTIM_HIST_NB 32
+
+enum swtim_xstat {
+	SWTIM_XSTAT_FIRED,
+	SWTIM_XSTAT_LATENESS_SUM,
+	SWTIM_XSTAT_ARM_TO_FIRE_SUM,
+	SWTIM_XSTAT_LATENESS_HIST,
+	SWTIM_XSTAT_ARM_TO_FIRE_HIST = SWTIM_XSTAT_LATENESS_HIST +
+				       SWTIM_HIST_NB,
+	SWTIM_XSTATS_NB = SWTIM_XSTAT_ARM_TO_FIRE_HIST + SWTIM_HIST_NB,
+};
+
+/* Extended statistics of the timers armed from one lcore. Only the adapter
+ * service updates them, so readers need no lock.
+ */
+struct swtim_lcore_xstats {
+	uint64_t v[SWTIM_XSTATS_NB];
+} __rte_cache_aligned;
+
+/* Timer object allocated from the adapter mempool */
+struct swtim_tim {
+	struct rte_timer tim;
+	/* Cycle count at which the event timer was armed */
+	uint64_t arm_cycles;
+	/* Cycle count at which the event timer should expire */
+	uint64_t exp_cycles;
+	/* Timer list the event timer was armed on */
+	unsigned int lcore_id;
+};
+
 struct event_buffer {
 	size_t head;
 	size_t tail;
@@ -591,6 +660,10 @@ struct swtim {
 	struct rte_timer *expired_timers[EXP_TIM_BUF_SZ];
 	/* The number of timers that can be returned to a mempool */
 	size_t n_expired_timers;
+	/* Extended statistics, indexed by arming lcore */
+	struct swtim_lcore_xstats xstats[RTE_MAX_LCORE];
+	/* Extended statistics values at the last reset */
+	struct swtim_lcore_xstats xstats_base[RTE_MAX_LCORE];
 };
 
 static inline struct swtim *
@@ -599,6 +672,39 @@ swtim_pmd_priv(const struct rte_event_timer_adapter *adapter)
 	return adapter->data->adapter_priv;
 }
 
+static inline unsigned int
+swtim_hist_bucket(uint64_t cycles)
+{
+	unsigned int bucket = rte_fls_u64(cycles >> SWTIM_HIST_SHIFT);
+
+	return RTE_MIN(bucket, (unsigned int)SWTIM_HIST_NB - 1);
+}
+
+static inline void
+swtim_xstat_add(uint64_t *stat, uint64_t val)
+{
+	__atomic_store_n(stat, *stat + val, __ATOMIC_RELAXED);
+}
+
+static inline void
+swtim_xstats_update(struct swtim *sw, const struct swtim_tim *stim,
+		    uint64_t now)
+{
+	uint64_t *v = sw->xstats[stim->lcore_id].v;
+	uint64_t lateness, arm_to_fire;
+
+	lateness = now > stim->exp_cycles ? now - stim->exp_cycles : 0;
+	arm_to_fire = now - stim->arm_cycles;
+
+	swtim_xstat_add(&v[SWTIM_XSTAT_FIRED], 1);
+	swtim_xstat_add(&v[SWTIM_XSTAT_LATENESS_SUM], lateness);
+	swtim_xstat_add(&v[SWTIM_XSTAT_ARM_TO_FIRE_SUM], arm_to_fire);
+	swtim_xstat_add(&v[SWTIM_XSTAT_LATENESS_HIST +
+			   swtim_hist_bucket(lateness)], 1);
+	swtim_xstat_add(&v[SWTIM_XSTAT_ARM_TO_FIRE_HIST +
+			   swtim_hist_bucket(arm_to_fire)], 1);
+}
+
 static void
 swtim_callback(struct rte_timer *tim)
 {
@@ -653,6 +759,9 @@ swtim_callback(struct rte_timer *tim)
 			sw->n_expired_timers = 0;
 		}
 
+		swtim_xstats_update(sw, (struct swtim_tim *)tim,
+				    rte_get_timer_cycles());
+
 		sw->expired_timers[sw->n_expired_timers++] = tim;
 		sw->stats.evtim_exp_count++;
 
@@ -856,7 +965,7 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 				adapter->data->conf.nb_timers, nb_timers);
 	flags = 0; /* pool is multi-producer, multi-consumer */
 	sw->tim_pool = rte_mempool_create(pool_name, pool_size,
-			sizeof(struct rte_timer), cache_size, 0, NULL, NULL,
+			sizeof(struct swtim_tim), cache_size, 0, NULL, NULL,
 			NULL, NULL, adapter->data->socket_id, flags);
 	if (sw->tim_pool == NULL) {
 		EVTIM_LOG_ERR("failed to create timer object mempool");
@@ -1038,6 +1147,94 @@ swtim_stats_reset(const struct rte_event_timer_adapter *adapter)
 	return 0;
 }
 
+static int
+swtim_xstats_names_get(const struct rte_event_timer_adapter *adapter,
+		       struct rte_event_dev_xstats_name *xstats_names,
+		       unsigned int size)
+{
+	static const char * const hist_names[] = {
+		"evtim_lateness_cycles", "evtim_arm_to_fire_cycles"
+	};
+	unsigned int i, j, n;
+	uint64_t lo, hi;
+
+	RTE_SET_USED(adapter);
+
+	if (xstats_names == NULL || size < SWTIM_XSTATS_NB)
+		return SWTIM_XSTATS_NB;
+
+	n = 0;
+	snprintf(xstats_names[n++].name, RTE_EVENT_DEV_XSTATS_NAME_SIZE,
+		 "evtim_fired");
+	snprintf(xstats_names[n++].name, RTE_EVENT_DEV_XSTATS_NAME_SIZE,
+		 "evtim_lateness_cycles_sum");
+	snprintf(xstats_names[n++].name, RTE_EVENT_DEV_XSTATS_NAME_SIZE,
+		 "evtim_arm_to_fire_cycles_sum");
+
+	for (i = 0; i < RTE_DIM(hist_names); i++) {
+		for (j = 0; j < SWTIM_HIST_NB; j++) {
+			lo = j ? 1ULL << (SWTIM_HIST_SHIFT + j - 1) : 0;
+			hi = (1ULL << (SWTIM_HIST_SHIFT + j)) - 1;
+			if (j == SWTIM_HIST_NB - 1)
+				snprintf(xstats_names[n++].name,
+					 RTE_EVENT_DEV_XSTATS_NAME_SIZE,
+					 "%s_%"PRIu64"_inf", hist_names[i], lo);
+			else
+				snprintf(xstats_names[n++].name,
+					 RTE_EVENT_DEV_XSTATS_NAME_SIZE,
+					 "%s_%"PRIu64"_%"PRIu64,
+					 hist_names[i], lo, hi);
+		}
+	}
+
+	return SWTIM_XSTATS_NB;
+}
+
+static int
+swtim_xstats_get(const struct rte_event_timer_adapter *adapter,
+		 unsigned int lcore_id, uint64_t *values, unsigned int size)
+{
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	unsigned int first, last, i, l;
+
+	if (values == NULL || size < SWTIM_XSTATS_NB)
+		return SWTIM_XSTATS_NB;
+
+	if (lcore_id == LCORE_ID_ANY) {
+		first = 0;
+		last = RTE_MAX_LCORE - 1;
+	} else {
+		first = last = lcore_id;
+	}
+
+	memset(values, 0, SWTIM_XSTATS_NB * sizeof(*values));
+	for (l = first; l <= last; l++)
+		for (i = 0; i < SWTIM_XSTATS_NB; i++)
+			values[i] += __atomic_load_n(&sw->xstats[l].v[i],
+						     __ATOMIC_RELAXED) -
+				     sw->xstats_base[l].v[i];
+
+	return SWTIM_XSTATS_NB;
+}
+
+/* The service keeps updating the counters, so a reset only records their
+ * current values as the new base.
+ */
+static int
+swtim_xstats_reset(const struct rte_event_timer_adapter *adapter)
+{
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	unsigned int i, l;
+
+	for (l = 0; l < RTE_MAX_LCORE; l++)
+		for (i = 0; i < SWTIM_XSTATS_NB; i++)
+			sw->xstats_base[l].v[i] =
+				__atomic_load_n(&sw->xstats[l].v[i],
+						__ATOMIC_RELAXED);
+
+	return 0;
+}
+
 static uint16_t
 __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 		struct rte_event_timer **evtims,
@@ -1047,7 +1244,8 @@ __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 	struct swtim *sw = swtim_pmd_priv(adapter);
 	uint32_t lcore_id = rte_lcore_id();
 	struct rte_timer *tim, *tims[nb_evtims];
-	uint64_t cycles;
+	struct swtim_tim *stim;
+	uint64_t cycles, now;
 	int n_lcores;
 	/* Timer list for this lcore is not in use. */
 	uint16_t exp_state = 0;
@@ -1091,6 +1289,8 @@ __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 		return 0;
 	}
 
+	now = rte_get_timer_cycles();
+
 	for (i = 0; i < nb_evtims; i++) {
 		n_state = __atomic_load_n(&evtims[i]->state, __ATOMIC_ACQUIRE);
 		if (n_state == RTE_EVENT_TIMER_ARMED) {
@@ -1133,6 +1333,11 @@ __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 		evtims[i]->impl_opaque[1] = (uintptr_t)adapter;
 
 		cycles = get_timeout_cycles(evtims[i], adapter);
+		stim = (struct swtim_tim *)tim;
+		stim->arm_cycles = now;
+		stim->exp_cycles = now + cycles;
+		stim->lcore_id = lcore_id;
+
 		ret = rte_timer_alt_reset(sw->timer_data_id, tim, cycles,
 					  SINGLE, lcore_id, NULL, evtims[i]);
 		if (ret < 0) {
@@ -1248,4 +1453,83 @@ static const struct event_timer_adapter_ops swtim_ops = {
 	.arm_burst = swtim_arm_burst,
 	.arm_tmo_tick_burst = swtim_arm_tmo_tick_burst,
 	.cancel_burst = swtim_cancel_burst,
+	.xstats_names_get = swtim_xstats_names_get,
+	.xstats_get = swtim_xstats_get,
+	.xstats_reset = swtim_xstats_reset,
 };
+
+static int
+handle_ta_xstats(const char *cmd __rte_unused,
+		 const char *params,
+		 struct rte_tel_data *d)
+{
+	struct rte_event_dev_xstats_name *xstats_names;
+	struct rte_event_timer_adapter *adapter;
+	unsigned int lcore_id = LCORE_ID_ANY;
+	unsigned long adapter_id;
+	uint64_t *values;
+	char *end;
+	int i, n, ret;
+
+	if (params == NULL || strlen(params) == 0 || !isdigit(*params))
+		return -1;
+
+	/* Parameters: adapter_id[,lcore_id] */
+	adapter_id = strtoul(params, &end, 10);
+	if (*end == ',') {
+		if (!isdigit(*(end + 1)))
+			return -1;
+		lcore_id = strtoul(end + 1, &end, 10);
+	}
+	if (*end != '\0')
+		EVTIM_LOG_ERR("Extra parameters passed to telemetry command, "
+			      "ignoring");
+
+	if (adapters == NULL ||
+	    adapter_id >= RTE_EVENT_TIMER_ADAPTER_NUM_MAX ||
+	    !adapters[adapter_id].allocated)
+		return -EINVAL;
+	adapter = &adapters[adapter_id];
+
+	n = rte_event_timer_adapter_xstats_names_get(adapter, NULL, 0);
+	if (n <= 0)
+		return n;
+
+	xstats_names = malloc(sizeof(*xstats_names) * n);
+	values = malloc(sizeof(*values) * n);
+	if (xstats_names == NULL || values == NULL) {
+		ret = -ENOMEM;
+		goto free;
+	}
+
+	ret = rte_event_timer_adapter_xstats_names_get(adapter, xstats_names,
+						       n);
+	if (ret < 0 || ret > n) {
+		ret = ret < 0 ? ret : -EINVAL;
+		goto free;
+	}
+
+	ret = rte_event_timer_adapter_xstats_get(adapter, lcore_id, values, n);
+	if (ret < 0 || ret > n) {
+		ret = ret < 0 ? ret : -EINVAL;
+		goto free;
+	}
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_u64(d, "timer_adapter_id", adapter_id);
+	for (i = 0; i < n; i++)
+		rte_tel_data_add_dict_u64(d, xstats_names[i].name, values[i]);
+	ret = 0;
+
+free:
+	free(xstats_names);
+	free(values);
+	return ret;
+}
+
+RTE_INIT(ta_init_telemetry)
+{
+	rte_telemetry_register_cmd("/eventdev/ta_xstats",
+		handle_ta_xstats,
+		"Returns timer adapter xstats. Parameters: ta_id[,lcore_id]");
+}
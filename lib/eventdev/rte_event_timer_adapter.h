@@ -97,6 +97,12 @@
  * The application can cancel the timers from expiring using the
  * ``rte_event_timer_cancel_burst()``.
  *
+ * Besides the aggregate counters returned by
+ * ``rte_event_timer_adapter_stats_get()``, an adapter may report extended
+ * statistics through ``rte_event_timer_adapter_xstats_get()``. The software
+ * implementation uses them to report, per arming lcore, histograms of the
+ * expiry lateness and of the arm-to-fire delay of event timers.
+ *
  * On the secondary process, ``rte_event_timer_adapter_lookup()`` can be used
  * to get the timer adapter pointer from its id and use it to invoke fastpath
  * operations such as arm and cancel.
@@ -434,6 +440,85 @@ rte_event_timer_adapter_stats_get(struct rte_event_timer_adapter *adapter,
 int
 rte_event_timer_adapter_stats_reset(struct rte_event_timer_adapter *adapter);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the names of the extended statistics of an event timer adapter
+ * instance. The set of statistics is implementation specific; the software
+ * implementation reports the number of fired timers, the sum of their
+ * expiry lateness and arm-to-fire delay, and log2 histograms of both, all
+ * expressed in rte_get_timer_cycles() units.
+ *
+ * @param adapter
+ *   A pointer to an event timer adapter structure.
+ * @param[out] xstats_names
+ *   Array to be filled with the statistics names, may be NULL.
+ * @param size
+ *   Number of elements in the xstats_names array.
+ *
+ * @return
+ *   - Number of extended statistics. If this is greater than size, or
+ *     xstats_names is NULL, the array is not filled.
+ *   - -ENOTSUP: the adapter does not report extended statistics.
+ *   - <0: Failure; error code returned.
+ */
+__rte_experimental
+int
+rte_event_timer_adapter_xstats_names_get(
+		struct rte_event_timer_adapter *adapter,
+		struct rte_event_dev_xstats_name *xstats_names,
+		unsigned int size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the extended statistics of an event timer adapter instance, in
+ * the order of the names returned by
+ * rte_event_timer_adapter_xstats_names_get().
+ *
+ * @param adapter
+ *   A pointer to an event timer adapter structure.
+ * @param lcore_id
+ *   Return the statistics of the timers armed from this lcore, or
+ *   LCORE_ID_ANY for the sum over all lcores. Timers armed from non-EAL
+ *   threads are accounted to lcore RTE_MAX_LCORE - 1.
+ * @param[out] values
+ *   Array to be filled with the statistics values, may be NULL.
+ * @param size
+ *   Number of elements in the values array.
+ *
+ * @return
+ *   - Number of extended statistics. If this is greater than size, or
+ *     values is NULL, the array is not filled.
+ *   - -ENOTSUP: the adapter does not report extended statistics, or does
+ *     not report them per lcore.
+ *   - <0: Failure; error code returned.
+ */
+__rte_experimental
+int
+rte_event_timer_adapter_xstats_get(struct rte_event_timer_adapter *adapter,
+		unsigned int lcore_id, uint64_t *values, unsigned int size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset the extended statistics of an event timer adapter instance.
+ *
+ * @param adapter
+ *   A pointer to an event timer adapter structure.
+ *
+ * @return
+ *   - 0: Successfully reset;
+ *   - -ENOTSUP: the adapter does not report extended statistics.
+ *   - <0: Failure; error code returned.
+ */
+__rte_experimental
+int
+rte_event_timer_adapter_xstats_reset(struct rte_event_timer_adapter *adapter);
+
 /**
  * Event timer state.
  */
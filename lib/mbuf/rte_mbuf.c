@@ -89,7 +89,7 @@ rte_pktmbuf_init(struct rte_mempool *mp,
 	/* start of buffer is after mbuf structure and priv data */
 	m->priv_size = priv_size;
 	m->buf_addr = (char *)m + mbuf_size;
-	m->buf_iova = rte_mempool_virt2iova(m) + mbuf_size;
+	rte_mbuf_iova_set(m, rte_mempool_virt2iova(m) + mbuf_size);
 	m->buf_len = (uint16_t)buf_len;
 
 	/* keep some headroom between start of buffer and data */
@@ -187,8 +187,8 @@ __rte_pktmbuf_init_extmem(struct rte_mempool *mp,
 	RTE_ASSERT(ctx->off + ext_mem->elt_size <= ext_mem->buf_len);
 
 	m->buf_addr = RTE_PTR_ADD(ext_mem->buf_ptr, ctx->off);
-	m->buf_iova = ext_mem->buf_iova == RTE_BAD_IOVA ?
-		      RTE_BAD_IOVA : (ext_mem->buf_iova + ctx->off);
+	rte_mbuf_iova_set(m, ext_mem->buf_iova == RTE_BAD_IOVA ?
+			  RTE_BAD_IOVA : (ext_mem->buf_iova + ctx->off));
 
 	ctx->off += ext_mem->elt_size;
 	if (ctx->off + ext_mem->elt_size > ext_mem->buf_len) {
@@ -214,9 +214,9 @@ __rte_pktmbuf_init_extmem(struct rte_mempool *mp,
 	rte_mbuf_ext_refcnt_set(shinfo, 1);
 }
 
-/* Helper to create a mbuf pool with given mempool ops name*/
-struct rte_mempool *
-rte_pktmbuf_pool_create_by_ops(const char *name, unsigned int n,
+/* Create a mbuf pool, elastic when chunk_n is not zero. */
+static struct rte_mempool *
+mbuf_pool_create(const char *name, unsigned int n, unsigned int chunk_n,
 	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size,
 	int socket_id, const char *ops_name)
 {
@@ -254,18 +254,33 @@ rte_pktmbuf_pool_create_by_ops(const char *name, unsigned int n,
 	}
 	rte_pktmbuf_pool_init(mp, &mbp_priv);
 
-	ret = rte_mempool_populate_default(mp);
+	if (chunk_n != 0)
+		ret = rte_mempool_populate_elastic(mp, chunk_n,
+						   rte_pktmbuf_init, NULL);
+	else
+		ret = rte_mempool_populate_default(mp);
 	if (ret < 0) {
 		rte_mempool_free(mp);
 		rte_errno = -ret;
 		return NULL;
 	}
 
-	rte_mempool_obj_iter(mp, rte_pktmbuf_init, NULL);
+	if (chunk_n == 0)
+		rte_mempool_obj_iter(mp, rte_pktmbuf_init, NULL);
 
 	return mp;
 }
 
+/* Helper to create a mbuf pool with given mempool ops name*/
+struct rte_mempool *
+rte_pktmbuf_pool_create_by_ops(const char *name, unsigned int n,
+	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size,
+	int socket_id, const char *ops_name)
+{
+	return mbuf_pool_create(name, n, 0, cache_size, priv_size,
+			data_room_size, socket_id, ops_name);
+}
+
 /* helper to create a mbuf pool */
 struct rte_mempool *
 rte_pktmbuf_pool_create(const char *name, unsigned int n,
@@ -276,6 +291,20 @@ rte_pktmbuf_pool_create(const char *name, unsigned int n,
 			data_room_size, socket_id, NULL);
 }
 
+/* helper to create an elastic mbuf pool */
+struct rte_mempool *
+rte_pktmbuf_pool_create_elastic(const char *name, unsigned int n,
+	unsigned int chunk_n, unsigned int cache_size, uint16_t priv_size,
+	uint16_t data_room_size, int socket_id)
+{
+	if (chunk_n == 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	return mbuf_pool_create(name, n, chunk_n, cache_size, priv_size,
+			data_room_size, socket_id, NULL);
+}
+
 /* Helper to create a mbuf pool with pinned external data buffers. */
 struct rte_mempool *
 rte_pktmbuf_pool_create_extbuf(const char *name, unsigned int n,
@@ -388,7 +417,7 @@ int rte_mbuf_check(const struct rte_mbuf *m, int is_header,
 		*reason = "bad mbuf pool";
 		return -1;
 	}
-	if (m->buf_iova == 0) {
+	if (rte_mbuf_iova_get(m) == 0) {
 		*reason = "bad IO addr";
 		return -1;
 	}
@@ -670,7 +699,7 @@ rte_pktmbuf_dump(FILE *f, const struct rte_mbuf *m, unsigned dump_len)
 	__rte_mbuf_sanity_check(m, 1);
 
 	fprintf(f, "dump mbuf at %p, iova=%#"PRIx64", buf_len=%u\n",
-		m, m->buf_iova, m->buf_len);
+		m, rte_mbuf_iova_get(m), m->buf_len);
 	fprintf(f, "  pkt_len=%u, ol_flags=%#"PRIx64", nb_segs=%u, port=%u",
 		m->pkt_len, m->ol_flags, m->nb_segs, m->port);
 
@@ -135,6 +135,50 @@ rte_mbuf_prefetch_part2(struct rte_mbuf *m)
 
 static inline uint16_t rte_pktmbuf_priv_size(struct rte_mempool *mp);
 
+/**
+ * Get the IOVA address of the mbuf data buffer.
+ *
+ * If the build is configured to use only virtual addresses as IOVA
+ * (RTE_IOVA_AS_PA is 0), this is the virtual address of the buffer.
+ *
+ * @param m
+ *   The pointer to the mbuf.
+ * @return
+ *   The IOVA address of the mbuf data buffer.
+ */
+static inline rte_iova_t
+rte_mbuf_iova_get(const struct rte_mbuf *m)
+{
+#if RTE_IOVA_AS_PA
+	return m->buf_iova;
+#else
+	return (rte_iova_t)(uintptr_t)m->buf_addr;
+#endif
+}
+
+/**
+ * Set the IOVA address of the mbuf data buffer.
+ *
+ * If the build is configured to use only virtual addresses as IOVA
+ * (RTE_IOVA_AS_PA is 0), the IOVA is the virtual address of the buffer
+ * and this function does nothing.
+ *
+ * @param m
+ *   The pointer to the mbuf.
+ * @param iova
+ *   Value to set as IOVA address of the mbuf data buffer.
+ */
+static inline void
+rte_mbuf_iova_set(struct rte_mbuf *m, rte_iova_t iova)
+{
+#if RTE_IOVA_AS_PA
+	m->buf_iova = iova;
+#else
+	RTE_SET_USED(m);
+	RTE_SET_USED(iova);
+#endif
+}
+
 /**
  * Return the IO address of the beginning of the mbuf data
  *
@@ -146,7 +190,7 @@ static inline uint16_t rte_pktmbuf_priv_size(struct rte_mempool *mp);
 static inline rte_iova_t
 rte_mbuf_data_iova(const struct rte_mbuf *mb)
 {
-	return mb->buf_iova + mb->data_off;
+	return rte_mbuf_iova_get(mb) + mb->data_off;
 }
 
 /**
@@ -164,7 +208,7 @@ rte_mbuf_data_iova(const struct rte_mbuf *mb)
 static inline rte_iova_t
 rte_mbuf_data_iova_default(const struct rte_mbuf *mb)
 {
-	return mb->buf_iova + RTE_PKTMBUF_HEADROOM;
+	return rte_mbuf_iova_get(mb) + RTE_PKTMBUF_HEADROOM;
 }
 
 /**
@@ -717,6 +761,53 @@ rte_pktmbuf_pool_create_by_ops(const char *name, unsigned int n,
 	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size,
 	int socket_id, const char *ops_name);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create an elastic mbuf pool
+ *
+ * This function creates a packet mbuf pool like rte_pktmbuf_pool_create(),
+ * but only allocates memory for chunk_n mbufs at init. The pool then grows
+ * by chunks of chunk_n mbufs with rte_mempool_elastic_grow(), up to n mbufs,
+ * and idle chunks can be released with rte_mempool_elastic_shrink().
+ * See rte_mempool_populate_elastic() for details.
+ *
+ * @param name
+ *   The name of the mbuf pool.
+ * @param n
+ *   The maximum number of elements in the mbuf pool.
+ * @param chunk_n
+ *   The number of elements added to the mbuf pool at once.
+ * @param cache_size
+ *   Size of the per-core object cache. See rte_mempool_create() for
+ *   details.
+ * @param priv_size
+ *   Size of application private are between the rte_mbuf structure
+ *   and the data buffer. This value must be aligned to RTE_MBUF_PRIV_ALIGN.
+ * @param data_room_size
+ *   Size of data buffer in each mbuf, including RTE_PKTMBUF_HEADROOM.
+ * @param socket_id
+ *   The socket identifier where the memory should be allocated. The
+ *   value can be *SOCKET_ID_ANY* if there is no NUMA constraint for the
+ *   reserved zone.
+ * @return
+ *   The pointer to the new allocated mempool, on success. NULL on error
+ *   with rte_errno set appropriately. Possible rte_errno values include:
+ *    - E_RTE_NO_CONFIG - function could not get pointer to rte_config structure
+ *    - E_RTE_SECONDARY - function was called from a secondary process instance
+ *    - EINVAL - cache size provided is too large, priv_size is not aligned,
+ *      or chunk_n is zero or larger than n.
+ *    - ENOSPC - the maximum number of memzones has already been allocated
+ *    - EEXIST - a memzone with the same name already exists
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+__rte_experimental
+struct rte_mempool *
+rte_pktmbuf_pool_create_elastic(const char *name, unsigned int n,
+	unsigned int chunk_n, unsigned int cache_size, uint16_t priv_size,
+	uint16_t data_room_size, int socket_id);
+
 /** A structure that describes the pinned external buffer segment. */
 struct rte_pktmbuf_extmem {
 	void *buf_ptr;		/**< The virtual address of data buffer. */
@@ -1056,7 +1147,7 @@ rte_pktmbuf_attach_extbuf(struct rte_mbuf *m, void *buf_addr,
 	RTE_ASSERT(shinfo->free_cb != NULL);
 
 	m->buf_addr = buf_addr;
-	m->buf_iova = buf_iova;
+	rte_mbuf_iova_set(m, buf_iova);
 	m->buf_len = buf_len;
 
 	m->data_len = 0;
@@ -1086,6 +1177,9 @@ rte_pktmbuf_attach_extbuf(struct rte_mbuf *m, void *buf_addr,
 static inline void
 rte_mbuf_dynfield_copy(struct rte_mbuf *mdst, const struct rte_mbuf *msrc)
 {
+#if !RTE_IOVA_AS_PA
+	mdst->dynfield2 = msrc->dynfield2;
+#endif
 	memcpy(&mdst->dynfield1, msrc->dynfield1, sizeof(mdst->dynfield1));
 }
 
@@ -1143,7 +1237,7 @@ static inline void rte_pktmbuf_attach(struct rte_mbuf *mi, struct rte_mbuf *m)
 
 	mi->data_off = m->data_off;
 	mi->data_len = m->data_len;
-	mi->buf_iova = m->buf_iova;
+	rte_mbuf_iova_set(mi, rte_mbuf_iova_get(m));
 	mi->buf_addr = m->buf_addr;
 	mi->buf_len = m->buf_len;
 
@@ -1245,7 +1339,7 @@ static inline void rte_pktmbuf_detach(struct rte_mbuf *m)
 
 	m->priv_size = priv_size;
 	m->buf_addr = (char *)m + mbuf_size;
-	m->buf_iova = rte_mempool_virt2iova(m) + mbuf_size;
+	rte_mbuf_iova_set(m, rte_mempool_virt2iova(m) + mbuf_size);
 	m->buf_len = (uint16_t)buf_len;
 	rte_pktmbuf_reset_headroom(m);
 	m->data_len = 0;
@@ -1401,6 +1495,44 @@ static inline void rte_pktmbuf_free(struct rte_mbuf *m)
  */
 void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free a bulk of packet mbufs back into their mempool, without any check.
+ *
+ * This is the equivalent of rte_pktmbuf_free_bulk() for mbufs that all
+ * meet the requirements of rte_mbuf_raw_free(), that is direct (or with
+ * a pinned external buffer), single-segment and with a reference counter
+ * of 1, and which all come from the same mempool. This is the case of the
+ * Tx queues with the RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE offload. The mbufs
+ * are put back into the mempool at once, without being reset.
+ *
+ *  @param mbufs
+ *    Array of pointers to packet mbufs, NULL pointers are not allowed.
+ *  @param count
+ *    Array size, must be greater than 0.
+ */
+__rte_experimental
+static inline void
+rte_pktmbuf_free_bulk_fast(struct rte_mbuf **mbufs, unsigned int count)
+{
+#ifdef RTE_LIBRTE_MBUF_DEBUG
+	unsigned int idx;
+
+	for (idx = 0; idx != count; idx++) {
+		struct rte_mbuf *m = mbufs[idx];
+
+		RTE_ASSERT(!RTE_MBUF_CLONED(m) &&
+			  (!RTE_MBUF_HAS_EXTBUF(m) ||
+			   RTE_MBUF_HAS_PINNED_EXTBUF(m)));
+		RTE_ASSERT(m->pool == mbufs[0]->pool);
+		__rte_mbuf_raw_sanity_check(m);
+	}
+#endif
+	rte_mempool_put_bulk(mbufs[0]->pool, (void **)mbufs, count);
+}
+
 /**
  * Create a "clone" of the given packet mbuf.
  *
@@ -0,0 +1,166 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#ifndef _RTE_MBUF_TMPL_H_
+#define _RTE_MBUF_TMPL_H_
+
+/**
+ * @file
+ * RTE Mbuf allocation from a rearm template
+ *
+ * Drivers refilling a receive ring compute the reset values of a mbuf once
+ * per queue, and write them to each mbuf of the burst with SIMD stores on
+ * the architectures supporting them.
+ */
+
+#include <rte_compat.h>
+#include <rte_common.h>
+#include <rte_mbuf.h>
+#include <rte_vect.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change without prior notice.
+ *
+ * Template of the 16 bytes of a mbuf starting at rearm_data, that is
+ * data_off, refcnt, nb_segs, port and ol_flags, written at once on
+ * allocation by rte_pktmbuf_alloc_bulk_tmpl().
+ *
+ * @see rte_pktmbuf_rearm_tmpl_init()
+ */
+struct rte_mbuf_rearm_tmpl {
+	RTE_STD_C11
+	union {
+		uint64_t rearm_data; /**< Template of the rearm_data bytes. */
+		__extension__
+		struct {
+			uint16_t data_off; /**< Template of data_off. */
+			uint16_t refcnt;   /**< Template of refcnt. */
+			uint16_t nb_segs;  /**< Template of nb_segs. */
+			uint16_t port;     /**< Template of port. */
+		};
+	};
+	uint64_t ol_flags; /**< Template of ol_flags. */
+} __rte_aligned(16);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize a rearm template for the mbufs of a pool.
+ *
+ * The template gives the fields their values after rte_pktmbuf_reset(),
+ * except the port field which is set to the given port. The headroom is
+ * computed from the data room size of the pool.
+ *
+ * @param mp
+ *   The packet mbuf pool.
+ * @param port
+ *   The value of the port field, RTE_MBUF_PORT_INVALID for the value set
+ *   by rte_pktmbuf_reset().
+ * @param tmpl
+ *   The template to initialize.
+ */
+__rte_experimental
+static inline void
+rte_pktmbuf_rearm_tmpl_init(struct rte_mempool *mp, uint16_t port,
+			    struct rte_mbuf_rearm_tmpl *tmpl)
+{
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, ol_flags) !=
+			 offsetof(struct rte_mbuf, rearm_data) + 8);
+	RTE_BUILD_BUG_ON((offsetof(struct rte_mbuf, rearm_data) & 15) != 0);
+	RTE_BUILD_BUG_ON((offsetof(struct rte_mbuf,
+				   rx_descriptor_fields1) & 15) != 0);
+
+	tmpl->rearm_data = 0;
+	tmpl->data_off = RTE_MIN((uint16_t)RTE_PKTMBUF_HEADROOM,
+				 rte_pktmbuf_data_room_size(mp));
+	tmpl->refcnt = 1;
+	tmpl->nb_segs = 1;
+	tmpl->port = port;
+	tmpl->ol_flags = (rte_pktmbuf_priv_flags(mp) &
+			  RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF) ?
+			 RTE_MBUF_F_EXTERNAL : 0;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Allocate a bulk of mbufs and reset them from a rearm template.
+ *
+ * This is the equivalent of rte_pktmbuf_alloc_bulk() for a template
+ * initialized with rte_pktmbuf_rearm_tmpl_init() on the same pool. The
+ * rearm_data and ol_flags bytes are written from the template, and the
+ * packet type, lengths and VLAN TCI with a single 16-byte store each on
+ * architectures with SIMD support. This store also clears the low half
+ * of the RSS hash, which is not valid after a reset.
+ *
+ * @param pool
+ *   The mempool from which mbufs are allocated.
+ * @param mbufs
+ *   Array of pointers to mbufs
+ * @param count
+ *   Array size
+ * @param tmpl
+ *   The rearm template of the pool.
+ * @return
+ *   - 0: Success
+ *   - -ENOENT: Not enough entries in the mempool; no mbufs are retrieved.
+ */
+__rte_experimental
+static inline int
+rte_pktmbuf_alloc_bulk_tmpl(struct rte_mempool *pool,
+			    struct rte_mbuf **mbufs, unsigned int count,
+			    const struct rte_mbuf_rearm_tmpl *tmpl)
+{
+	unsigned int idx;
+	int rc;
+
+	rc = rte_mempool_get_bulk(pool, (void **)mbufs, count);
+	if (unlikely(rc))
+		return rc;
+
+#if defined(RTE_ARCH_X86)
+	const __m128i rearm = _mm_load_si128((const __m128i *)tmpl);
+	const __m128i zero = _mm_setzero_si128();
+#elif defined(RTE_ARCH_ARM64)
+	const uint64x2_t rearm = vld1q_u64((const uint64_t *)tmpl);
+	const uint64x2_t zero = vdupq_n_u64(0);
+#endif
+
+	for (idx = 0; idx != count; idx++) {
+		struct rte_mbuf *m = mbufs[idx];
+
+		__rte_mbuf_raw_sanity_check(m);
+#if defined(RTE_ARCH_X86)
+		_mm_store_si128((__m128i *)&m->rearm_data, rearm);
+		_mm_store_si128((__m128i *)&m->rx_descriptor_fields1, zero);
+#elif defined(RTE_ARCH_ARM64)
+		vst1q_u64((uint64_t *)&m->rearm_data, rearm);
+		vst1q_u64((uint64_t *)&m->rx_descriptor_fields1, zero);
+#else
+		*(uint64_t *)&m->rearm_data = tmpl->rearm_data;
+		m->ol_flags = tmpl->ol_flags;
+		m->packet_type = 0;
+		m->pkt_len = 0;
+		m->data_len = 0;
+		m->vlan_tci = 0;
+#endif
+		m->vlan_tci_outer = 0;
+		m->tx_offload = 0;
+		__rte_mbuf_sanity_check(m, 1);
+	}
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MBUF_TMPL_H_ */
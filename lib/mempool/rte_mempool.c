@@ -5,6 +5,7 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
@@ -13,6 +14,7 @@
 #include <sys/queue.h>
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_log.h>
 #include <rte_debug.h>
 #include <rte_memory.h>
@@ -44,10 +46,23 @@ static struct rte_tailq_elem callback_tailq = {
 EAL_REGISTER_TAILQ(callback_tailq)
 
 /* Invoke all registered mempool event callbacks. */
-static void
+static int
 mempool_event_callback_invoke(enum rte_mempool_event event,
 			      struct rte_mempool *mp);
 
+/* Internal state of an elastic mempool, see rte_mempool_populate_elastic(). */
+struct rte_mempool_elastic {
+	rte_spinlock_t lock;          /**< Serializes grows and shrinks. */
+	uint32_t chunk_objs;          /**< Objects added per chunk. */
+	uint32_t min_chunk_objs;      /**< Objects of the smallest chunk. */
+	uint32_t base_chunks;         /**< Chunks never released. */
+	uint32_t mz_id;               /**< Index of the next chunk memzone. */
+	rte_mempool_obj_cb_t *obj_init; /**< Called on each new object. */
+	void *obj_init_arg;           /**< Argument passed to obj_init. */
+	uint64_t grows;               /**< Chunks added on demand. */
+	uint64_t shrinks;             /**< Chunks released. */
+};
+
 #define CACHE_FLUSHTHRESH_MULTIPLIER 1.5
 #define CALC_CACHE_FLUSHTHRESH(c)	\
 	((typeof(c))((c) * CACHE_FLUSHTHRESH_MULTIPLIER))
@@ -158,9 +173,10 @@ get_min_page_size(int socket_id)
 
 
 static void
-mempool_add_elem(struct rte_mempool *mp, __rte_unused void *opaque,
+mempool_add_elem(struct rte_mempool *mp, void *opaque,
 		 void *obj, rte_iova_t iova)
 {
+	struct rte_mempool_elastic *elastic = opaque;
 	struct rte_mempool_objhdr *hdr;
 	struct rte_mempool_objtlr *tlr __rte_unused;
 
@@ -176,6 +192,11 @@ mempool_add_elem(struct rte_mempool *mp, __rte_unused void *opaque,
 	tlr = rte_mempool_get_trailer(obj);
 	tlr->cookie = RTE_MEMPOOL_TRAILER_COOKIE;
 #endif
+
+	/* objects of elastic mempools are initialized before being enqueued */
+	if (elastic != NULL && elastic->obj_init != NULL)
+		elastic->obj_init(mp, elastic->obj_init_arg, obj,
+				  mp->populated_size - 1);
 }
 
 /* call obj_cb() for each mempool element */
@@ -309,14 +330,14 @@ mempool_ops_alloc_once(struct rte_mempool *mp)
 	return 0;
 }
 
-/* Add objects in the pool, using a physically contiguous memory
- * zone. Return the number of objects added, or a negative value
+/* Add up to max_objs objects in the pool, using a physically contiguous
+ * memory zone. Return the number of objects added, or a negative value
  * on error.
  */
-int
-rte_mempool_populate_iova(struct rte_mempool *mp, char *vaddr,
-	rte_iova_t iova, size_t len, rte_mempool_memchunk_free_cb_t *free_cb,
-	void *opaque)
+static int
+mempool_populate_iova(struct rte_mempool *mp, unsigned int max_objs,
+	char *vaddr, rte_iova_t iova, size_t len,
+	rte_mempool_memchunk_free_cb_t *free_cb, void *opaque)
 {
 	unsigned i = 0;
 	size_t off;
@@ -352,10 +373,29 @@ rte_mempool_populate_iova(struct rte_mempool *mp, char *vaddr,
 		goto fail;
 	}
 
-	i = rte_mempool_ops_populate(mp, mp->size - mp->populated_size,
+	/*
+	 * Chunks added to a ready elastic mempool are reported before their
+	 * objects are made available, so that drivers can refuse them.
+	 */
+	if (mp->elastic != NULL && mp->nb_mem_chunks != 0) {
+		STAILQ_INSERT_TAIL(&mp->mem_list, memhdr, next);
+		mp->nb_mem_chunks++;
+		ret = mempool_event_callback_invoke(RTE_MEMPOOL_EVENT_CHUNK_ADD,
+						    mp);
+		if (ret < 0)
+			mempool_event_callback_invoke(
+				RTE_MEMPOOL_EVENT_CHUNK_DEL, mp);
+		STAILQ_REMOVE(&mp->mem_list, memhdr, rte_mempool_memhdr, next);
+		mp->nb_mem_chunks--;
+		if (ret < 0)
+			goto fail;
+	}
+
+	i = rte_mempool_ops_populate(mp,
+		RTE_MIN(max_objs, mp->size - mp->populated_size),
 		(char *)vaddr + off,
 		(iova == RTE_BAD_IOVA) ? RTE_BAD_IOVA : (iova + off),
-		len - off, mempool_add_elem, NULL);
+		len - off, mempool_add_elem, mp->elastic);
 
 	/* not enough room to store one object */
 	if (i == 0) {
@@ -370,8 +410,11 @@ rte_mempool_populate_iova(struct rte_mempool *mp, char *vaddr,
 	if (!(mp->flags & RTE_MEMPOOL_F_NO_IOVA_CONTIG) && iova != RTE_BAD_IOVA)
 		mp->flags &= ~RTE_MEMPOOL_F_NON_IO;
 
-	/* Report the mempool as ready only when fully populated. */
-	if (mp->populated_size >= mp->size)
+	/*
+	 * Report the mempool as ready only when fully populated.
+	 * Elastic mempools report their own events.
+	 */
+	if (mp->populated_size >= mp->size && mp->elastic == NULL)
 		mempool_event_callback_invoke(RTE_MEMPOOL_EVENT_READY, mp);
 
 	rte_mempool_trace_populate_iova(mp, vaddr, iova, len, free_cb, opaque);
@@ -382,6 +425,19 @@ rte_mempool_populate_iova(struct rte_mempool *mp, char *vaddr,
 	return ret;
 }
 
+/* Add objects in the pool, using a physically contiguous memory
+ * zone. Return the number of objects added, or a negative value
+ * on error.
+ */
+int
+rte_mempool_populate_iova(struct rte_mempool *mp, char *vaddr,
+	rte_iova_t iova, size_t len, rte_mempool_memchunk_free_cb_t *free_cb,
+	void *opaque)
+{
+	return mempool_populate_iova(mp, UINT_MAX, vaddr, iova, len,
+				     free_cb, opaque);
+}
+
 static rte_iova_t
 get_iova(void *addr)
 {
@@ -487,11 +543,12 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 	unsigned int mz_flags = RTE_MEMZONE_1GB|RTE_MEMZONE_SIZE_HINT_ONLY;
 	char mz_name[RTE_MEMZONE_NAMESIZE];
 	const struct rte_memzone *mz;
+	struct rte_mempool_info info;
 	ssize_t mem_size;
 	size_t align, pg_sz, pg_shift = 0;
 	rte_iova_t iova;
-	unsigned mz_id, n;
-	int ret;
+	unsigned mz_id, n, nb_sockets = 1;
+	int socket_id, ret;
 	bool need_iova_contig_obj;
 	size_t max_alloc_size = SIZE_MAX;
 
@@ -549,11 +606,33 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 	if (pg_sz != 0)
 		pg_shift = rte_bsf32(pg_sz);
 
+	/* the driver may ask for its objects to be spread over sockets */
+	memset(&info, 0, sizeof(info));
+	if (rte_mempool_ops_get_info(mp, &info) == 0 &&
+	    (info.flags & RTE_MEMPOOL_INFO_F_SOCKET_SPREAD))
+		nb_sockets = rte_socket_count();
+
 	for (mz_id = 0, n = mp->size; n > 0; mz_id++, n -= ret) {
 		size_t min_chunk_size;
+		unsigned int chunk_n = n;
+
+		socket_id = mp->socket_id;
+		if (nb_sockets > 1) {
+			unsigned int first = mp->size - n;
+			unsigned int idx = 0;
+
+			/* populate the remaining share of the socket */
+			while (idx + 1 < nb_sockets &&
+			       (uint64_t)(idx + 1) * mp->size / nb_sockets <=
+					first)
+				idx++;
+			chunk_n = (uint64_t)(idx + 1) * mp->size / nb_sockets -
+				first;
+			socket_id = rte_socket_id_by_idx(idx);
+		}
 
 		mem_size = rte_mempool_ops_calc_mem_size(
-			mp, n, pg_shift, &min_chunk_size, &align);
+			mp, chunk_n, pg_shift, &min_chunk_size, &align);
 
 		if (mem_size < 0) {
 			ret = mem_size;
@@ -577,11 +656,17 @@ rte_mempool_populate_default(struct rte_mempool *mp)
 		do {
 			mz = rte_memzone_reserve_aligned(mz_name,
 				RTE_MIN((size_t)mem_size, max_alloc_size),
-				mp->socket_id, mz_flags, align);
+				socket_id, mz_flags, align);
 
 			if (mz != NULL || rte_errno != ENOMEM)
 				break;
 
+			/* Use the mempool socket if this one has no memory */
+			if (socket_id != mp->socket_id) {
+				socket_id = mp->socket_id;
+				continue;
+			}
+
 			max_alloc_size = RTE_MIN(max_alloc_size,
 						(size_t)mem_size) / 2;
 		} while (mz == NULL && max_alloc_size >= min_chunk_size);
@@ -712,6 +797,287 @@ rte_mempool_populate_anon(struct rte_mempool *mp)
 	return 0;
 }
 
+/* Add a chunk of objects to an elastic mempool, with its lock held. */
+static int
+mempool_elastic_chunk_add(struct rte_mempool *mp)
+{
+	struct rte_mempool_elastic *elastic = mp->elastic;
+	unsigned int mz_flags = RTE_MEMZONE_1GB|RTE_MEMZONE_SIZE_HINT_ONLY;
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	size_t min_chunk_size, align;
+	rte_iova_t iova = RTE_BAD_IOVA;
+	ssize_t mem_size;
+	unsigned int n;
+	int ret;
+
+	n = RTE_MIN(elastic->chunk_objs, mp->size - mp->populated_size);
+	if (n == 0)
+		return -ENOSPC;
+
+	/*
+	 * Each chunk is a single IOVA-contiguous memzone, so that it is
+	 * described by one memory header and can be released alone.
+	 */
+	mem_size = rte_mempool_ops_calc_mem_size(mp, n, 0, &min_chunk_size,
+						 &align);
+	if (mem_size < 0)
+		return mem_size;
+
+	ret = snprintf(mz_name, sizeof(mz_name),
+		RTE_MEMPOOL_MZ_FORMAT "_%u", mp->name, elastic->mz_id);
+	if (ret < 0 || ret >= (int)sizeof(mz_name))
+		return -ENAMETOOLONG;
+
+	if ((mp->flags & RTE_MEMPOOL_F_NO_IOVA_CONTIG) == 0)
+		mz_flags |= RTE_MEMZONE_IOVA_CONTIG;
+
+	mz = rte_memzone_reserve_aligned(mz_name, mem_size, mp->socket_id,
+					 mz_flags, align);
+	if (mz == NULL)
+		return -rte_errno;
+	elastic->mz_id++;
+
+	if ((mp->flags & RTE_MEMPOOL_F_NO_IOVA_CONTIG) == 0)
+		iova = mz->iova;
+
+	ret = mempool_populate_iova(mp, n, mz->addr, iova, mz->len,
+		rte_mempool_memchunk_mz_free, (void *)(uintptr_t)mz);
+	if (ret == 0) /* should not happen */
+		ret = -ENOBUFS;
+	if (ret < 0) {
+		rte_memzone_free(mz);
+		return ret;
+	}
+
+	if (elastic->min_chunk_objs == 0 ||
+	    (unsigned int)ret < elastic->min_chunk_objs)
+		elastic->min_chunk_objs = ret;
+	return ret;
+}
+
+/* populate the mempool with a first chunk, and grow it on demand */
+int
+rte_mempool_populate_elastic(struct rte_mempool *mp, unsigned int chunk_objs,
+			     rte_mempool_obj_cb_t *obj_init,
+			     void *obj_init_arg)
+{
+	struct rte_mempool_elastic *elastic;
+	int ret;
+
+	if (chunk_objs == 0 || chunk_objs > mp->size)
+		return -EINVAL;
+
+	/* mempool must not be populated */
+	if (mp->nb_mem_chunks != 0)
+		return -EEXIST;
+
+	ret = mempool_ops_alloc_once(mp);
+	if (ret != 0)
+		return ret;
+
+	elastic = rte_zmalloc_socket("MEMPOOL_ELASTIC", sizeof(*elastic), 0,
+				     mp->socket_id);
+	if (elastic == NULL)
+		return -ENOMEM;
+
+	rte_spinlock_init(&elastic->lock);
+	elastic->chunk_objs = chunk_objs;
+	elastic->obj_init = obj_init;
+	elastic->obj_init_arg = obj_init_arg;
+	mp->elastic = elastic;
+
+	ret = mempool_elastic_chunk_add(mp);
+	if (ret < 0) {
+		mp->elastic = NULL;
+		rte_free(elastic);
+		return ret;
+	}
+	elastic->base_chunks = mp->nb_mem_chunks;
+
+	mempool_event_callback_invoke(RTE_MEMPOOL_EVENT_READY, mp);
+	return ret;
+}
+
+/* add chunks to an elastic mempool until enough objects are available */
+int
+rte_mempool_elastic_grow(struct rte_mempool *mp, unsigned int min_avail)
+{
+	struct rte_mempool_elastic *elastic;
+	int added = 0;
+	int ret = 0;
+
+	if (mp == NULL || mp->elastic == NULL)
+		return -EINVAL;
+	elastic = mp->elastic;
+
+	rte_spinlock_lock(&elastic->lock);
+	while (rte_mempool_ops_get_count(mp) < min_avail) {
+		ret = mempool_elastic_chunk_add(mp);
+		if (ret < 0)
+			break;
+		elastic->grows++;
+		added += ret;
+	}
+	rte_spinlock_unlock(&elastic->lock);
+
+	if (ret < 0 && added == 0)
+		return ret;
+	return added;
+}
+
+/* Count the objects of a chunk, in the pool or in the given table. */
+static unsigned int
+mempool_chunk_nb_objs(struct rte_mempool *mp,
+		      const struct rte_mempool_memhdr *memhdr,
+		      void * const *objs, unsigned int n)
+{
+	const char *start = memhdr->addr;
+	const char *end = start + memhdr->len;
+	struct rte_mempool_objhdr *hdr;
+	unsigned int i, count = 0;
+
+	if (objs != NULL) {
+		for (i = 0; i < n; i++)
+			if ((const char *)objs[i] >= start &&
+			    (const char *)objs[i] < end)
+				count++;
+		return count;
+	}
+
+	STAILQ_FOREACH(hdr, &mp->elt_list, next)
+		if ((const char *)hdr >= start && (const char *)hdr < end)
+			count++;
+	return count;
+}
+
+/* Free an idle chunk whose objects are out of the common pool. */
+static void
+mempool_elastic_chunk_free(struct rte_mempool *mp,
+			   struct rte_mempool_memhdr *memhdr)
+{
+	struct rte_mempool_objhdr_list elt_list =
+		STAILQ_HEAD_INITIALIZER(elt_list);
+	const char *start = memhdr->addr;
+	const char *end = start + memhdr->len;
+	struct rte_mempool_objhdr *hdr;
+
+	/* report the chunk as the last one of the list */
+	STAILQ_REMOVE(&mp->mem_list, memhdr, rte_mempool_memhdr, next);
+	STAILQ_INSERT_TAIL(&mp->mem_list, memhdr, next);
+	mempool_event_callback_invoke(RTE_MEMPOOL_EVENT_CHUNK_DEL, mp);
+	STAILQ_REMOVE(&mp->mem_list, memhdr, rte_mempool_memhdr, next);
+	mp->nb_mem_chunks--;
+
+	while ((hdr = STAILQ_FIRST(&mp->elt_list)) != NULL) {
+		STAILQ_REMOVE_HEAD(&mp->elt_list, next);
+		if ((const char *)hdr >= start && (const char *)hdr < end)
+			mp->populated_size--;
+		else
+			STAILQ_INSERT_TAIL(&elt_list, hdr, next);
+	}
+	STAILQ_CONCAT(&mp->elt_list, &elt_list);
+
+	if (memhdr->free_cb != NULL)
+		memhdr->free_cb(memhdr, memhdr->opaque);
+	rte_free(memhdr);
+}
+
+/* release the idle chunks of an elastic mempool */
+int
+rte_mempool_elastic_shrink(struct rte_mempool *mp, unsigned int max_chunks)
+{
+	struct rte_mempool_elastic *elastic;
+	struct rte_mempool_memhdr *memhdr, *next;
+	unsigned int i, j, n, avail, nb_objs, nb_free = 0;
+	unsigned int nb_chunks = 0;
+	void **objs;
+	int ret = 0;
+
+	if (mp == NULL || mp->elastic == NULL)
+		return -EINVAL;
+	elastic = mp->elastic;
+
+	rte_spinlock_lock(&elastic->lock);
+
+	/* no chunk can be idle unless the common pool can fill one */
+	avail = rte_mempool_ops_get_count(mp);
+	if (max_chunks == 0 || mp->nb_mem_chunks <= elastic->base_chunks ||
+	    avail < elastic->min_chunk_objs) {
+		rte_spinlock_unlock(&elastic->lock);
+		return 0;
+	}
+
+	objs = rte_malloc("MEMPOOL_SHRINK", sizeof(void *) * avail, 0);
+	if (objs == NULL) {
+		rte_spinlock_unlock(&elastic->lock);
+		return -ENOMEM;
+	}
+
+	/* take the objects out of the pool to find idle chunks */
+	while (nb_free < avail) {
+		n = RTE_MIN(rte_mempool_ops_get_count(mp), avail - nb_free);
+		if (n == 0 ||
+		    rte_mempool_ops_dequeue_bulk(mp, &objs[nb_free], n) < 0)
+			break;
+		nb_free += n;
+	}
+
+	/* the first chunks are kept, later ones are appended to the list */
+	memhdr = STAILQ_FIRST(&mp->mem_list);
+	for (i = 0; i < elastic->base_chunks && memhdr != NULL; i++)
+		memhdr = STAILQ_NEXT(memhdr, next);
+
+	for (; memhdr != NULL && nb_chunks < max_chunks; memhdr = next) {
+		const char *start = memhdr->addr;
+		const char *end = start + memhdr->len;
+
+		next = STAILQ_NEXT(memhdr, next);
+		nb_objs = mempool_chunk_nb_objs(mp, memhdr, NULL, 0);
+		if (mempool_chunk_nb_objs(mp, memhdr, objs, nb_free) !=
+				nb_objs)
+			continue;
+
+		/* drop the objects of the chunk from the table */
+		for (i = 0, j = 0; i < nb_free; i++)
+			if ((const char *)objs[i] < start ||
+			    (const char *)objs[i] >= end)
+				objs[j++] = objs[i];
+		nb_free = j;
+
+		mempool_elastic_chunk_free(mp, memhdr);
+		elastic->shrinks++;
+		nb_chunks++;
+		ret += nb_objs;
+	}
+
+	if (nb_free != 0)
+		rte_mempool_ops_enqueue_bulk(mp, objs, nb_free);
+	rte_spinlock_unlock(&elastic->lock);
+	rte_free(objs);
+
+	return ret;
+}
+
+/* free the handoff rings of the per-lcore caches */
+static void
+mempool_cache_handoff_free(struct rte_mempool *mp)
+{
+	unsigned int lcore_id;
+
+	if ((mp->flags & RTE_MEMPOOL_F_CACHE_HANDOFF) == 0)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		struct rte_mempool_cache *cache = &mp->local_cache[lcore_id];
+
+		if (cache->handoff_role == RTE_MEMPOOL_CACHE_HANDOFF_PUT)
+			rte_ring_free(cache->handoff);
+		cache->handoff = NULL;
+		cache->handoff_role = RTE_MEMPOOL_CACHE_HANDOFF_NONE;
+	}
+}
+
 /* free a mempool */
 void
 rte_mempool_free(struct rte_mempool *mp)
@@ -738,7 +1104,10 @@ rte_mempool_free(struct rte_mempool *mp)
 
 	mempool_event_callback_invoke(RTE_MEMPOOL_EVENT_DESTROY, mp);
 	rte_mempool_trace_free(mp);
+	mempool_cache_handoff_free(mp);
 	rte_mempool_free_memchunks(mp);
+	rte_free(mp->elastic);
+	rte_free(mp->track);
 	rte_mempool_ops_free(mp);
 	rte_memzone_free(mp->mz);
 }
@@ -792,6 +1161,247 @@ rte_mempool_cache_free(struct rte_mempool_cache *cache)
 	rte_free(cache);
 }
 
+/* Ratio between flushes and refills above which a cache is resized. */
+#define CACHE_ADAPT_RATIO 4
+
+/* Number of objects going through a cache between two resizes. */
+static inline uint32_t
+mempool_cache_adapt_window(const struct rte_mempool *mp)
+{
+	return RTE_MIN(mp->cache_size * 4, (uint32_t)UINT16_MAX);
+}
+
+/* Resize a per-lcore cache from its imbalance over the last window. */
+static void
+mempool_cache_adapt(struct rte_mempool *mp, struct rte_mempool_cache *cache,
+		    uint32_t flushed, uint32_t refilled)
+{
+	uint32_t base = mp->cache_size;
+	uint32_t size, flushthresh;
+
+	if ((mp->flags & RTE_MEMPOOL_F_CACHE_ADAPTIVE) == 0 ||
+	    cache < &mp->local_cache[0] ||
+	    cache >= &mp->local_cache[RTE_MAX_LCORE])
+		return;
+
+	/* counters cannot wrap, they are reset once above the window */
+	cache->win_flush += flushed;
+	cache->win_refill += refilled;
+	if ((uint32_t)cache->win_flush + cache->win_refill <
+			mempool_cache_adapt_window(mp))
+		return;
+
+	if (cache->win_flush >= CACHE_ADAPT_RATIO * cache->win_refill) {
+		/* Mostly frees: keep less objects, flush bigger bursts. */
+		size = RTE_MAX(base / 2, 1U);
+		flushthresh = RTE_MIN(base * 2,
+				      RTE_MEMPOOL_CACHE_MAX_SIZE * 2U);
+	} else if (cache->win_refill >= CACHE_ADAPT_RATIO * cache->win_flush) {
+		/* Mostly allocations: refill bigger bursts. */
+		size = RTE_MIN(base * 2, (uint32_t)RTE_MEMPOOL_CACHE_MAX_SIZE);
+		if (CALC_CACHE_FLUSHTHRESH(size) > mp->size)
+			size = base;
+		flushthresh = CALC_CACHE_FLUSHTHRESH(size);
+	} else {
+		size = base;
+		flushthresh = CALC_CACHE_FLUSHTHRESH(base);
+	}
+
+	if (cache->size != size || cache->flushthresh != flushthresh) {
+		cache->size = size;
+		cache->flushthresh = flushthresh;
+		cache->resizes++;
+	}
+	cache->win_flush = 0;
+	cache->win_refill = 0;
+}
+
+/* Flush a cache above its size, to the handoff ring first. */
+void
+__rte_mempool_cache_put_miss(struct rte_mempool *mp,
+			     struct rte_mempool_cache *cache)
+{
+	void **objs = &cache->objs[cache->size];
+	uint32_t n = cache->len - cache->size;
+	unsigned int handed = 0;
+
+	if (cache->handoff_role == RTE_MEMPOOL_CACHE_HANDOFF_PUT) {
+		handed = rte_ring_sp_enqueue_burst(cache->handoff, objs, n,
+						   NULL);
+		cache->handoff_objs += handed;
+	}
+	if (handed < n)
+		rte_mempool_ops_enqueue_bulk(mp, objs + handed, n - handed);
+
+	cache->len = cache->size;
+	cache->flush_objs += n;
+	mempool_cache_adapt(mp, cache, n, 0);
+}
+
+/* Refill a cache, from the handoff ring first. */
+int
+__rte_mempool_cache_get_miss(struct rte_mempool *mp,
+			     struct rte_mempool_cache *cache, unsigned int n)
+{
+	uint32_t req = n + (cache->size - cache->len);
+	uint32_t refilled;
+	unsigned int handed = 0;
+	int ret;
+
+	if (cache->handoff_role == RTE_MEMPOOL_CACHE_HANDOFF_GET) {
+		handed = rte_ring_sc_dequeue_burst(cache->handoff,
+				&cache->objs[cache->len], req, NULL);
+		cache->len += handed;
+		cache->handoff_objs += handed;
+		cache->refill_objs += handed;
+		req -= handed;
+	}
+	refilled = handed;
+
+	/* Do not go to the pool if the handoff ring gave enough. */
+	if (cache->len < n) {
+		ret = rte_mempool_ops_dequeue_bulk(mp,
+				&cache->objs[cache->len], req);
+		if (unlikely(ret < 0)) {
+			mempool_cache_adapt(mp, cache, 0, refilled);
+			return ret;
+		}
+		cache->len += req;
+		cache->refill_objs += req;
+		refilled += req;
+	}
+
+	mempool_cache_adapt(mp, cache, 0, refilled);
+	return 0;
+}
+
+int
+rte_mempool_cache_adaptive_set(struct rte_mempool *mp, int enable)
+{
+	unsigned int lcore_id;
+
+	if (mp == NULL || mp->cache_size == 0)
+		return -EINVAL;
+
+	if (enable)
+		__atomic_fetch_or(&mp->flags, RTE_MEMPOOL_F_CACHE_ADAPTIVE,
+				  __ATOMIC_RELEASE);
+	else
+		__atomic_fetch_and(&mp->flags, ~RTE_MEMPOOL_F_CACHE_ADAPTIVE,
+				   __ATOMIC_RELAXED);
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		struct rte_mempool_cache *cache = &mp->local_cache[lcore_id];
+
+		/* objects above the threshold are flushed on next put */
+		if (!enable) {
+			cache->size = mp->cache_size;
+			cache->flushthresh =
+				CALC_CACHE_FLUSHTHRESH(mp->cache_size);
+		}
+		cache->win_flush = 0;
+		cache->win_refill = 0;
+	}
+	return 0;
+}
+
+int
+rte_mempool_cache_handoff_add(struct rte_mempool *mp, unsigned int put_lcore,
+			      unsigned int get_lcore)
+{
+	static uint32_t handoff_id;
+	struct rte_mempool_cache *put_cache, *get_cache;
+	char name[RTE_RING_NAMESIZE];
+	struct rte_ring *r;
+
+	if (mp == NULL || mp->cache_size == 0 ||
+	    put_lcore >= RTE_MAX_LCORE || get_lcore >= RTE_MAX_LCORE ||
+	    put_lcore == get_lcore)
+		return -EINVAL;
+
+	put_cache = &mp->local_cache[put_lcore];
+	get_cache = &mp->local_cache[get_lcore];
+	if (put_cache->handoff_role != RTE_MEMPOOL_CACHE_HANDOFF_NONE ||
+	    get_cache->handoff_role != RTE_MEMPOOL_CACHE_HANDOFF_NONE)
+		return -EBUSY;
+
+	snprintf(name, sizeof(name), "MP_HANDOFF_%u",
+		 __atomic_fetch_add(&handoff_id, 1, __ATOMIC_RELAXED));
+	r = rte_ring_create(name, mp->cache_size * 4, mp->socket_id,
+			    RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (r == NULL) {
+		RTE_LOG(ERR, MEMPOOL, "Cannot allocate handoff ring for %s\n",
+			mp->name);
+		return -ENOMEM;
+	}
+
+	put_cache->handoff = r;
+	put_cache->handoff_role = RTE_MEMPOOL_CACHE_HANDOFF_PUT;
+	get_cache->handoff = r;
+	get_cache->handoff_role = RTE_MEMPOOL_CACHE_HANDOFF_GET;
+	__atomic_fetch_or(&mp->flags, RTE_MEMPOOL_F_CACHE_HANDOFF,
+			  __ATOMIC_RELEASE);
+	return 0;
+}
+
+int
+rte_mempool_cache_handoff_del(struct rte_mempool *mp, unsigned int put_lcore)
+{
+	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE];
+	bool handoff_left = false;
+	unsigned int lcore_id, n;
+	struct rte_ring *r;
+
+	if (mp == NULL || mp->cache_size == 0 || put_lcore >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	if (mp->local_cache[put_lcore].handoff_role !=
+			RTE_MEMPOOL_CACHE_HANDOFF_PUT)
+		return -ENOENT;
+
+	r = mp->local_cache[put_lcore].handoff;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		struct rte_mempool_cache *cache = &mp->local_cache[lcore_id];
+
+		if (cache->handoff == r) {
+			cache->handoff = NULL;
+			cache->handoff_role = RTE_MEMPOOL_CACHE_HANDOFF_NONE;
+		} else if (cache->handoff != NULL) {
+			handoff_left = true;
+		}
+	}
+	if (!handoff_left)
+		__atomic_fetch_and(&mp->flags, ~RTE_MEMPOOL_F_CACHE_HANDOFF,
+				   __ATOMIC_RELAXED);
+
+	while ((n = rte_ring_sc_dequeue_burst(r, objs, RTE_DIM(objs),
+					      NULL)) != 0)
+		rte_mempool_ops_enqueue_bulk(mp, objs, n);
+	rte_ring_free(r);
+	return 0;
+}
+
+int
+rte_mempool_cache_stats_get(struct rte_mempool *mp, unsigned int lcore_id,
+			    struct rte_mempool_cache_stats *stats)
+{
+	const struct rte_mempool_cache *cache;
+
+	if (mp == NULL || stats == NULL || mp->cache_size == 0 ||
+	    lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	cache = &mp->local_cache[lcore_id];
+	stats->size = cache->size;
+	stats->flushthresh = cache->flushthresh;
+	stats->len = cache->len;
+	stats->resizes = cache->resizes;
+	stats->flush_objs = cache->flush_objs;
+	stats->refill_objs = cache->refill_objs;
+	stats->handoff_objs = cache->handoff_objs;
+	return 0;
+}
+
 /* create an empty mempool */
 struct rte_mempool *
 rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
@@ -814,6 +1424,11 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 			  RTE_CACHE_LINE_MASK) != 0);
 	RTE_BUILD_BUG_ON((sizeof(struct rte_mempool_cache) &
 			  RTE_CACHE_LINE_MASK) != 0);
+	/* cache statistics must fit in the padding of the cache objects */
+	RTE_BUILD_BUG_ON(sizeof(struct rte_mempool_cache) !=
+			 RTE_ALIGN_CEIL(offsetof(struct rte_mempool_cache, objs) +
+					sizeof(((struct rte_mempool_cache *)0)->objs),
+					RTE_CACHE_LINE_SIZE));
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
 	RTE_BUILD_BUG_ON((sizeof(struct rte_mempool_debug_stats) &
 			  RTE_CACHE_LINE_MASK) != 0);
@@ -1007,8 +1622,14 @@ rte_mempool_avail_count(const struct rte_mempool *mp)
 	if (mp->cache_size == 0)
 		return count;
 
-	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
-		count += mp->local_cache[lcore_id].len;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		const struct rte_mempool_cache *cache =
+			&mp->local_cache[lcore_id];
+
+		count += cache->len;
+		if (cache->handoff_role == RTE_MEMPOOL_CACHE_HANDOFF_PUT)
+			count += rte_ring_count(cache->handoff);
+	}
 
 	/*
 	 * due to race condition (access to len is not locked), the
@@ -1041,10 +1662,27 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 		return count;
 
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
-		cache_count = mp->local_cache[lcore_id].len;
+		const struct rte_mempool_cache *cache =
+			&mp->local_cache[lcore_id];
+
+		cache_count = cache->len;
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
 		count += cache_count;
+		if (cache->flush_objs == 0 && cache->refill_objs == 0)
+			continue;
+		fprintf(f, "      size=%"PRIu32" flushthresh=%"PRIu32
+			" resizes=%"PRIu32"\n",
+			cache->size, cache->flushthresh, cache->resizes);
+		fprintf(f, "      flush_objs=%"PRIu64" refill_objs=%"PRIu64
+			" handoff_objs=%"PRIu64"\n",
+			cache->flush_objs, cache->refill_objs,
+			cache->handoff_objs);
+		if (cache->handoff_role == RTE_MEMPOOL_CACHE_HANDOFF_PUT) {
+			cache_count = rte_ring_count(cache->handoff);
+			fprintf(f, "      handoff_count=%u\n", cache_count);
+			count += cache_count;
+		}
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
 	return count;
@@ -1213,6 +1851,286 @@ rte_mempool_audit(struct rte_mempool *mp)
 	RTE_SET_USED(mp);
 }
 
+/* Maximum number of events recorded per lcore by the ownership tracking. */
+#define MEMPOOL_TRACK_MAX_EVENTS (1U << 20)
+
+/* Ring buffer of the events recorded by an lcore. */
+struct mempool_track_lcore {
+	uint64_t head; /**< Number of events recorded since enabled. */
+	/** size events, NULL if the lcore uses the shared ring buffer. */
+	struct rte_mempool_track_event *events;
+} __rte_cache_aligned;
+
+/* Internal state of the ownership tracking, see rte_mempool_track_enable(). */
+struct rte_mempool_track {
+	uint32_t size;    /**< Events per lcore, power of 2. */
+	uint32_t nb_bufs; /**< Number of ring buffers. */
+	/** Ring buffers, the last one shared by the other threads. */
+	struct mempool_track_lcore lcore[RTE_MAX_LCORE + 1];
+	/** Events of the ring buffers. */
+	struct rte_mempool_track_event events[];
+};
+
+/* Objects held by the application, taken by the same caller and owner. */
+struct mempool_track_site {
+	const void *caller;
+	uint32_t owner;
+	uint64_t objs;
+	uint64_t oldest_tsc;
+};
+
+static RTE_DEFINE_PER_LCORE(uint32_t, mempool_track_owner);
+
+__rte_noinline void
+__rte_mempool_track(struct rte_mempool *mp, void * const *obj_table,
+		    unsigned int n, unsigned int op)
+{
+	const void *caller = __builtin_return_address(0);
+	struct rte_mempool_track *track = mp->track;
+	struct rte_mempool_track_event *ev, *events;
+	unsigned int lcore_id = rte_lcore_id();
+	uint32_t owner = RTE_PER_LCORE(mempool_track_owner);
+	uint64_t tsc = rte_rdtsc();
+	uint64_t head;
+	unsigned int i;
+
+	if (lcore_id >= RTE_MAX_LCORE || track->lcore[lcore_id].events == NULL)
+		lcore_id = RTE_MAX_LCORE;
+	events = track->lcore[lcore_id].events;
+
+	/* Only the shared ring buffer has several writers. */
+	if (lcore_id == RTE_MAX_LCORE)
+		head = __atomic_fetch_add(&track->lcore[lcore_id].head, n,
+					  __ATOMIC_RELAXED);
+	else {
+		head = track->lcore[lcore_id].head;
+		__atomic_store_n(&track->lcore[lcore_id].head, head + n,
+				 __ATOMIC_RELAXED);
+	}
+
+	for (i = 0; i < n; i++) {
+		ev = &events[(head + i) & (track->size - 1)];
+		ev->obj = obj_table[i];
+		ev->caller = caller;
+		ev->tsc = tsc;
+		ev->owner = owner;
+		ev->lcore_id = lcore_id;
+		ev->op = op;
+	}
+}
+
+int
+rte_mempool_track_enable(struct rte_mempool *mp, unsigned int nb_events)
+{
+	struct rte_mempool_track *track;
+	enum rte_lcore_role_t role;
+	unsigned int lcore_id;
+	uint32_t size, nb_bufs = 1;
+
+	if (mp->track == NULL) {
+		if (nb_events == 0 || nb_events > MEMPOOL_TRACK_MAX_EVENTS)
+			return -EINVAL;
+		size = rte_align32pow2(nb_events);
+
+		/* A ring buffer per datapath lcore, and a shared one. */
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+			role = rte_eal_lcore_role(lcore_id);
+			if (role == ROLE_RTE || role == ROLE_SERVICE)
+				nb_bufs++;
+		}
+
+		track = rte_zmalloc_socket("MEMPOOL_TRACK", sizeof(*track) +
+				sizeof(track->events[0]) * size * nb_bufs,
+				RTE_CACHE_LINE_SIZE, mp->socket_id);
+		if (track == NULL)
+			return -ENOMEM;
+		track->size = size;
+		track->nb_bufs = 0;
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+			role = rte_eal_lcore_role(lcore_id);
+			if (role == ROLE_RTE || role == ROLE_SERVICE)
+				track->lcore[lcore_id].events = &track->events[
+					(size_t)track->nb_bufs++ * size];
+		}
+		track->lcore[RTE_MAX_LCORE].events =
+			&track->events[(size_t)track->nb_bufs++ * size];
+		mp->track = track;
+	}
+
+	/* The flags are also changed at runtime by other control paths. */
+	__atomic_fetch_or(&mp->flags, RTE_MEMPOOL_F_TRACK, __ATOMIC_RELEASE);
+	return 0;
+}
+
+void
+rte_mempool_track_disable(struct rte_mempool *mp)
+{
+	__atomic_fetch_and(&mp->flags, ~RTE_MEMPOOL_F_TRACK, __ATOMIC_RELAXED);
+}
+
+void
+rte_mempool_track_owner_set(uint32_t owner)
+{
+	RTE_PER_LCORE(mempool_track_owner) = owner;
+}
+
+/* Number of valid events in the ring buffer of an lcore. */
+static uint32_t
+mempool_track_count(const struct rte_mempool_track *track,
+		    unsigned int lcore_id)
+{
+	uint64_t head = __atomic_load_n(&track->lcore[lcore_id].head,
+					__ATOMIC_RELAXED);
+
+	return RTE_MIN(head, (uint64_t)track->size);
+}
+
+int
+rte_mempool_track_obj_last(const struct rte_mempool *mp, const void *obj,
+			   struct rte_mempool_track_event *event)
+{
+	const struct rte_mempool_track *track = mp->track;
+	const struct rte_mempool_track_event *ev, *last = NULL;
+	unsigned int lcore_id;
+	uint32_t i, count;
+
+	if (track == NULL)
+		return -EINVAL;
+
+	for (lcore_id = 0; lcore_id <= RTE_MAX_LCORE; lcore_id++) {
+		ev = track->lcore[lcore_id].events;
+		if (ev == NULL)
+			continue;
+		count = mempool_track_count(track, lcore_id);
+		for (i = 0; i < count; i++, ev++)
+			if (ev->obj == obj && (last == NULL ||
+					       ev->tsc >= last->tsc))
+				last = ev;
+	}
+
+	if (last == NULL)
+		return -ENOENT;
+
+	*event = *last;
+	return 0;
+}
+
+static int
+mempool_track_event_cmp(const void *a, const void *b)
+{
+	const struct rte_mempool_track_event *ea = a, *eb = b;
+
+	if (ea->obj != eb->obj)
+		return (uintptr_t)ea->obj < (uintptr_t)eb->obj ? -1 : 1;
+	if (ea->tsc != eb->tsc)
+		return ea->tsc < eb->tsc ? -1 : 1;
+	return 0;
+}
+
+static int
+mempool_track_site_cmp(const void *a, const void *b)
+{
+	const struct rte_mempool_track_event *ea = a, *eb = b;
+
+	if (ea->caller != eb->caller)
+		return (uintptr_t)ea->caller < (uintptr_t)eb->caller ? -1 : 1;
+	if (ea->owner != eb->owner)
+		return ea->owner < eb->owner ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Group the objects held by the application by caller and owner, from a
+ * snapshot of the ring buffers. Return the number of sites, stored in an
+ * array to free by the caller, or a negative errno.
+ */
+static int
+mempool_track_sites(const struct rte_mempool *mp,
+		    struct mempool_track_site **sites_p)
+{
+	const struct rte_mempool_track *track = mp->track;
+	struct rte_mempool_track_event *events;
+	struct mempool_track_site *sites, *site = NULL;
+	unsigned int lcore_id;
+	uint32_t count, i, nb_events = 0, nb_held = 0;
+	int nb_sites = 0;
+
+	if (track == NULL)
+		return -EINVAL;
+
+	events = malloc(sizeof(*events) * track->size * track->nb_bufs);
+	if (events == NULL)
+		return -ENOMEM;
+
+	/* Events might be overwritten while copied, the snapshot is only
+	 * a hint of the objects held on a live system.
+	 */
+	for (lcore_id = 0; lcore_id <= RTE_MAX_LCORE; lcore_id++) {
+		if (track->lcore[lcore_id].events == NULL)
+			continue;
+		count = mempool_track_count(track, lcore_id);
+		memcpy(&events[nb_events], track->lcore[lcore_id].events,
+		       sizeof(*events) * count);
+		nb_events += count;
+	}
+
+	/* Keep the last event of each object, if it is a get. */
+	qsort(events, nb_events, sizeof(*events), mempool_track_event_cmp);
+	for (i = 0; i < nb_events; i++) {
+		if (i + 1 < nb_events && events[i + 1].obj == events[i].obj)
+			continue;
+		if (events[i].op == RTE_MEMPOOL_TRACK_GET)
+			events[nb_held++] = events[i];
+	}
+
+	sites = malloc(sizeof(*sites) * RTE_MAX(nb_held, 1U));
+	if (sites == NULL) {
+		free(events);
+		return -ENOMEM;
+	}
+
+	qsort(events, nb_held, sizeof(*events), mempool_track_site_cmp);
+	for (i = 0; i < nb_held; i++) {
+		if (site == NULL || site->caller != events[i].caller ||
+		    site->owner != events[i].owner) {
+			site = &sites[nb_sites++];
+			site->caller = events[i].caller;
+			site->owner = events[i].owner;
+			site->objs = 0;
+			site->oldest_tsc = events[i].tsc;
+		}
+		site->objs++;
+		if (site->oldest_tsc > events[i].tsc)
+			site->oldest_tsc = events[i].tsc;
+	}
+
+	free(events);
+	*sites_p = sites;
+	return nb_sites;
+}
+
+int
+rte_mempool_track_dump(FILE *f, const struct rte_mempool *mp)
+{
+	struct mempool_track_site *sites;
+	uint64_t now = rte_rdtsc();
+	int i, nb_sites;
+
+	nb_sites = mempool_track_sites(mp, &sites);
+	if (nb_sites < 0)
+		return nb_sites;
+
+	fprintf(f, "mempool <%s>@%p held objects\n", mp->name, mp);
+	for (i = 0; i < nb_sites; i++)
+		fprintf(f, "  caller=%p owner=%"PRIu32" objs=%"PRIu64
+			" oldest=%"PRIu64" cycles ago\n", sites[i].caller,
+			sites[i].owner, sites[i].objs,
+			now - sites[i].oldest_tsc);
+
+	free(sites);
+	return 0;
+}
+
 /* dump the status of the mempool on the console */
 void
 rte_mempool_dump(FILE *f, struct rte_mempool *mp)
@@ -1239,6 +2157,14 @@ rte_mempool_dump(FILE *f, struct rte_mempool *mp)
 	fprintf(f, "  nb_mem_chunks=%u\n", mp->nb_mem_chunks);
 	fprintf(f, "  size=%"PRIu32"\n", mp->size);
 	fprintf(f, "  populated_size=%"PRIu32"\n", mp->populated_size);
+	if (mp->elastic != NULL)
+		fprintf(f, "  elastic: chunk_objs=%"PRIu32" grows=%"PRIu64
+			" shrinks=%"PRIu64"\n", mp->elastic->chunk_objs,
+			mp->elastic->grows, mp->elastic->shrinks);
+	if (mp->track != NULL)
+		fprintf(f, "  track: %s events_per_lcore=%"PRIu32"\n",
+			(mp->flags & RTE_MEMPOOL_F_TRACK) ? "on" : "off",
+			mp->track->size);
 	fprintf(f, "  header_size=%"PRIu32"\n", mp->header_size);
 	fprintf(f, "  elt_size=%"PRIu32"\n", mp->elt_size);
 	fprintf(f, "  trailer_size=%"PRIu32"\n", mp->trailer_size);
@@ -1376,23 +2302,33 @@ struct mempool_callback_data {
 	void *user_data;
 };
 
-static void
+/*
+ * Return the error of the first callback refusing a chunk on
+ * RTE_MEMPOOL_EVENT_CHUNK_ADD, the callbacks after it are not invoked.
+ */
+static int
 mempool_event_callback_invoke(enum rte_mempool_event event,
 			      struct rte_mempool *mp)
 {
 	struct mempool_callback_list *list;
 	struct rte_tailq_entry *te;
 	void *tmp_te;
+	int ret = 0;
 
 	rte_mcfg_tailq_read_lock();
 	list = RTE_TAILQ_CAST(callback_tailq.head, mempool_callback_list);
 	RTE_TAILQ_FOREACH_SAFE(te, list, next, tmp_te) {
 		struct mempool_callback_data *cb = te->data;
 		rte_mcfg_tailq_read_unlock();
-		cb->func(event, mp, cb->user_data);
+		ret = cb->func(event, mp, cb->user_data);
 		rte_mcfg_tailq_read_lock();
+		if (ret < 0 && event == RTE_MEMPOOL_EVENT_CHUNK_ADD)
+			break;
+		ret = 0;
 	}
 	rte_mcfg_tailq_read_unlock();
+
+	return ret;
 }
 
 int
@@ -1553,10 +2489,80 @@ mempool_handle_info(const char *cmd __rte_unused, const char *params,
 	return 0;
 }
 
+static void
+mempool_track_cb(struct rte_mempool *mp, void *arg)
+{
+	struct mempool_info_cb_arg *info = (struct mempool_info_cb_arg *)arg;
+	struct mempool_track_site *sites;
+	char key[RTE_TEL_MAX_STRING_LEN];
+	struct rte_tel_data *held;
+	uint64_t nb_held = 0;
+	int i, nb_sites;
+
+	if (strncmp(mp->name, info->pool_name, RTE_MEMZONE_NAMESIZE))
+		return;
+
+	rte_tel_data_add_dict_string(info->d, "name", mp->name);
+	rte_tel_data_add_dict_int(info->d, "enabled",
+				  !!(mp->flags & RTE_MEMPOOL_F_TRACK));
+
+	nb_sites = mempool_track_sites(mp, &sites);
+	if (nb_sites < 0)
+		return;
+
+	held = rte_tel_data_alloc();
+	if (held == NULL) {
+		free(sites);
+		return;
+	}
+
+	/* Objects held by the application, per caller address and owner.
+	 * The sites beyond the dictionary size are only accounted in total.
+	 */
+	rte_tel_data_start_dict(held);
+	for (i = 0; i < nb_sites; i++) {
+		nb_held += sites[i].objs;
+		if (i >= RTE_TEL_MAX_DICT_ENTRIES)
+			continue;
+		snprintf(key, sizeof(key), "%p/%"PRIu32, sites[i].caller,
+			 sites[i].owner);
+		rte_tel_data_add_dict_u64(held, key, sites[i].objs);
+	}
+	free(sites);
+
+	rte_tel_data_add_dict_int(info->d, "events_per_lcore",
+				  mp->track->size);
+	rte_tel_data_add_dict_u64(info->d, "held_objs", nb_held);
+	rte_tel_data_add_dict_int(info->d, "held_sites", nb_sites);
+	rte_tel_data_add_dict_container(info->d, "held", held, 0);
+}
+
+static int
+mempool_handle_track(const char *cmd __rte_unused, const char *params,
+		     struct rte_tel_data *d)
+{
+	struct mempool_info_cb_arg mp_arg;
+	char name[RTE_MEMZONE_NAMESIZE];
+
+	if (!params || strlen(params) == 0)
+		return -EINVAL;
+
+	rte_strlcpy(name, params, RTE_MEMZONE_NAMESIZE);
+
+	rte_tel_data_start_dict(d);
+	mp_arg.pool_name = name;
+	mp_arg.d = d;
+	rte_mempool_walk(mempool_track_cb, &mp_arg);
+
+	return 0;
+}
+
 RTE_INIT(mempool_init_telemetry)
 {
 	rte_telemetry_register_cmd("/mempool/list", mempool_handle_list,
 		"Returns list of available mempool. Takes no parameters");
 	rte_telemetry_register_cmd("/mempool/info", mempool_handle_info,
 		"Returns mempool info. Parameters: pool_name");
+	rte_telemetry_register_cmd("/mempool/track", mempool_handle_track,
+		"Returns objects held per caller/owner of a tracked mempool. Parameters: pool_name");
 }
@@ -91,8 +91,45 @@ struct rte_mempool_cache {
 	 * cases to avoid needless emptying of cache.
 	 */
 	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3]; /**< Cache objects */
+	/*
+	 * Fields below live in the tail padding of the structure, they are
+	 * only accessed when the cache goes to the backing pool.
+	 */
+	uint64_t flush_objs;   /**< Objects flushed out of the cache */
+	uint64_t refill_objs;  /**< Objects refilled into the cache */
+	uint64_t handoff_objs; /**< Objects passed through the handoff ring */
+	struct rte_ring *handoff; /**< Handoff ring, see handoff_role */
+	uint32_t resizes;      /**< Number of adaptive resizes */
+	uint16_t win_flush;    /**< Objects flushed in the adaptive window */
+	uint16_t win_refill;   /**< Objects refilled in the adaptive window */
+	uint8_t handoff_role;  /**< RTE_MEMPOOL_CACHE_HANDOFF_* role */
 } __rte_cache_aligned;
 
+/** The cache does not take part in a handoff. */
+#define RTE_MEMPOOL_CACHE_HANDOFF_NONE 0
+/** The cache flushes to the handoff ring first. */
+#define RTE_MEMPOOL_CACHE_HANDOFF_PUT  1
+/** The cache refills from the handoff ring first. */
+#define RTE_MEMPOOL_CACHE_HANDOFF_GET  2
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change without prior notice.
+ *
+ * Statistics of a per-lcore mempool cache.
+ *
+ * @see rte_mempool_cache_stats_get()
+ */
+struct rte_mempool_cache_stats {
+	uint32_t size;         /**< Current cache size. */
+	uint32_t flushthresh;  /**< Current flush threshold. */
+	uint32_t len;          /**< Current cache count. */
+	uint32_t resizes;      /**< Number of adaptive resizes. */
+	uint64_t flush_objs;   /**< Objects flushed to the pool or handoff. */
+	uint64_t refill_objs;  /**< Objects refilled from the pool or handoff. */
+	uint64_t handoff_objs; /**< Objects passed through the handoff ring. */
+};
+
 /**
  * A structure that stores the size of mempool elements.
  */
@@ -200,8 +237,19 @@ struct rte_mempool_memhdr {
 struct rte_mempool_info {
 	/** Number of objects in the contiguous block */
 	unsigned int contig_block_size;
+	/** Flags of the mempool driver, RTE_MEMPOOL_INFO_F_* */
+	unsigned int flags;
 } __rte_cache_aligned;
 
+/**
+ * rte_mempool_populate_default() spreads the objects over all NUMA sockets,
+ * allocating the memory of each share on its socket.
+ */
+#define RTE_MEMPOOL_INFO_F_SOCKET_SPREAD 0x0001
+
+struct rte_mempool_elastic;
+struct rte_mempool_track;
+
 /**
  * The RTE mempool structure.
  */
@@ -240,6 +288,15 @@ struct rte_mempool {
 	struct rte_mempool_objhdr_list elt_list; /**< List of objects in pool */
 	uint32_t nb_mem_chunks;          /**< Number of memory chunks */
 	struct rte_mempool_memhdr_list mem_list; /**< List of memory chunks */
+	/*
+	 * On 64-bit architectures, the two pointers below fit in the former
+	 * tail padding of the structure: its size and the offsets of the
+	 * fields above are unchanged, only the debug statistics are moved.
+	 */
+	/** Internal state of elastic mempools, NULL otherwise. */
+	struct rte_mempool_elastic *elastic;
+	/** Internal state of the ownership tracking, NULL if never enabled. */
+	struct rte_mempool_track *track;
 
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
 	/** Per-lcore statistics. */
@@ -286,6 +343,12 @@ struct rte_mempool {
 #define MEMPOOL_F_NO_IOVA_CONTIG	RTE_MEMPOOL_F_NO_IOVA_CONTIG
 /** Internal: no object from the pool can be used for device IO (DMA). */
 #define RTE_MEMPOOL_F_NON_IO		0x0040
+/** Internal: per-lcore caches are resized from their get/put imbalance. */
+#define RTE_MEMPOOL_F_CACHE_ADAPTIVE	0x0080
+/** Internal: some per-lcore caches hand objects off to another lcore. */
+#define RTE_MEMPOOL_F_CACHE_HANDOFF	0x0100
+/** Internal: the gets and puts of objects are recorded. */
+#define RTE_MEMPOOL_F_TRACK		0x0200
 
 /**
  * This macro lists all the mempool flags an application may request.
@@ -1197,6 +1260,110 @@ int rte_mempool_populate_default(struct rte_mempool *mp);
  */
 int rte_mempool_populate_anon(struct rte_mempool *mp);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Populate an elastic mempool
+ *
+ * Instead of committing the memory for all the objects at init, add one
+ * memory chunk of chunk_objs objects, allocated with rte_memzone_reserve(),
+ * and mark the mempool as elastic. More chunks are added with
+ * rte_mempool_elastic_grow(), until the pool holds the number of objects
+ * given at creation, and chunks left idle are released with
+ * rte_mempool_elastic_shrink(). Gets and puts never allocate nor free
+ * memory: both functions are meant to be called from a control thread,
+ * for instance when rte_mempool_avail_count() crosses a threshold.
+ *
+ * The mempool is reported ready (RTE_MEMPOOL_EVENT_READY) once the first
+ * chunk is added. Each chunk added or released afterwards is reported with
+ * RTE_MEMPOOL_EVENT_CHUNK_ADD or RTE_MEMPOOL_EVENT_CHUNK_DEL.
+ *
+ * @param mp
+ *   A pointer to the mempool structure, created with
+ *   rte_mempool_create_empty().
+ * @param chunk_objs
+ *   The number of objects in each memory chunk.
+ * @param obj_init
+ *   A function called for each object added to the pool, before it is
+ *   made available. Can be NULL.
+ * @param obj_init_arg
+ *   An opaque pointer passed to obj_init.
+ * @return
+ *   The number of objects added on success.
+ *   On error, a negative errno is returned:
+ *     (-EINVAL): chunk_objs is zero or larger than the mempool size.
+ *     (-EEXIST): mempool is already populated.
+ *     (-ENOMEM): allocation failure.
+ */
+__rte_experimental
+int
+rte_mempool_populate_elastic(struct rte_mempool *mp, unsigned int chunk_objs,
+			     rte_mempool_obj_cb_t *obj_init,
+			     void *obj_init_arg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add memory chunks to an elastic mempool
+ *
+ * Chunks are added until the common pool holds at least min_avail
+ * objects, or the mempool holds the number of objects given at creation.
+ * Objects held by per-lcore caches are not counted. The memory of each
+ * chunk is reserved and its objects are initialized by the calling
+ * thread, before they are made available to gets.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param min_avail
+ *   The number of objects the common pool must hold.
+ * @return
+ *   The number of objects added on success, zero if the common pool
+ *   already holds min_avail objects. It can be less than needed when
+ *   the mempool reaches its size or an allocation fails after some
+ *   chunks are added.
+ *   On error, when no chunk is added, a negative errno is returned:
+ *     (-EINVAL): the mempool is not elastic.
+ *     (-ENOSPC): the mempool already holds the objects given at creation.
+ *     (-ENOMEM): allocation failure.
+ *     Other negative values: the chunk was refused by a mempool event
+ *     callback, e.g. a driver which cannot map its memory.
+ */
+__rte_experimental
+int
+rte_mempool_elastic_grow(struct rte_mempool *mp, unsigned int min_avail);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Release the idle memory chunks of an elastic mempool
+ *
+ * A chunk is idle when all its objects are in the common pool; objects
+ * held by per-lcore caches keep their chunk in use. The chunk added by
+ * rte_mempool_populate_elastic() is never released.
+ *
+ * Nothing is done unless the common pool holds enough objects to fill a
+ * chunk. Otherwise, the objects of the common pool are taken out while
+ * chunks are checked, and gets done meanwhile may fail: the work is
+ * bounded by the number of objects in the common pool and the time by
+ * max_chunks.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param max_chunks
+ *   The maximum number of chunks to release.
+ * @return
+ *   The number of objects released on success.
+ *   On error, a negative errno is returned:
+ *     (-EINVAL): the mempool is not elastic.
+ *     (-ENOMEM): allocation failure.
+ */
+__rte_experimental
+int
+rte_mempool_elastic_shrink(struct rte_mempool *mp, unsigned int max_chunks);
+
 /**
  * Call a function for each mempool element
  *
@@ -1269,6 +1436,121 @@ rte_mempool_cache_create(uint32_t size, int socket_id);
 void
 rte_mempool_cache_free(struct rte_mempool_cache *cache);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable or disable adaptive sizing of the per-lcore default caches.
+ *
+ * When enabled, each time a cache goes to the backing pool its flushed and
+ * refilled object counts are accumulated. Once enough objects went through,
+ * the cache is resized from the observed imbalance: a cache that mostly
+ * flushes (an lcore that frees what other lcores allocate) keeps fewer
+ * objects and flushes bigger bursts, a cache that mostly refills keeps up
+ * to twice the mempool cache size so that it refills in bigger bursts, and
+ * a balanced cache gets the mempool cache size back. Resizing is done by
+ * the lcore owning the cache, on the slow path only.
+ *
+ * This function must not be called while other lcores use the mempool.
+ * Applications must be built with ALLOW_EXPERIMENTAL_API for their inline
+ * get and put functions to take part in adaptive sizing.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param enable
+ *   Non-zero to enable adaptive sizing, zero to disable it and restore
+ *   the initial size of all the per-lcore caches.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool has no per-lcore cache.
+ */
+__rte_experimental
+int
+rte_mempool_cache_adaptive_set(struct rte_mempool *mp, int enable);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add a direct handoff from the default cache of one lcore to the default
+ * cache of another one.
+ *
+ * Objects flushed by the cache of put_lcore are first enqueued to a
+ * single-producer single-consumer ring, and the cache of get_lcore first
+ * refills from that ring, so that objects freed on one lcore and allocated
+ * on the other bypass the shared backing pool. Objects that do not fit in
+ * the ring, or are missing from it, go to, or come from, the backing pool.
+ * The ring holds up to four times the mempool cache size.
+ *
+ * An lcore can take part in one handoff only for a given mempool. This
+ * function must not be called while put_lcore or get_lcore use the mempool.
+ * Applications must be built with ALLOW_EXPERIMENTAL_API for their inline
+ * get and put functions to use the handoff.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param put_lcore
+ *   The lcore freeing the objects.
+ * @param get_lcore
+ *   The lcore allocating the objects.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: Invalid lcore or the mempool has no per-lcore cache.
+ *   - -EBUSY: One of the lcores already takes part in a handoff.
+ *   - -ENOMEM: The handoff ring cannot be allocated.
+ */
+__rte_experimental
+int
+rte_mempool_cache_handoff_add(struct rte_mempool *mp, unsigned int put_lcore,
+			      unsigned int get_lcore);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Remove a handoff added with rte_mempool_cache_handoff_add().
+ *
+ * The objects left in the handoff ring are returned to the backing pool.
+ * This function must not be called while the lcores of the handoff use
+ * the mempool.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param put_lcore
+ *   The lcore freeing the objects.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: Invalid lcore or the mempool has no per-lcore cache.
+ *   - -ENOENT: put_lcore does not hand objects off.
+ */
+__rte_experimental
+int
+rte_mempool_cache_handoff_del(struct rte_mempool *mp, unsigned int put_lcore);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the statistics of the default cache of an lcore.
+ *
+ * Counters are updated without synchronization by the lcore owning the
+ * cache, so they may be slightly behind when read from another lcore.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param lcore_id
+ *   The logical core id.
+ * @param stats
+ *   A pointer to a structure filled with the cache statistics.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: Invalid parameter or the mempool has no per-lcore cache.
+ */
+__rte_experimental
+int
+rte_mempool_cache_stats_get(struct rte_mempool *mp, unsigned int lcore_id,
+			    struct rte_mempool_cache_stats *stats);
+
 /**
  * Get a pointer to the per-lcore default mempool cache.
  *
@@ -1315,6 +1597,86 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @internal Flush the objects of a cache above its size when the mempool
+ * uses adaptive cache sizing or a cache handoff; used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache, which crossed its flush threshold.
+ */
+__rte_experimental
+void
+__rte_mempool_cache_put_miss(struct rte_mempool *mp,
+			     struct rte_mempool_cache *cache);
+
+/**
+ * @internal Refill a cache when the mempool uses adaptive cache sizing
+ * or a cache handoff; used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache, which holds less than n objects.
+ * @param n
+ *   The number of objects the cache must hold on return.
+ * @return
+ *   - 0: Success; the cache holds at least n objects.
+ *   - <0: Error; code of ring dequeue function.
+ */
+__rte_experimental
+int
+__rte_mempool_cache_get_miss(struct rte_mempool *mp,
+			     struct rte_mempool_cache *cache, unsigned int n);
+
+/** Operation recorded by the mempool ownership tracking. */
+enum rte_mempool_track_op {
+	RTE_MEMPOOL_TRACK_GET, /**< The object was taken from the mempool. */
+	RTE_MEMPOOL_TRACK_PUT, /**< The object was returned to the mempool. */
+};
+
+/** Get or put of an object recorded by the mempool ownership tracking. */
+struct rte_mempool_track_event {
+	void *obj;          /**< Object. */
+	/**
+	 * Address of the get or put: as the mempool API is inlined, this is
+	 * an address in the function which called it, after the call to the
+	 * tracking.
+	 */
+	const void *caller;
+	uint64_t tsc;       /**< TSC of the operation. */
+	/** Owner of the lcore at the time, see rte_mempool_track_owner_set(). */
+	uint32_t owner;
+	/** lcore of the operation, RTE_MAX_LCORE for threads without a ring
+	 * buffer of their own, see rte_mempool_track_enable().
+	 */
+	uint16_t lcore_id;
+	uint8_t op;         /**< Operation, enum rte_mempool_track_op. */
+	uint8_t reserved;
+};
+
+/**
+ * @internal Record the gets or puts of objects of a mempool with
+ * ownership tracking enabled; used internally.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects.
+ * @param op
+ *   The operation, enum rte_mempool_track_op.
+ *
+ * It is not inlined, so that its return address is in the function which
+ * called the inline get or put function.
+ */
+__rte_experimental
+void
+__rte_mempool_track(struct rte_mempool *mp, void * const *obj_table,
+		    unsigned int n, unsigned int op);
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1356,6 +1718,14 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	cache->len += n;
 
 	if (cache->len >= cache->flushthresh) {
+#ifdef ALLOW_EXPERIMENTAL_API
+		if (unlikely(mp->flags & (RTE_MEMPOOL_F_CACHE_ADAPTIVE |
+					  RTE_MEMPOOL_F_CACHE_HANDOFF))) {
+			__rte_mempool_cache_put_miss(mp, cache);
+			return;
+		}
+#endif
+		cache->flush_objs += cache->len - cache->size;
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
 		cache->len = cache->size;
@@ -1393,6 +1763,10 @@ rte_mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 {
 	rte_mempool_trace_generic_put(mp, obj_table, n, cache);
 	RTE_MEMPOOL_CHECK_COOKIES(mp, obj_table, n, 0);
+#ifdef ALLOW_EXPERIMENTAL_API
+	if (unlikely(mp->flags & RTE_MEMPOOL_F_TRACK))
+		__rte_mempool_track(mp, obj_table, n, RTE_MEMPOOL_TRACK_PUT);
+#endif
 	rte_mempool_do_generic_put(mp, obj_table, n, cache);
 }
 
@@ -1471,6 +1845,14 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		/* No. Backfill the cache first, and then fill from it */
 		uint32_t req = n + (cache->size - cache->len);
 
+#ifdef ALLOW_EXPERIMENTAL_API
+		if (unlikely(mp->flags & (RTE_MEMPOOL_F_CACHE_ADAPTIVE |
+					  RTE_MEMPOOL_F_CACHE_HANDOFF))) {
+			if (__rte_mempool_cache_get_miss(mp, cache, n) < 0)
+				goto ring_dequeue;
+			goto cache_fill;
+		}
+#endif
 		/* How many do we require i.e. number to fill the cache + the request */
 		ret = rte_mempool_ops_dequeue_bulk(mp,
 			&cache->objs[cache->len], req);
@@ -1485,8 +1867,13 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		}
 
 		cache->len += req;
+		cache->refill_objs += req;
 	}
 
+#ifdef ALLOW_EXPERIMENTAL_API
+cache_fill:
+#endif
+
 	/* Now fill in the response ... */
 	for (index = 0, len = cache->len - 1; index < n; ++index, len--, obj_table++)
 		*obj_table = cache_objs[len];
@@ -1542,6 +1929,10 @@ rte_mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 	ret = rte_mempool_do_generic_get(mp, obj_table, n, cache);
 	if (ret == 0)
 		RTE_MEMPOOL_CHECK_COOKIES(mp, obj_table, n, 1);
+#ifdef ALLOW_EXPERIMENTAL_API
+	if (unlikely(ret == 0 && (mp->flags & RTE_MEMPOOL_F_TRACK)))
+		__rte_mempool_track(mp, obj_table, n, RTE_MEMPOOL_TRACK_GET);
+#endif
 	rte_mempool_trace_generic_get(mp, obj_table, n, cache);
 	return ret;
 }
@@ -1743,6 +2134,120 @@ rte_mempool_virt2iova(const void *elt)
  */
 void rte_mempool_audit(struct rte_mempool *mp);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable the ownership tracking of the objects of a mempool
+ *
+ * Each get and put of objects is recorded in a ring buffer of the lcore
+ * doing it, with the caller address, the lcore owner tag and the TSC. The
+ * last operation on each object still in the buffers tells whether it is
+ * held by the application, and where it was taken from the pool. The ring
+ * buffers are kept when the tracking is disabled, and freed with the
+ * mempool.
+ *
+ * Ring buffers are allocated for the EAL and service lcores enabled at
+ * the first call. Other threads share one more ring buffer.
+ *
+ * Only the gets and puts done through the inline functions of an
+ * application built with ALLOW_EXPERIMENTAL_API are recorded.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param nb_events
+ *   The number of events recorded per lcore, rounded up to a power of 2.
+ *   Ignored if the tracking was already enabled once.
+ * @return
+ *   0 on success.
+ *   On error, a negative errno is returned:
+ *     (-EINVAL): nb_events is zero or too large.
+ *     (-ENOMEM): allocation failure.
+ */
+__rte_experimental
+int
+rte_mempool_track_enable(struct rte_mempool *mp, unsigned int nb_events);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Disable the ownership tracking of the objects of a mempool
+ *
+ * The events already recorded are kept.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ */
+__rte_experimental
+void
+rte_mempool_track_disable(struct rte_mempool *mp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the owner tag recorded with the mempool operations of the calling
+ * lcore
+ *
+ * The tag is free-form: for instance, a polling lcore may set it to the
+ * port and queue it is about to serve. It is 0 until set.
+ *
+ * @param owner
+ *   The owner tag.
+ */
+__rte_experimental
+void
+rte_mempool_track_owner_set(uint32_t owner);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the last recorded operation on an object of a mempool
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param obj
+ *   A pointer to the object.
+ * @param event
+ *   A pointer to the structure filled with the last event of the object.
+ * @return
+ *   0 on success.
+ *   On error, a negative errno is returned:
+ *     (-EINVAL): the tracking was never enabled on the mempool.
+ *     (-ENOENT): no event of the object is left in the ring buffers.
+ */
+__rte_experimental
+int
+rte_mempool_track_obj_last(const struct rte_mempool *mp, const void *obj,
+			   struct rte_mempool_track_event *event);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dump the objects of a mempool held by the application
+ *
+ * The objects whose last recorded operation is a get are grouped by
+ * caller address and owner tag, the sites which may leak objects.
+ * Objects whose events were overwritten in the ring buffers are not
+ * accounted for.
+ *
+ * @param f
+ *   A pointer to a file for output.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @return
+ *   0 on success.
+ *   On error, a negative errno is returned:
+ *     (-EINVAL): the tracking was never enabled on the mempool.
+ *     (-ENOMEM): allocation failure.
+ */
+__rte_experimental
+int
+rte_mempool_track_dump(FILE *f, const struct rte_mempool *mp);
+
 /**
  * Return a pointer to the private data in an mempool structure.
  *
@@ -1826,6 +2331,18 @@ enum rte_mempool_event {
 	RTE_MEMPOOL_EVENT_READY = 0,
 	/** Occurs before the destruction of a mempool begins. */
 	RTE_MEMPOOL_EVENT_DESTROY = 1,
+	/**
+	 * Occurs when a memory chunk is added to a ready elastic mempool,
+	 * before its objects are made available. The chunk is the last one
+	 * of the mempool memory list. A callback can refuse the chunk.
+	 */
+	RTE_MEMPOOL_EVENT_CHUNK_ADD = 2,
+	/**
+	 * Occurs before a memory chunk of an elastic mempool is freed,
+	 * including a chunk refused on RTE_MEMPOOL_EVENT_CHUNK_ADD.
+	 * The chunk is the last one of the mempool memory list.
+	 */
+	RTE_MEMPOOL_EVENT_CHUNK_DEL = 3,
 };
 
 /**
@@ -1836,8 +2353,12 @@ enum rte_mempool_event {
  * but the callbacks registered this way will not be invoked for the same event.
  * rte_mempool_event_callback_unregister() may only be safely called
  * to remove the running callback.
+ *
+ * The return value is only used for RTE_MEMPOOL_EVENT_CHUNK_ADD: a negative
+ * errno refuses the memory chunk, which is then reported to all callbacks
+ * with RTE_MEMPOOL_EVENT_CHUNK_DEL and freed.
  */
-typedef void (rte_mempool_event_callback)(
+typedef int (rte_mempool_event_callback)(
 		enum rte_mempool_event event,
 		struct rte_mempool *mp,
 		void *user_data);
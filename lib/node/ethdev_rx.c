@@ -141,7 +141,7 @@ eth_pkt_parse_cb(uint16_t port, uint16_t queue, struct rte_mbuf **mbufs,
 }
 
 #define MAX_PTYPES 16
-static int
+int
 ethdev_ptype_setup(uint16_t port, uint16_t queue)
 {
 	uint8_t l3_ipv4 = 0, l3_ipv6 = 0;
@@ -72,4 +72,20 @@ struct ethdev_rx_node_main *ethdev_rx_get_node_data_get(void);
  */
 struct rte_node_register *ethdev_rx_node_get(void);
 
+/**
+ * @internal
+ *
+ * Enable software ptype parsing on an Ethernet Rx queue when the port
+ * does not report the L3 ptypes needed by the pkt_cls node.
+ *
+ * @param port
+ *   Port identifier.
+ * @param queue
+ *   Rx queue identifier.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+int ethdev_ptype_setup(uint16_t port, uint16_t queue);
+
 #endif /* __INCLUDE_ETHDEV_RX_PRIV_H__ */
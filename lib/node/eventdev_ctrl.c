@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <rte_ethdev.h>
+#include <rte_eventdev.h>
+#include <rte_graph.h>
+
+#include "rte_node_eventdev_api.h"
+
+#include "ethdev_rx_priv.h"
+#include "eventdev_rx_priv.h"
+#include "eventdev_tx_priv.h"
+#include "ip4_rewrite_priv.h"
+#include "node_private.h"
+
+static struct eventdev_ctrl {
+	bool configured;
+} ctrl;
+
+int
+rte_node_eventdev_config(struct rte_node_eventdev_config *conf,
+			 uint16_t nb_graphs)
+{
+	struct rte_node_register *ip4_rewrite_node;
+	struct eventdev_tx_node_main *tx_node_data;
+	struct eventdev_rx_node_main *rx_node_data;
+	struct rte_node_register *tx_node;
+	struct rte_node_register *rx_node;
+	struct rte_eth_dev_info dev_info;
+	char name[RTE_NODE_NAMESIZE];
+	const char *next_nodes = name;
+	uint16_t port_id, q;
+	uint8_t ev_port;
+	int i, rc;
+	uint32_t id;
+
+	if (conf == NULL || ctrl.configured)
+		return -EINVAL;
+
+	if (conf->dev_id >= rte_event_dev_count())
+		return -EINVAL;
+
+	/* Check if we have an event port for each worker */
+	if (conf->nb_ev_ports < nb_graphs ||
+	    conf->nb_ev_ports > RTE_EVENT_MAX_PORTS_PER_DEV)
+		return -EINVAL;
+
+	ip4_rewrite_node = ip4_rewrite_node_get();
+	rx_node_data = eventdev_rx_node_data_get();
+	rx_node = eventdev_rx_node_get();
+	tx_node_data = eventdev_tx_node_data_get();
+	tx_node = eventdev_tx_node_get();
+
+	/* Create node for each event port */
+	for (i = 0; i < conf->nb_ev_ports; i++) {
+		eventdev_rx_node_elem_t *elem;
+
+		ev_port = conf->ev_ports[i];
+		snprintf(name, sizeof(name), "%u-%u", conf->dev_id, ev_port);
+		/* Clone a new rx node with same edges as parent */
+		id = rte_node_clone(rx_node->id, name);
+		if (id == RTE_NODE_ID_INVALID)
+			return -EIO;
+
+		/* Add it to list of eventdev rx nodes for lookup */
+		elem = malloc(sizeof(eventdev_rx_node_elem_t));
+		if (elem == NULL)
+			return -ENOMEM;
+		memset(elem, 0, sizeof(eventdev_rx_node_elem_t));
+		elem->ctx.dev_id = conf->dev_id;
+		elem->ctx.port_id = ev_port;
+		elem->nid = id;
+		elem->next = rx_node_data->head;
+		rx_node_data->head = elem;
+
+		tx_node_data->ev_ports[i] = ev_port;
+
+		node_dbg("eventdev", "Rx node %s-%s: is at %u", rx_node->name,
+			 name, id);
+	}
+	tx_node_data->nb_ev_ports = conf->nb_ev_ports;
+	tx_node_data->dev_id = conf->dev_id;
+	tx_node_data->tx_queue_id = conf->tx_queue_id;
+	tx_node_data->internal_port = !!conf->tx_internal_port;
+
+	for (i = 0; i < conf->nb_eth_ports; i++) {
+		port_id = conf->eth_ports[i];
+
+		if (!rte_eth_dev_is_valid_port(port_id))
+			return -EINVAL;
+
+		/* Packets reach pkt_cls without going through ethdev_rx */
+		rc = rte_eth_dev_info_get(port_id, &dev_info);
+		if (rc < 0)
+			return rc;
+		for (q = 0; q < dev_info.nb_rx_queues; q++) {
+			rc = ethdev_ptype_setup(port_id, q);
+			if (rc < 0)
+				return rc;
+		}
+
+		/* Create a per port tx node from base node */
+		snprintf(name, sizeof(name), "%u", port_id);
+		/* Clone a new node with same edges as parent */
+		id = rte_node_clone(tx_node->id, name);
+		if (id == RTE_NODE_ID_INVALID)
+			return -EIO;
+		tx_node_data->nodes[port_id] = id;
+
+		node_dbg("eventdev", "Tx node %s-%s: is at %u", tx_node->name,
+			 name, id);
+
+		/* Prepare the actual name of the cloned node */
+		snprintf(name, sizeof(name), "eventdev_tx-%u", port_id);
+
+		/* Add this tx port node as next to ip4_rewrite_node */
+		rte_node_edge_update(ip4_rewrite_node->id, RTE_EDGE_ID_INVALID,
+				     &next_nodes, 1);
+		/* Assuming edge id is the last one alloc'ed */
+		rc = ip4_rewrite_set_next(
+			port_id, rte_node_edge_count(ip4_rewrite_node->id) - 1);
+		if (rc < 0)
+			return rc;
+	}
+
+	ctrl.configured = true;
+	return 0;
+}
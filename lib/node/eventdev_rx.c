@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <rte_debug.h>
+#include <rte_eventdev.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_mempool.h>
+
+#include "eventdev_rx_priv.h"
+#include "node_private.h"
+
+static struct eventdev_rx_node_main eventdev_rx_main;
+
+static __rte_always_inline uint16_t
+eventdev_rx_node_process_inline(struct rte_graph *graph, struct rte_node *node,
+				eventdev_rx_node_ctx_t *ctx)
+{
+	struct rte_event ev[RTE_GRAPH_BURST_SIZE];
+	uint16_t count, next_index, nb_ev, i;
+	struct rte_event_vector *vec;
+	void **to_next;
+
+	next_index = ctx->cls_next;
+
+	/* Get events from event port */
+	nb_ev = rte_event_dequeue_burst(ctx->dev_id, ctx->port_id, ev,
+					RTE_GRAPH_BURST_SIZE, 0);
+	if (!nb_ev)
+		return 0;
+
+	/* Each event vector carries a burst of mbufs */
+	count = 0;
+	for (i = 0; i < nb_ev; i++) {
+		if (ev[i].event_type & RTE_EVENT_TYPE_VECTOR)
+			count += ev[i].vec->nb_elem;
+		else
+			count++;
+	}
+
+	/* Enqueue to next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, count);
+	count = 0;
+	for (i = 0; i < nb_ev; i++) {
+		if (!(ev[i].event_type & RTE_EVENT_TYPE_VECTOR)) {
+			to_next[count++] = ev[i].mbuf;
+			continue;
+		}
+
+		vec = ev[i].vec;
+		rte_memcpy(&to_next[count], vec->mbufs,
+			   vec->nb_elem * sizeof(void *));
+		count += vec->nb_elem;
+		/* Vector container is no longer needed */
+		rte_mempool_put(rte_mempool_from_obj(vec), vec);
+	}
+	rte_node_next_stream_put(graph, node, next_index, count);
+
+	return count;
+}
+
+static __rte_always_inline uint16_t
+eventdev_rx_node_process(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t cnt)
+{
+	eventdev_rx_node_ctx_t *ctx = (eventdev_rx_node_ctx_t *)node->ctx;
+	uint16_t n_pkts = 0;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(cnt);
+
+	n_pkts = eventdev_rx_node_process_inline(graph, node, ctx);
+	return n_pkts;
+}
+
+static int
+eventdev_rx_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	eventdev_rx_node_ctx_t *ctx = (eventdev_rx_node_ctx_t *)node->ctx;
+	eventdev_rx_node_elem_t *elem = eventdev_rx_main.head;
+
+	RTE_SET_USED(graph);
+
+	while (elem) {
+		if (elem->nid == node->id) {
+			/* Update node specific context */
+			memcpy(ctx, &elem->ctx, sizeof(eventdev_rx_node_ctx_t));
+			break;
+		}
+		elem = elem->next;
+	}
+
+	RTE_VERIFY(elem != NULL);
+
+	ctx->cls_next = EVENTDEV_RX_NEXT_PKT_CLS;
+
+	return 0;
+}
+
+struct eventdev_rx_node_main *
+eventdev_rx_node_data_get(void)
+{
+	return &eventdev_rx_main;
+}
+
+static struct rte_node_register eventdev_rx_node_base = {
+	.process = eventdev_rx_node_process,
+	.flags = RTE_NODE_SOURCE_F,
+	.name = "eventdev_rx",
+
+	.init = eventdev_rx_node_init,
+
+	.nb_edges = EVENTDEV_RX_NEXT_MAX,
+	.next_nodes = {
+		/* Default pkt classification node */
+		[EVENTDEV_RX_NEXT_PKT_CLS] = "pkt_cls",
+		[EVENTDEV_RX_NEXT_IP4_LOOKUP] = "ip4_lookup",
+	},
+};
+
+struct rte_node_register *
+eventdev_rx_node_get(void)
+{
+	return &eventdev_rx_node_base;
+}
+
+RTE_NODE_REGISTER(eventdev_rx_node_base);
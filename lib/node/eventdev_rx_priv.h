@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+#ifndef __INCLUDE_EVENTDEV_RX_PRIV_H__
+#define __INCLUDE_EVENTDEV_RX_PRIV_H__
+
+#include <rte_common.h>
+
+struct eventdev_rx_node_elem;
+struct eventdev_rx_node_ctx;
+typedef struct eventdev_rx_node_elem eventdev_rx_node_elem_t;
+typedef struct eventdev_rx_node_ctx eventdev_rx_node_ctx_t;
+
+/**
+ * @internal
+ *
+ * Event device Rx node context structure.
+ */
+struct eventdev_rx_node_ctx {
+	uint8_t dev_id;	 /**< Event device identifier of the Rx node. */
+	uint8_t port_id; /**< Event port identifier of the Rx node. */
+	uint16_t cls_next;
+};
+
+/**
+ * @internal
+ *
+ * Event device Rx node list element structure.
+ */
+struct eventdev_rx_node_elem {
+	struct eventdev_rx_node_elem *next;
+	/**< Pointer to the next Rx node element. */
+	struct eventdev_rx_node_ctx ctx;
+	/**< Rx node context. */
+	rte_node_t nid;
+	/**< Node identifier of the Rx node. */
+};
+
+enum eventdev_rx_next_nodes {
+	EVENTDEV_RX_NEXT_IP4_LOOKUP,
+	EVENTDEV_RX_NEXT_PKT_CLS,
+	EVENTDEV_RX_NEXT_MAX,
+};
+
+/**
+ * @internal
+ *
+ * Event device Rx node main structure.
+ */
+struct eventdev_rx_node_main {
+	eventdev_rx_node_elem_t *head;
+	/**< Pointer to the head Rx node element. */
+};
+
+/**
+ * @internal
+ *
+ * Get the event device Rx node data.
+ *
+ * @return
+ *   Pointer to event device Rx node data.
+ */
+struct eventdev_rx_node_main *eventdev_rx_node_data_get(void);
+
+/**
+ * @internal
+ *
+ * Get the event device Rx node.
+ *
+ * @return
+ *   Pointer to the event device Rx node.
+ */
+struct rte_node_register *eventdev_rx_node_get(void);
+
+#endif /* __INCLUDE_EVENTDEV_RX_PRIV_H__ */
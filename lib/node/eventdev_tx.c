@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <rte_debug.h>
+#include <rte_event_eth_tx_adapter.h>
+#include <rte_eventdev.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+
+#include "eventdev_tx_priv.h"
+
+static struct eventdev_tx_node_main eventdev_tx_main;
+
+static uint16_t
+eventdev_tx_node_process(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t nb_objs)
+{
+	eventdev_tx_node_ctx_t *ctx = (eventdev_tx_node_ctx_t *)node->ctx;
+	struct rte_event ev[RTE_GRAPH_BURST_SIZE];
+	uint16_t count = 0, sent, n, i;
+	struct rte_mbuf *mbuf;
+
+	while (count < nb_objs) {
+		n = RTE_MIN(nb_objs - count, RTE_GRAPH_BURST_SIZE);
+		for (i = 0; i < n; i++) {
+			mbuf = objs[count + i];
+			/* Tx adapter picks the port and queue from the mbuf */
+			mbuf->port = ctx->port;
+			rte_event_eth_tx_adapter_txq_set(mbuf, ctx->queue);
+
+			ev[i].event = 0;
+			ev[i].flow_id = mbuf->hash.rss;
+			ev[i].op = RTE_EVENT_OP_NEW;
+			ev[i].sched_type = RTE_SCHED_TYPE_ATOMIC;
+			ev[i].queue_id = ctx->tx_queue_id;
+			ev[i].event_type = RTE_EVENT_TYPE_CPU;
+			ev[i].mbuf = mbuf;
+		}
+
+		if (ctx->internal_port)
+			sent = rte_event_eth_tx_adapter_enqueue(ctx->dev_id,
+								ctx->ev_port,
+								ev, n, 0);
+		else
+			sent = rte_event_enqueue_new_burst(ctx->dev_id,
+							   ctx->ev_port, ev, n);
+		count += sent;
+		if (sent != n)
+			break;
+	}
+
+	/* Redirect unsent pkts to drop node */
+	if (count != nb_objs) {
+		rte_node_enqueue(graph, node, EVENTDEV_TX_NEXT_PKT_DROP,
+				 &objs[count], nb_objs - count);
+	}
+
+	return count;
+}
+
+static int
+eventdev_tx_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	eventdev_tx_node_ctx_t *ctx = (eventdev_tx_node_ctx_t *)node->ctx;
+	uint64_t port_id = RTE_MAX_ETHPORTS;
+	int i;
+
+	/* Find our port id */
+	for (i = 0; i < RTE_MAX_ETHPORTS; i++) {
+		if (eventdev_tx_main.nodes[i] == node->id) {
+			port_id = i;
+			break;
+		}
+	}
+	RTE_VERIFY(port_id < RTE_MAX_ETHPORTS);
+	/* Each graph owns the event port matching its id */
+	RTE_VERIFY(graph->id < eventdev_tx_main.nb_ev_ports);
+
+	/* Update port, queue and event port */
+	ctx->port = port_id;
+	ctx->queue = graph->id;
+	ctx->dev_id = eventdev_tx_main.dev_id;
+	ctx->ev_port = eventdev_tx_main.ev_ports[graph->id];
+	ctx->tx_queue_id = eventdev_tx_main.tx_queue_id;
+	ctx->internal_port = eventdev_tx_main.internal_port;
+
+	return 0;
+}
+
+struct eventdev_tx_node_main *
+eventdev_tx_node_data_get(void)
+{
+	return &eventdev_tx_main;
+}
+
+static struct rte_node_register eventdev_tx_node_base = {
+	.process = eventdev_tx_node_process,
+	.name = "eventdev_tx",
+
+	.init = eventdev_tx_node_init,
+
+	.nb_edges = EVENTDEV_TX_NEXT_MAX,
+	.next_nodes = {
+		[EVENTDEV_TX_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+eventdev_tx_node_get(void)
+{
+	return &eventdev_tx_node_base;
+}
+
+RTE_NODE_REGISTER(eventdev_tx_node_base);
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+#ifndef __INCLUDE_EVENTDEV_TX_PRIV_H__
+#define __INCLUDE_EVENTDEV_TX_PRIV_H__
+
+#include <rte_ethdev.h>
+#include <rte_eventdev.h>
+
+struct eventdev_tx_node_ctx;
+typedef struct eventdev_tx_node_ctx eventdev_tx_node_ctx_t;
+
+enum eventdev_tx_next_nodes {
+	EVENTDEV_TX_NEXT_PKT_DROP,
+	EVENTDEV_TX_NEXT_MAX,
+};
+
+/**
+ * @internal
+ *
+ * Event device Tx node context structure.
+ */
+struct eventdev_tx_node_ctx {
+	uint16_t port;	     /**< Ethdev port of the Tx node. */
+	uint16_t queue;	     /**< Ethdev Tx queue of the Tx node. */
+	uint8_t dev_id;	     /**< Event device identifier. */
+	uint8_t ev_port;     /**< Event port used to enqueue. */
+	uint8_t tx_queue_id; /**< Event queue linked to the Tx adapter. */
+	uint8_t internal_port;
+	/**< Enqueue through rte_event_eth_tx_adapter_enqueue(). */
+};
+
+/**
+ * @internal
+ *
+ * Event device Tx node main structure.
+ */
+struct eventdev_tx_node_main {
+	uint32_t nodes[RTE_MAX_ETHPORTS]; /**< Tx nodes for each ethdev port. */
+	uint8_t ev_ports[RTE_EVENT_MAX_PORTS_PER_DEV];
+	/**< Event port of each graph, indexed by graph id. */
+	uint16_t nb_ev_ports;	     /**< Number of valid ev_ports entries. */
+	uint8_t dev_id;		     /**< Event device identifier. */
+	uint8_t tx_queue_id;	     /**< Event queue linked to the Tx adapter. */
+	uint8_t internal_port;	     /**< Tx adapter has an internal port. */
+};
+
+/**
+ * @internal
+ *
+ * Get the event device Tx node data.
+ *
+ * @return
+ *   Pointer to event device Tx node data.
+ */
+struct eventdev_tx_node_main *eventdev_tx_node_data_get(void);
+
+/**
+ * @internal
+ *
+ * Get the event device Tx node.
+ *
+ * @return
+ *   Pointer to the event device Tx node.
+ */
+struct rte_node_register *eventdev_tx_node_get(void);
+
+#endif /* __INCLUDE_EVENTDEV_TX_PRIV_H__ */
@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#ifndef __INCLUDE_RTE_NODE_EVENTDEV_API_H__
+#define __INCLUDE_RTE_NODE_EVENTDEV_API_H__
+
+/**
+ * @file rte_node_eventdev_api.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API allows to setup eventdev_rx and eventdev_tx nodes
+ * and their event port associations.
+ *
+ * An eventdev_rx node dequeues events, or event vectors, from an event port
+ * and feeds the mbufs they carry into the graph. An eventdev_tx node hands
+ * the mbufs routed to it back to the event device, so that they get
+ * transmitted by the event eth Tx adapter.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_common.h>
+
+/**
+ * Event device config for eventdev_rx and eventdev_tx nodes.
+ */
+struct rte_node_eventdev_config {
+	uint8_t dev_id;
+	/**< Event device identifier. */
+	uint8_t tx_queue_id;
+	/**< Event queue linked to the event port of the Tx adapter.
+	 * Unused when *tx_internal_port* is set.
+	 */
+	uint8_t tx_internal_port;
+	/**< Set when the Tx adapter has the
+	 * RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT capability, the
+	 * eventdev_tx nodes then use rte_event_eth_tx_adapter_enqueue().
+	 */
+	uint8_t *ev_ports;
+	/**< Array of event ports. An eventdev_rx node is created for each
+	 * of them, and the graph with id N enqueues through ev_ports[N].
+	 */
+	uint16_t nb_ev_ports;
+	/**< Size of ev_ports array. */
+	uint16_t *eth_ports;
+	/**< Array of ethdev ports to create eventdev_tx nodes for. */
+	uint16_t nb_eth_ports;
+	/**< Size of eth_ports array. */
+};
+
+/**
+ * Initializes eventdev nodes.
+ *
+ * For each event port P of event device D, an eventdev_rx node
+ * ``eventdev_rx-D-P`` is cloned; it must only be part of the graph whose
+ * id matches the index of P in the *ev_ports* array, as event ports are
+ * not multi-thread safe. For each ethdev port X, an eventdev_tx node
+ * ``eventdev_tx-X`` is cloned and set as the ip4_rewrite next node for X.
+ * Each graph transmits on the Tx queue matching its graph id, so the ethdev
+ * ports must have at least *nb_graphs* Tx queues added to the Tx adapter.
+ *
+ * The event device and the ethdev ports must be configured before this call.
+ * It can only be called once.
+ *
+ * @param conf
+ *   Event device config that identifies which eventdev_rx and eventdev_tx
+ *   nodes need to be created.
+ * @param nb_graphs
+ *   Number of graphs that will be used.
+ *
+ * @return
+ *   0 on successful initialization, negative otherwise.
+ */
+__rte_experimental
+int rte_node_eventdev_config(struct rte_node_eventdev_config *conf,
+			     uint16_t nb_graphs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_NODE_EVENTDEV_API_H__ */
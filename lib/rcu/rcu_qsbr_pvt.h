@@ -44,6 +44,15 @@ struct rte_rcu_qsbr_dq {
 	 *   pointer to the data structure to which the resource to free
 	 *   belongs.
 	 */
+	uint32_t flags;
+	/**< Flags given at creation. */
+	struct rte_rcu_qsbr_dq_stats stats;
+	/**< Statistics, updated with relaxed atomics. */
+	uint8_t *reclaim_buf;
+	/**< __RTE_RCU_QSBR_DQ_RECLAIM_BURST elements dequeued by reclaim.
+	 *   Used between the start and the finish of the dequeue, which
+	 *   serializes the reclaiming threads.
+	 */
 };
 
 /* Internal structure to represent the element on the defer queue.
@@ -52,7 +61,14 @@ struct rte_rcu_qsbr_dq {
  */
 typedef struct {
 	uint64_t token;  /**< Token */
+	uint64_t tsc;    /**< TSC at enqueue */
 	uint8_t elem[0]; /**< Pointer to user element */
 } __attribute__((__may_alias__)) __rte_rcu_qsbr_dq_elem_t;
 
+/* Size of the header of the elements on the defer queue. */
+#define __RTE_RCU_QSBR_DQ_HDR_SIZE sizeof(__rte_rcu_qsbr_dq_elem_t)
+
+/* Maximum number of resources checked and freed at once by reclaim. */
+#define __RTE_RCU_QSBR_DQ_RECLAIM_BURST 32
+
 #endif /* _RTE_RCU_QSBR_PVT_H_ */
@@ -10,6 +10,7 @@
 #include <errno.h>
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_log.h>
 #include <rte_memory.h>
 #include <rte_malloc.h>
@@ -42,6 +43,9 @@ rte_rcu_qsbr_get_memsize(uint32_t max_threads)
 	/* Add the size of the registered thread ID bitmap array */
 	sz += __RTE_QSBR_THRID_ARRAY_SIZE(max_threads);
 
+	/* Add the size of the group acknowledged token array */
+	sz += __RTE_QSBR_GROUP_ACKED_ARRAY_SIZE(max_threads);
+
 	return sz;
 }
 
@@ -63,7 +67,9 @@ rte_rcu_qsbr_init(struct rte_rcu_qsbr *v, uint32_t max_threads)
 	if (sz == 1)
 		return 1;
 
-	/* Set all the threads to offline */
+	/* Set all the threads to offline and the tokens acknowledged by
+	 * the thread groups to __RTE_QSBR_CNT_INIT - 1.
+	 */
 	memset(v, 0, sz);
 	v->max_threads = max_threads;
 	v->num_elems = RTE_ALIGN_MUL_CEIL(max_threads,
@@ -246,6 +252,14 @@ rte_rcu_qsbr_dump(FILE *f, struct rte_rcu_qsbr *v)
 	fprintf(f, "  Least Acknowledged Token = %" PRIu64 "\n",
 			__atomic_load_n(&v->acked_token, __ATOMIC_ACQUIRE));
 
+	fprintf(f, "  Least Acknowledged Token of thread groups = ");
+	for (i = 0; i < v->num_elems; i++)
+		fprintf(f, "%" PRIu64 " ",
+			__atomic_load_n(__RTE_QSBR_GROUP_ACKED_ELM(v, i),
+					__ATOMIC_ACQUIRE));
+
+	fprintf(f, "\n");
+
 	fprintf(f, "Quiescent State Counts for readers:\n");
 	for (i = 0; i < v->num_elems; i++) {
 		bmap = __atomic_load_n(__RTE_QSBR_THRID_ARRAY_ELM(v, i),
@@ -323,9 +337,9 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 	 * max_size.
 	 */
 	qs_fifo_size = rte_align32pow2(params->size + 1);
-	/* Add token size to ring element size */
+	/* Add token and enqueue TSC size to ring element size */
 	dq->r = rte_ring_create_elem(params->name,
-			__RTE_QSBR_TOKEN_SIZE + params->esize,
+			__RTE_RCU_QSBR_DQ_HDR_SIZE + params->esize,
 			qs_fifo_size, SOCKET_ID_ANY, flags);
 	if (dq->r == NULL) {
 		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
@@ -334,13 +348,24 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 		return NULL;
 	}
 
+	dq->reclaim_buf = rte_malloc(NULL, __RTE_RCU_QSBR_DQ_RECLAIM_BURST *
+			(__RTE_RCU_QSBR_DQ_HDR_SIZE + params->esize),
+			RTE_CACHE_LINE_SIZE);
+	if (dq->reclaim_buf == NULL) {
+		rte_ring_free(dq->r);
+		rte_free(dq);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
 	dq->v = params->v;
 	dq->size = params->size;
-	dq->esize = __RTE_QSBR_TOKEN_SIZE + params->esize;
+	dq->esize = __RTE_RCU_QSBR_DQ_HDR_SIZE + params->esize;
 	dq->trigger_reclaim_limit = params->trigger_reclaim_limit;
 	dq->max_reclaim_size = params->max_reclaim_size;
 	dq->free_fn = params->free_fn;
 	dq->p = params->p;
+	dq->flags = params->flags;
 
 	return dq;
 }
@@ -385,7 +410,8 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 	 * on the queue. So, some tokens might wait longer than they
 	 * are required to be reclaimed.
 	 */
-	memcpy(dq_elem->elem, e, dq->esize - __RTE_QSBR_TOKEN_SIZE);
+	memcpy(dq_elem->elem, e, dq->esize - __RTE_RCU_QSBR_DQ_HDR_SIZE);
+	dq_elem->tsc = rte_rdtsc();
 	/* Check the status as enqueue might fail since the other threads
 	 * might have used up the freed space.
 	 * Enqueue uses the configured flags when the DQ was created.
@@ -401,6 +427,9 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 			"%s(): Skipped enqueuing token = %" PRIu64 "\n",
 			__func__, dq_elem->token);
 
+		__atomic_fetch_add(&dq->stats.enqueue_fails, 1,
+				   __ATOMIC_RELAXED);
+
 		rte_errno = ENOSPC;
 		return 1;
 	}
@@ -409,17 +438,77 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 		"%s(): Enqueued token = %" PRIu64 "\n",
 		__func__, dq_elem->token);
 
+	__atomic_fetch_add(&dq->stats.enqueued, 1, __ATOMIC_RELAXED);
+	/* The count might be stale. There is no need to update the
+	 * maximum very accurately using compare-and-swap.
+	 */
+	cur_size = rte_ring_count(dq->r);
+	if (cur_size > __atomic_load_n(&dq->stats.max_pending,
+				       __ATOMIC_RELAXED))
+		__atomic_store_n(&dq->stats.max_pending, cur_size,
+				 __ATOMIC_RELAXED);
+
 	return 0;
 }
 
+/* Account the reclamation latency of the resources and free them. */
+static void
+__rcu_qsbr_dq_free(struct rte_rcu_qsbr_dq *dq, uint8_t *data, uint32_t n)
+{
+	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	uint32_t esize = dq->esize - __RTE_RCU_QSBR_DQ_HDR_SIZE;
+	uint64_t now = rte_rdtsc();
+	uint64_t latency, total = 0, max = 0;
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		dq_elem = (__rte_rcu_qsbr_dq_elem_t *)(data + i * dq->esize);
+		latency = now - dq_elem->tsc;
+		total += latency;
+		if (latency > max)
+			max = latency;
+
+		rte_log(RTE_LOG_INFO, rte_rcu_log_type,
+			"%s(): Reclaimed token = %" PRIu64 "\n",
+			__func__, dq_elem->token);
+
+		if (!(dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_BATCH))
+			dq->free_fn(dq->p, dq_elem->elem, 1);
+		else
+			/* Pack the resources for a single call. As the
+			 * resources are smaller than the queue elements, a
+			 * resource never overwrites one not moved yet.
+			 */
+			memmove(data + i * esize, dq_elem->elem, esize);
+	}
+
+	if (dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_BATCH)
+		dq->free_fn(dq->p, data, n);
+
+	__atomic_fetch_add(&dq->stats.reclaimed, n, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&dq->stats.free_calls,
+		(dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_BATCH) ? 1 : n,
+		__ATOMIC_RELAXED);
+	__atomic_fetch_add(&dq->stats.latency_cycles_total, total,
+			   __ATOMIC_RELAXED);
+	/* There might be multiple reclaiming threads. There is no need to
+	 * update the maximum very accurately using compare-and-swap.
+	 */
+	if (max > __atomic_load_n(&dq->stats.latency_cycles_max,
+				  __ATOMIC_RELAXED))
+		__atomic_store_n(&dq->stats.latency_cycles_max, max,
+				 __ATOMIC_RELAXED);
+}
+
 /* Reclaim resources from the defer queue. */
 int
 rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 			unsigned int *freed, unsigned int *pending,
 			unsigned int *available)
 {
-	uint32_t cnt;
+	uint32_t cnt, burst, i;
 	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	uint8_t *data;
 
 	if (dq == NULL || n == 0) {
 		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
@@ -430,28 +519,44 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 	}
 
 	cnt = 0;
+	data = dq->reclaim_buf;
 
-	char data[dq->esize];
-	/* Check reader threads quiescent state and reclaim resources */
-	while (cnt < n &&
-		rte_ring_dequeue_bulk_elem_start(dq->r, &data,
-					dq->esize, 1, available) != 0) {
-		dq_elem = (__rte_rcu_qsbr_dq_elem_t *)data;
-
-		/* Reclaim the resource */
-		if (rte_rcu_qsbr_check(dq->v, dq_elem->token, false) != 1) {
-			rte_ring_dequeue_elem_finish(dq->r, 0);
+	/* Check reader threads quiescent state and reclaim resources,
+	 * a burst at a time.
+	 */
+	while (cnt < n) {
+		burst = rte_ring_dequeue_burst_elem_start(dq->r, data,
+				dq->esize,
+				RTE_MIN(n - cnt,
+					(uint32_t)__RTE_RCU_QSBR_DQ_RECLAIM_BURST),
+				available);
+		if (burst == 0)
 			break;
-		}
-		rte_ring_dequeue_elem_finish(dq->r, 1);
 
-		rte_log(RTE_LOG_INFO, rte_rcu_log_type,
-			"%s(): Reclaimed token = %" PRIu64 "\n",
-			__func__, dq_elem->token);
+		/* Find the resources whose grace period is over. Tokens
+		 * might be out of order on a queue shared by multiple
+		 * writers, stop at the first one still in use.
+		 */
+		for (i = 0; i < burst; i++) {
+			dq_elem = (__rte_rcu_qsbr_dq_elem_t *)
+				(data + i * dq->esize);
+			if (rte_rcu_qsbr_check(dq->v, dq_elem->token,
+					       false) != 1)
+				break;
+		}
+		/* Free the resources before finishing the dequeue, the
+		 * other reclaiming threads wait to reuse the buffer.
+		 */
+		if (i != 0)
+			__rcu_qsbr_dq_free(dq, data, i);
 
-		dq->free_fn(dq->p, dq_elem->elem, 1);
+		rte_ring_dequeue_elem_finish(dq->r, i);
+		if (available != NULL)
+			*available += burst - i;
 
-		cnt++;
+		cnt += i;
+		if (i != burst)
+			break;
 	}
 
 	rte_log(RTE_LOG_INFO, rte_rcu_log_type,
@@ -465,6 +570,60 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 	return 0;
 }
 
+/* Get the statistics of a defer queue. */
+int
+rte_rcu_qsbr_dq_stats_get(struct rte_rcu_qsbr_dq *dq,
+	struct rte_rcu_qsbr_dq_stats *stats)
+{
+	if (dq == NULL || stats == NULL) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+		rte_errno = EINVAL;
+
+		return 1;
+	}
+
+	stats->enqueued = __atomic_load_n(&dq->stats.enqueued,
+					  __ATOMIC_RELAXED);
+	stats->enqueue_fails = __atomic_load_n(&dq->stats.enqueue_fails,
+					       __ATOMIC_RELAXED);
+	stats->reclaimed = __atomic_load_n(&dq->stats.reclaimed,
+					   __ATOMIC_RELAXED);
+	stats->free_calls = __atomic_load_n(&dq->stats.free_calls,
+					    __ATOMIC_RELAXED);
+	stats->max_pending = __atomic_load_n(&dq->stats.max_pending,
+					     __ATOMIC_RELAXED);
+	stats->latency_cycles_total = __atomic_load_n(
+			&dq->stats.latency_cycles_total, __ATOMIC_RELAXED);
+	stats->latency_cycles_max = __atomic_load_n(
+			&dq->stats.latency_cycles_max, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+/* Reset the statistics of a defer queue. */
+int
+rte_rcu_qsbr_dq_stats_reset(struct rte_rcu_qsbr_dq *dq)
+{
+	if (dq == NULL) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+		rte_errno = EINVAL;
+
+		return 1;
+	}
+
+	__atomic_store_n(&dq->stats.enqueued, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&dq->stats.enqueue_fails, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&dq->stats.reclaimed, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&dq->stats.free_calls, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&dq->stats.max_pending, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&dq->stats.latency_cycles_total, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&dq->stats.latency_cycles_max, 0, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
 /* Delete a defer queue. */
 int
 rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
@@ -487,6 +646,7 @@ rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
 	}
 
 	rte_ring_free(dq->r);
+	rte_free(dq->reclaim_buf);
 	rte_free(dq);
 
 	return 0;
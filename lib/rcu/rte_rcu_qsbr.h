@@ -71,6 +71,16 @@ extern int rte_rcu_log_type;
 #define __RTE_QSBR_THRID_MASK 0x3f
 #define RTE_QSBR_THRID_INVALID 0xffffffff
 
+/* Threads are grouped by 64, as in the registered thread ID bitmap. The
+ * least token acked by the threads of each group is stored after the bitmap,
+ * so that the groups which acked a token are not checked again for it.
+ */
+#define __RTE_QSBR_GROUP_ACKED_ARRAY_SIZE(max_threads) \
+	__RTE_QSBR_THRID_ARRAY_SIZE(max_threads)
+#define __RTE_QSBR_GROUP_ACKED_ELM(v, i) ((uint64_t *) \
+	((uint8_t *)__RTE_QSBR_THRID_ARRAY_ELM(v, 0) + \
+	 __RTE_QSBR_THRID_ARRAY_SIZE(v->max_threads)) + i)
+
 /* Worker thread counter */
 struct rte_rcu_qsbr_cnt {
 	uint64_t cnt;
@@ -89,10 +99,11 @@ struct rte_rcu_qsbr_cnt {
 #define __RTE_QSBR_TOKEN_SIZE sizeof(uint64_t)
 
 /* RTE Quiescent State variable structure.
- * This structure has two elements that vary in size based on the
+ * This structure has three elements that vary in size based on the
  * 'max_threads' parameter.
  * 1) Quiescent state counter array
  * 2) Register thread ID array
+ * 3) Least acked token array of the thread groups
  */
 struct rte_rcu_qsbr {
 	uint64_t token __rte_cache_aligned;
@@ -115,6 +126,9 @@ struct rte_rcu_qsbr {
 	/**< Registered thread IDs are stored in a bitmap array,
 	 *   after the quiescent state counter array.
 	 */
+	/**< The least token acknowledged by the threads of each bitmap
+	 *   element is stored in an array, after the bitmap array.
+	 */
 } __rte_cache_aligned;
 
 /**
@@ -123,9 +137,15 @@ struct rte_rcu_qsbr {
  * @param p
  *   Pointer provided while creating the defer queue
  * @param e
- *   Pointer to the resource data stored on the defer queue
+ *   Pointer to the resource data stored on the defer queue. If the defer
+ *   queue is created with RTE_RCU_QSBR_DQ_RECLAIM_BATCH, this points to
+ *   'n' consecutive resources of 'esize' bytes each.
  * @param n
- *   Number of resources to free. Currently, this is set to 1.
+ *   Number of resources to free. This is set to 1, unless the defer queue
+ *   is created with RTE_RCU_QSBR_DQ_RECLAIM_BATCH.
+ *
+ * The function is called while the reclaiming thread holds the dequeue
+ * side of the defer queue, it must not enqueue to or reclaim from it.
  *
  * @return
  *   None
@@ -143,6 +163,10 @@ typedef void (*rte_rcu_qsbr_free_resource_t)(void *p, void *e, unsigned int n);
  *   Set this flag if multi-thread safety is not required.
  */
 #define RTE_RCU_QSBR_DQ_MT_UNSAFE 1
+/**< Pass the resources reclaimed at once to a single call of the
+ *   free function, instead of one call for each resource.
+ */
+#define RTE_RCU_QSBR_DQ_RECLAIM_BATCH 2
 
 /**
  * Parameters used when creating the defer queue.
@@ -190,6 +214,30 @@ struct rte_rcu_qsbr_dq_parameters {
 	/**< RCU QSBR variable to use for this defer queue */
 };
 
+/**
+ * Statistics of a defer queue.
+ */
+struct rte_rcu_qsbr_dq_stats {
+	uint64_t enqueued;
+	/**< Number of resources enqueued. */
+	uint64_t enqueue_fails;
+	/**< Number of resources not enqueued as the queue is full. */
+	uint64_t reclaimed;
+	/**< Number of resources reclaimed. */
+	uint64_t free_calls;
+	/**< Number of calls to the free function. */
+	uint64_t max_pending;
+	/**< Maximum number of resources waiting on the queue. */
+	uint64_t latency_cycles_total;
+	/**< Sum of the TSC cycles between the enqueue and the reclamation
+	 *   of the reclaimed resources.
+	 */
+	uint64_t latency_cycles_max;
+	/**< Maximum TSC cycles between the enqueue and the reclamation
+	 *   of a resource.
+	 */
+};
+
 /* RTE defer queue structure.
  * This structure holds the defer queue. The defer queue is used to
  * hold the deleted entries from the data structure that are not
@@ -507,6 +555,42 @@ rte_rcu_qsbr_quiescent(struct rte_rcu_qsbr *v, unsigned int thread_id)
 		__func__, t, thread_id);
 }
 
+/* Check whether the readers of a group acked a token in a previous check.
+ * The load-acquire pairs with the store-release of __rte_rcu_qsbr_group_acked
+ * so that the group check replaces the loads of the reader counters.
+ */
+static __rte_always_inline bool
+__rte_rcu_qsbr_group_check(uint64_t *group_acked, uint64_t t,
+	uint64_t *acked_token)
+{
+	uint64_t c = __atomic_load_n(group_acked, __ATOMIC_ACQUIRE);
+
+	if (c < t)
+		return false;
+
+	if (*acked_token > c)
+		*acked_token = c;
+	return true;
+}
+
+/* Store the least token acked by the readers of a group, or the checked
+ * token if none of them is online: a reader coming online later starts
+ * from the current token.
+ * There might be multiple writers trying to update this. There is
+ * no need to update this very accurately using compare-and-swap.
+ */
+static __rte_always_inline void
+__rte_rcu_qsbr_group_acked(uint64_t *group_acked, uint64_t t,
+	uint64_t group_acked_token, uint64_t *acked_token)
+{
+	if (group_acked_token == __RTE_QSBR_CNT_MAX)
+		group_acked_token = t;
+	__atomic_store_n(group_acked, group_acked_token, __ATOMIC_RELEASE);
+
+	if (*acked_token > group_acked_token)
+		*acked_token = group_acked_token;
+}
+
 /* Check the quiescent state counter for registered threads only, assuming
  * that not all threads have registered.
  */
@@ -517,16 +601,24 @@ __rte_rcu_qsbr_check_selective(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 	uint64_t bmap;
 	uint64_t c;
 	uint64_t *reg_thread_id;
+	uint64_t *group_acked;
+	uint64_t group_acked_token;
 	uint64_t acked_token = __RTE_QSBR_CNT_MAX;
 
-	for (i = 0, reg_thread_id = __RTE_QSBR_THRID_ARRAY_ELM(v, 0);
+	for (i = 0, reg_thread_id = __RTE_QSBR_THRID_ARRAY_ELM(v, 0),
+		group_acked = __RTE_QSBR_GROUP_ACKED_ELM(v, 0);
 		i < v->num_elems;
-		i++, reg_thread_id++) {
+		i++, reg_thread_id++, group_acked++) {
+		/* Skip the group if its readers already acked this token */
+		if (__rte_rcu_qsbr_group_check(group_acked, t, &acked_token))
+			continue;
+
 		/* Load the current registered thread bit map before
 		 * loading the reader thread quiescent state counters.
 		 */
 		bmap = __atomic_load_n(reg_thread_id, __ATOMIC_ACQUIRE);
 		id = i << __RTE_QSBR_THRID_INDEX_SHIFT;
+		group_acked_token = __RTE_QSBR_CNT_MAX;
 
 		while (bmap) {
 			j = __builtin_ctzl(bmap);
@@ -560,14 +652,18 @@ __rte_rcu_qsbr_check_selective(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 			}
 
 			/* This thread is in quiescent state. Use the counter
-			 * to find the least acknowledged token among all the
-			 * readers.
+			 * to find the least acknowledged token among the
+			 * readers of the group.
 			 */
-			if (c != __RTE_QSBR_CNT_THR_OFFLINE && acked_token > c)
-				acked_token = c;
+			if (c != __RTE_QSBR_CNT_THR_OFFLINE &&
+			    group_acked_token > c)
+				group_acked_token = c;
 
 			bmap &= ~(1UL << j);
 		}
+
+		__rte_rcu_qsbr_group_acked(group_acked, t, group_acked_token,
+					   &acked_token);
 	}
 
 	/* All readers are checked, update least acknowledged token.
@@ -587,12 +683,26 @@ __rte_rcu_qsbr_check_selective(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 static __rte_always_inline int
 __rte_rcu_qsbr_check_all(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 {
-	uint32_t i;
+	uint32_t i, end;
 	struct rte_rcu_qsbr_cnt *cnt;
 	uint64_t c;
+	uint64_t *group_acked;
+	uint64_t group_acked_token = __RTE_QSBR_CNT_MAX;
 	uint64_t acked_token = __RTE_QSBR_CNT_MAX;
 
-	for (i = 0, cnt = v->qsbr_cnt; i < v->max_threads; i++, cnt++) {
+	for (i = 0, cnt = v->qsbr_cnt, group_acked = __RTE_QSBR_GROUP_ACKED_ELM(v, 0);
+		i < v->max_threads; i++, cnt++) {
+		/* Skip the group if its readers already acked this token */
+		if ((i & __RTE_QSBR_THRID_MASK) == 0 &&
+		    __rte_rcu_qsbr_group_check(group_acked, t, &acked_token)) {
+			end = RTE_MIN(i + __RTE_QSBR_THRID_ARRAY_ELM_SIZE,
+				      v->max_threads);
+			cnt += end - i - 1;
+			i = end - 1;
+			group_acked++;
+			continue;
+		}
+
 		__RTE_RCU_DP_LOG(DEBUG,
 			"%s: check: token = %" PRIu64 ", wait = %d, Thread ID = %d",
 			__func__, t, wait, i);
@@ -616,10 +726,20 @@ __rte_rcu_qsbr_check_all(struct rte_rcu_qsbr *v, uint64_t t, bool wait)
 		}
 
 		/* This thread is in quiescent state. Use the counter to find
-		 * the least acknowledged token among all the readers.
+		 * the least acknowledged token among the readers of the group.
 		 */
-		if (likely(c != __RTE_QSBR_CNT_THR_OFFLINE && acked_token > c))
-			acked_token = c;
+		if (likely(c != __RTE_QSBR_CNT_THR_OFFLINE &&
+			   group_acked_token > c))
+			group_acked_token = c;
+
+		/* Last thread of the group */
+		if ((i & __RTE_QSBR_THRID_MASK) == __RTE_QSBR_THRID_MASK ||
+		    i == v->max_threads - 1) {
+			__rte_rcu_qsbr_group_acked(group_acked, t,
+					group_acked_token, &acked_token);
+			group_acked_token = __RTE_QSBR_CNT_MAX;
+			group_acked++;
+		}
 	}
 
 	/* All readers are checked, update least acknowledged token.
@@ -835,6 +955,48 @@ __rte_experimental
 int
 rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the statistics of a defer queue.
+ *
+ * The statistics are updated by the enqueue and reclaim operations.
+ * The average reclamation latency is latency_cycles_total / reclaimed.
+ *
+ * @param dq
+ *   Defer queue.
+ * @param stats
+ *   Structure filled with the statistics.
+ * @return
+ *   On success - 0
+ *   On error - 1
+ *   Possible rte_errno codes are:
+ *   - EINVAL - NULL parameters are passed
+ */
+__rte_experimental
+int
+rte_rcu_qsbr_dq_stats_get(struct rte_rcu_qsbr_dq *dq,
+	struct rte_rcu_qsbr_dq_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset the statistics of a defer queue.
+ *
+ * @param dq
+ *   Defer queue.
+ * @return
+ *   On success - 0
+ *   On error - 1
+ *   Possible rte_errno codes are:
+ *   - EINVAL - NULL parameters are passed
+ */
+__rte_experimental
+int
+rte_rcu_qsbr_dq_stats_reset(struct rte_rcu_qsbr_dq *dq);
+
 #ifdef __cplusplus
 }
 #endif
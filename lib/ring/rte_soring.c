@@ -0,0 +1,429 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_pause.h>
+#include <rte_string_fns.h>
+
+#include "rte_soring.h"
+
+/* Head and tail of the producers, the consumers or a stage. */
+struct soring_headtail {
+	volatile uint32_t head;
+	volatile uint32_t tail;
+	enum rte_ring_sync_type sync_type;
+} __rte_cache_aligned;
+
+/*
+ * Release of an acquire operation of a stage, stored at the index of its
+ * first element until the stage tail moves past it.
+ */
+union soring_state {
+	uint64_t raw;
+	struct {
+		uint32_t ftoken;
+		uint32_t n;
+	};
+};
+
+struct rte_soring {
+	char name[RTE_RING_NAMESIZE];
+	uint32_t size;      /* Number of entries, a power of 2. */
+	uint32_t mask;      /* size - 1 */
+	uint32_t capacity;  /* Usable number of entries, up to max_capacity. */
+	uint32_t max_capacity; /* Number of elements given at init. */
+	uint32_t esize;     /* Element size in bytes. */
+	uint32_t nb_stage;
+	struct soring_headtail *stage;  /* Head and tail of each stage. */
+	union soring_state *state;      /* size entries for each stage. */
+	uint8_t *elems;
+
+	struct soring_headtail prod;
+	struct soring_headtail cons;
+};
+
+static int
+soring_check_param(const struct rte_soring_param *prm)
+{
+	if (prm->elem_size == 0 || prm->elem_size % 4 != 0) {
+		RTE_LOG(ERR, RING, "element size is not a multiple of 4\n");
+		return -EINVAL;
+	}
+	if (prm->elems == 0 || prm->elems > RTE_RING_SZ_MASK) {
+		RTE_LOG(ERR, RING,
+			"Requested number of elements is invalid, must not exceed %u\n",
+			RTE_RING_SZ_MASK);
+		return -EINVAL;
+	}
+	if (prm->stages == 0 || prm->stages > RTE_SORING_STAGE_MAX) {
+		RTE_LOG(ERR, RING,
+			"Requested number of stages is invalid, must be from 1 to %u\n",
+			RTE_SORING_STAGE_MAX);
+		return -EINVAL;
+	}
+	if ((prm->prod_synt != RTE_RING_SYNC_MT &&
+	     prm->prod_synt != RTE_RING_SYNC_ST) ||
+	    (prm->cons_synt != RTE_RING_SYNC_MT &&
+	     prm->cons_synt != RTE_RING_SYNC_ST)) {
+		RTE_LOG(ERR, RING, "Unsupported producer or consumer sync mode\n");
+		return -EINVAL;
+	}
+	return 0;
+}
+
+ssize_t
+rte_soring_get_memsize(const struct rte_soring_param *prm)
+{
+	size_t size, sz;
+	int ret;
+
+	ret = soring_check_param(prm);
+	if (ret != 0)
+		return ret;
+
+	size = rte_align32pow2(prm->elems);
+	sz = sizeof(struct rte_soring);
+	sz += sizeof(struct soring_headtail) * prm->stages;
+	sz += RTE_ALIGN(sizeof(union soring_state) * size * prm->stages,
+			RTE_CACHE_LINE_SIZE);
+	sz += RTE_ALIGN(size * prm->elem_size, RTE_CACHE_LINE_SIZE);
+	return sz;
+}
+
+int
+rte_soring_init(struct rte_soring *r, const struct rte_soring_param *prm)
+{
+	ssize_t sz;
+	uint8_t *p;
+
+	sz = rte_soring_get_memsize(prm);
+	if (sz < 0)
+		return sz;
+
+	memset(r, 0, sz);
+	if (prm->name != NULL)
+		strlcpy(r->name, prm->name, sizeof(r->name));
+	r->size = rte_align32pow2(prm->elems);
+	r->mask = r->size - 1;
+	r->capacity = prm->elems;
+	r->max_capacity = prm->elems;
+	r->esize = prm->elem_size;
+	r->nb_stage = prm->stages;
+	r->prod.sync_type = prm->prod_synt;
+	r->cons.sync_type = prm->cons_synt;
+
+	p = (uint8_t *)(r + 1);
+	r->stage = (struct soring_headtail *)p;
+	p += sizeof(struct soring_headtail) * r->nb_stage;
+	r->state = (union soring_state *)p;
+	p += RTE_ALIGN(sizeof(union soring_state) * r->size * r->nb_stage,
+		       RTE_CACHE_LINE_SIZE);
+	r->elems = p;
+
+	return 0;
+}
+
+int
+rte_soring_set_capacity(struct rte_soring *r, uint32_t capacity)
+{
+	if (capacity == 0 || capacity > r->max_capacity)
+		return -EINVAL;
+
+	__atomic_store_n(&r->capacity, capacity, __ATOMIC_RELAXED);
+	return 0;
+}
+
+uint32_t
+rte_soring_get_capacity(const struct rte_soring *r)
+{
+	return __atomic_load_n(&r->capacity, __ATOMIC_RELAXED);
+}
+
+uint32_t
+rte_soring_count(const struct rte_soring *r)
+{
+	return r->prod.tail - r->cons.tail;
+}
+
+uint32_t
+rte_soring_free_count(const struct rte_soring *r)
+{
+	uint32_t capacity = rte_soring_get_capacity(r);
+	uint32_t count = rte_soring_count(r);
+
+	return count < capacity ? capacity - count : 0;
+}
+
+void
+rte_soring_dump(FILE *f, const struct rte_soring *r)
+{
+	uint32_t i;
+
+	fprintf(f, "soring <%s>@%p\n", r->name, r);
+	fprintf(f, "  size=%"PRIu32"\n", r->size);
+	fprintf(f, "  capacity=%"PRIu32"\n", rte_soring_get_capacity(r));
+	fprintf(f, "  esize=%"PRIu32"\n", r->esize);
+	fprintf(f, "  ct=%"PRIu32"\n", r->cons.tail);
+	fprintf(f, "  ch=%"PRIu32"\n", r->cons.head);
+	for (i = r->nb_stage; i-- != 0; ) {
+		fprintf(f, "  stage%"PRIu32"_t=%"PRIu32"\n", i,
+			r->stage[i].tail);
+		fprintf(f, "  stage%"PRIu32"_h=%"PRIu32"\n", i,
+			r->stage[i].head);
+	}
+	fprintf(f, "  pt=%"PRIu32"\n", r->prod.tail);
+	fprintf(f, "  ph=%"PRIu32"\n", r->prod.head);
+	fprintf(f, "  used=%u\n", rte_soring_count(r));
+	fprintf(f, "  avail=%u\n", rte_soring_free_count(r));
+}
+
+static void
+soring_copy_in(struct rte_soring *r, uint32_t pos, const void *objs,
+	       uint32_t n)
+{
+	uint32_t idx = pos & r->mask;
+	uint32_t n1 = RTE_MIN(n, r->size - idx);
+
+	memcpy(r->elems + (size_t)idx * r->esize, objs,
+	       (size_t)n1 * r->esize);
+	if (n1 != n)
+		memcpy(r->elems, (const uint8_t *)objs + (size_t)n1 * r->esize,
+		       (size_t)(n - n1) * r->esize);
+}
+
+static void
+soring_copy_out(const struct rte_soring *r, uint32_t pos, void *objs,
+		uint32_t n)
+{
+	uint32_t idx = pos & r->mask;
+	uint32_t n1 = RTE_MIN(n, r->size - idx);
+
+	memcpy(objs, r->elems + (size_t)idx * r->esize,
+	       (size_t)n1 * r->esize);
+	if (n1 != n)
+		memcpy((uint8_t *)objs + (size_t)n1 * r->esize, r->elems,
+		       (size_t)(n - n1) * r->esize);
+}
+
+/*
+ * Move the head of a producer, consumer or stage by up to n entries.
+ * The entries available are capacity + *limit - head: the consumer tail
+ * and the ring capacity for the producers, the tail of the previous step
+ * and 0 for the stages and the consumers.
+ */
+static uint32_t
+soring_move_head(struct soring_headtail *ht, const volatile uint32_t *limit,
+		 uint32_t capacity, uint32_t n,
+		 enum rte_ring_queue_behavior behavior, uint32_t *old_head,
+		 uint32_t *entries_left)
+{
+	const uint32_t max = n;
+	uint32_t head, entries;
+	int success;
+
+	head = __atomic_load_n(&ht->head, __ATOMIC_RELAXED);
+	do {
+		n = max;
+
+		/* Load the head before the limit, as in rte_ring. */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		entries = capacity + __atomic_load_n(limit, __ATOMIC_ACQUIRE) -
+			head;
+		/* The capacity may have been decreased below the count. */
+		if ((int32_t)entries < 0)
+			entries = 0;
+
+		if (n > entries)
+			n = (behavior == RTE_RING_QUEUE_FIXED) ? 0 : entries;
+		if (n == 0)
+			break;
+
+		if (ht->sync_type == RTE_RING_SYNC_ST) {
+			ht->head = head + n;
+			success = 1;
+		} else {
+			/* On failure, head is updated with the current one. */
+			success = __atomic_compare_exchange_n(&ht->head,
+					&head, head + n, 0, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED);
+		}
+	} while (unlikely(success == 0));
+
+	*old_head = head;
+	*entries_left = entries - n;
+	return n;
+}
+
+/* Move the tail of the producers or consumers, in head order. */
+static void
+soring_update_tail(struct soring_headtail *ht, uint32_t old, uint32_t n)
+{
+	if (ht->sync_type != RTE_RING_SYNC_ST)
+		rte_wait_until_equal_32(&ht->tail, old, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&ht->tail, old + n, __ATOMIC_RELEASE);
+}
+
+static uint32_t
+soring_enqueue(struct rte_soring *r, const void *objs, uint32_t n,
+	       enum rte_ring_queue_behavior behavior, uint32_t *free_space)
+{
+	uint32_t head, free;
+
+	n = soring_move_head(&r->prod, &r->cons.tail,
+			     rte_soring_get_capacity(r), n, behavior,
+			     &head, &free);
+	if (n != 0) {
+		soring_copy_in(r, head, objs, n);
+		soring_update_tail(&r->prod, head, n);
+	}
+
+	if (free_space != NULL)
+		*free_space = free;
+	return n;
+}
+
+static uint32_t
+soring_dequeue(struct rte_soring *r, void *objs, uint32_t n,
+	       enum rte_ring_queue_behavior behavior, uint32_t *available)
+{
+	uint32_t head, entries;
+
+	n = soring_move_head(&r->cons, &r->stage[r->nb_stage - 1].tail, 0,
+			     n, behavior, &head, &entries);
+	if (n != 0) {
+		soring_copy_out(r, head, objs, n);
+		soring_update_tail(&r->cons, head, n);
+	}
+
+	if (available != NULL)
+		*available = entries;
+	return n;
+}
+
+static uint32_t
+soring_acquire(struct rte_soring *r, void *objs, uint32_t stage,
+	       uint32_t n, enum rte_ring_queue_behavior behavior,
+	       uint32_t *ftoken, uint32_t *available)
+{
+	const volatile uint32_t *limit;
+	uint32_t head, entries;
+
+	RTE_ASSERT(stage < r->nb_stage);
+
+	limit = (stage == 0) ? &r->prod.tail : &r->stage[stage - 1].tail;
+	n = soring_move_head(&r->stage[stage], limit, 0, n, behavior,
+			     &head, &entries);
+	if (n != 0 && objs != NULL)
+		soring_copy_out(r, head, objs, n);
+
+	*ftoken = head;
+	if (available != NULL)
+		*available = entries;
+	return n;
+}
+
+uint32_t
+rte_soring_enqueue_bulk(struct rte_soring *r, const void *objs, uint32_t n,
+			uint32_t *free_space)
+{
+	return soring_enqueue(r, objs, n, RTE_RING_QUEUE_FIXED, free_space);
+}
+
+uint32_t
+rte_soring_enqueue_burst(struct rte_soring *r, const void *objs, uint32_t n,
+			 uint32_t *free_space)
+{
+	return soring_enqueue(r, objs, n, RTE_RING_QUEUE_VARIABLE,
+			      free_space);
+}
+
+uint32_t
+rte_soring_dequeue_bulk(struct rte_soring *r, void *objs, uint32_t n,
+			uint32_t *available)
+{
+	return soring_dequeue(r, objs, n, RTE_RING_QUEUE_FIXED, available);
+}
+
+uint32_t
+rte_soring_dequeue_burst(struct rte_soring *r, void *objs, uint32_t n,
+			 uint32_t *available)
+{
+	return soring_dequeue(r, objs, n, RTE_RING_QUEUE_VARIABLE, available);
+}
+
+uint32_t
+rte_soring_acquire_bulk(struct rte_soring *r, void *objs, uint32_t stage,
+			uint32_t n, uint32_t *ftoken, uint32_t *available)
+{
+	return soring_acquire(r, objs, stage, n, RTE_RING_QUEUE_FIXED,
+			      ftoken, available);
+}
+
+uint32_t
+rte_soring_acquire_burst(struct rte_soring *r, void *objs, uint32_t stage,
+			 uint32_t n, uint32_t *ftoken, uint32_t *available)
+{
+	return soring_acquire(r, objs, stage, n, RTE_RING_QUEUE_VARIABLE,
+			      ftoken, available);
+}
+
+void
+rte_soring_release(struct rte_soring *r, const void *objs, uint32_t stage,
+		   uint32_t n, uint32_t ftoken)
+{
+	struct soring_headtail *ht;
+	union soring_state *state;
+	union soring_state st;
+	uint32_t tail, len;
+
+	RTE_ASSERT(stage < r->nb_stage);
+
+	if (n == 0)
+		return;
+	if (objs != NULL)
+		soring_copy_in(r, ftoken, objs, n);
+
+	ht = &r->stage[stage];
+	state = &r->state[(size_t)stage * r->size];
+
+	/*
+	 * Publish the release before reading the tail: either this thread
+	 * sees the tail reach ftoken, or the thread moving it there sees
+	 * this release.
+	 */
+	st.ftoken = ftoken;
+	st.n = n;
+	__atomic_store_n(&state[ftoken & r->mask].raw, st.raw,
+			 __ATOMIC_SEQ_CST);
+
+	/* Move the tail over the releases which follow it in ring order. */
+	tail = __atomic_load_n(&ht->tail, __ATOMIC_SEQ_CST);
+	for (;;) {
+		st.raw = __atomic_load_n(&state[tail & r->mask].raw,
+					 __ATOMIC_SEQ_CST);
+		if (st.ftoken != tail || st.n == 0)
+			break;
+
+		/* On failure, tail is updated with the current one. */
+		len = st.n;
+		if (__atomic_compare_exchange_n(&ht->tail, &tail, tail + len,
+				0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+			/*
+			 * Forget the release so that it is not mistaken for
+			 * a later one once the positions wrap around, unless
+			 * the entry is already reused.
+			 */
+			__atomic_compare_exchange_n(&state[tail & r->mask].raw,
+					&st.raw, 0, 0, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED);
+			tail += len;
+		}
+	}
+}
@@ -0,0 +1,358 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#ifndef _RTE_SORING_H_
+#define _RTE_SORING_H_
+
+/**
+ * @file
+ * RTE Staged-Ordered Ring (SORING)
+ *
+ * A ring of fixed-size elements which are passed through a sequence of
+ * processing stages in place, before being dequeued:
+ *
+ *   enqueue -> stage 0 -> stage 1 -> ... -> stage N-1 -> dequeue
+ *
+ * Each stage acquires the elements released by the previous stage (the
+ * producer for the first stage) in ring order, processes them, possibly
+ * modifies them, and releases them to the next stage. Several threads may
+ * acquire and release elements of the same stage concurrently: elements
+ * may be released in any order, but they become available to the next
+ * stage only in ring order. Hence the order of the elements is kept from
+ * enqueue to dequeue, with no copy into an intermediate ring between the
+ * stages.
+ *
+ * The number of elements the ring can hold may be changed at runtime, up
+ * to the number given at init.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <rte_compat.h>
+#include <rte_ring_core.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of stages of a staged-ordered ring. */
+#define RTE_SORING_STAGE_MAX 16
+
+/** Staged-ordered ring, see rte_soring_init(). */
+struct rte_soring;
+
+/**
+ * Parameters of a staged-ordered ring.
+ */
+struct rte_soring_param {
+	/** Name of the ring, for debug purposes. */
+	const char *name;
+	/** Maximum number of elements in the ring. */
+	uint32_t elems;
+	/** Size of an element in bytes, must be a multiple of 4. */
+	uint32_t elem_size;
+	/** Number of processing stages, from 1 to RTE_SORING_STAGE_MAX. */
+	uint32_t stages;
+	/** Synchronization of producers, RTE_RING_SYNC_MT or ST. */
+	enum rte_ring_sync_type prod_synt;
+	/** Synchronization of consumers, RTE_RING_SYNC_MT or ST. */
+	enum rte_ring_sync_type cons_synt;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Calculate the memory size needed for a staged-ordered ring.
+ *
+ * @param prm
+ *   The parameters of the ring.
+ * @return
+ *   - The memory size needed for the ring on success.
+ *   - -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+ssize_t rte_soring_get_memsize(const struct rte_soring_param *prm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize a staged-ordered ring in a memory area.
+ *
+ * The memory area must be at least rte_soring_get_memsize() bytes long
+ * and aligned on a cache line. The ring is empty after init and can hold
+ * up to prm->elems elements.
+ *
+ * @param r
+ *   The memory area of the ring.
+ * @param prm
+ *   The parameters of the ring.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int rte_soring_init(struct rte_soring *r, const struct rte_soring_param *prm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Change the number of elements a staged-ordered ring can hold.
+ *
+ * Decreasing the capacity below the current number of elements is
+ * allowed: enqueue operations fail until enough elements are dequeued.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @param capacity
+ *   The new capacity, from 1 to the number of elements given at init.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the capacity is invalid.
+ */
+__rte_experimental
+int rte_soring_set_capacity(struct rte_soring *r, uint32_t capacity);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the number of elements a staged-ordered ring can hold.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @return
+ *   The capacity of the ring.
+ */
+__rte_experimental
+uint32_t rte_soring_get_capacity(const struct rte_soring *r);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the number of elements in a staged-ordered ring, whatever their
+ * stage.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @return
+ *   The number of elements in the ring.
+ */
+__rte_experimental
+uint32_t rte_soring_count(const struct rte_soring *r);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the number of elements which can be enqueued in a staged-ordered
+ * ring.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @return
+ *   The number of free entries in the ring.
+ */
+__rte_experimental
+uint32_t rte_soring_free_count(const struct rte_soring *r);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dump the status of a staged-ordered ring.
+ *
+ * @param f
+ *   A pointer to a file for output.
+ * @param r
+ *   A pointer to the ring.
+ */
+__rte_experimental
+void rte_soring_dump(FILE *f, const struct rte_soring *r);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue several elements on a staged-ordered ring, all or nothing.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @param objs
+ *   The array of elements to enqueue.
+ * @param n
+ *   The number of elements to enqueue.
+ * @param free_space
+ *   If non-NULL, returns the number of free entries after the operation.
+ * @return
+ *   The number of elements enqueued, either 0 or n.
+ */
+__rte_experimental
+uint32_t rte_soring_enqueue_bulk(struct rte_soring *r, const void *objs,
+		uint32_t n, uint32_t *free_space);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue up to n elements on a staged-ordered ring.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @param objs
+ *   The array of elements to enqueue.
+ * @param n
+ *   The maximum number of elements to enqueue.
+ * @param free_space
+ *   If non-NULL, returns the number of free entries after the operation.
+ * @return
+ *   The number of elements enqueued, from 0 to n.
+ */
+__rte_experimental
+uint32_t rte_soring_enqueue_burst(struct rte_soring *r, const void *objs,
+		uint32_t n, uint32_t *free_space);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dequeue several elements released by the last stage of a staged-ordered
+ * ring, all or nothing.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @param objs
+ *   The array filled with the dequeued elements.
+ * @param n
+ *   The number of elements to dequeue.
+ * @param available
+ *   If non-NULL, returns the number of elements left to dequeue after the
+ *   operation.
+ * @return
+ *   The number of elements dequeued, either 0 or n.
+ */
+__rte_experimental
+uint32_t rte_soring_dequeue_bulk(struct rte_soring *r, void *objs,
+		uint32_t n, uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dequeue up to n elements released by the last stage of a
+ * staged-ordered ring.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @param objs
+ *   The array filled with the dequeued elements.
+ * @param n
+ *   The maximum number of elements to dequeue.
+ * @param available
+ *   If non-NULL, returns the number of elements left to dequeue after the
+ *   operation.
+ * @return
+ *   The number of elements dequeued, from 0 to n.
+ */
+__rte_experimental
+uint32_t rte_soring_dequeue_burst(struct rte_soring *r, void *objs,
+		uint32_t n, uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Acquire several elements for a stage of a staged-ordered ring, all or
+ * nothing.
+ *
+ * The elements are the next ones released by the previous stage, or
+ * enqueued for the first stage. They stay in the ring and must be given
+ * back with rte_soring_release() and the returned token.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @param objs
+ *   If non-NULL, the array filled with a copy of the acquired elements.
+ * @param stage
+ *   The stage index, from 0 to the number of stages minus 1.
+ * @param n
+ *   The number of elements to acquire.
+ * @param ftoken
+ *   Returns the token to give to rte_soring_release().
+ * @param available
+ *   If non-NULL, returns the number of elements left to acquire by the
+ *   stage after the operation.
+ * @return
+ *   The number of elements acquired, either 0 or n.
+ */
+__rte_experimental
+uint32_t rte_soring_acquire_bulk(struct rte_soring *r, void *objs,
+		uint32_t stage, uint32_t n, uint32_t *ftoken,
+		uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Acquire up to n elements for a stage of a staged-ordered ring.
+ *
+ * @see rte_soring_acquire_bulk()
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @param objs
+ *   If non-NULL, the array filled with a copy of the acquired elements.
+ * @param stage
+ *   The stage index, from 0 to the number of stages minus 1.
+ * @param n
+ *   The maximum number of elements to acquire.
+ * @param ftoken
+ *   Returns the token to give to rte_soring_release().
+ * @param available
+ *   If non-NULL, returns the number of elements left to acquire by the
+ *   stage after the operation.
+ * @return
+ *   The number of elements acquired, from 0 to n.
+ */
+__rte_experimental
+uint32_t rte_soring_acquire_burst(struct rte_soring *r, void *objs,
+		uint32_t stage, uint32_t n, uint32_t *ftoken,
+		uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Release elements acquired by a stage of a staged-ordered ring to the
+ * next stage, or to the consumers for the last stage.
+ *
+ * All the elements of an acquire operation are released at once. The
+ * acquire operations of a stage can be released in any order, but their
+ * elements are made available to the next stage in ring order.
+ *
+ * @param r
+ *   A pointer to the ring.
+ * @param objs
+ *   If non-NULL, the new value of the elements, else they are unchanged.
+ * @param stage
+ *   The stage index given to the acquire operation.
+ * @param n
+ *   The number of elements returned by the acquire operation.
+ * @param ftoken
+ *   The token returned by the acquire operation.
+ */
+__rte_experimental
+void rte_soring_release(struct rte_soring *r, const void *objs,
+		uint32_t stage, uint32_t n, uint32_t ftoken);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_SORING_H_ */
@@ -30,6 +30,8 @@ rte_stack_init(struct rte_stack *s, unsigned int count, uint32_t flags)
 
 	if (flags & RTE_STACK_F_LF)
 		rte_stack_lf_init(s, count);
+	else if (flags & RTE_STACK_F_LF_IDX)
+		rte_stack_lf_idx_init(s, count);
 	else
 		rte_stack_std_init(s);
 }
@@ -39,6 +41,8 @@ rte_stack_get_memsize(unsigned int count, uint32_t flags)
 {
 	if (flags & RTE_STACK_F_LF)
 		return rte_stack_lf_get_memsize(count);
+	else if (flags & RTE_STACK_F_LF_IDX)
+		return rte_stack_lf_idx_get_memsize(count);
 	else
 		return rte_stack_std_get_memsize(count);
 }
@@ -55,7 +59,8 @@ rte_stack_create(const char *name, unsigned int count, int socket_id,
 	unsigned int sz;
 	int ret;
 
-	if (flags & ~(RTE_STACK_F_LF)) {
+	if ((flags & ~(RTE_STACK_F_LF | RTE_STACK_F_LF_IDX)) ||
+	    (flags & RTE_STACK_F_LF && flags & RTE_STACK_F_LF_IDX)) {
 		STACK_LOG_ERR("Unsupported stack flags %#x\n", flags);
 		return NULL;
 	}
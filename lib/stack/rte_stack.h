@@ -59,6 +59,31 @@ struct rte_stack_lf {
 	struct rte_stack_lf_elem elems[] __rte_cache_aligned;
 };
 
+/* LIFO list of element indexes. The head holds the index of the top element
+ * in its low 32 bits and a modification tag in its high 32 bits, so that it is
+ * updated with a 64-bit CAS.
+ */
+struct rte_stack_lf_idx_list {
+	/** List head: top index and modification tag */
+	uint64_t head;
+	/** List len */
+	uint64_t len;
+};
+
+/* Structure containing two lock-free LIFO lists of indexes in a single array
+ * of elements: the stack itself and the list of free elements.
+ */
+struct rte_stack_lf_idx {
+	/** LIFO list of elements */
+	struct rte_stack_lf_idx_list used __rte_cache_aligned;
+	/** LIFO list of free elements */
+	struct rte_stack_lf_idx_list free __rte_cache_aligned;
+	/** Data pointer of each element, followed by the next index of each
+	 * element.
+	 */
+	void *objs[] __rte_cache_aligned;
+};
+
 /* Structure containing the LIFO, its current length, and a lock for mutual
  * exclusion.
  */
@@ -82,6 +107,8 @@ struct rte_stack {
 	union {
 		struct rte_stack_lf stack_lf; /**< Lock-free LIFO structure. */
 		struct rte_stack_std stack_std;	/**< LIFO structure. */
+		/** Index-based lock-free LIFO structure. */
+		struct rte_stack_lf_idx stack_lf_idx;
 	};
 } __rte_cache_aligned;
 
@@ -91,8 +118,17 @@ struct rte_stack {
  */
 #define RTE_STACK_F_LF 0x0001
 
+/**
+ * The stack uses lock-free push and pop functions based on element indexes,
+ * which only need a 64-bit CAS and are supported on all platforms. The
+ * elements take less memory than with RTE_STACK_F_LF, but the ABA problem is
+ * prevented with a 32-bit modification tag instead of a 64-bit one.
+ */
+#define RTE_STACK_F_LF_IDX 0x0002
+
 #include "rte_stack_std.h"
 #include "rte_stack_lf.h"
+#include "rte_stack_lf_idx.h"
 
 /**
  * Push several objects on the stack (MT-safe).
@@ -114,6 +150,8 @@ rte_stack_push(struct rte_stack *s, void * const *obj_table, unsigned int n)
 
 	if (s->flags & RTE_STACK_F_LF)
 		return __rte_stack_lf_push(s, obj_table, n);
+	else if (s->flags & RTE_STACK_F_LF_IDX)
+		return __rte_stack_lf_idx_push(s, obj_table, n);
 	else
 		return __rte_stack_std_push(s, obj_table, n);
 }
@@ -138,6 +176,8 @@ rte_stack_pop(struct rte_stack *s, void **obj_table, unsigned int n)
 
 	if (s->flags & RTE_STACK_F_LF)
 		return __rte_stack_lf_pop(s, obj_table, n);
+	else if (s->flags & RTE_STACK_F_LF_IDX)
+		return __rte_stack_lf_idx_pop(s, obj_table, n);
 	else
 		return __rte_stack_std_pop(s, obj_table, n);
 }
@@ -157,6 +197,8 @@ rte_stack_count(struct rte_stack *s)
 
 	if (s->flags & RTE_STACK_F_LF)
 		return __rte_stack_lf_count(s);
+	else if (s->flags & RTE_STACK_F_LF_IDX)
+		return __rte_stack_lf_idx_count(s);
 	else
 		return __rte_stack_std_count(s);
 }
@@ -196,6 +238,9 @@ rte_stack_free_count(struct rte_stack *s)
  *    - RTE_STACK_F_LF: If this flag is set, the stack uses lock-free
  *      variants of the push and pop functions. Otherwise, it achieves
  *      thread-safety using a lock.
+ *    - RTE_STACK_F_LF_IDX: If this flag is set, the stack uses index-based
+ *      lock-free variants of the push and pop functions. It cannot be
+ *      combined with RTE_STACK_F_LF.
  * @return
  *   On success, the pointer to the new allocated stack. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
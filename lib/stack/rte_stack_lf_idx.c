@@ -0,0 +1,39 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#include "rte_stack.h"
+
+void
+rte_stack_lf_idx_init(struct rte_stack *s, unsigned int count)
+{
+	struct rte_stack_lf_idx *lf = &s->stack_lf_idx;
+	uint32_t *next = (uint32_t *)&lf->objs[count];
+	unsigned int i;
+
+	/* All the elements are linked in index order in the free list. */
+	for (i = 0; i < count; i++)
+		next[i] = (i + 1 < count) ? i + 1 : __RTE_STACK_LF_IDX_NONE;
+
+	lf->free.head = __RTE_STACK_LF_IDX_HEAD(count != 0 ? 0 :
+						__RTE_STACK_LF_IDX_NONE, 0);
+	lf->free.len = count;
+	lf->used.head = __RTE_STACK_LF_IDX_HEAD(__RTE_STACK_LF_IDX_NONE, 0);
+	lf->used.len = 0;
+}
+
+ssize_t
+rte_stack_lf_idx_get_memsize(unsigned int count)
+{
+	ssize_t sz = sizeof(struct rte_stack);
+
+	sz += RTE_CACHE_LINE_ROUNDUP(count * (sizeof(void *) +
+					      sizeof(uint32_t)));
+
+	/* Add padding to avoid false sharing conflicts caused by
+	 * next-line hardware prefetchers.
+	 */
+	sz += 2 * RTE_CACHE_LINE_SIZE;
+
+	return sz;
+}
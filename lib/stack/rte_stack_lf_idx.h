@@ -0,0 +1,244 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 OKTET Labs Ltd.
+ */
+
+#ifndef _RTE_STACK_LF_IDX_H_
+#define _RTE_STACK_LF_IDX_H_
+
+#include <rte_branch_prediction.h>
+#include <rte_prefetch.h>
+
+/* Index of the end of a list */
+#define __RTE_STACK_LF_IDX_NONE UINT32_MAX
+
+/* List head from a top index and a modification tag */
+#define __RTE_STACK_LF_IDX_HEAD(top, tag) \
+	(((uint64_t)(tag) << 32) | (uint32_t)(top))
+
+/* Top index of a list head */
+#define __RTE_STACK_LF_IDX_TOP(head) ((uint32_t)(head))
+
+/* Modification tag of a list head */
+#define __RTE_STACK_LF_IDX_TAG(head) ((uint32_t)((head) >> 32))
+
+/* The next index of each element follows the data pointers. */
+static __rte_always_inline uint32_t *
+__rte_stack_lf_idx_next(struct rte_stack *s)
+{
+	return (uint32_t *)&s->stack_lf_idx.objs[s->capacity];
+}
+
+static __rte_always_inline unsigned int
+__rte_stack_lf_idx_count(struct rte_stack *s)
+{
+	/* As for the pointer-based lock-free stack, the length is updated
+	 * after the list, so that the stack may appear to have fewer elements
+	 * than it does, but never more.
+	 */
+	return (unsigned int)__atomic_load_n(&s->stack_lf_idx.used.len,
+					     __ATOMIC_RELAXED);
+}
+
+static __rte_always_inline void
+__rte_stack_lf_idx_push_elems(struct rte_stack_lf_idx_list *list,
+			      uint32_t *next, uint32_t first, uint32_t last,
+			      unsigned int num)
+{
+	uint64_t old_head, new_head;
+
+	old_head = __atomic_load_n(&list->head, __ATOMIC_RELAXED);
+
+	do {
+		/* Swing the top index to the first element in the list and
+		 * make the last element point to the old top.
+		 */
+		next[last] = __RTE_STACK_LF_IDX_TOP(old_head);
+		new_head = __RTE_STACK_LF_IDX_HEAD(first,
+				__RTE_STACK_LF_IDX_TAG(old_head) + 1);
+
+		/* Use the release memmodel to ensure the writes to the
+		 * elements are visible before the head write.
+		 */
+	} while (!__atomic_compare_exchange_n(&list->head, &old_head,
+					      new_head, 1, __ATOMIC_RELEASE,
+					      __ATOMIC_RELAXED));
+
+	/* Ensure the stack modifications are not reordered with respect
+	 * to the LIFO len update.
+	 */
+	__atomic_add_fetch(&list->len, num, __ATOMIC_RELEASE);
+}
+
+static __rte_always_inline uint32_t
+__rte_stack_lf_idx_pop_elems(struct rte_stack_lf_idx_list *list,
+			     void * const *objs, const uint32_t *next,
+			     uint32_t capacity, unsigned int num,
+			     void **obj_table, uint32_t *last)
+{
+	uint64_t old_head, new_head, len;
+	unsigned int i;
+	uint32_t idx;
+
+	/* Reserve num elements, if available */
+	len = __atomic_load_n(&list->len, __ATOMIC_RELAXED);
+
+	while (1) {
+		/* Does the list contain enough elements? */
+		if (unlikely(len < num))
+			return __RTE_STACK_LF_IDX_NONE;
+
+		/* len is updated on failure */
+		if (__atomic_compare_exchange_n(&list->len,
+						&len, len - num,
+						1, __ATOMIC_ACQUIRE,
+						__ATOMIC_RELAXED))
+			break;
+	}
+
+	/* Use the acquire memmodel to ensure the reads of the elements are
+	 * ordered after the head read, here and on CAS failure.
+	 */
+	old_head = __atomic_load_n(&list->head, __ATOMIC_ACQUIRE);
+
+	/* Pop num elements */
+	for (;;) {
+		idx = __RTE_STACK_LF_IDX_TOP(old_head);
+
+		/* Traverse the list to find the new head. A next index will
+		 * either be another element or the end of the list; if a
+		 * thread encounters an element that has already been popped,
+		 * the tag of the head has changed and the CAS will fail.
+		 */
+		for (i = 0; i < num && idx < capacity; i++) {
+			if (obj_table)
+				obj_table[i] = objs[idx];
+			*last = idx;
+			idx = next[idx];
+		}
+
+		/* If the end was encountered, the list was modified while
+		 * traversing it. Retry with the current head.
+		 */
+		if (i != num) {
+			old_head = __atomic_load_n(&list->head,
+						   __ATOMIC_ACQUIRE);
+			continue;
+		}
+
+		new_head = __RTE_STACK_LF_IDX_HEAD(idx,
+				__RTE_STACK_LF_IDX_TAG(old_head) + 1);
+
+		/* As for the pointer-based lock-free stack, the elements
+		 * popped from the used list are pushed to the free list
+		 * with a CAS store-release, which orders the reads above
+		 * before they are reused. old_head is updated on failure.
+		 */
+		if (__atomic_compare_exchange_n(&list->head, &old_head,
+						new_head, 0, __ATOMIC_ACQUIRE,
+						__ATOMIC_ACQUIRE))
+			break;
+	}
+
+	return __RTE_STACK_LF_IDX_TOP(old_head);
+}
+
+/**
+ * @internal Push several objects on the index-based lock-free stack
+ * (MT-safe).
+ *
+ * @param s
+ *   A pointer to the stack structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to push on the stack from the obj_table.
+ * @return
+ *   Actual number of objects enqueued.
+ */
+static __rte_always_inline unsigned int
+__rte_stack_lf_idx_push(struct rte_stack *s,
+			void * const *obj_table,
+			unsigned int n)
+{
+	struct rte_stack_lf_idx *lf = &s->stack_lf_idx;
+	uint32_t *next = __rte_stack_lf_idx_next(s);
+	uint32_t idx, first, last = 0;
+	unsigned int i;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	/* Pop n free elements */
+	first = __rte_stack_lf_idx_pop_elems(&lf->free, lf->objs, next,
+					     s->capacity, n, NULL, &last);
+	if (unlikely(first == __RTE_STACK_LF_IDX_NONE))
+		return 0;
+
+	/* Set the data of the elements */
+	for (idx = first, i = 0; i < n; i++, idx = next[idx])
+		lf->objs[idx] = obj_table[n - i - 1];
+
+	/* Push them to the used list */
+	__rte_stack_lf_idx_push_elems(&lf->used, next, first, last, n);
+
+	return n;
+}
+
+/**
+ * @internal Pop several objects from the index-based lock-free stack
+ * (MT-safe).
+ *
+ * @param s
+ *   A pointer to the stack structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to pull from the stack.
+ * @return
+ *   - Actual number of objects popped.
+ */
+static __rte_always_inline unsigned int
+__rte_stack_lf_idx_pop(struct rte_stack *s, void **obj_table, unsigned int n)
+{
+	struct rte_stack_lf_idx *lf = &s->stack_lf_idx;
+	uint32_t *next = __rte_stack_lf_idx_next(s);
+	uint32_t first, last = 0;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	/* Pop n used elements */
+	first = __rte_stack_lf_idx_pop_elems(&lf->used, lf->objs, next,
+					     s->capacity, n, obj_table, &last);
+	if (unlikely(first == __RTE_STACK_LF_IDX_NONE))
+		return 0;
+
+	/* Push the elements to the free list */
+	__rte_stack_lf_idx_push_elems(&lf->free, next, first, last, n);
+
+	return n;
+}
+
+/**
+ * @internal Initialize an index-based lock-free stack.
+ *
+ * @param s
+ *   A pointer to the stack structure.
+ * @param count
+ *   The size of the stack.
+ */
+void
+rte_stack_lf_idx_init(struct rte_stack *s, unsigned int count);
+
+/**
+ * @internal Return the memory required for an index-based lock-free stack.
+ *
+ * @param count
+ *   The size of the stack.
+ * @return
+ *   The bytes to allocate for an index-based lock-free stack.
+ */
+ssize_t
+rte_stack_lf_idx_get_memsize(unsigned int count);
+
+#endif /* _RTE_STACK_LF_IDX_H_ */
@@ -6,6 +6,7 @@
 #include <numaif.h>
 #endif
 
+#include <rte_malloc.h>
 #include <rte_tailq.h>
 
 #include "iotlb.h"
@@ -20,10 +21,31 @@ struct vhost_iotlb_entry {
 	uint8_t perm;
 };
 
+/*
+ * The cache is an array of entries sorted by IOVA, so that a translation
+ * is a binary search. The entry found last is checked first, as most of
+ * the translations of a burst hit the same mapping.
+ *
+ * Readers do not lock the cache. Writers, serialized by iotlb_lock, update
+ * a copy of the array and publish it, then wait for the reader of the
+ * virtqueue to leave its read-side section before reusing the previous
+ * array for the next update.
+ */
+struct vhost_iotlb_cache_entry {
+	uint64_t iova;
+	uint64_t uaddr;
+	uint64_t size;
+	/* Tick of the last lookup which found the entry, for LRU eviction */
+	uint64_t last_used;
+	uint8_t perm;
+};
+
 #define IOTLB_CACHE_SIZE 2048
 
-static void
-vhost_user_iotlb_cache_random_evict(struct vhost_virtqueue *vq);
+struct vhost_iotlb_cache {
+	int nr;
+	struct vhost_iotlb_cache_entry entries[IOTLB_CACHE_SIZE];
+};
 
 static void
 vhost_user_iotlb_pending_remove_all(struct vhost_virtqueue *vq)
@@ -73,10 +95,7 @@ vhost_user_iotlb_pending_insert(struct virtio_net *dev, struct vhost_virtqueue *
 		VHOST_LOG_CONFIG(DEBUG,
 				"(%s) IOTLB pool %s empty, clear entries for pending insertion\n",
 				dev->ifname, vq->iotlb_pool->name);
-		if (!TAILQ_EMPTY(&vq->iotlb_pending_list))
-			vhost_user_iotlb_pending_remove_all(vq);
-		else
-			vhost_user_iotlb_cache_random_evict(vq);
+		vhost_user_iotlb_pending_remove_all(vq);
 		ret = rte_mempool_get(vq->iotlb_pool, (void **)&node);
 		if (ret) {
 			VHOST_LOG_CONFIG(ERR,
@@ -119,44 +138,80 @@ vhost_user_iotlb_pending_remove(struct vhost_virtqueue *vq,
 	rte_rwlock_write_unlock(&vq->iotlb_pending_lock);
 }
 
+/* Called with iotlb_lock held */
 static void
-vhost_user_iotlb_cache_remove_all(struct vhost_virtqueue *vq)
+vhost_user_iotlb_cache_publish(struct vhost_virtqueue *vq,
+		struct vhost_iotlb_cache *next)
 {
-	struct vhost_iotlb_entry *node, *temp_node;
+	struct vhost_iotlb_cache *prev = vq->iotlb_cache;
+	uint64_t seq;
 
-	rte_rwlock_write_lock(&vq->iotlb_lock);
-
-	RTE_TAILQ_FOREACH_SAFE(node, &vq->iotlb_list, next, temp_node) {
-		TAILQ_REMOVE(&vq->iotlb_list, node, next);
-		rte_mempool_put(vq->iotlb_pool, node);
-	}
+	__atomic_store_n(&vq->iotlb_cache, next, __ATOMIC_RELEASE);
+	/* Pairs with the fence of vhost_user_iotlb_rd_lock() */
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
 
-	vq->iotlb_cache_nr = 0;
+	/* A reader in its read-side section may still use the previous array. */
+	seq = __atomic_load_n(&vq->iotlb_rd_seq, __ATOMIC_ACQUIRE);
+	if (seq & 1)
+		while (__atomic_load_n(&vq->iotlb_rd_seq, __ATOMIC_ACQUIRE) == seq)
+			rte_pause();
 
-	rte_rwlock_write_unlock(&vq->iotlb_lock);
+	vq->iotlb_cache_next = prev;
 }
 
 static void
-vhost_user_iotlb_cache_random_evict(struct vhost_virtqueue *vq)
+vhost_user_iotlb_cache_remove_all(struct vhost_virtqueue *vq)
 {
-	struct vhost_iotlb_entry *node, *temp_node;
-	int entry_idx;
+	rte_spinlock_lock(&vq->iotlb_lock);
+
+	if (vq->iotlb_cache->nr != 0) {
+		vq->iotlb_cache_next->nr = 0;
+		vhost_user_iotlb_cache_publish(vq, vq->iotlb_cache_next);
+	}
 
-	rte_rwlock_write_lock(&vq->iotlb_lock);
+	rte_spinlock_unlock(&vq->iotlb_lock);
+}
 
-	entry_idx = rte_rand() % vq->iotlb_cache_nr;
+/* Index of the last entry whose IOVA is lower than or equal to iova, or -1 */
+static __rte_always_inline int
+vhost_user_iotlb_cache_search(const struct vhost_iotlb_cache *cache,
+		uint64_t iova)
+{
+	const struct vhost_iotlb_cache_entry *entries = cache->entries;
+	int lo = 0, hi = cache->nr, mid;
 
-	RTE_TAILQ_FOREACH_SAFE(node, &vq->iotlb_list, next, temp_node) {
-		if (!entry_idx) {
-			TAILQ_REMOVE(&vq->iotlb_list, node, next);
-			rte_mempool_put(vq->iotlb_pool, node);
-			vq->iotlb_cache_nr--;
-			break;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (entries[mid].iova <= iova)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo - 1;
+}
+
+/* Called with iotlb_lock held, on the unpublished copy */
+static void
+vhost_user_iotlb_cache_lru_evict(struct vhost_virtqueue *vq,
+		struct vhost_iotlb_cache *cache)
+{
+	struct vhost_iotlb_cache_entry *entries = cache->entries;
+	int last_hit = __atomic_load_n(&vq->iotlb_last_hit, __ATOMIC_RELAXED);
+	uint64_t oldest = UINT64_MAX;
+	int i, victim = 0;
+
+	/* The last hit entry is in use even if it has not been stamped lately. */
+	for (i = 0; i < cache->nr; i++) {
+		if (i != last_hit && entries[i].last_used < oldest) {
+			oldest = entries[i].last_used;
+			victim = i;
 		}
-		entry_idx--;
 	}
 
-	rte_rwlock_write_unlock(&vq->iotlb_lock);
+	memmove(&entries[victim], &entries[victim + 1],
+		(cache->nr - victim - 1) * sizeof(*entries));
+	cache->nr--;
 }
 
 void
@@ -164,56 +219,50 @@ vhost_user_iotlb_cache_insert(struct virtio_net *dev, struct vhost_virtqueue *vq
 				uint64_t iova, uint64_t uaddr,
 				uint64_t size, uint8_t perm)
 {
-	struct vhost_iotlb_entry *node, *new_node;
-	int ret;
-
-	ret = rte_mempool_get(vq->iotlb_pool, (void **)&new_node);
-	if (ret) {
-		VHOST_LOG_CONFIG(DEBUG,
-				"(%s) IOTLB pool %s empty, clear entries for cache insertion\n",
-				dev->ifname, vq->iotlb_pool->name);
-		if (!TAILQ_EMPTY(&vq->iotlb_list))
-			vhost_user_iotlb_cache_random_evict(vq);
-		else
-			vhost_user_iotlb_pending_remove_all(vq);
-		ret = rte_mempool_get(vq->iotlb_pool, (void **)&new_node);
-		if (ret) {
-			VHOST_LOG_CONFIG(ERR,
-					"(%s) IOTLB pool %s still empty, cache insertion failed\n",
-					dev->ifname, vq->iotlb_pool->name);
-			return;
-		}
+	struct vhost_iotlb_cache *cache;
+	struct vhost_iotlb_cache_entry *entries;
+	int idx;
+
+	rte_spinlock_lock(&vq->iotlb_lock);
+
+	cache = vq->iotlb_cache;
+	idx = vhost_user_iotlb_cache_search(cache, iova);
+	/*
+	 * Entries must be invalidated before being updated.
+	 * So if iova already in cache, assume identical.
+	 */
+	if (idx >= 0 && cache->entries[idx].iova == iova)
+		goto unlock;
+
+	cache = vq->iotlb_cache_next;
+	entries = cache->entries;
+	memcpy(entries, vq->iotlb_cache->entries,
+		vq->iotlb_cache->nr * sizeof(*entries));
+	cache->nr = vq->iotlb_cache->nr;
+
+	if (cache->nr == IOTLB_CACHE_SIZE) {
+		VHOST_LOG_CONFIG(DEBUG, "(%s) IOTLB cache full, evict LRU entry\n",
+				dev->ifname);
+		vhost_user_iotlb_cache_lru_evict(vq, cache);
+		idx = vhost_user_iotlb_cache_search(cache, iova);
 	}
 
-	new_node->iova = iova;
-	new_node->uaddr = uaddr;
-	new_node->size = size;
-	new_node->perm = perm;
+	idx++;
+	memmove(&entries[idx + 1], &entries[idx],
+		(cache->nr - idx) * sizeof(*entries));
+	entries[idx].iova = iova;
+	entries[idx].uaddr = uaddr;
+	entries[idx].size = size;
+	entries[idx].last_used = vq->iotlb_lru_tick;
+	entries[idx].perm = perm;
+	cache->nr++;
 
-	rte_rwlock_write_lock(&vq->iotlb_lock);
-
-	TAILQ_FOREACH(node, &vq->iotlb_list, next) {
-		/*
-		 * Entries must be invalidated before being updated.
-		 * So if iova already in list, assume identical.
-		 */
-		if (node->iova == new_node->iova) {
-			rte_mempool_put(vq->iotlb_pool, new_node);
-			goto unlock;
-		} else if (node->iova > new_node->iova) {
-			TAILQ_INSERT_BEFORE(node, new_node, next);
-			vq->iotlb_cache_nr++;
-			goto unlock;
-		}
-	}
-
-	TAILQ_INSERT_TAIL(&vq->iotlb_list, new_node, next);
-	vq->iotlb_cache_nr++;
+	vhost_user_iotlb_cache_publish(vq, cache);
 
 unlock:
 	vhost_user_iotlb_pending_remove(vq, iova, size, perm);
 
-	rte_rwlock_write_unlock(&vq->iotlb_lock);
+	rte_spinlock_unlock(&vq->iotlb_lock);
 
 }
 
@@ -221,40 +270,72 @@ void
 vhost_user_iotlb_cache_remove(struct vhost_virtqueue *vq,
 					uint64_t iova, uint64_t size)
 {
-	struct vhost_iotlb_entry *node, *temp_node;
+	const struct vhost_iotlb_cache_entry *entries;
+	struct vhost_iotlb_cache *next;
+	int i, nr = 0;
 
 	if (unlikely(!size))
 		return;
 
-	rte_rwlock_write_lock(&vq->iotlb_lock);
+	rte_spinlock_lock(&vq->iotlb_lock);
 
-	RTE_TAILQ_FOREACH_SAFE(node, &vq->iotlb_list, next, temp_node) {
-		/* Sorted list */
-		if (unlikely(iova + size < node->iova))
-			break;
+	entries = vq->iotlb_cache->entries;
+	next = vq->iotlb_cache_next;
 
-		if (iova < node->iova + node->size) {
-			TAILQ_REMOVE(&vq->iotlb_list, node, next);
-			rte_mempool_put(vq->iotlb_pool, node);
-			vq->iotlb_cache_nr--;
-		}
+	/* Copy the sorted array, dropping the entries in the range. */
+	for (i = 0; i < vq->iotlb_cache->nr; i++) {
+		if (iova + size >= entries[i].iova &&
+				iova < entries[i].iova + entries[i].size)
+			continue;
+		next->entries[nr++] = entries[i];
 	}
+	next->nr = nr;
+
+	if (nr != vq->iotlb_cache->nr)
+		vhost_user_iotlb_cache_publish(vq, next);
 
-	rte_rwlock_write_unlock(&vq->iotlb_lock);
+	rte_spinlock_unlock(&vq->iotlb_lock);
 }
 
+/* Called in an IOTLB read-side section, see vhost_user_iotlb_rd_lock() */
 uint64_t
 vhost_user_iotlb_cache_find(struct vhost_virtqueue *vq, uint64_t iova,
 						uint64_t *size, uint8_t perm)
 {
-	struct vhost_iotlb_entry *node;
+	struct vhost_iotlb_cache *cache;
+	struct vhost_iotlb_cache_entry *node;
 	uint64_t offset, vva = 0, mapped = 0;
+	uint64_t tick;
+	int idx;
 
 	if (unlikely(!*size))
 		goto out;
 
-	TAILQ_FOREACH(node, &vq->iotlb_list, next) {
-		/* List sorted by iova */
+	cache = __atomic_load_n(&vq->iotlb_cache, __ATOMIC_ACQUIRE);
+
+	/*
+	 * The last hit index and the LRU ticks are only hints, updated
+	 * concurrently with the writers, and are accessed relaxed.
+	 */
+	idx = __atomic_load_n(&vq->iotlb_last_hit, __ATOMIC_RELAXED);
+	if (unlikely(idx >= cache->nr || iova < cache->entries[idx].iova ||
+			iova >= cache->entries[idx].iova + cache->entries[idx].size)) {
+		idx = vhost_user_iotlb_cache_search(cache, iova);
+		if (unlikely(idx < 0 || iova >= cache->entries[idx].iova +
+				cache->entries[idx].size))
+			goto out;
+
+		tick = __atomic_load_n(&vq->iotlb_lru_tick, __ATOMIC_RELAXED) + 1;
+		__atomic_store_n(&vq->iotlb_lru_tick, tick, __ATOMIC_RELAXED);
+		__atomic_store_n(&cache->entries[idx].last_used, tick,
+				__ATOMIC_RELAXED);
+		__atomic_store_n(&vq->iotlb_last_hit, idx, __ATOMIC_RELAXED);
+	}
+
+	for (; idx < cache->nr; idx++) {
+		node = &cache->entries[idx];
+
+		/* Array sorted by iova */
 		if (unlikely(iova < node->iova))
 			break;
 
@@ -312,12 +393,32 @@ vhost_user_iotlb_init(struct virtio_net *dev, int vq_index)
 		socket = 0;
 #endif
 
-	rte_rwlock_init(&vq->iotlb_lock);
+	rte_spinlock_init(&vq->iotlb_lock);
 	rte_rwlock_init(&vq->iotlb_pending_lock);
 
-	TAILQ_INIT(&vq->iotlb_list);
 	TAILQ_INIT(&vq->iotlb_pending_list);
 
+	rte_free(vq->iotlb_cache);
+	rte_free(vq->iotlb_cache_next);
+	vq->iotlb_cache = rte_zmalloc_socket("iotlb_cache",
+			sizeof(struct vhost_iotlb_cache), RTE_CACHE_LINE_SIZE, socket);
+	vq->iotlb_cache_next = rte_zmalloc_socket("iotlb_cache",
+			sizeof(struct vhost_iotlb_cache), RTE_CACHE_LINE_SIZE, socket);
+	if (!vq->iotlb_cache || !vq->iotlb_cache_next) {
+		VHOST_LOG_CONFIG(ERR, "(%s) Failed to allocate IOTLB cache\n",
+				dev->ifname);
+		rte_free(vq->iotlb_cache);
+		rte_free(vq->iotlb_cache_next);
+		vq->iotlb_cache = NULL;
+		vq->iotlb_cache_next = NULL;
+		rte_mempool_free(vq->iotlb_pool);
+		vq->iotlb_pool = NULL;
+		return -1;
+	}
+	vq->iotlb_rd_seq = 0;
+	vq->iotlb_last_hit = 0;
+	vq->iotlb_lru_tick = 0;
+
 	snprintf(pool_name, sizeof(pool_name), "iotlb_%u_%d_%d",
 			getpid(), dev->vid, vq_index);
 	VHOST_LOG_CONFIG(DEBUG, "(%s) IOTLB cache name: %s\n", dev->ifname, pool_name);
@@ -337,7 +438,5 @@ vhost_user_iotlb_init(struct virtio_net *dev, int vq_index)
 		return -1;
 	}
 
-	vq->iotlb_cache_nr = 0;
-
 	return 0;
 }
@@ -7,37 +7,40 @@
 
 #include <stdbool.h>
 
+#include <rte_compat.h>
+
 #include "vhost.h"
 
+/*
+ * The reader of a virtqueue, which holds its access_lock, does not lock the
+ * IOTLB cache but marks its read-side section, so that the writers updating
+ * the cache know when the array it may use can be reused.
+ */
 static __rte_always_inline void
 vhost_user_iotlb_rd_lock(struct vhost_virtqueue *vq)
 {
-	rte_rwlock_read_lock(&vq->iotlb_lock);
-}
+	uint64_t seq = __atomic_load_n(&vq->iotlb_rd_seq, __ATOMIC_RELAXED);
 
-static __rte_always_inline void
-vhost_user_iotlb_rd_unlock(struct vhost_virtqueue *vq)
-{
-	rte_rwlock_read_unlock(&vq->iotlb_lock);
+	__atomic_store_n(&vq->iotlb_rd_seq, seq + 1, __ATOMIC_RELAXED);
+	/* Order the section start before the load of the cache array. */
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
 }
 
 static __rte_always_inline void
-vhost_user_iotlb_wr_lock(struct vhost_virtqueue *vq)
+vhost_user_iotlb_rd_unlock(struct vhost_virtqueue *vq)
 {
-	rte_rwlock_write_lock(&vq->iotlb_lock);
-}
+	uint64_t seq = __atomic_load_n(&vq->iotlb_rd_seq, __ATOMIC_RELAXED);
 
-static __rte_always_inline void
-vhost_user_iotlb_wr_unlock(struct vhost_virtqueue *vq)
-{
-	rte_rwlock_write_unlock(&vq->iotlb_lock);
+	__atomic_store_n(&vq->iotlb_rd_seq, seq + 1, __ATOMIC_RELEASE);
 }
 
+__rte_internal
 void vhost_user_iotlb_cache_insert(struct virtio_net *dev, struct vhost_virtqueue *vq,
 					uint64_t iova, uint64_t uaddr,
 					uint64_t size, uint8_t perm);
 void vhost_user_iotlb_cache_remove(struct vhost_virtqueue *vq,
 					uint64_t iova, uint64_t size);
+__rte_internal
 uint64_t vhost_user_iotlb_cache_find(struct vhost_virtqueue *vq, uint64_t iova,
 					uint64_t *size, uint8_t perm);
 bool vhost_user_iotlb_pending_miss(struct vhost_virtqueue *vq, uint64_t iova,
@@ -47,6 +50,7 @@ void vhost_user_iotlb_pending_insert(struct virtio_net *dev, struct vhost_virtqu
 void vhost_user_iotlb_pending_remove(struct vhost_virtqueue *vq, uint64_t iova,
 						uint64_t size, uint8_t perm);
 void vhost_user_iotlb_flush_all(struct vhost_virtqueue *vq);
+__rte_internal
 int vhost_user_iotlb_init(struct virtio_net *dev, int vq_index);
 
 #endif /* _VHOST_IOTLB_H_ */
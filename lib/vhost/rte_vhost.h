@@ -39,6 +39,8 @@ extern "C" {
 #define RTE_VHOST_USER_LINEARBUF_SUPPORT	(1ULL << 6)
 #define RTE_VHOST_USER_ASYNC_COPY	(1ULL << 7)
 #define RTE_VHOST_USER_NET_COMPLIANT_OL_FLAGS	(1ULL << 8)
+/* collect statistics of the virtqueues */
+#define RTE_VHOST_USER_NET_STATS_ENABLE	(1ULL << 9)
 
 /* Features. */
 #ifndef VIRTIO_NET_F_GUEST_ANNOUNCE
@@ -1063,6 +1065,168 @@ __rte_experimental
 int
 rte_vhost_slave_config_change(int vid, bool need_reply);
 
+/** Maximum name length of a virtqueue statistic. */
+#define RTE_VHOST_STATS_NAME_SIZE 64
+
+/**
+ * Name of a virtqueue statistic, see rte_vhost_vring_stats_get_names().
+ */
+struct rte_vhost_stat_name {
+	char name[RTE_VHOST_STATS_NAME_SIZE]; /**< Name of the statistic. */
+};
+
+/**
+ * Value of a virtqueue statistic, see rte_vhost_vring_stats_get().
+ */
+struct rte_vhost_stat {
+	uint64_t id;    /**< Index of the statistic in the names array. */
+	uint64_t value; /**< Value of the statistic. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the names of the statistics of a virtqueue.
+ *
+ * The statistics are collected if the vhost-user socket was registered
+ * with RTE_VHOST_USER_NET_STATS_ENABLE. The names are the same for all
+ * the virtqueues of a device.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param queue_id
+ *  virtqueue index
+ * @param name
+ *  array to fill with the names, or NULL to get the number of statistics
+ * @param size
+ *  number of elements of the name array
+ * @return
+ *  - the number of statistics on success, if greater than size, the
+ *    array was not filled.
+ *  - -EINVAL if the device or virtqueue is invalid.
+ *  - -ENOTSUP if the statistics are not enabled.
+ */
+__rte_experimental
+int
+rte_vhost_vring_stats_get_names(int vid, uint16_t queue_id,
+		struct rte_vhost_stat_name *name, unsigned int size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the statistics of a virtqueue.
+ *
+ * The statistics are:
+ * - the number of packets and bytes,
+ * - the TSC cycles spent in the bursts, in total and per packet,
+ * - the number of guest notifications,
+ * - the number of bursts per power of two range of burst size,
+ * - the number of packets per power of two range of guest buffer
+ *   segments, that is, of descriptors split at host memory boundaries.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param queue_id
+ *  virtqueue index
+ * @param stats
+ *  array to fill with the statistics
+ * @param n
+ *  number of elements of the stats array
+ * @return
+ *  - the number of statistics on success, if greater than n, the
+ *    array was not filled.
+ *  - -EINVAL if the device or virtqueue is invalid.
+ *  - -ENOTSUP if the statistics are not enabled.
+ */
+__rte_experimental
+int
+rte_vhost_vring_stats_get(int vid, uint16_t queue_id,
+		struct rte_vhost_stat *stats, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Reset the statistics of a virtqueue.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param queue_id
+ *  virtqueue index
+ * @return
+ *  - 0 on success.
+ *  - -EINVAL if the device or virtqueue is invalid.
+ *  - -ENOTSUP if the statistics are not enabled.
+ */
+__rte_experimental
+int
+rte_vhost_vring_stats_reset(int vid, uint16_t queue_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Configure the coalescing of the guest notifications of a virtqueue.
+ *
+ * When enabled, the notification of the guest for the buffers made used
+ * by a burst is deferred until max_pkts packets are pending notification,
+ * or until usecs microseconds have elapsed since the first of them was
+ * made used. The time threshold is checked on each enqueue or dequeue
+ * burst of the virtqueue, including empty ones, and on the completion
+ * polls of the asynchronous data path; an application which stops
+ * polling the virtqueue can flush the deferred notification with
+ * rte_vhost_vring_call(). The VIRTIO_RING_F_EVENT_IDX and notification
+ * suppression requested by the guest still apply when the notification
+ * is sent.
+ *
+ * The configuration is reset with the virtqueue, so it is typically set
+ * in the new_device() callback.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param queue_id
+ *  virtqueue index
+ * @param max_pkts
+ *  Number of packets which triggers the notification, 0 or 1 to notify
+ *  the guest on each burst (default).
+ * @param usecs
+ *  Maximum delay of a notification in microseconds, must not be 0 if
+ *  max_pkts is greater than 1.
+ * @return
+ *  - 0 on success.
+ *  - -EINVAL if the device, virtqueue or thresholds are invalid.
+ */
+__rte_experimental
+int
+rte_vhost_vring_coalesce_set(int vid, uint16_t queue_id, uint32_t max_pkts,
+		uint32_t usecs);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the guest notification coalescing configuration of a virtqueue.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param queue_id
+ *  virtqueue index
+ * @param max_pkts
+ *  Returns the number of packets which triggers the notification, 0 if
+ *  coalescing is disabled.
+ * @param usecs
+ *  Returns the maximum delay of a notification in microseconds.
+ * @return
+ *  - 0 on success.
+ *  - -EINVAL if the device or virtqueue is invalid.
+ */
+__rte_experimental
+int
+rte_vhost_vring_coalesce_get(int vid, uint16_t queue_id, uint32_t *max_pkts,
+		uint32_t *usecs);
+
 #ifdef __cplusplus
 }
 #endif
@@ -141,8 +141,8 @@ int rte_vhost_async_get_inflight(int vid, uint16_t queue_id);
 
 /**
  * This function checks async completion status and clear packets for
- * a specific vhost device queue. Packets which are inflight will be
- * returned in an array.
+ * a specific vhost device queue, enqueue or dequeue. Packets which are
+ * inflight will be returned in an array.
  *
  * @note This function does not perform any locking
  *
@@ -187,6 +187,42 @@ uint16_t rte_vhost_clear_queue_thread_unsafe(int vid, uint16_t queue_id,
 __rte_experimental
 int rte_vhost_async_dma_configure(int16_t dma_id, uint16_t vchan_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * This function tries to receive packets from the guest with offloading
+ * copies to the DMA vChannel. Successfully dequeued packets are returned
+ * in "pkts". The other packets that their copies are submitted to
+ * the DMA vChannel but not completed are called "in-flight packets".
+ * This function will not return in-flight packets until their copies are
+ * completed by the DMA vChannel, and they are returned in the order the
+ * guest sent them.
+ *
+ * @param vid
+ *  ID of vhost device to dequeue data
+ * @param queue_id
+ *  ID of virtqueue to dequeue data
+ * @param mbuf_pool
+ *  Mempool used to allocate mbufs for in-flight packets
+ * @param pkts
+ *  Blank array to keep successfully dequeued packets
+ * @param count
+ *  Size of the packet array
+ * @param nr_inflight
+ *  -1 on failure, number of in-flight packets on success
+ * @param dma_id
+ *  the identifier of DMA device
+ * @param vchan_id
+ *  the identifier of virtual DMA channel
+ * @return
+ *  Number of successfully dequeued packets
+ */
+__rte_experimental
+uint16_t rte_vhost_async_try_dequeue_burst(int vid, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts, uint16_t count,
+		int *nr_inflight, int16_t dma_id, uint16_t vchan_id);
+
 #ifdef __cplusplus
 }
 #endif
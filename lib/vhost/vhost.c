@@ -24,7 +24,7 @@
 struct virtio_net *vhost_devices[RTE_MAX_VHOST_DEVICE];
 pthread_mutex_t vhost_dev_lock = PTHREAD_MUTEX_INITIALIZER;
 
-/* Called with iotlb_lock read-locked */
+/* Called in an IOTLB read-side section */
 uint64_t
 __vhost_iova_to_vva(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		    uint64_t iova, uint64_t *size, uint8_t perm)
@@ -44,11 +44,12 @@ __vhost_iova_to_vva(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 	if (!vhost_user_iotlb_pending_miss(vq, iova, perm)) {
 		/*
-		 * iotlb_lock is read-locked for a full burst,
+		 * The IOTLB read-side section lasts for a full burst,
 		 * but it only protects the iotlb cache.
 		 * In case of IOTLB miss, we might block on the socket,
 		 * which could cause a deadlock with QEMU if an IOTLB update
-		 * is being handled. We can safely unlock here to avoid it.
+		 * is being handled and waits for the section to end.
+		 * We can safely leave it here to avoid it.
 		 */
 		vhost_user_iotlb_rd_unlock(vq);
 
@@ -361,6 +362,8 @@ free_vq(struct virtio_net *dev, struct vhost_virtqueue *vq)
 	vhost_free_async_mem(vq);
 	rte_free(vq->batch_copy_elems);
 	rte_mempool_free(vq->iotlb_pool);
+	rte_free(vq->iotlb_cache);
+	rte_free(vq->iotlb_cache_next);
 	rte_free(vq->log_cache);
 	rte_free(vq);
 }
@@ -398,7 +401,7 @@ log_translate(struct virtio_net *dev, struct vhost_virtqueue *vq)
  * If IOMMU is enabled, the log address is IOVA
  * If IOMMU not enabled, the log address is already GPA
  *
- * Caller should have iotlb_lock read-locked
+ * Caller should be in an IOTLB read-side section
  */
 uint64_t
 translate_log_addr(struct virtio_net *dev, struct vhost_virtqueue *vq,
@@ -429,7 +432,7 @@ translate_log_addr(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		return log_addr;
 }
 
-/* Caller should have iotlb_lock read-locked */
+/* Caller should be in an IOTLB read-side section */
 static int
 vring_translate_split(struct virtio_net *dev, struct vhost_virtqueue *vq)
 {
@@ -468,7 +471,7 @@ vring_translate_split(struct virtio_net *dev, struct vhost_virtqueue *vq)
 	return 0;
 }
 
-/* Caller should have iotlb_lock read-locked */
+/* Caller should be in an IOTLB read-side section */
 static int
 vring_translate_packed(struct virtio_net *dev, struct vhost_virtqueue *vq)
 {
@@ -524,20 +527,18 @@ vring_translate(struct virtio_net *dev, struct vhost_virtqueue *vq)
 	return 0;
 }
 
+/*
+ * Called with access_lock held, which excludes the data path,
+ * or when the virtqueue is stopped.
+ */
 void
-vring_invalidate(struct virtio_net *dev, struct vhost_virtqueue *vq)
+vring_invalidate(struct virtio_net *dev __rte_unused, struct vhost_virtqueue *vq)
 {
-	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
-		vhost_user_iotlb_wr_lock(vq);
-
 	vq->access_ok = false;
 	vq->desc = NULL;
 	vq->avail = NULL;
 	vq->used = NULL;
 	vq->log_guest_addr = 0;
-
-	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
-		vhost_user_iotlb_wr_unlock(vq);
 }
 
 static void
@@ -755,7 +756,7 @@ vhost_set_ifname(int vid, const char *if_name, unsigned int if_len)
 }
 
 void
-vhost_setup_virtio_net(int vid, bool enable, bool compliant_ol_flags)
+vhost_setup_virtio_net(int vid, bool enable, bool compliant_ol_flags, bool stats_enabled)
 {
 	struct virtio_net *dev = get_device(vid);
 
@@ -770,6 +771,10 @@ vhost_setup_virtio_net(int vid, bool enable, bool compliant_ol_flags)
 		dev->flags |= VIRTIO_DEV_LEGACY_OL_FLAGS;
 	else
 		dev->flags &= ~VIRTIO_DEV_LEGACY_OL_FLAGS;
+	if (stats_enabled)
+		dev->flags |= VIRTIO_DEV_STATS_ENABLED;
+	else
+		dev->flags &= ~VIRTIO_DEV_STATS_ENABLED;
 }
 
 void
@@ -1941,5 +1946,179 @@ rte_vhost_get_monitor_addr(int vid, uint16_t queue_id,
 	return 0;
 }
 
+struct vhost_vq_stats_name_off {
+	char name[RTE_VHOST_STATS_NAME_SIZE];
+	unsigned int offset;
+};
+
+static const struct vhost_vq_stats_name_off vhost_vq_stat_strings[] = {
+	{"good_packets",           offsetof(struct vhost_virtqueue, stats.packets)},
+	{"good_bytes",             offsetof(struct vhost_virtqueue, stats.bytes)},
+	{"cycles",                 offsetof(struct vhost_virtqueue, stats.cycles)},
+	{"guest_notifications",    offsetof(struct vhost_virtqueue, stats.guest_notifications)},
+	{"guest_notifications_deferred",
+			offsetof(struct vhost_virtqueue, stats.guest_notifications_deferred)},
+	{"burst_size_0",           offsetof(struct vhost_virtqueue, stats.burst[0])},
+	{"burst_size_1",           offsetof(struct vhost_virtqueue, stats.burst[1])},
+	{"burst_size_2_to_3",      offsetof(struct vhost_virtqueue, stats.burst[2])},
+	{"burst_size_4_to_7",      offsetof(struct vhost_virtqueue, stats.burst[3])},
+	{"burst_size_8_to_15",     offsetof(struct vhost_virtqueue, stats.burst[4])},
+	{"burst_size_16_to_31",    offsetof(struct vhost_virtqueue, stats.burst[5])},
+	{"burst_size_32_to_max",   offsetof(struct vhost_virtqueue, stats.burst[6])},
+	{"chain_len_1",            offsetof(struct vhost_virtqueue, stats.chain_len[0])},
+	{"chain_len_2_to_3",       offsetof(struct vhost_virtqueue, stats.chain_len[1])},
+	{"chain_len_4_to_7",       offsetof(struct vhost_virtqueue, stats.chain_len[2])},
+	{"chain_len_8_to_15",      offsetof(struct vhost_virtqueue, stats.chain_len[3])},
+	{"chain_len_16_to_max",    offsetof(struct vhost_virtqueue, stats.chain_len[4])},
+};
+
+#define VHOST_NB_VQ_STATS RTE_DIM(vhost_vq_stat_strings)
+/* The cycles per packet are computed after the counters. */
+#define VHOST_NB_VQ_XSTATS (VHOST_NB_VQ_STATS + 1)
+
+static struct vhost_virtqueue *
+vhost_stats_get_vq(int vid, uint16_t queue_id)
+{
+	struct virtio_net *dev = get_device(vid);
+
+	if (dev == NULL || queue_id >= dev->nr_vring)
+		return NULL;
+
+	return dev->virtqueue[queue_id];
+}
+
+int
+rte_vhost_vring_stats_get_names(int vid, uint16_t queue_id,
+		struct rte_vhost_stat_name *name, unsigned int size)
+{
+	struct virtio_net *dev = get_device(vid);
+	unsigned int i;
+
+	if (vhost_stats_get_vq(vid, queue_id) == NULL)
+		return -EINVAL;
+
+	if (!(dev->flags & VIRTIO_DEV_STATS_ENABLED))
+		return -ENOTSUP;
+
+	if (name == NULL || size < VHOST_NB_VQ_XSTATS)
+		return VHOST_NB_VQ_XSTATS;
+
+	for (i = 0; i < VHOST_NB_VQ_STATS; i++)
+		snprintf(name[i].name, sizeof(name[i].name), "%s_q%u_%s",
+				(queue_id & 1) ? "rx" : "tx", queue_id / 2,
+				vhost_vq_stat_strings[i].name);
+	snprintf(name[i].name, sizeof(name[i].name), "%s_q%u_cycles_per_packet",
+			(queue_id & 1) ? "rx" : "tx", queue_id / 2);
+
+	return VHOST_NB_VQ_XSTATS;
+}
+
+int
+rte_vhost_vring_stats_get(int vid, uint16_t queue_id,
+		struct rte_vhost_stat *stats, unsigned int n)
+{
+	struct virtio_net *dev = get_device(vid);
+	struct vhost_virtqueue *vq;
+	unsigned int i;
+
+	vq = vhost_stats_get_vq(vid, queue_id);
+	if (vq == NULL)
+		return -EINVAL;
+
+	if (!(dev->flags & VIRTIO_DEV_STATS_ENABLED))
+		return -ENOTSUP;
+
+	if (stats == NULL || n < VHOST_NB_VQ_XSTATS)
+		return VHOST_NB_VQ_XSTATS;
+
+	rte_spinlock_lock(&vq->access_lock);
+	for (i = 0; i < VHOST_NB_VQ_STATS; i++) {
+		stats[i].value = *(uint64_t *)(((char *)vq) +
+				vhost_vq_stat_strings[i].offset);
+		stats[i].id = i;
+	}
+	stats[i].value = vq->stats.packets != 0 ?
+			vq->stats.cycles / vq->stats.packets : 0;
+	stats[i].id = i;
+	rte_spinlock_unlock(&vq->access_lock);
+
+	return VHOST_NB_VQ_XSTATS;
+}
+
+int
+rte_vhost_vring_stats_reset(int vid, uint16_t queue_id)
+{
+	struct virtio_net *dev = get_device(vid);
+	struct vhost_virtqueue *vq;
+
+	vq = vhost_stats_get_vq(vid, queue_id);
+	if (vq == NULL)
+		return -EINVAL;
+
+	if (!(dev->flags & VIRTIO_DEV_STATS_ENABLED))
+		return -ENOTSUP;
+
+	rte_spinlock_lock(&vq->access_lock);
+	memset(&vq->stats, 0, sizeof(vq->stats));
+	rte_spinlock_unlock(&vq->access_lock);
+
+	return 0;
+}
+
+int
+rte_vhost_vring_coalesce_set(int vid, uint16_t queue_id, uint32_t max_pkts,
+		uint32_t usecs)
+{
+	struct virtio_net *dev = get_device(vid);
+	struct vhost_virtqueue *vq;
+
+	if (dev == NULL || queue_id >= dev->nr_vring)
+		return -EINVAL;
+
+	vq = dev->virtqueue[queue_id];
+	if (vq == NULL)
+		return -EINVAL;
+
+	if (max_pkts <= 1) {
+		max_pkts = 0;
+		usecs = 0;
+	} else if (usecs == 0) {
+		VHOST_LOG_CONFIG(ERR, "(%s) no time threshold to coalesce notifications of queue %u\n",
+				dev->ifname, queue_id);
+		return -EINVAL;
+	}
+
+	rte_spinlock_lock(&vq->access_lock);
+	vq->coalesce_max_pkts = max_pkts;
+	vq->coalesce_usecs = usecs;
+	vq->coalesce_cycles = rte_get_tsc_hz() * usecs / US_PER_S;
+	/* The pending notification is sent by the next burst. */
+	vq->coalesce_deadline = 0;
+	rte_spinlock_unlock(&vq->access_lock);
+
+	return 0;
+}
+
+int
+rte_vhost_vring_coalesce_get(int vid, uint16_t queue_id, uint32_t *max_pkts,
+		uint32_t *usecs)
+{
+	struct virtio_net *dev = get_device(vid);
+	struct vhost_virtqueue *vq;
+
+	if (dev == NULL || queue_id >= dev->nr_vring ||
+			max_pkts == NULL || usecs == NULL)
+		return -EINVAL;
+
+	vq = dev->virtqueue[queue_id];
+	if (vq == NULL)
+		return -EINVAL;
+
+	*max_pkts = vq->coalesce_max_pkts;
+	*usecs = vq->coalesce_usecs;
+
+	return 0;
+}
+
 RTE_LOG_REGISTER_SUFFIX(vhost_config_log_level, config, INFO);
 RTE_LOG_REGISTER_SUFFIX(vhost_data_log_level, data, WARNING);
@@ -16,6 +16,7 @@
 #include <linux/if.h>
 
 #include <rte_log.h>
+#include <rte_cycles.h>
 #include <rte_ether.h>
 #include <rte_malloc.h>
 #include <rte_dmadev.h>
@@ -37,12 +38,40 @@
 #define VIRTIO_DEV_FEATURES_FAILED ((uint32_t)1 << 4)
 /* Used to indicate that the virtio_net tx code should fill TX ol_flags */
 #define VIRTIO_DEV_LEGACY_OL_FLAGS ((uint32_t)1 << 5)
+/* Used to indicate that the virtqueue statistics are collected */
+#define VIRTIO_DEV_STATS_ENABLED ((uint32_t)1 << 6)
 
 /* Backend value set by guest. */
 #define VIRTIO_DEV_STOPPED -1
 
 #define BUF_VECTOR_MAX 256
 
+/* Power of two bins: 0, 1, 2-3, 4-7, 8-15, 16-31, 32 and more */
+#define VHOST_STATS_BURST_BINS 7
+/* Power of two bins: 1, 2-3, 4-7, 8-15, 16 and more */
+#define VHOST_STATS_CHAIN_BINS 5
+
+/**
+ * Statistics of a virtqueue, updated by the data path when the device
+ * has VIRTIO_DEV_STATS_ENABLED.
+ */
+struct virtqueue_stats {
+	uint64_t packets;
+	uint64_t bytes;
+	/* TSC cycles spent in the bursts */
+	uint64_t cycles;
+	uint64_t guest_notifications;
+	/*
+	 * Bursts whose notification was deferred by coalescing, whether or
+	 * not the guest would have been notified without it
+	 */
+	uint64_t guest_notifications_deferred;
+	/* Number of bursts per number of packets */
+	uint64_t burst[VHOST_STATS_BURST_BINS];
+	/* Number of packets per number of guest buffer segments */
+	uint64_t chain_len[VHOST_STATS_CHAIN_BINS];
+};
+
 #define VHOST_LOG_CACHE_NR 32
 
 #define MAX_PKT_BURST 32
@@ -65,6 +94,11 @@
 			    sizeof(struct vring_packed_desc))
 #define PACKED_BATCH_MASK (PACKED_BATCH_SIZE - 1)
 
+#define SPLIT_BATCH_SIZE (RTE_CACHE_LINE_SIZE / \
+			  sizeof(struct vring_desc))
+#define SPLIT_DESC_SINGLE_FLAG (VRING_DESC_F_NEXT | \
+				VRING_DESC_F_INDIRECT)
+
 #ifdef VHOST_GCC_UNROLL_PRAGMA
 #define vhost_for_each_try_unroll(iter, val, size) _Pragma("GCC unroll 4") \
 	for (iter = val; iter < size; iter++)
@@ -180,6 +214,7 @@ struct async_inflight_info {
 	struct rte_mbuf *mbuf;
 	uint16_t descs; /* num of descs inflight */
 	uint16_t nr_buffers; /* num of buffers inflight for packed ring */
+	struct virtio_net_hdr nethdr; /* offload info of a dequeued packet */
 };
 
 struct vhost_async {
@@ -279,12 +314,16 @@ struct vhost_virtqueue {
 	uint64_t		log_guest_addr;
 	struct log_cache_entry	*log_cache;
 
-	rte_rwlock_t	iotlb_lock;
+	rte_spinlock_t	iotlb_lock;
 	rte_rwlock_t	iotlb_pending_lock;
 	struct rte_mempool *iotlb_pool;
-	TAILQ_HEAD(, vhost_iotlb_entry) iotlb_list;
+	struct vhost_iotlb_cache *iotlb_cache;
+	struct vhost_iotlb_cache *iotlb_cache_next;
 	TAILQ_HEAD(, vhost_iotlb_entry) iotlb_pending_list;
-	int				iotlb_cache_nr;
+	/* Odd while the reader of the virtqueue may use iotlb_cache */
+	uint64_t			iotlb_rd_seq;
+	int				iotlb_last_hit;
+	uint64_t			iotlb_lru_tick;
 
 	/* Used to notify the guest (trigger interrupt) */
 	int			callfd;
@@ -305,6 +344,18 @@ struct vhost_virtqueue {
 #define VIRTIO_UNINITIALIZED_NOTIF	(-1)
 
 	struct vhost_vring_addr ring_addrs;
+	struct virtqueue_stats	stats;
+
+	/*
+	 * Guest notification coalescing, disabled when coalesce_max_pkts
+	 * is 0. The notification is deferred until coalesce_max_pkts
+	 * packets are pending or coalesce_deadline is reached.
+	 */
+	uint32_t		coalesce_max_pkts;
+	uint32_t		coalesce_usecs;
+	uint64_t		coalesce_cycles;
+	uint32_t		coalesce_pending;
+	uint64_t		coalesce_deadline;
 } __rte_cache_aligned;
 
 /* Virtio device status as per Virtio specification */
@@ -780,7 +831,8 @@ int alloc_vring_queue(struct virtio_net *dev, uint32_t vring_idx);
 void vhost_attach_vdpa_device(int vid, struct rte_vdpa_device *dev);
 
 void vhost_set_ifname(int, const char *if_name, unsigned int if_len);
-void vhost_setup_virtio_net(int vid, bool enable, bool legacy_ol_flags);
+void vhost_setup_virtio_net(int vid, bool enable, bool legacy_ol_flags,
+	bool stats_enabled);
 void vhost_enable_extbuf(int vid);
 void vhost_enable_linearbuf(int vid);
 int vhost_enable_guest_notification(struct virtio_net *dev,
@@ -835,6 +887,8 @@ vhost_need_event(uint16_t event_idx, uint16_t new_idx, uint16_t old)
 static __rte_always_inline void
 vhost_vring_call_split(struct virtio_net *dev, struct vhost_virtqueue *vq)
 {
+	vq->coalesce_pending = 0;
+
 	/* Flush used->idx update before we read avail->flags. */
 	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
 
@@ -855,6 +909,8 @@ vhost_vring_call_split(struct virtio_net *dev, struct vhost_virtqueue *vq)
 		if ((vhost_need_event(vhost_used_event(vq), new, old) &&
 					(vq->callfd >= 0)) ||
 				unlikely(!signalled_used_valid)) {
+			if (dev->flags & VIRTIO_DEV_STATS_ENABLED)
+				vq->stats.guest_notifications++;
 			eventfd_write(vq->callfd, (eventfd_t) 1);
 			if (dev->notify_ops->guest_notified)
 				dev->notify_ops->guest_notified(dev->vid);
@@ -863,6 +919,8 @@ vhost_vring_call_split(struct virtio_net *dev, struct vhost_virtqueue *vq)
 		/* Kick the guest if necessary. */
 		if (!(vq->avail->flags & VRING_AVAIL_F_NO_INTERRUPT)
 				&& (vq->callfd >= 0)) {
+			if (dev->flags & VIRTIO_DEV_STATS_ENABLED)
+				vq->stats.guest_notifications++;
 			eventfd_write(vq->callfd, (eventfd_t)1);
 			if (dev->notify_ops->guest_notified)
 				dev->notify_ops->guest_notified(dev->vid);
@@ -876,6 +934,8 @@ vhost_vring_call_packed(struct virtio_net *dev, struct vhost_virtqueue *vq)
 	uint16_t old, new, off, off_wrap;
 	bool signalled_used_valid, kick = false;
 
+	vq->coalesce_pending = 0;
+
 	/* Flush used desc update. */
 	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
 
@@ -918,12 +978,69 @@ vhost_vring_call_packed(struct virtio_net *dev, struct vhost_virtqueue *vq)
 		kick = true;
 kick:
 	if (kick) {
+		if (dev->flags & VIRTIO_DEV_STATS_ENABLED)
+			vq->stats.guest_notifications++;
 		eventfd_write(vq->callfd, (eventfd_t)1);
 		if (dev->notify_ops->guest_notified)
 			dev->notify_ops->guest_notified(dev->vid);
 	}
 }
 
+/*
+ * Account nr_pkts buffers made used since the last guest notification and
+ * return true if the notification can be deferred by coalescing.
+ *
+ * The used index the guest was last notified for is left unchanged while
+ * deferring, so that with VIRTIO_RING_F_EVENT_IDX the deferred notification
+ * checks the event index against all the buffers used since then.
+ */
+static __rte_always_inline bool
+vhost_vring_coalesce(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		uint32_t nr_pkts)
+{
+	uint64_t now;
+
+	if (likely(vq->coalesce_max_pkts == 0))
+		return false;
+
+	/* Nothing would be left pending for the flush to notify. */
+	if (unlikely(nr_pkts == 0))
+		return false;
+
+	now = rte_rdtsc();
+	if (vq->coalesce_pending == 0)
+		vq->coalesce_deadline = now + vq->coalesce_cycles;
+
+	vq->coalesce_pending += nr_pkts;
+	if (vq->coalesce_pending >= vq->coalesce_max_pkts ||
+			now >= vq->coalesce_deadline)
+		return false;
+
+	if (dev->flags & VIRTIO_DEV_STATS_ENABLED)
+		vq->stats.guest_notifications_deferred++;
+
+	return true;
+}
+
+/*
+ * Send the guest notification deferred by coalescing if its time
+ * threshold is reached. Called on each burst of the virtqueue.
+ */
+static __rte_always_inline void
+vhost_vring_coalesce_flush(struct virtio_net *dev, struct vhost_virtqueue *vq)
+{
+	if (likely(vq->coalesce_pending == 0))
+		return;
+
+	if (rte_rdtsc() < vq->coalesce_deadline)
+		return;
+
+	if (vq_is_packed(dev))
+		vhost_vring_call_packed(dev, vq);
+	else
+		vhost_vring_call_split(dev, vq);
+}
+
 static __rte_always_inline void
 free_ind_table(void *idesc)
 {
@@ -941,7 +1058,7 @@ restore_mbuf(struct rte_mbuf *m)
 		/* start of buffer is after mbuf structure and priv data */
 
 		m->buf_addr = (char *)m + mbuf_size;
-		m->buf_iova = rte_mempool_virt2iova(m) + mbuf_size;
+		rte_mbuf_iova_set(m, rte_mempool_virt2iova(m) + mbuf_size);
 		m = m->next;
 	}
 }
@@ -47,6 +47,43 @@ is_valid_virt_queue_idx(uint32_t idx, int is_tx, uint32_t nr_vring)
 	return (is_tx ^ (idx & 1)) == 0 && idx < nr_vring;
 }
 
+static __rte_always_inline uint64_t
+vhost_queue_stats_start(struct virtio_net *dev)
+{
+	if (unlikely(dev->flags & VIRTIO_DEV_STATS_ENABLED))
+		return rte_rdtsc();
+
+	return 0;
+}
+
+/* Account a burst of count packets, called with the access lock held */
+static __rte_always_inline void
+vhost_queue_stats_update(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		struct rte_mbuf **pkts, uint16_t count, uint64_t start)
+{
+	struct virtqueue_stats *stats = &vq->stats;
+	uint16_t i;
+
+	if (likely(!(dev->flags & VIRTIO_DEV_STATS_ENABLED)))
+		return;
+
+	stats->burst[RTE_MIN(rte_fls_u32(count), VHOST_STATS_BURST_BINS - 1)]++;
+	stats->packets += count;
+	for (i = 0; i < count; i++)
+		stats->bytes += pkts[i]->pkt_len;
+	stats->cycles += rte_rdtsc() - start;
+}
+
+/* Account nr_pkts packets made of nr_vec guest buffer segments each */
+static __rte_always_inline void
+vhost_queue_stats_chain(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		uint16_t nr_vec, uint16_t nr_pkts)
+{
+	if (unlikely(dev->flags & VIRTIO_DEV_STATS_ENABLED))
+		vq->stats.chain_len[RTE_MIN(rte_fls_u32(nr_vec | 1),
+				VHOST_STATS_CHAIN_BINS) - 1] += nr_pkts;
+}
+
 static __rte_always_inline int64_t
 vhost_async_dma_transfer_one(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		int16_t dma_id, uint16_t vchan_id, uint16_t flag_idx,
@@ -62,6 +99,12 @@ vhost_async_dma_transfer_one(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	uint32_t nr_segs = pkt->nr_segs;
 	uint16_t i;
 
+	/* A dequeued packet made of a virtio-net header only has no data. */
+	if (unlikely(nr_segs == 0)) {
+		vq->async->pkts_cmpl_flag[flag_idx] = true;
+		return 0;
+	}
+
 	if (rte_dma_burst_capacity(dma_id, vchan_id) < nr_segs)
 		return -1;
 
@@ -997,13 +1040,14 @@ async_iter_reset(struct vhost_async *async)
 }
 
 static __rte_always_inline int
-async_mbuf_to_desc_seg(struct virtio_net *dev, struct vhost_virtqueue *vq,
+async_fill_seg(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		struct rte_mbuf *m, uint32_t mbuf_offset,
-		uint64_t buf_iova, uint32_t cpy_len)
+		uint64_t buf_iova, uint32_t cpy_len, bool to_desc)
 {
 	struct vhost_async *async = vq->async;
 	uint64_t mapped_len;
 	uint32_t buf_offset = 0;
+	void *src, *dst;
 	void *host_iova;
 
 	while (cpy_len) {
@@ -1015,10 +1059,16 @@ async_mbuf_to_desc_seg(struct virtio_net *dev, struct vhost_virtqueue *vq,
 			return -1;
 		}
 
-		if (unlikely(async_iter_add_iovec(dev, async,
-						(void *)(uintptr_t)rte_pktmbuf_iova_offset(m,
-							mbuf_offset),
-						host_iova, (size_t)mapped_len)))
+		if (to_desc) {
+			src = (void *)(uintptr_t)rte_pktmbuf_iova_offset(m, mbuf_offset);
+			dst = host_iova;
+		} else {
+			src = host_iova;
+			dst = (void *)(uintptr_t)rte_pktmbuf_iova_offset(m, mbuf_offset);
+		}
+
+		if (unlikely(async_iter_add_iovec(dev, async, src, dst,
+						(size_t)mapped_len)))
 			return -1;
 
 		cpy_len -= (uint32_t)mapped_len;
@@ -1071,6 +1121,8 @@ mbuf_to_desc(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	if (unlikely(m == NULL))
 		return -1;
 
+	vhost_queue_stats_chain(dev, vq, nr_vec, 1);
+
 	buf_addr = buf_vec[vec_idx].buf_addr;
 	buf_iova = buf_vec[vec_idx].buf_iova;
 	buf_len = buf_vec[vec_idx].buf_len;
@@ -1154,8 +1206,8 @@ mbuf_to_desc(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		cpy_len = RTE_MIN(buf_avail, mbuf_avail);
 
 		if (is_async) {
-			if (async_mbuf_to_desc_seg(dev, vq, m, mbuf_offset,
-						buf_iova + buf_offset, cpy_len) < 0)
+			if (async_fill_seg(dev, vq, m, mbuf_offset,
+						buf_iova + buf_offset, cpy_len, true) < 0)
 				goto error;
 		} else {
 			sync_mbuf_to_desc_seg(dev, vq, m, mbuf_offset,
@@ -1243,6 +1295,97 @@ vhost_enqueue_single_packed(struct virtio_net *dev,
 	return 0;
 }
 
+/*
+ * Enqueue a batch of packets, each to a single descriptor chain made of
+ * one direct descriptor large enough for the header and the data.
+ */
+static __rte_always_inline int
+virtio_dev_rx_sync_batch_split(struct virtio_net *dev,
+			   struct vhost_virtqueue *vq,
+			   struct rte_mbuf **pkts,
+			   uint16_t avail_head)
+{
+	struct virtio_net_hdr_mrg_rxbuf *hdrs[SPLIT_BATCH_SIZE];
+	uint32_t buf_offset = dev->vhost_hlen;
+	struct vring_desc *descs = vq->desc;
+	uint16_t avail_idx = vq->last_avail_idx;
+	uint64_t desc_addrs[SPLIT_BATCH_SIZE];
+	uint64_t lens[SPLIT_BATCH_SIZE];
+	uint16_t ids[SPLIT_BATCH_SIZE];
+	uint16_t i;
+
+	if (unlikely((uint16_t)(avail_head - avail_idx) < SPLIT_BATCH_SIZE))
+		return -1;
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		ids[i] = vq->avail->ring[(avail_idx + i) & (vq->size - 1)];
+		if (unlikely(ids[i] >= vq->size))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(pkts[i]->next != NULL))
+			return -1;
+		if (unlikely(descs[ids[i]].flags & SPLIT_DESC_SINGLE_FLAG))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		lens[i] = descs[ids[i]].len;
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(lens[i] < buf_offset ||
+			     pkts[i]->pkt_len > (lens[i] - buf_offset)))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		desc_addrs[i] = vhost_iova_to_vva(dev, vq,
+						  descs[ids[i]].addr,
+						  &lens[i],
+						  VHOST_ACCESS_RW);
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(!desc_addrs[i]))
+			return -1;
+		if (unlikely(lens[i] != descs[ids[i]].len))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		rte_prefetch0((void *)(uintptr_t)desc_addrs[i]);
+		hdrs[i] = (struct virtio_net_hdr_mrg_rxbuf *)
+					(uintptr_t)desc_addrs[i];
+		lens[i] = pkts[i]->pkt_len + buf_offset;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		virtio_enqueue_offload(pkts[i], &hdrs[i]->hdr);
+
+	if (rxvq_is_mergeable(dev)) {
+		vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+			ASSIGN_UNLESS_EQUAL(hdrs[i]->num_buffers, 1);
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		rte_memcpy((void *)(uintptr_t)(desc_addrs[i] + buf_offset),
+			   rte_pktmbuf_mtod_offset(pkts[i], void *, 0),
+			   pkts[i]->pkt_len);
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		vhost_log_cache_write_iova(dev, vq, descs[ids[i]].addr,
+					   lens[i]);
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		update_shadow_used_ring_split(vq, ids[i], lens[i]);
+
+	vq->last_avail_idx += SPLIT_BATCH_SIZE;
+	vhost_queue_stats_chain(dev, vq, 1, SPLIT_BATCH_SIZE);
+
+	return 0;
+}
+
 static __rte_noinline uint32_t
 virtio_dev_rx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	struct rte_mbuf **pkts, uint32_t count)
@@ -1260,10 +1403,19 @@ virtio_dev_rx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 	rte_prefetch0(&vq->avail->ring[vq->last_avail_idx & (vq->size - 1)]);
 
-	for (pkt_idx = 0; pkt_idx < count; pkt_idx++) {
+	while (pkt_idx < count) {
 		uint32_t pkt_len = pkts[pkt_idx]->pkt_len + dev->vhost_hlen;
 		uint16_t nr_vec = 0;
 
+		if (count - pkt_idx >= SPLIT_BATCH_SIZE) {
+			if (!virtio_dev_rx_sync_batch_split(dev, vq,
+							&pkts[pkt_idx],
+							avail_head)) {
+				pkt_idx += SPLIT_BATCH_SIZE;
+				continue;
+			}
+		}
+
 		if (unlikely(reserve_avail_buf_split(dev, vq,
 						pkt_len, buf_vec, &num_buffers,
 						avail_head, &nr_vec) < 0)) {
@@ -1285,13 +1437,15 @@ virtio_dev_rx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		}
 
 		vq->last_avail_idx += num_buffers;
+		pkt_idx++;
 	}
 
 	do_data_copy_enqueue(dev, vq);
 
 	if (likely(vq->shadow_used_idx)) {
 		flush_shadow_used_ring_split(dev, vq);
-		vhost_vring_call_split(dev, vq);
+		if (!vhost_vring_coalesce(dev, vq, pkt_idx))
+			vhost_vring_call_split(dev, vq);
 	}
 
 	return pkt_idx;
@@ -1408,6 +1562,7 @@ virtio_dev_rx_sync_batch_packed(struct virtio_net *dev,
 	}
 
 	virtio_dev_rx_batch_packed_copy(dev, vq, pkts, desc_addrs, lens);
+	vhost_queue_stats_chain(dev, vq, 1, PACKED_BATCH_SIZE);
 
 	return 0;
 }
@@ -1466,7 +1621,7 @@ virtio_dev_rx_packed(struct virtio_net *dev,
 		vhost_flush_enqueue_shadow_packed(dev, vq);
 	}
 
-	if (pkt_idx)
+	if (pkt_idx && !vhost_vring_coalesce(dev, vq, pkt_idx))
 		vhost_vring_call_packed(dev, vq);
 
 	return pkt_idx;
@@ -1478,6 +1633,7 @@ virtio_dev_rx(struct virtio_net *dev, uint16_t queue_id,
 {
 	struct vhost_virtqueue *vq;
 	uint32_t nb_tx = 0;
+	uint64_t start;
 
 	VHOST_LOG_DATA(DEBUG, "(%s) %s\n", dev->ifname, __func__);
 	if (unlikely(!is_valid_virt_queue_idx(queue_id, 0, dev->nr_vring))) {
@@ -1500,14 +1656,18 @@ virtio_dev_rx(struct virtio_net *dev, uint16_t queue_id,
 		if (unlikely(vring_translate(dev, vq) < 0))
 			goto out;
 
+	vhost_vring_coalesce_flush(dev, vq);
+
 	count = RTE_MIN((uint32_t)MAX_PKT_BURST, count);
 	if (count == 0)
 		goto out;
 
+	start = vhost_queue_stats_start(dev);
 	if (vq_is_packed(dev))
 		nb_tx = virtio_dev_rx_packed(dev, vq, pkts, count);
 	else
 		nb_tx = virtio_dev_rx_split(dev, vq, pkts, count);
+	vhost_queue_stats_update(dev, vq, pkts, nb_tx, start);
 
 out:
 	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
@@ -1986,8 +2146,11 @@ vhost_poll_enqueue_completed(struct virtio_net *dev, uint16_t queue_id,
 		nr_cpl_pkts++;
 	}
 
-	if (nr_cpl_pkts == 0)
+	if (nr_cpl_pkts == 0) {
+		if (likely(vq->enabled && vq->access_ok))
+			vhost_vring_coalesce_flush(dev, vq);
 		return 0;
+	}
 
 	for (i = 0; i < nr_cpl_pkts; i++) {
 		from = (start_idx + i) % vq->size;
@@ -2003,11 +2166,13 @@ vhost_poll_enqueue_completed(struct virtio_net *dev, uint16_t queue_id,
 	if (likely(vq->enabled && vq->access_ok)) {
 		if (vq_is_packed(dev)) {
 			write_back_completed_descs_packed(vq, n_buffers);
-			vhost_vring_call_packed(dev, vq);
+			if (!vhost_vring_coalesce(dev, vq, nr_cpl_pkts))
+				vhost_vring_call_packed(dev, vq);
 		} else {
 			write_back_completed_descs_split(vq, n_descs);
 			__atomic_add_fetch(&vq->used->idx, n_descs, __ATOMIC_RELEASE);
-			vhost_vring_call_split(dev, vq);
+			if (!vhost_vring_coalesce(dev, vq, nr_cpl_pkts))
+				vhost_vring_call_split(dev, vq);
 		}
 	} else {
 		if (vq_is_packed(dev)) {
@@ -2070,6 +2235,11 @@ rte_vhost_poll_enqueue_completed(int vid, uint16_t queue_id,
 	return n_pkts_cpl;
 }
 
+static __rte_always_inline uint16_t
+async_poll_dequeue_completed(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		struct rte_mbuf **pkts, uint16_t count, int16_t dma_id,
+		uint16_t vchan_id, bool legacy_ol_flags);
+
 uint16_t
 rte_vhost_clear_queue_thread_unsafe(int vid, uint16_t queue_id,
 		struct rte_mbuf **pkts, uint16_t count, int16_t dma_id,
@@ -2083,7 +2253,7 @@ rte_vhost_clear_queue_thread_unsafe(int vid, uint16_t queue_id,
 		return 0;
 
 	VHOST_LOG_DATA(DEBUG, "(%s) %s\n", dev->ifname, __func__);
-	if (unlikely(!is_valid_virt_queue_idx(queue_id, 0, dev->nr_vring))) {
+	if (unlikely(queue_id >= dev->nr_vring)) {
 		VHOST_LOG_DATA(ERR, "(%s) %s: invalid virtqueue idx %d.\n",
 			dev->ifname, __func__, queue_id);
 		return 0;
@@ -2104,7 +2274,12 @@ rte_vhost_clear_queue_thread_unsafe(int vid, uint16_t queue_id,
 		return 0;
 	}
 
-	n_pkts_cpl = vhost_poll_enqueue_completed(dev, queue_id, pkts, count, dma_id, vchan_id);
+	if (queue_id % 2 == 0)
+		n_pkts_cpl = vhost_poll_enqueue_completed(dev, queue_id, pkts, count,
+				dma_id, vchan_id);
+	else
+		n_pkts_cpl = async_poll_dequeue_completed(dev, vq, pkts, count,
+				dma_id, vchan_id, dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS);
 
 	return n_pkts_cpl;
 }
@@ -2115,6 +2290,7 @@ virtio_dev_rx_async_submit(struct virtio_net *dev, uint16_t queue_id,
 {
 	struct vhost_virtqueue *vq;
 	uint32_t nb_tx = 0;
+	uint64_t start;
 
 	VHOST_LOG_DATA(DEBUG, "(%s) %s\n", dev->ifname, __func__);
 	if (unlikely(!is_valid_virt_queue_idx(queue_id, 0, dev->nr_vring))) {
@@ -2148,12 +2324,14 @@ virtio_dev_rx_async_submit(struct virtio_net *dev, uint16_t queue_id,
 	if (count == 0)
 		goto out;
 
+	start = vhost_queue_stats_start(dev);
 	if (vq_is_packed(dev))
 		nb_tx = virtio_dev_rx_async_submit_packed(dev, vq, queue_id,
 				pkts, count, dma_id, vchan_id);
 	else
 		nb_tx = virtio_dev_rx_async_submit_split(dev, vq, queue_id,
 				pkts, count, dma_id, vchan_id);
+	vhost_queue_stats_update(dev, vq, pkts, nb_tx, start);
 
 out:
 	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
@@ -2471,10 +2649,10 @@ static __rte_always_inline int
 copy_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		  struct buf_vector *buf_vec, uint16_t nr_vec,
 		  struct rte_mbuf *m, struct rte_mempool *mbuf_pool,
-		  bool legacy_ol_flags)
+		  bool legacy_ol_flags, uint16_t slot_idx, bool is_async)
 {
 	uint32_t buf_avail, buf_offset;
-	uint64_t buf_addr, buf_len;
+	uint64_t buf_addr, buf_iova, buf_len;
 	uint32_t mbuf_avail, mbuf_offset;
 	uint32_t cpy_len;
 	struct rte_mbuf *cur = m, *prev = m;
@@ -2483,11 +2661,20 @@ copy_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	/* A counter to avoid desc dead loop chain */
 	uint16_t vec_idx = 0;
 	struct batch_copy_elem *batch_copy = vq->batch_copy_elems;
+	struct vhost_async *async = vq->async;
 	int error = 0;
 
 	buf_addr = buf_vec[vec_idx].buf_addr;
+	buf_iova = buf_vec[vec_idx].buf_iova;
 	buf_len = buf_vec[vec_idx].buf_len;
 
+	vhost_queue_stats_chain(dev, vq, nr_vec, 1);
+
+	if (is_async) {
+		if (async_iter_initialize(dev, async))
+			return -1;
+	}
+
 	if (unlikely(buf_len < dev->vhost_hlen && nr_vec <= 1)) {
 		error = -1;
 		goto out;
@@ -2504,6 +2691,10 @@ copy_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		} else {
 			hdr = (struct virtio_net_hdr *)((uintptr_t)buf_addr);
 		}
+
+		/* The offloads are set once the data copy completes. */
+		if (is_async)
+			async->pkts_info[slot_idx].nethdr = *hdr;
 	}
 
 	/*
@@ -2515,12 +2706,14 @@ copy_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		buf_offset = dev->vhost_hlen - buf_len;
 		vec_idx++;
 		buf_addr = buf_vec[vec_idx].buf_addr;
+		buf_iova = buf_vec[vec_idx].buf_iova;
 		buf_len = buf_vec[vec_idx].buf_len;
 		buf_avail  = buf_len - buf_offset;
 	} else if (buf_len == dev->vhost_hlen) {
 		if (unlikely(++vec_idx >= nr_vec))
 			goto out;
 		buf_addr = buf_vec[vec_idx].buf_addr;
+		buf_iova = buf_vec[vec_idx].buf_iova;
 		buf_len = buf_vec[vec_idx].buf_len;
 
 		buf_offset = 0;
@@ -2539,7 +2732,13 @@ copy_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	while (1) {
 		cpy_len = RTE_MIN(buf_avail, mbuf_avail);
 
-		if (likely(cpy_len > MAX_BATCH_LEN ||
+		if (is_async) {
+			if (async_fill_seg(dev, vq, cur, mbuf_offset,
+					buf_iova + buf_offset, cpy_len, false) < 0) {
+				error = -1;
+				goto out;
+			}
+		} else if (likely(cpy_len > MAX_BATCH_LEN ||
 					vq->batch_copy_nb_elems >= vq->size ||
 					(hdr && cur == m))) {
 			rte_memcpy(rte_pktmbuf_mtod_offset(cur, void *,
@@ -2567,6 +2766,7 @@ copy_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 				break;
 
 			buf_addr = buf_vec[vec_idx].buf_addr;
+			buf_iova = buf_vec[vec_idx].buf_iova;
 			buf_len = buf_vec[vec_idx].buf_len;
 
 			buf_offset = 0;
@@ -2603,10 +2803,16 @@ copy_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	prev->data_len = mbuf_offset;
 	m->pkt_len    += mbuf_offset;
 
-	if (hdr)
+	if (hdr && !is_async)
 		vhost_dequeue_offload(dev, hdr, m, legacy_ol_flags);
 
 out:
+	if (is_async) {
+		if (unlikely(error))
+			async_iter_cancel(async);
+		else
+			async_iter_finalize(async);
+	}
 
 	return error;
 }
@@ -2674,6 +2880,116 @@ virtio_dev_pktmbuf_prep(struct virtio_net *dev, struct rte_mbuf *pkt,
 	return -1;
 }
 
+/*
+ * Dequeue a batch of packets, each from a single direct descriptor.
+ */
+static __rte_always_inline int
+vhost_reserve_avail_batch_split(struct virtio_net *dev,
+				struct vhost_virtqueue *vq,
+				struct rte_mbuf **pkts,
+				uint16_t avail_idx,
+				uintptr_t *desc_addrs,
+				uint16_t *ids)
+{
+	struct vring_desc *descs = vq->desc;
+	uint64_t lens[SPLIT_BATCH_SIZE];
+	uint64_t buf_lens[SPLIT_BATCH_SIZE];
+	uint32_t buf_offset = dev->vhost_hlen;
+	uint16_t i;
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		ids[i] = vq->avail->ring[(avail_idx + i) & (vq->size - 1)];
+		if (unlikely(ids[i] >= vq->size))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(descs[ids[i]].flags & SPLIT_DESC_SINGLE_FLAG))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		lens[i] = descs[ids[i]].len;
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(lens[i] < buf_offset))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		desc_addrs[i] = vhost_iova_to_vva(dev, vq,
+						  descs[ids[i]].addr,
+						  &lens[i], VHOST_ACCESS_RO);
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(!desc_addrs[i]))
+			return -1;
+		if (unlikely((lens[i] != descs[ids[i]].len)))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (virtio_dev_pktmbuf_prep(dev, pkts[i], lens[i]))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		buf_lens[i] = pkts[i]->buf_len - pkts[i]->data_off;
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(buf_lens[i] < (lens[i] - buf_offset)))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		pkts[i]->pkt_len = lens[i] - buf_offset;
+		pkts[i]->data_len = pkts[i]->pkt_len;
+	}
+
+	return 0;
+}
+
+static __rte_always_inline int
+virtio_dev_tx_batch_split(struct virtio_net *dev,
+			  struct vhost_virtqueue *vq,
+			  struct rte_mbuf **pkts,
+			  uint16_t avail_idx,
+			  bool legacy_ol_flags)
+{
+	uint32_t buf_offset = dev->vhost_hlen;
+	struct virtio_net_hdr *hdr;
+	uintptr_t desc_addrs[SPLIT_BATCH_SIZE];
+	uint16_t ids[SPLIT_BATCH_SIZE];
+	uint16_t i;
+
+	if (vhost_reserve_avail_batch_split(dev, vq, pkts, avail_idx,
+					    desc_addrs, ids))
+		return -1;
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		rte_prefetch0((void *)(uintptr_t)desc_addrs[i]);
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		rte_memcpy(rte_pktmbuf_mtod_offset(pkts[i], void *, 0),
+			   (void *)(uintptr_t)(desc_addrs[i] + buf_offset),
+			   pkts[i]->pkt_len);
+
+	if (virtio_net_with_host_offload(dev)) {
+		vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+			hdr = (struct virtio_net_hdr *)(desc_addrs[i]);
+			vhost_dequeue_offload(dev, hdr, pkts[i], legacy_ol_flags);
+		}
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		update_shadow_used_ring_split(vq, ids[i], 0);
+
+	vhost_queue_stats_chain(dev, vq, 1, SPLIT_BATCH_SIZE);
+
+	return 0;
+}
+
 __rte_always_inline
 static uint16_t
 virtio_dev_tx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
@@ -2706,13 +3022,23 @@ virtio_dev_tx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts, count))
 		return 0;
 
-	for (i = 0; i < count; i++) {
+	i = 0;
+	while (i < count) {
 		struct buf_vector buf_vec[BUF_VECTOR_MAX];
 		uint16_t head_idx;
 		uint32_t buf_len;
 		uint16_t nr_vec = 0;
 		int err;
 
+		if ((uint32_t)(count - i) >= SPLIT_BATCH_SIZE) {
+			if (!virtio_dev_tx_batch_split(dev, vq, &pkts[i],
+						       vq->last_avail_idx + i,
+						       legacy_ol_flags)) {
+				i += SPLIT_BATCH_SIZE;
+				continue;
+			}
+		}
+
 		if (unlikely(fill_vec_buf_split(dev, vq,
 						vq->last_avail_idx + i,
 						&nr_vec, buf_vec,
@@ -2740,7 +3066,7 @@ virtio_dev_tx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		}
 
 		err = copy_desc_to_mbuf(dev, vq, buf_vec, nr_vec, pkts[i],
-				mbuf_pool, legacy_ol_flags);
+				mbuf_pool, legacy_ol_flags, 0, false);
 		if (unlikely(err)) {
 			if (!allocerr_warned) {
 				VHOST_LOG_DATA(ERR, "(%s) failed to copy desc to mbuf.\n",
@@ -2751,6 +3077,8 @@ virtio_dev_tx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 			i++;
 			break;
 		}
+
+		i++;
 	}
 
 	if (dropped)
@@ -2763,7 +3091,9 @@ virtio_dev_tx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		vq->shadow_used_idx = i;
 	if (likely(vq->shadow_used_idx)) {
 		flush_shadow_used_ring_split(dev, vq);
-		vhost_vring_call_split(dev, vq);
+		/* The buffers of the dropped packets are used too. */
+		if (!vhost_vring_coalesce(dev, vq, i))
+			vhost_vring_call_split(dev, vq);
 	}
 
 	return (i - dropped);
@@ -2897,6 +3227,7 @@ virtio_dev_tx_batch_packed(struct virtio_net *dev,
 		vhost_shadow_dequeue_batch_packed(dev, vq, ids);
 
 	vq_inc_last_avail_packed(vq, PACKED_BATCH_SIZE);
+	vhost_queue_stats_chain(dev, vq, 1, PACKED_BATCH_SIZE);
 
 	return 0;
 }
@@ -2933,7 +3264,7 @@ vhost_dequeue_single_packed(struct virtio_net *dev,
 	}
 
 	err = copy_desc_to_mbuf(dev, vq, buf_vec, nr_vec, pkts,
-				mbuf_pool, legacy_ol_flags);
+				mbuf_pool, legacy_ol_flags, 0, false);
 	if (unlikely(err)) {
 		if (!allocerr_warned) {
 			VHOST_LOG_DATA(ERR, "(%s) failed to copy desc to mbuf.\n",
@@ -3014,7 +3345,8 @@ virtio_dev_tx_packed(struct virtio_net *dev,
 		do_data_copy_dequeue(vq);
 
 		vhost_flush_dequeue_shadow_packed(dev, vq);
-		vhost_vring_call_packed(dev, vq);
+		if (!vhost_vring_coalesce(dev, vq, pkt_idx))
+			vhost_vring_call_packed(dev, vq);
 	}
 
 	return pkt_idx;
@@ -3046,6 +3378,7 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 	struct rte_mbuf *rarp_mbuf = NULL;
 	struct vhost_virtqueue *vq;
 	int16_t success = 1;
+	uint64_t start;
 
 	dev = get_device(vid);
 	if (!dev)
@@ -3082,6 +3415,8 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 			goto out;
 		}
 
+	vhost_vring_coalesce_flush(dev, vq);
+
 	/*
 	 * Construct a RARP broadcast packet, and inject it to the "pkts"
 	 * array, to looks like that guest actually send such packet.
@@ -3117,6 +3452,7 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 		count -= 1;
 	}
 
+	start = vhost_queue_stats_start(dev);
 	if (vq_is_packed(dev)) {
 		if (dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS)
 			count = virtio_dev_tx_packed_legacy(dev, vq, mbuf_pool, pkts, count);
@@ -3128,6 +3464,542 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 		else
 			count = virtio_dev_tx_split_compliant(dev, vq, mbuf_pool, pkts, count);
 	}
+	vhost_queue_stats_update(dev, vq, pkts, count, start);
+
+out:
+	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
+		vhost_user_iotlb_rd_unlock(vq);
+
+out_access_unlock:
+	rte_spinlock_unlock(&vq->access_lock);
+
+	if (unlikely(rarp_mbuf != NULL))
+		count += 1;
+
+	return count;
+}
+
+static __rte_always_inline uint16_t
+async_poll_dequeue_completed(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		struct rte_mbuf **pkts, uint16_t count, int16_t dma_id,
+		uint16_t vchan_id, bool legacy_ol_flags)
+{
+	struct vhost_async *async = vq->async;
+	struct async_inflight_info *pkts_info = async->pkts_info;
+	uint16_t nr_cpl_pkts = 0;
+	uint16_t n_descs = 0, n_buffers = 0;
+	uint16_t start_idx, from, i;
+
+	/* Check completed copies for the given DMA vChannel */
+	vhost_async_dma_check_completed(dev, dma_id, vchan_id, VHOST_DMA_MAX_COPY_COMPLETE);
+
+	/* Packets are handed over in the order they were dequeued. */
+	start_idx = async_get_first_inflight_pkt_idx(vq);
+	from = start_idx;
+	while (async->pkts_cmpl_flag[from] && count--) {
+		async->pkts_cmpl_flag[from] = false;
+		from++;
+		if (from >= vq->size)
+			from -= vq->size;
+		nr_cpl_pkts++;
+	}
+
+	if (nr_cpl_pkts == 0) {
+		if (likely(vq->enabled && vq->access_ok))
+			vhost_vring_coalesce_flush(dev, vq);
+		return 0;
+	}
+
+	for (i = 0; i < nr_cpl_pkts; i++) {
+		from = (start_idx + i) % vq->size;
+		/* Only used with packed ring */
+		n_buffers += pkts_info[from].nr_buffers;
+		/* Only used with split ring */
+		n_descs += pkts_info[from].descs;
+		pkts[i] = pkts_info[from].mbuf;
+
+		if (virtio_net_with_host_offload(dev))
+			vhost_dequeue_offload(dev, &pkts_info[from].nethdr, pkts[i],
+					legacy_ol_flags);
+	}
+
+	async->pkts_inflight_n -= nr_cpl_pkts;
+
+	if (likely(vq->enabled && vq->access_ok)) {
+		if (vq_is_packed(dev)) {
+			write_back_completed_descs_packed(vq, n_buffers);
+			if (!vhost_vring_coalesce(dev, vq, nr_cpl_pkts))
+				vhost_vring_call_packed(dev, vq);
+		} else {
+			write_back_completed_descs_split(vq, n_descs);
+			__atomic_add_fetch(&vq->used->idx, n_descs, __ATOMIC_RELEASE);
+			if (!vhost_vring_coalesce(dev, vq, nr_cpl_pkts))
+				vhost_vring_call_split(dev, vq);
+		}
+	} else {
+		if (vq_is_packed(dev)) {
+			async->last_buffer_idx_packed += n_buffers;
+			if (async->last_buffer_idx_packed >= vq->size)
+				async->last_buffer_idx_packed -= vq->size;
+		} else {
+			async->last_desc_idx_split += n_descs;
+		}
+	}
+
+	return nr_cpl_pkts;
+}
+
+static __rte_always_inline uint16_t
+virtio_dev_tx_async_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts, uint16_t count,
+		int16_t dma_id, uint16_t vchan_id, bool legacy_ol_flags)
+{
+	static bool allocerr_warned;
+	bool dropped = false;
+	uint16_t free_entries;
+	uint16_t pkt_idx, slot_idx = 0;
+	uint16_t nr_done_pkts = 0;
+	uint16_t pkt_err = 0;
+	uint16_t n_xfer;
+	struct vhost_async *async = vq->async;
+	struct async_inflight_info *pkts_info = async->pkts_info;
+	struct rte_mbuf *pkts_prealloc[MAX_PKT_BURST];
+	uint16_t pkts_size = count;
+
+	/**
+	 * The ordering between avail index and
+	 * desc reads needs to be enforced.
+	 */
+	free_entries = __atomic_load_n(&vq->avail->idx, __ATOMIC_ACQUIRE) -
+			vq->last_avail_idx;
+	if (free_entries == 0)
+		goto out;
+
+	rte_prefetch0(&vq->avail->ring[vq->last_avail_idx & (vq->size - 1)]);
+
+	async_iter_reset(async);
+
+	count = RTE_MIN(count, MAX_PKT_BURST);
+	count = RTE_MIN(count, free_entries);
+	VHOST_LOG_DATA(DEBUG, "(%s) about to dequeue %u buffers\n",
+			dev->ifname, count);
+
+	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts_prealloc, count))
+		goto out;
+
+	for (pkt_idx = 0; pkt_idx < count; pkt_idx++) {
+		uint16_t head_idx = 0;
+		uint16_t nr_vec = 0;
+		uint16_t to;
+		uint32_t buf_len;
+		int err;
+		struct buf_vector buf_vec[BUF_VECTOR_MAX];
+		struct rte_mbuf *pkt = pkts_prealloc[pkt_idx];
+
+		if (unlikely(fill_vec_buf_split(dev, vq, vq->last_avail_idx,
+						&nr_vec, buf_vec,
+						&head_idx, &buf_len,
+						VHOST_ACCESS_RO) < 0)) {
+			dropped = true;
+			break;
+		}
+
+		err = virtio_dev_pktmbuf_prep(dev, pkt, buf_len);
+		if (unlikely(err)) {
+			/**
+			 * mbuf allocation fails for jumbo packets when external
+			 * buffer allocation is not allowed and linear buffer
+			 * is required. Drop this packet.
+			 */
+			if (!allocerr_warned) {
+				VHOST_LOG_DATA(ERR, "(%s) %s: Failed mbuf alloc of size %d from %s\n",
+					dev->ifname, __func__, buf_len, mbuf_pool->name);
+				allocerr_warned = true;
+			}
+			dropped = true;
+			break;
+		}
+
+		slot_idx = (async->pkts_idx + pkt_idx) & (vq->size - 1);
+		err = copy_desc_to_mbuf(dev, vq, buf_vec, nr_vec, pkt, mbuf_pool,
+				legacy_ol_flags, slot_idx, true);
+		if (unlikely(err)) {
+			if (!allocerr_warned) {
+				VHOST_LOG_DATA(ERR, "(%s) %s: Failed to offload copies to async channel.\n",
+					dev->ifname, __func__);
+				allocerr_warned = true;
+			}
+			dropped = true;
+			break;
+		}
+
+		pkts_info[slot_idx].mbuf = pkt;
+		pkts_info[slot_idx].descs = 1;
+
+		/* store used descs */
+		to = async->desc_idx_split & (vq->size - 1);
+		async->descs_split[to].id = head_idx;
+		async->descs_split[to].len = 0;
+		async->desc_idx_split++;
+
+		vq->last_avail_idx++;
+	}
+
+	if (unlikely(dropped))
+		rte_pktmbuf_free_bulk(&pkts_prealloc[pkt_idx], count - pkt_idx);
+
+	n_xfer = vhost_async_dma_transfer(dev, vq, dma_id, vchan_id, async->pkts_idx,
+					  async->iov_iter, pkt_idx);
+
+	async->pkts_inflight_n += n_xfer;
+
+	pkt_err = pkt_idx - n_xfer;
+	if (unlikely(pkt_err)) {
+		VHOST_LOG_DATA(DEBUG, "(%s) %s: failed to transfer data.\n",
+				dev->ifname, __func__);
+
+		pkt_idx = n_xfer;
+		/* recover available ring */
+		vq->last_avail_idx -= pkt_err;
+
+		/**
+		 * recover async channel copy related structures and free pktmbufs
+		 * for error pkts.
+		 */
+		async->desc_idx_split -= pkt_err;
+		while (pkt_err-- > 0) {
+			rte_pktmbuf_free(pkts_info[slot_idx & (vq->size - 1)].mbuf);
+			slot_idx--;
+		}
+	}
+
+	async->pkts_idx += pkt_idx;
+	if (async->pkts_idx >= vq->size)
+		async->pkts_idx -= vq->size;
+
+out:
+	/* DMA device may serve other queues, unconditionally check completed. */
+	nr_done_pkts = async_poll_dequeue_completed(dev, vq, pkts, pkts_size,
+			dma_id, vchan_id, legacy_ol_flags);
+
+	return nr_done_pkts;
+}
+
+__rte_noinline
+static uint16_t
+virtio_dev_tx_async_split_legacy(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, struct rte_mempool *mbuf_pool,
+		struct rte_mbuf **pkts, uint16_t count,
+		int16_t dma_id, uint16_t vchan_id)
+{
+	return virtio_dev_tx_async_split(dev, vq, mbuf_pool,
+				pkts, count, dma_id, vchan_id, true);
+}
+
+__rte_noinline
+static uint16_t
+virtio_dev_tx_async_split_compliant(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, struct rte_mempool *mbuf_pool,
+		struct rte_mbuf **pkts, uint16_t count,
+		int16_t dma_id, uint16_t vchan_id)
+{
+	return virtio_dev_tx_async_split(dev, vq, mbuf_pool,
+				pkts, count, dma_id, vchan_id, false);
+}
+
+static __rte_always_inline void
+vhost_async_shadow_dequeue_single_packed(struct vhost_virtqueue *vq,
+		uint16_t buf_id, uint16_t count)
+{
+	struct vhost_async *async = vq->async;
+	uint16_t idx = async->buffer_idx_packed;
+
+	async->buffers_packed[idx].id = buf_id;
+	async->buffers_packed[idx].len = 0;
+	async->buffers_packed[idx].count = count;
+
+	async->buffer_idx_packed++;
+	if (async->buffer_idx_packed >= vq->size)
+		async->buffer_idx_packed -= vq->size;
+}
+
+static __rte_always_inline int
+virtio_dev_tx_async_single_packed(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, struct rte_mempool *mbuf_pool,
+		struct rte_mbuf *pkts, uint16_t slot_idx, bool legacy_ol_flags)
+{
+	int err;
+	uint16_t buf_id, desc_count = 0;
+	uint16_t nr_vec = 0;
+	uint32_t buf_len;
+	struct buf_vector buf_vec[BUF_VECTOR_MAX];
+	static bool allocerr_warned;
+
+	if (unlikely(fill_vec_buf_packed(dev, vq, vq->last_avail_idx, &desc_count,
+					 buf_vec, &nr_vec, &buf_id, &buf_len,
+					 VHOST_ACCESS_RO) < 0))
+		return -1;
+
+	if (unlikely(virtio_dev_pktmbuf_prep(dev, pkts, buf_len))) {
+		if (!allocerr_warned) {
+			VHOST_LOG_DATA(ERR, "(%s) %s: Failed mbuf alloc of size %d from %s.\n",
+				dev->ifname, __func__, buf_len, mbuf_pool->name);
+			allocerr_warned = true;
+		}
+		return -1;
+	}
+
+	err = copy_desc_to_mbuf(dev, vq, buf_vec, nr_vec, pkts, mbuf_pool,
+			legacy_ol_flags, slot_idx, true);
+	if (unlikely(err)) {
+		if (!allocerr_warned) {
+			VHOST_LOG_DATA(ERR, "(%s) %s: Failed to copy desc to mbuf.\n",
+				dev->ifname, __func__);
+			allocerr_warned = true;
+		}
+		return -1;
+	}
+
+	vq->async->pkts_info[slot_idx].descs = desc_count;
+
+	/* update async shadow packed ring */
+	vhost_async_shadow_dequeue_single_packed(vq, buf_id, desc_count);
+
+	return err;
+}
+
+static __rte_always_inline uint16_t
+virtio_dev_tx_async_packed(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count, int16_t dma_id, uint16_t vchan_id, bool legacy_ol_flags)
+{
+	uint16_t pkt_idx;
+	uint16_t slot_idx = 0;
+	uint16_t nr_done_pkts = 0;
+	uint16_t pkt_err = 0;
+	uint32_t n_xfer;
+	struct vhost_async *async = vq->async;
+	struct async_inflight_info *pkts_info = async->pkts_info;
+	struct rte_mbuf *pkts_prealloc[MAX_PKT_BURST];
+
+	VHOST_LOG_DATA(DEBUG, "(%s) %s\n", dev->ifname, __func__);
+
+	async_iter_reset(async);
+
+	count = RTE_MIN(count, MAX_PKT_BURST);
+	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts_prealloc, count))
+		goto out;
+
+	for (pkt_idx = 0; pkt_idx < count; pkt_idx++) {
+		struct rte_mbuf *pkt = pkts_prealloc[pkt_idx];
+
+		rte_prefetch0(&vq->desc_packed[vq->last_avail_idx]);
+
+		slot_idx = (async->pkts_idx + pkt_idx) % vq->size;
+		if (unlikely(virtio_dev_tx_async_single_packed(dev, vq, mbuf_pool, pkt,
+						slot_idx, legacy_ol_flags))) {
+			rte_pktmbuf_free_bulk(&pkts_prealloc[pkt_idx], count - pkt_idx);
+			break;
+		}
+
+		pkts_info[slot_idx].mbuf = pkt;
+		pkts_info[slot_idx].nr_buffers = 1;
+
+		vq_inc_last_avail_packed(vq, pkts_info[slot_idx].descs);
+	}
+
+	n_xfer = vhost_async_dma_transfer(dev, vq, dma_id, vchan_id, async->pkts_idx,
+					async->iov_iter, pkt_idx);
+
+	async->pkts_inflight_n += n_xfer;
+
+	pkt_err = pkt_idx - n_xfer;
+
+	if (unlikely(pkt_err)) {
+		uint16_t descs_err = 0;
+
+		pkt_idx -= pkt_err;
+
+		/**
+		 * recover DMA-copy related structures and free pktmbuf for DMA-error pkt.
+		 */
+		if (async->buffer_idx_packed >= pkt_err)
+			async->buffer_idx_packed -= pkt_err;
+		else
+			async->buffer_idx_packed += vq->size - pkt_err;
+
+		while (pkt_err-- > 0) {
+			rte_pktmbuf_free(pkts_info[slot_idx].mbuf);
+			descs_err += pkts_info[slot_idx].descs;
+
+			if (slot_idx == 0)
+				slot_idx = vq->size - 1;
+			else
+				slot_idx--;
+		}
+
+		/* recover available ring */
+		if (vq->last_avail_idx >= descs_err) {
+			vq->last_avail_idx -= descs_err;
+		} else {
+			vq->last_avail_idx += vq->size - descs_err;
+			vq->avail_wrap_counter ^= 1;
+		}
+	}
+
+	async->pkts_idx += pkt_idx;
+	if (async->pkts_idx >= vq->size)
+		async->pkts_idx -= vq->size;
+
+out:
+	nr_done_pkts = async_poll_dequeue_completed(dev, vq, pkts, count,
+					dma_id, vchan_id, legacy_ol_flags);
+
+	return nr_done_pkts;
+}
+
+__rte_noinline
+static uint16_t
+virtio_dev_tx_async_packed_legacy(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count, int16_t dma_id, uint16_t vchan_id)
+{
+	return virtio_dev_tx_async_packed(dev, vq, mbuf_pool,
+				pkts, count, dma_id, vchan_id, true);
+}
+
+__rte_noinline
+static uint16_t
+virtio_dev_tx_async_packed_compliant(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count, int16_t dma_id, uint16_t vchan_id)
+{
+	return virtio_dev_tx_async_packed(dev, vq, mbuf_pool,
+				pkts, count, dma_id, vchan_id, false);
+}
+
+uint16_t
+rte_vhost_async_try_dequeue_burst(int vid, uint16_t queue_id,
+	struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts, uint16_t count,
+	int *nr_inflight, int16_t dma_id, uint16_t vchan_id)
+{
+	struct virtio_net *dev;
+	struct rte_mbuf *rarp_mbuf = NULL;
+	struct vhost_virtqueue *vq;
+	int16_t success = 1;
+	uint64_t start;
+
+	dev = get_device(vid);
+	if (!dev || !nr_inflight)
+		return 0;
+
+	*nr_inflight = -1;
+
+	if (unlikely(!(dev->flags & VIRTIO_DEV_BUILTIN_VIRTIO_NET))) {
+		VHOST_LOG_DATA(ERR, "(%s) %s: built-in vhost net backend is disabled.\n",
+				dev->ifname, __func__);
+		return 0;
+	}
+
+	if (unlikely(!is_valid_virt_queue_idx(queue_id, 1, dev->nr_vring))) {
+		VHOST_LOG_DATA(ERR, "(%s) %s: invalid virtqueue idx %d.\n",
+				dev->ifname, __func__, queue_id);
+		return 0;
+	}
+
+	if (unlikely(dma_id < 0 || dma_id >= RTE_DMADEV_DEFAULT_MAX)) {
+		VHOST_LOG_DATA(ERR, "(%s) %s: invalid dma id %d.\n",
+				dev->ifname, __func__, dma_id);
+		return 0;
+	}
+
+	if (unlikely(!dma_copy_track[dma_id].vchans ||
+				!dma_copy_track[dma_id].vchans[vchan_id].pkts_cmpl_flag_addr)) {
+		VHOST_LOG_DATA(ERR, "(%s) %s: invalid channel %d:%u.\n", dev->ifname, __func__,
+				dma_id, vchan_id);
+		return 0;
+	}
+
+	vq = dev->virtqueue[queue_id];
+
+	if (unlikely(rte_spinlock_trylock(&vq->access_lock) == 0))
+		return 0;
+
+	if (unlikely(vq->enabled == 0)) {
+		count = 0;
+		goto out_access_unlock;
+	}
+
+	if (unlikely(!vq->async)) {
+		VHOST_LOG_DATA(ERR, "(%s) %s: async not registered for queue id %d.\n",
+				dev->ifname, __func__, queue_id);
+		count = 0;
+		goto out_access_unlock;
+	}
+
+	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
+		vhost_user_iotlb_rd_lock(vq);
+
+	if (unlikely(vq->access_ok == 0))
+		if (unlikely(vring_translate(dev, vq) < 0)) {
+			count = 0;
+			goto out;
+		}
+
+	/*
+	 * Construct a RARP broadcast packet, and inject it to the "pkts"
+	 * array, to looks like that guest actually send such packet.
+	 *
+	 * Check user_send_rarp() for more information.
+	 *
+	 * broadcast_rarp shares a cacheline in the virtio_net structure
+	 * with some fields that are accessed during enqueue and
+	 * __atomic_compare_exchange_n causes a write if performed compare
+	 * and exchange. This could result in false sharing between enqueue
+	 * and dequeue.
+	 *
+	 * Prevent unnecessary false sharing by reading broadcast_rarp first
+	 * and only performing compare and exchange if the read indicates it
+	 * is likely to be set.
+	 */
+	if (unlikely(__atomic_load_n(&dev->broadcast_rarp, __ATOMIC_ACQUIRE) &&
+			__atomic_compare_exchange_n(&dev->broadcast_rarp,
+			&success, 0, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))) {
+
+		rarp_mbuf = rte_net_make_rarp_packet(mbuf_pool, &dev->mac);
+		if (rarp_mbuf == NULL) {
+			VHOST_LOG_DATA(ERR, "(%s) failed to make RARP packet.\n", dev->ifname);
+			count = 0;
+			goto out;
+		}
+		/*
+		 * Inject it to the head of "pkts" array, so that switch's mac
+		 * learning table will get updated first.
+		 */
+		pkts[0] = rarp_mbuf;
+		pkts++;
+		count -= 1;
+	}
+
+	start = vhost_queue_stats_start(dev);
+	if (vq_is_packed(dev)) {
+		if (dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS)
+			count = virtio_dev_tx_async_packed_legacy(dev, vq, mbuf_pool,
+					pkts, count, dma_id, vchan_id);
+		else
+			count = virtio_dev_tx_async_packed_compliant(dev, vq, mbuf_pool,
+					pkts, count, dma_id, vchan_id);
+	} else {
+		if (dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS)
+			count = virtio_dev_tx_async_split_legacy(dev, vq, mbuf_pool,
+					pkts, count, dma_id, vchan_id);
+		else
+			count = virtio_dev_tx_async_split_compliant(dev, vq, mbuf_pool,
+					pkts, count, dma_id, vchan_id);
+	}
+	vhost_queue_stats_update(dev, vq, pkts, count, start);
+
+	*nr_inflight = vq->async->pkts_inflight_n;
 
 out:
 	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))